@@ -156,17 +156,25 @@ describe('CompletionQueryEngine', () => {
         const astManager = getAstManagerForTests();
         const resolver = new InheritanceResolver([root]);
         const projectSymbolIndex = new ProjectSymbolIndex(resolver);
-        const engine = new CompletionQueryEngine({
-            snapshotProvider: astManager,
-            projectSymbolIndex,
-            contextAnalyzer: new CompletionContextAnalyzer()
-        });
         const headerDocument = createDocument(headerPath, headerContent);
         const sourceDocument = createDocument(sourcePath, sourceContent);
 
         const headerSnapshot = astManager.getSemanticSnapshot(headerDocument, false);
-        const sourceSnapshot = astManager.getSemanticSnapshot(sourceDocument, false);
-        sourceSnapshot.includeStatements[0].resolvedUri = headerSnapshot.uri;
+        const parsedSourceSnapshot = astManager.getSemanticSnapshot(sourceDocument, false);
+        // 快照已冻结，用替换了 include 解析结果的副本模拟已解析的头文件。
+        const sourceSnapshot = {
+            ...parsedSourceSnapshot,
+            includeStatements: [{ ...parsedSourceSnapshot.includeStatements[0], resolvedUri: headerSnapshot.uri }]
+        };
+        const engine = new CompletionQueryEngine({
+            snapshotProvider: {
+                getSnapshot: (document: vscode.TextDocument) => document === sourceDocument
+                    ? sourceSnapshot
+                    : astManager.getSemanticSnapshot(document, false)
+            },
+            projectSymbolIndex,
+            contextAnalyzer: new CompletionContextAnalyzer()
+        });
         projectSymbolIndex.updateFromSemanticSnapshot(headerSnapshot);
         projectSymbolIndex.updateFromSemanticSnapshot(sourceSnapshot);
 
@@ -561,5 +569,63 @@ describe('CompletionQueryEngine', () => {
         expect(baseCandidates[0].detail).toBe('"/lib/base"');
         expect(result.candidates.map(candidate => candidate.label)).not.toContain('ROOM_D');
     });
+
+    test('caps large identifier lists as incomplete and reuses prebuilt layers while typing', () => {
+        const basePath = path.join(root, 'lib', 'big_base.c');
+        const childPath = path.join(root, 'big-room.c');
+        const baseContent = 'int fn_helper() { return 1; }';
+        const childContent = [
+            'inherit "/lib/big_base";',
+            '',
+            'void demo() {',
+            '    fn_12();',
+            '}'
+        ].join('\n');
+        fs.writeFileSync(basePath, baseContent, 'utf8');
+        fs.writeFileSync(childPath, childContent, 'utf8');
+
+        const efuns = Array.from({ length: 1500 }, (_, index) => `fn_${String(index).padStart(4, '0')}`);
+        const astManager = getAstManagerForTests();
+        const projectSymbolIndex = new ProjectSymbolIndex(new InheritanceResolver([root]));
+        projectSymbolIndex.updateFromSemanticSnapshot(astManager.getSemanticSnapshot(createDocument(basePath, baseContent), false));
+        const createEngine = () => new CompletionQueryEngine({
+            snapshotProvider: astManager,
+            projectSymbolIndex,
+            contextAnalyzer: new CompletionContextAnalyzer(),
+            efunProvider: {
+                getAllFunctions: () => [...efuns],
+                getAllSimulatedFunctions: () => []
+            }
+        });
+        const engine = createEngine();
+        const childDocument = createDocument(childPath, childContent);
+        const queryAt = (target: CompletionQueryEngine, character: number) => target.query(
+            childDocument,
+            new vscode.Position(3, character),
+            {} as vscode.CompletionContext,
+            { isCancellationRequested: false } as vscode.CancellationToken
+        );
+        const includedLookups = jest.spyOn(projectSymbolIndex, 'getIncludedSymbols');
+
+        const broad = queryAt(engine, '    fn'.length);
+        expect(broad.isIncomplete).toBe(true);
+        expect(broad.candidates).toHaveLength(1000);
+        expect(broad.candidates[0].label).toBe('fn_helper');
+
+        const narrowed = queryAt(engine, '    fn_1'.length);
+        const refined = queryAt(engine, '    fn_12'.length);
+        expect(narrowed.isIncomplete).toBe(false);
+        expect(narrowed.candidates).toHaveLength(500);
+        expect(refined.candidates.map(candidate => candidate.key))
+            .toEqual(queryAt(createEngine(), '    fn_12'.length).candidates.map(candidate => candidate.key));
+        expect(refined.candidates.map(candidate => candidate.label)).toEqual(efuns.filter(name => name.startsWith('fn_12')));
+        expect(includedLookups).toHaveBeenCalledTimes(2);
+
+        const updatedBaseContent = `${baseContent}\nint fn_1200_local() { return 2; }`;
+        projectSymbolIndex.updateFromSemanticSnapshot(
+            astManager.getSemanticSnapshot(createDocument(basePath, updatedBaseContent, 2), false)
+        );
+        expect(queryAt(engine, '    fn_12'.length).candidates[0].label).toBe('fn_1200_local');
+    });
 });
 import { afterAll, afterEach, beforeAll, beforeEach, describe, expect, jest, test } from '@jest/globals';
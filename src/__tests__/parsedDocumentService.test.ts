@@ -56,6 +56,23 @@ describe('ParsedDocumentService', () => {
         expect(stats.hits).toBeGreaterThanOrEqual(1);
     });
 
+    test('reuses the parse tree when a newer version carries identical text', () => {
+        const service = new ParsedDocumentService({ cleanupInterval: 0, enableMonitoring: true });
+        const content = 'int demo() {\n    return 1;\n}';
+        const first = service.get(createDocument(content, '/virtual/content-reuse.c', 1));
+        const second = service.get(createDocument(content, '/virtual/content-reuse.c', 2));
+
+        expect(second).not.toBe(first);
+        expect(second.version).toBe(2);
+        expect(second.tree).toBe(first.tree);
+        expect(second.visibleTokens).toEqual(first.visibleTokens);
+        expect(service.getStats().parseCount).toBe(1);
+
+        const edited = service.get(createDocument('int demo() {\n    return 2;\n}', '/virtual/content-reuse.c', 3));
+        expect(edited.tree).not.toBe(first.tree);
+        expect(service.getStats().parseCount).toBe(2);
+    });
+
     test('disposing the global parsed document service recreates a fresh singleton on next access', () => {
         const first = getGlobalParsedDocumentService();
 
@@ -183,5 +200,41 @@ describe('ParsedDocumentService', () => {
             })
         ]));
     });
+
+    test('parses declarations for indexing without function bodies or cache writes', () => {
+        const service = new ParsedDocumentService({ cleanupInterval: 0, enableMonitoring: true });
+        const document = createDocument([
+            'inherit "/std/object";',
+            'int *levels = ({ 1, 2 });',
+            'class Payload { int hp; }',
+            '',
+            '// entry point',
+            'void create() {',
+            '    int local_value = 1;',
+            '    if (local_value) { local_value++; }',
+            '}',
+            '',
+            'string query_name() { return "demo"; }'
+        ].join('\n'), '/virtual/declarations.c');
+
+        const parsed = service.parseDeclarations(document);
+        const visibleText = parsed.visibleTokens.map((token) => token.text).join(' ');
+
+        expect(parsed.declarationOnly).toBe(true);
+        expect(parsed.degraded).toBeUndefined();
+        expect(parsed.diagnostics).toEqual([]);
+        expect(visibleText).toContain('levels = ( { 1 , 2 } )');
+        expect(visibleText).toContain('class Payload { int hp ; }');
+        expect(visibleText).toContain('void create ( ) { }');
+        expect(visibleText).toContain('string query_name ( ) { }');
+        expect(visibleText).not.toContain('local_value');
+        expect(parsed.tokenTriviaIndex.getAllTrivia().map((entry) => entry.text)).toContain('// entry point');
+        expect(parsed.visibleTokens.find((token) => token.text === 'query_name')?.line).toBe(11);
+        expect(service.getStats().size).toBe(0);
+
+        const full = service.get(document);
+        expect(full.declarationOnly).toBeUndefined();
+        expect(service.parseDeclarations(document)).toBe(full);
+    });
 });
 import { afterAll, afterEach, beforeAll, beforeEach, describe, expect, jest, test } from '@jest/globals';
@@ -169,6 +169,31 @@ describe('ProjectSymbolIndex', () => {
         expect(index.getRecord(snapshot.uri)?.exportedFunctions.map(func => func.name)).toEqual(['query_name']);
     });
 
+    test('shares frozen records across queries and copies caller-owned input once', () => {
+        const snapshot = createSnapshot('/virtual/shared.c');
+        snapshot.exportedFunctions = [{
+            name: 'query_name',
+            returnType: 'string',
+            parameters: [],
+            modifiers: [],
+            sourceUri: snapshot.uri,
+            range: new vscode.Range(0, 0, 0, 20),
+            origin: 'local'
+        }];
+
+        const index = new ProjectSymbolIndex(new InheritanceResolver(['/']));
+        index.updateFromSnapshot(snapshot);
+        const record = index.getRecord(snapshot.uri);
+
+        expect(index.getRecord(snapshot.uri)).toBe(record);
+        expect(index.getAllRecords()[0]).toBe(record);
+        expect(Object.isFrozen(record?.exportedFunctions[0])).toBe(true);
+        expect(Object.isFrozen(snapshot.exportedFunctions)).toBe(false);
+
+        snapshot.exportedFunctions[0].name = 'changed_after_update';
+        expect(index.getRecord(snapshot.uri)?.exportedFunctions[0].name).toBe('query_name');
+    });
+
     test('updates records when a same-version dependency snapshot is rebuilt', () => {
         const firstSnapshot = createSnapshot('/virtual/include/helper.h');
         firstSnapshot.exportedFunctions = [{
@@ -286,4 +311,136 @@ describe('ProjectSymbolIndex', () => {
         expect(included.fileGlobals.map((global) => global.name)).toEqual(['HELPER_D']);
         expect(included.unresolvedIncludes.map((include) => include.value)).toEqual(['/missing.h']);
     });
+
+    test('re-links inherit targets of a stored record without re-summarizing it', () => {
+        const baseSnapshot = createSnapshot('/virtual/std/base.c');
+        baseSnapshot.exportedFunctions = [{
+            name: 'base_call',
+            returnType: 'void',
+            parameters: [],
+            modifiers: [],
+            sourceUri: baseSnapshot.uri,
+            range: new vscode.Range(0, 0, 0, 10),
+            origin: 'local'
+        }];
+        const childSnapshot = createSnapshot('/virtual/room/child.c');
+        childSnapshot.inheritStatements = [{
+            rawText: 'inherit "/std/base";',
+            expressionKind: 'string',
+            value: '/std/base',
+            range: new vscode.Range(0, 0, 0, 20),
+            isResolved: false
+        }];
+
+        let baseExists = false;
+        const resolver = new InheritanceResolver(['/virtual']);
+        jest.spyOn(resolver, 'resolveInheritTargets')
+            .mockImplementation((snapshot: Pick<SemanticSnapshot, 'uri' | 'inheritStatements'>) => snapshot.inheritStatements.map(statement => ({
+                rawValue: statement.value,
+                expressionKind: statement.expressionKind,
+                sourceUri: snapshot.uri,
+                resolvedUri: baseExists ? baseSnapshot.uri : undefined,
+                isResolved: baseExists
+            })));
+
+        const index = new ProjectSymbolIndex(resolver);
+        index.updateFromSnapshot(childSnapshot);
+
+        expect(index.getRecordsWithUnresolvedLinks().map(record => record.uri)).toEqual([childSnapshot.uri]);
+        expect(index.getInheritedSymbols(childSnapshot.uri).functions).toEqual([]);
+
+        baseExists = true;
+        index.updateFromSnapshot(baseSnapshot);
+        expect(index.refreshInheritTargets(childSnapshot.uri)).toBe(true);
+
+        expect(index.getInheritingUris(baseSnapshot.uri)).toEqual([childSnapshot.uri]);
+        expect(index.getRecord(childSnapshot.uri)?.inheritStatements[0]).toEqual(expect.objectContaining({
+            resolvedUri: baseSnapshot.uri,
+            isResolved: true
+        }));
+        expect(index.getInheritedSymbols(childSnapshot.uri).functions.map(func => func.name)).toEqual(['base_call']);
+        expect(index.getRecordsWithUnresolvedLinks()).toEqual([]);
+        expect(index.refreshInheritTargets('/virtual/missing.c')).toBe(false);
+    });
+
+    test('memoizes flattened sets and invalidates them along reverse inherit and include edges', () => {
+        const createFunction = (snapshot: SemanticSnapshot, name: string) => ({
+            name,
+            returnType: 'void',
+            parameters: [],
+            modifiers: [],
+            sourceUri: snapshot.uri,
+            range: new vscode.Range(0, 0, 0, 10),
+            origin: 'local' as const
+        });
+        const inherit = (snapshot: SemanticSnapshot, target: SemanticSnapshot) => {
+            snapshot.inheritStatements = [{
+                rawText: `inherit "${target.uri}";`,
+                expressionKind: 'string',
+                value: target.uri,
+                range: new vscode.Range(0, 0, 0, 20),
+                resolvedUri: target.uri,
+                isResolved: true
+            }];
+        };
+        const baseSnapshot = createSnapshot('/virtual/std/base.c');
+        baseSnapshot.exportedFunctions = [createFunction(baseSnapshot, 'base_call')];
+        baseSnapshot.typeDefinitions = [{
+            name: 'Payload',
+            kind: 'class',
+            members: [],
+            sourceUri: baseSnapshot.uri,
+            range: new vscode.Range(0, 0, 1, 1)
+        }];
+        const roomSnapshot = createSnapshot('/virtual/std/room.c');
+        inherit(roomSnapshot, baseSnapshot);
+        const innSnapshot = createSnapshot('/virtual/d/inn.c');
+        inherit(innSnapshot, roomSnapshot);
+        const headerSnapshot = createSnapshot('/virtual/include/helper.h');
+        headerSnapshot.exportedFunctions = [createFunction(headerSnapshot, 'helper_call')];
+        const daemonSnapshot = createSnapshot('/virtual/adm/daemon.c');
+        daemonSnapshot.includeStatements = [{
+            rawText: '#include "/include/helper.h"',
+            value: '/include/helper.h',
+            range: new vscode.Range(0, 0, 0, 28),
+            isSystemInclude: false,
+            resolvedUri: headerSnapshot.uri
+        }];
+
+        const resolver = new InheritanceResolver(['/']);
+        jest.spyOn(resolver, 'resolveInheritTargets')
+            .mockImplementation((snapshot: Pick<SemanticSnapshot, 'uri' | 'inheritStatements'>) => snapshot.inheritStatements.map(statement => ({
+                rawValue: statement.value,
+                expressionKind: statement.expressionKind,
+                sourceUri: snapshot.uri,
+                resolvedUri: statement.resolvedUri,
+                isResolved: statement.isResolved
+            })));
+        const index = new ProjectSymbolIndex(resolver);
+        for (const snapshot of [baseSnapshot, roomSnapshot, innSnapshot, headerSnapshot, daemonSnapshot]) {
+            index.updateFromSnapshot(snapshot);
+        }
+
+        const innSymbols = index.getInheritedSymbols(innSnapshot.uri);
+        const daemonIncluded = index.getIncludedSymbols(daemonSnapshot.uri);
+        expect(innSymbols.functions.map(func => func.name)).toEqual(['base_call']);
+        expect(Object.isFrozen(innSymbols.functions)).toBe(true);
+        expect(index.getInheritedSymbols(innSnapshot.uri)).toBe(innSymbols);
+        expect(index.getIncludedSymbols(daemonSnapshot.uri)).toBe(daemonIncluded);
+        expect(index.getInheritingUris(roomSnapshot.uri)).toEqual([innSnapshot.uri]);
+
+        const updatedBase = createSnapshot('/virtual/std/base.c');
+        updatedBase.version = 2;
+        updatedBase.exportedFunctions = [createFunction(updatedBase, 'base_call'), createFunction(updatedBase, 'base_reset')];
+        index.updateFromSnapshot(updatedBase);
+
+        expect(index.getInheritedSymbols(innSnapshot.uri).functions.map(func => func.name)).toEqual(['base_call', 'base_reset']);
+        expect(index.getIncludedSymbols(daemonSnapshot.uri)).toBe(daemonIncluded);
+        expect(index.findType('Payload')).toBeUndefined();
+
+        index.removeFile(headerSnapshot.uri);
+
+        expect(index.getIncludedSymbols(daemonSnapshot.uri).functions).toEqual([]);
+        expect(index.getOwnersIncluding(headerSnapshot.uri).map(record => record.uri)).toEqual([daemonSnapshot.uri]);
+    });
 });
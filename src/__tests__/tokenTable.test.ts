@@ -0,0 +1,53 @@
+import { afterEach, describe, expect, test } from '@jest/globals';
+import { Token } from 'antlr4ts';
+import { LPCLexer } from '../antlr/LPCLexer';
+import { ParsedDocumentService } from '../parser/ParsedDocumentService';
+import { TokenTable } from '../parser/TokenTable';
+import { TestHelper } from './utils/TestHelper';
+
+describe('TokenTable', () => {
+    const parsedDocumentService = new ParsedDocumentService({});
+
+    afterEach(() => {
+        parsedDocumentService.clear();
+    });
+
+    test('mirrors the token stream columns and slices text from the parse text', () => {
+        const source = `// room\ninherit "/std/room";\n\nvoid create() {\n    set("short", "inn");\n}\n`;
+        const parsed = parsedDocumentService.get(TestHelper.createMockDocument(source, 'lpc', 'token-table.c'));
+        const table = parsed.tokenTable!;
+
+        expect(table.length).toBe(parsed.allTokens.length);
+        parsed.allTokens.forEach((token, index) => {
+            expect(table.types[index]).toBe(token.type);
+            expect(table.lines[index]).toBe(token.line);
+            expect(table.columns[index]).toBe(token.charPositionInLine);
+            if (token.type !== Token.EOF) {
+                expect(table.text(index)).toBe(token.text);
+            }
+        });
+        expect(Array.from(table.visibleIndexes)).toEqual(parsed.visibleTokens.map((token) => token.tokenIndex));
+        expect(Array.from(table.hiddenIndexes)).toEqual(parsed.hiddenTokens.map((token) => token.tokenIndex));
+    });
+
+    test('finds neighbouring visible tokens without materializing token objects', () => {
+        const source = `int x = query("hp");\n`;
+        const parsed = parsedDocumentService.get(TestHelper.createMockDocument(source, 'lpc', 'token-table-nav.c'));
+        const table = parsed.tokenTable!;
+
+        const queryIndex = table.findVisibleAtOrBefore(source.indexOf('query'));
+        expect(table.text(queryIndex)).toBe('query');
+        expect(table.text(table.findAdjacentVisible(queryIndex, 1))).toBe('(');
+        expect(table.text(table.findAdjacentVisible(queryIndex, -1))).toBe('=');
+        expect(table.view(queryIndex)).toEqual(expect.objectContaining({ text: 'query', line: 1, tokenIndex: queryIndex }));
+    });
+
+    test('keeps token-supplied text when no source is given', () => {
+        const table = TokenTable.fromTokens([
+            { type: LPCLexer.Identifier, text: 'demo', line: 1, charPositionInLine: 0, channel: 0, tokenIndex: 0, startIndex: 0, stopIndex: 3 }
+        ]);
+
+        expect(table.text(0)).toBe('demo');
+        expect(Array.from(table.visibleIndexes)).toEqual([0]);
+    });
+});
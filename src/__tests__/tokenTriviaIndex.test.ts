@@ -86,4 +86,21 @@ describe('TokenTriviaIndex', () => {
         expect(triviaKinds(trailingTrivia)).toEqual(['whitespace', 'line-comment', 'newline']);
         expect(trailingTrivia[1].text).toBe('// trailing comment');
     });
+
+    test('matches a full scan for every visible token range', () => {
+        const source = `/* a */ int /* b */ value = // c\n    1 /* d */ + 2; // e\n`;
+        const document = TestHelper.createMockDocument(source, 'lpc', 'trivia-ranges.c');
+        const parsed = parsedDocumentService.get(document);
+        const allTrivia = parsed.tokenTriviaIndex.getAllTrivia();
+        const visibleIndexes = [-1, ...parsed.visibleTokens.map((token) => token.tokenIndex)];
+
+        for (let index = 0; index < visibleIndexes.length - 1; index++) {
+            const start = visibleIndexes[index];
+            const end = visibleIndexes[index + 1];
+            expect(parsed.tokenTriviaIndex.getInterveningTrivia(start, end)).toEqual(
+                allTrivia.filter((entry) => entry.tokenIndex > start && entry.tokenIndex < end)
+            );
+        }
+        expect(triviaKinds(parsed.tokenTriviaIndex.getLeadingTrivia(visibleIndexes[1]))).toEqual(['block-comment', 'whitespace']);
+    });
 });
@@ -0,0 +1,150 @@
+import { CompletionCandidate } from './types';
+
+/** 与 `String.prototype.localeCompare` 默认行为一致，但不必每次比较都解析区域设置 */
+const labelCollator = new Intl.Collator();
+
+interface IndexedCandidate {
+    readonly candidate: CompletionCandidate;
+    readonly normalizedLabel: string;
+    /** 在展示顺序中的位置 */
+    readonly rank: number;
+}
+
+export function getSortGroupOrder(group: CompletionCandidate['sortGroup']): number {
+    switch (group) {
+        case 'scope': return 0;
+        case 'type-member': return 1;
+        case 'inherited': return 2;
+        case 'keyword': return 3;
+        case 'builtin': return 4;
+        default: return 9;
+    }
+}
+
+/**
+ * 补全列表的展示顺序：先按分组，再按标签。
+ */
+export function compareCompletionCandidates(left: CompletionCandidate, right: CompletionCandidate): number {
+    const sortGroupOrder = getSortGroupOrder(left.sortGroup) - getSortGroupOrder(right.sortGroup);
+    if (sortGroupOrder !== 0) {
+        return sortGroupOrder;
+    }
+
+    return labelCollator.compare(left.label, right.label);
+}
+
+/**
+ * 一层补全候选（内置函数与关键字、继承/包含的符号、当前作用域符号等）的预排序索引。
+ * 候选在构建时按 key 去重、按展示顺序排好，同时保留一份按小写标签排序的副本，
+ * 前缀查询用二分查找定位区间，不再逐个比较整层候选。
+ */
+export class CompletionCandidateIndex {
+    public static readonly EMPTY = new CompletionCandidateIndex([]);
+
+    private readonly ordered: readonly CompletionCandidate[];
+    private readonly byLabel: readonly IndexedCandidate[];
+
+    constructor(candidates: Iterable<CompletionCandidate>) {
+        const deduped = new Map<string, CompletionCandidate>();
+        for (const candidate of candidates) {
+            if (!deduped.has(candidate.key)) {
+                deduped.set(candidate.key, candidate);
+            }
+        }
+
+        this.ordered = Object.freeze(Array.from(deduped.values()).sort(compareCompletionCandidates));
+        this.byLabel = this.ordered
+            .map((candidate, rank): IndexedCandidate => ({
+                candidate,
+                normalizedLabel: candidate.label.toLowerCase(),
+                rank
+            }))
+            .sort((left, right) => compareCodeUnits(left.normalizedLabel, right.normalizedLabel) || left.rank - right.rank);
+    }
+
+    public get size(): number {
+        return this.ordered.length;
+    }
+
+    /**
+     * 标签以 `prefix` 开头（不区分大小写）的候选，按展示顺序返回。
+     */
+    public query(prefix: string): readonly CompletionCandidate[] {
+        if (!prefix) {
+            return this.ordered;
+        }
+
+        const normalizedPrefix = prefix.toLowerCase();
+        const matches: IndexedCandidate[] = [];
+        for (let index = this.lowerBound(normalizedPrefix); index < this.byLabel.length; index++) {
+            const entry = this.byLabel[index];
+            if (!entry.normalizedLabel.startsWith(normalizedPrefix)) {
+                break;
+            }
+            matches.push(entry);
+        }
+
+        return matches
+            .sort((left, right) => left.rank - right.rank)
+            .map((entry) => entry.candidate);
+    }
+
+    private lowerBound(value: string): number {
+        let low = 0;
+        let high = this.byLabel.length;
+        while (low < high) {
+            const mid = (low + high) >>> 1;
+            if (this.byLabel[mid].normalizedLabel < value) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        return low;
+    }
+}
+
+/**
+ * 合并各层已按展示顺序排好的结果；比较相等时靠前的层优先，
+ * 与把各层依次拼接后做稳定排序的结果相同。
+ */
+export function mergeCompletionCandidates(lists: readonly (readonly CompletionCandidate[])[]): CompletionCandidate[] {
+    const nonEmpty = lists.filter((list) => list.length > 0);
+    if (nonEmpty.length === 0) {
+        return [];
+    }
+    if (nonEmpty.length === 1) {
+        return nonEmpty[0].slice();
+    }
+
+    const merged: CompletionCandidate[] = [];
+    const cursors = nonEmpty.map(() => 0);
+    for (;;) {
+        let best = -1;
+        for (let listIndex = 0; listIndex < nonEmpty.length; listIndex++) {
+            const candidate = nonEmpty[listIndex][cursors[listIndex]];
+            if (candidate === undefined) {
+                continue;
+            }
+            if (best === -1 || compareCompletionCandidates(candidate, nonEmpty[best][cursors[best]]) < 0) {
+                best = listIndex;
+            }
+        }
+
+        if (best === -1) {
+            return merged;
+        }
+
+        merged.push(nonEmpty[best][cursors[best]]);
+        cursors[best]++;
+    }
+}
+
+function compareCodeUnits(left: string, right: string): number {
+    if (left === right) {
+        return 0;
+    }
+
+    return left < right ? -1 : 1;
+}
@@ -16,11 +16,17 @@ import {
     CompletionQueryResult,
     DocumentSemanticSnapshot,
     FileGlobalSummary,
+    FileSymbolRecord,
     FunctionSummary,
     TypeDefinitionSummary
 } from './types';
 import { CompletionContextAnalyzer } from './completionContextAnalyzer';
 import { CompletionRequestTrace } from './completionInstrumentation';
+import {
+    compareCompletionCandidates,
+    CompletionCandidateIndex,
+    mergeCompletionCandidates
+} from './completionCandidateIndex';
 
 type SnapshotProvider = {
     getSnapshot(document: vscode.TextDocument, useCache?: boolean): DocumentSemanticSnapshot;
@@ -33,6 +39,34 @@ type EfunProvider = {
     getAllSimulatedFunctions(document: vscode.TextDocument): string[];
 };
 
+type InheritedSymbols = ReturnType<ProjectSymbolIndex['getInheritedSymbols']>;
+
+interface StaticCandidateLayer {
+    readonly efuns: readonly string[];
+    readonly simulatedEfuns: readonly string[];
+    readonly index: CompletionCandidateIndex;
+}
+
+interface DependencyCandidateLayer {
+    readonly records: readonly (FileSymbolRecord | undefined)[];
+    readonly typeDefinitions: readonly TypeDefinitionSummary[];
+    readonly index: CompletionCandidateIndex;
+}
+
+/**
+ * 上一次标识符补全的完整（未截断）结果。同一位置继续输入时，
+ * 新结果是它的子集，直接在其上过滤即可。
+ */
+interface IdentifierQueryMemo {
+    readonly uri: string;
+    readonly line: number;
+    readonly wordStart: number;
+    readonly normalizedWord: string;
+    readonly symbolTable: DocumentSemanticSnapshot['symbolTable'];
+    readonly layers: readonly CompletionCandidateIndex[];
+    readonly candidates: readonly CompletionCandidate[];
+}
+
 export interface CompletionQueryEngineOptions {
     snapshotProvider: SnapshotProvider;
     projectSymbolIndex: ProjectSymbolIndex;
@@ -49,6 +83,10 @@ const COMMON_OBJECT_METHODS = [
     { name: 'delete', snippet: 'delete(${1:prop})', detail: '????' }
 ];
 
+/** 单次返回的候选上限；超出时标记 `isIncomplete`，由客户端在继续输入时重新请求 */
+export const MAX_COMPLETION_RESULTS = 1000;
+const MAX_DEPENDENCY_LAYERS = 32;
+
 export class CompletionQueryEngine {
     private readonly snapshotProvider: SnapshotProvider;
     private readonly projectSymbolIndex: ProjectSymbolIndex;
@@ -56,6 +94,11 @@ export class CompletionQueryEngine {
     private readonly efunProvider?: EfunProvider;
     private readonly builtinTypes: string[];
     private readonly keywords: string[];
+    private readonly objectMethodCandidates: readonly CompletionCandidate[];
+    private staticLayer: StaticCandidateLayer | undefined;
+    /** 按文档 URI 缓存的继承/包含层，Map 顺序即最近使用顺序 */
+    private readonly dependencyLayers = new Map<string, DependencyCandidateLayer>();
+    private lastIdentifierQuery: IdentifierQueryMemo | undefined;
 
     constructor(options: CompletionQueryEngineOptions) {
         this.snapshotProvider = options.snapshotProvider;
@@ -64,6 +107,17 @@ export class CompletionQueryEngine {
         this.efunProvider = options.efunProvider;
         this.builtinTypes = options.builtinTypes || [...LPC_BUILTIN_TYPES];
         this.keywords = options.keywords || [...LPC_COMPLETION_KEYWORDS];
+        this.objectMethodCandidates = Object.freeze(COMMON_OBJECT_METHODS.map((method): CompletionCandidate => ({
+            key: `object-method:${method.name}`,
+            label: method.name,
+            kind: vscode.CompletionItemKind.Method,
+            detail: method.detail,
+            insertText: method.snippet,
+            sortGroup: 'builtin',
+            metadata: {
+                sourceType: 'keyword'
+            }
+        })));
     }
 
     public query(
@@ -103,31 +157,49 @@ export class CompletionQueryEngine {
             return this.emptyResult(analyzedContext);
         }
 
-        const candidates = trace
+        const matches = trace
             ? trace.measure('candidate-build', () => {
-                const rawCandidates = this.buildCandidates(document, snapshot, position, analyzedContext, inheritedSymbols.functions, inheritedSymbols.types);
-                const filteredCandidates = this.filterAndSortCandidates(rawCandidates, analyzedContext.currentWord);
+                const filteredCandidates = this.collectCandidates(document, snapshot, position, analyzedContext, inheritedSymbols);
                 trace.recordStage('candidate-build', 0, { candidateCount: filteredCandidates.length });
                 return filteredCandidates;
             })
-            : this.filterAndSortCandidates(
-                this.buildCandidates(document, snapshot, position, analyzedContext, inheritedSymbols.functions, inheritedSymbols.types),
-                analyzedContext.currentWord
-            );
+            : this.collectCandidates(document, snapshot, position, analyzedContext, inheritedSymbols);
+        const isIncomplete = matches.length > MAX_COMPLETION_RESULTS;
 
         return {
             context: analyzedContext,
-            candidates,
-            isIncomplete: false
+            candidates: isIncomplete ? matches.slice(0, MAX_COMPLETION_RESULTS) : matches.slice(),
+            isIncomplete
         };
     }
 
-    private buildCandidates(
+    private collectCandidates(
         document: vscode.TextDocument,
         snapshot: DocumentSemanticSnapshot,
         position: vscode.Position,
         context: CompletionQueryContext,
-        inheritedFunctions: FunctionSummary[],
+        inheritedSymbols: InheritedSymbols
+    ): readonly CompletionCandidate[] {
+        switch (context.kind) {
+            case 'member':
+            case 'preprocessor':
+            case 'inherit-path':
+            case 'include-path':
+            case 'type-position':
+                return this.filterAndSortCandidates(
+                    this.buildCandidates(snapshot, position, context, inheritedSymbols.types),
+                    context.currentWord
+                );
+            case 'identifier':
+            default:
+                return this.queryIdentifierCandidates(document, snapshot, position, context.currentWord, inheritedSymbols);
+        }
+    }
+
+    private buildCandidates(
+        snapshot: DocumentSemanticSnapshot,
+        position: vscode.Position,
+        context: CompletionQueryContext,
         inheritedTypes: TypeDefinitionSummary[]
     ): CompletionCandidate[] {
         const includedSymbols = this.projectSymbolIndex.getIncludedSymbols(snapshot.uri);
@@ -141,35 +213,123 @@ export class CompletionQueryEngine {
             case 'include-path':
                 return this.queryPathCandidates(snapshot, 'include-path');
             case 'type-position':
-                return this.queryTypeCandidates(snapshot, [...includedSymbols.types, ...inheritedTypes]);
-            case 'identifier':
             default:
-                return this.queryIdentifierCandidates(
-                    snapshot,
-                    position,
-                    includedSymbols.functions,
-                    includedSymbols.fileGlobals,
-                    inheritedFunctions,
-                    [...includedSymbols.types, ...inheritedTypes],
-                    document
-                );
+                return this.queryTypeCandidates(snapshot, [...includedSymbols.types, ...inheritedTypes]);
         }
     }
+
+    /**
+     * 标识符补全分三层查询：当前作用域符号随请求构建；继承与包含的符号、
+     * 内置类型/关键字/efun 各自预建索引，只在依赖变化时重建。
+     * 同一位置继续输入时复用上一次的结果逐步收窄。
+     */
     private queryIdentifierCandidates(
+        document: vscode.TextDocument,
         snapshot: DocumentSemanticSnapshot,
         position: vscode.Position,
+        currentWord: string,
+        inheritedSymbols: InheritedSymbols
+    ): readonly CompletionCandidate[] {
+        const layers = [
+            this.getDependencyLayer(snapshot, inheritedSymbols),
+            this.getStaticLayer(document)
+        ];
+        const normalizedWord = currentWord.toLowerCase();
+        const wordStart = position.character - currentWord.length;
+        const previous = this.lastIdentifierQuery;
+
+        if (
+            previous
+            && previous.uri === snapshot.uri
+            && previous.line === position.line
+            && previous.wordStart === wordStart
+            && previous.symbolTable === snapshot.symbolTable
+            && normalizedWord.startsWith(previous.normalizedWord)
+            && previous.layers.every((layer, index) => layer === layers[index])
+        ) {
+            const candidates = normalizedWord === previous.normalizedWord
+                ? previous.candidates
+                : previous.candidates.filter((candidate) => candidate.label.toLowerCase().startsWith(normalizedWord));
+            this.lastIdentifierQuery = { ...previous, normalizedWord, candidates };
+            return candidates;
+        }
+
+        const scopeLayer = new CompletionCandidateIndex(
+            snapshot.symbolTable.getSymbolsInScope(position).map((symbol) => this.createSymbolCandidate(symbol))
+        );
+        const candidates = mergeCompletionCandidates([scopeLayer, ...layers].map((layer) => layer.query(currentWord)));
+        this.lastIdentifierQuery = {
+            uri: snapshot.uri,
+            line: position.line,
+            wordStart,
+            normalizedWord,
+            symbolTable: snapshot.symbolTable,
+            layers,
+            candidates
+        };
+        return candidates;
+    }
+
+    private getDependencyLayer(snapshot: DocumentSemanticSnapshot, inheritedSymbols: InheritedSymbols): CompletionCandidateIndex {
+        const records = this.projectSymbolIndex.getDependencyRecords(snapshot.uri);
+        const cached = this.dependencyLayers.get(snapshot.uri);
+        this.dependencyLayers.delete(snapshot.uri);
+
+        if (
+            cached
+            && cached.typeDefinitions === snapshot.typeDefinitions
+            && cached.records.length === records.length
+            && cached.records.every((record, index) => record === records[index])
+        ) {
+            this.dependencyLayers.set(snapshot.uri, cached);
+            return cached.index;
+        }
+
+        const includedSymbols = this.projectSymbolIndex.getIncludedSymbols(snapshot.uri);
+        const layer: DependencyCandidateLayer = {
+            records,
+            typeDefinitions: snapshot.typeDefinitions,
+            index: new CompletionCandidateIndex(this.createDependencyCandidates(
+                snapshot,
+                includedSymbols.functions,
+                includedSymbols.fileGlobals,
+                inheritedSymbols.functions,
+                [...includedSymbols.types, ...inheritedSymbols.types]
+            ))
+        };
+
+        this.dependencyLayers.set(snapshot.uri, layer);
+        while (this.dependencyLayers.size > MAX_DEPENDENCY_LAYERS) {
+            this.dependencyLayers.delete(this.dependencyLayers.keys().next().value as string);
+        }
+
+        return layer.index;
+    }
+
+    private getStaticLayer(document: vscode.TextDocument): CompletionCandidateIndex {
+        const efuns = this.efunProvider?.getAllFunctions() || [];
+        const simulatedEfuns = this.efunProvider?.getAllSimulatedFunctions(document) || [];
+        const cached = this.staticLayer;
+        if (cached && sameNames(cached.efuns, efuns) && sameNames(cached.simulatedEfuns, simulatedEfuns)) {
+            return cached.index;
+        }
+
+        this.staticLayer = {
+            efuns,
+            simulatedEfuns,
+            index: new CompletionCandidateIndex(this.createStaticCandidates(efuns, simulatedEfuns))
+        };
+        return this.staticLayer.index;
+    }
+
+    private createDependencyCandidates(
+        snapshot: DocumentSemanticSnapshot,
         includedFunctions: FunctionSummary[],
         includedGlobals: FileGlobalSummary[],
         inheritedFunctions: FunctionSummary[],
-        inheritedTypes: TypeDefinitionSummary[],
-        document: vscode.TextDocument
+        inheritedTypes: TypeDefinitionSummary[]
     ): CompletionCandidate[] {
         const candidates: CompletionCandidate[] = [];
-        const symbols = snapshot.symbolTable.getSymbolsInScope(position);
-
-        for (const symbol of symbols) {
-            candidates.push(this.createSymbolCandidate(symbol));
-        }
 
         for (const func of includedFunctions) {
             candidates.push({
@@ -232,6 +392,12 @@ export class CompletionQueryEngine {
             });
         }
 
+        return candidates;
+    }
+
+    private createStaticCandidates(efuns: readonly string[], simulatedEfuns: readonly string[]): CompletionCandidate[] {
+        const candidates: CompletionCandidate[] = [];
+
         for (const typeName of this.builtinTypes) {
             candidates.push({
                 key: `builtin-type:${typeName}`,
@@ -262,10 +428,9 @@ export class CompletionQueryEngine {
             });
         }
 
-        const simulatedEfuns = this.efunProvider?.getAllSimulatedFunctions(document) || [];
         const simulatedEfunNames = new Set(simulatedEfuns);
 
-        for (const efun of this.efunProvider?.getAllFunctions() || []) {
+        for (const efun of efuns) {
             if (simulatedEfunNames.has(efun)) {
                 continue;
             }
@@ -335,7 +500,7 @@ export class CompletionQueryEngine {
         }
 
         if (this.shouldIncludeObjectMethods(context, receiverType)) {
-            candidates.push(...this.createObjectMethodCandidates());
+            candidates.push(...this.objectMethodCandidates);
         }
 
         return candidates;
@@ -536,20 +701,6 @@ export class CompletionQueryEngine {
             || /\[[^\]]+\]$/.test(normalizedExpression);
     }
 
-    private createObjectMethodCandidates(): CompletionCandidate[] {
-        return COMMON_OBJECT_METHODS.map(method => ({
-            key: `object-method:${method.name}`,
-            label: method.name,
-            kind: vscode.CompletionItemKind.Method,
-            detail: method.detail,
-            insertText: method.snippet,
-            sortGroup: 'builtin',
-            metadata: {
-                sourceType: 'keyword'
-            }
-        }));
-    }
-
     private filterAndSortCandidates(candidates: CompletionCandidate[], currentWord: string): CompletionCandidate[] {
         const deduped = new Map<string, CompletionCandidate>();
         const normalizedPrefix = currentWord.toLowerCase();
@@ -564,25 +715,7 @@ export class CompletionQueryEngine {
             }
         }
 
-        return Array.from(deduped.values()).sort((left, right) => {
-            const sortGroupOrder = this.getSortGroupOrder(left.sortGroup) - this.getSortGroupOrder(right.sortGroup);
-            if (sortGroupOrder !== 0) {
-                return sortGroupOrder;
-            }
-
-            return left.label.localeCompare(right.label);
-        });
-    }
-
-    private getSortGroupOrder(group: CompletionCandidate['sortGroup']): number {
-        switch (group) {
-            case 'scope': return 0;
-            case 'type-member': return 1;
-            case 'inherited': return 2;
-            case 'keyword': return 3;
-            case 'builtin': return 4;
-            default: return 9;
-        }
+        return Array.from(deduped.values()).sort(compareCompletionCandidates);
     }
 
     private toCompletionKind(symbolType: SymbolType): vscode.CompletionItemKind {
@@ -606,3 +739,7 @@ export class CompletionQueryEngine {
         };
     }
 }
+
+function sameNames(left: readonly string[], right: readonly string[]): boolean {
+    return left === right || (left.length === right.length && left.every((name, index) => name === right[index]));
+}
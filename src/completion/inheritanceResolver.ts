@@ -1,6 +1,6 @@
-import * as fs from 'fs';
 import * as path from 'path';
 import * as vscode from 'vscode';
+import { getGlobalVirtualFileSystem, VirtualFileSystem } from '../core/VirtualFileSystem';
 import type { MacroDefinitionSummary } from '../semantic/documentSemanticTypes';
 import { SemanticSnapshot } from '../semantic/semanticSnapshot';
 import { ResolvedInheritTarget } from './types';
@@ -15,10 +15,12 @@ type InheritanceSnapshot = Pick<SemanticSnapshot, 'uri' | 'inheritStatements'> &
 
 export class InheritanceResolver {
     private readonly workspaceRoots?: string[];
+    private readonly fileSystem: VirtualFileSystem;
     private indexView?: InheritanceIndexView;
 
-    constructor(workspaceRoots?: string[]) {
+    constructor(workspaceRoots?: string[], fileSystem: VirtualFileSystem = getGlobalVirtualFileSystem()) {
         this.workspaceRoots = workspaceRoots;
+        this.fileSystem = fileSystem;
     }
 
     public attachIndex(indexView: InheritanceIndexView): void {
@@ -93,7 +95,7 @@ export class InheritanceResolver {
 
         }
 
-        return Array.from(candidates).find(candidate => fs.existsSync(candidate));
+        return this.fileSystem.findFirstExisting(candidates);
     }
 
     private resolveDirectiveValue(
@@ -1,6 +1,6 @@
 import * as vscode from 'vscode';
 import { getTypeLookupName } from '../ast/typeNormalization';
-import { SemanticSnapshot } from '../semantic/semanticSnapshot';
+import { freezeSemanticData, SemanticSnapshot } from '../semantic/semanticSnapshot';
 import {
     FileSymbolRecord,
     FileGlobalSummary,
@@ -29,19 +29,43 @@ type ProjectSemanticSnapshot = Pick<
     | 'createdAt'
 > & Pick<Partial<SemanticSnapshot>, 'degraded'>;
 
+interface MemoizedSymbolSet<T> {
+    generation: number;
+    value: T;
+}
+
+const MAX_NORMALIZED_URI_KEYS = 50000;
+
 export class ProjectSymbolIndex implements InheritanceIndexView {
     private readonly inheritanceResolver: InheritanceResolver;
     private readonly records = new Map<string, FileSymbolRecord>();
     private readonly resolvedTargets = new Map<string, ResolvedInheritTarget[]>();
     private readonly normalizedRecordKeys = new Map<string, string>();
     private readonly normalizedResolvedTargetKeys = new Map<string, string>();
-    private readonly typeLookup = new Map<string, TypeDefinitionSummary[]>();
+    // lookup name -> record key -> definitions, in indexing order
+    private readonly typeLookup = new Map<string, Map<string, TypeDefinitionSummary[]>>();
+    // Reverse edges keyed by normalized target URI: the record keys that inherit or include it.
+    private readonly inheritorsByTarget = new Map<string, Set<string>>();
+    private readonly includersByTarget = new Map<string, Set<string>>();
+    private readonly generations = new Map<string, number>();
+    private readonly inheritedSetCache = new Map<string, MemoizedSymbolSet<InheritedSymbolSet>>();
+    private readonly includedSetCache = new Map<string, MemoizedSymbolSet<IncludedSymbolSet>>();
+    private readonly normalizedUriKeys = new Map<string, string>();
+    private recordRevision = 0;
 
     constructor(inheritanceResolver: InheritanceResolver) {
         this.inheritanceResolver = inheritanceResolver;
         this.inheritanceResolver.attachIndex(this);
     }
 
+    /**
+     * Bumped whenever a record is stored, replaced or dropped. Derived indexes compare it to skip
+     * re-reading `getAllRecords()` when nothing changed.
+     */
+    public get revision(): number {
+        return this.recordRevision;
+    }
+
     public updateFromSemanticSnapshot(snapshot: ProjectSemanticSnapshot): void {
         if (snapshot.degraded) {
             return;
@@ -53,6 +77,15 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
         }
 
         const resolvedTargets = this.inheritanceResolver.resolveInheritTargets(snapshot);
+        if (
+            existingRecord
+            && isSameIndexedSnapshot(existingRecord, snapshot)
+            && sameResolvedTargets(this.resolvedTargets.get(snapshot.uri), resolvedTargets)
+        ) {
+            // Re-indexing the same frozen snapshot: keep the record so identity-keyed caches stay valid.
+            return;
+        }
+
         const resolvedUriByValue = new Map<string, ResolvedInheritTarget>();
 
         for (const target of resolvedTargets) {
@@ -60,19 +93,15 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
         }
 
         this.removeNormalizedRecordCollision(snapshot.uri);
-        this.records.set(snapshot.uri, {
+        this.linkInheritTargets(snapshot.uri, false);
+        this.linkIncludes(snapshot.uri, false);
+        this.records.set(snapshot.uri, freezeSemanticData({
             uri: snapshot.uri,
             version: snapshot.version,
-            exportedFunctions: snapshot.exportedFunctions.map(func => cloneFunctionSummary(func)),
-            symbols: snapshot.symbols?.map(symbol => ({ ...symbol })),
-            typeDefinitions: snapshot.typeDefinitions.map(type => ({
-                ...type,
-                members: type.members.map(member => ({
-                    ...member,
-                    parameters: member.parameters?.map(parameter => ({ ...parameter }))
-                }))
-            })),
-            fileGlobals: (snapshot.fileGlobals || []).map(summary => cloneFileGlobalSummary(summary)),
+            exportedFunctions: adoptSummaries(snapshot.exportedFunctions, cloneFunctionSummary),
+            symbols: snapshot.symbols && adoptSummaries(snapshot.symbols, summary => ({ ...summary })),
+            typeDefinitions: adoptSummaries(snapshot.typeDefinitions, cloneTypeDefinitionSummary),
+            fileGlobals: adoptSummaries(snapshot.fileGlobals || [], summary => ({ ...summary })),
             inheritStatements: snapshot.inheritStatements.map(statement => {
                 const target = resolvedUriByValue.get(`${statement.expressionKind}:${statement.value}`);
 
@@ -82,16 +111,19 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
                     isResolved: target?.isResolved ?? statement.isResolved
                 };
             }),
-            includeStatements: snapshot.includeStatements.map(statement => ({ ...statement })),
-            macroDefinitions: snapshot.macroDefinitions?.map(definition => cloneMacroDefinitionSummary(definition)),
-            macroReferences: snapshot.macroReferences.map(reference => ({ ...reference })),
+            includeStatements: adoptSummaries(snapshot.includeStatements, statement => ({ ...statement })),
+            macroDefinitions: snapshot.macroDefinitions && adoptSummaries(snapshot.macroDefinitions, cloneMacroDefinitionSummary),
+            macroReferences: adoptSummaries(snapshot.macroReferences, reference => ({ ...reference })),
             updatedAt: snapshot.createdAt
-        });
+        }));
 
         this.resolvedTargets.set(snapshot.uri, resolvedTargets.map(target => ({ ...target })));
-        this.normalizedRecordKeys.set(normalizeUriKey(snapshot.uri), snapshot.uri);
-        this.normalizedResolvedTargetKeys.set(normalizeUriKey(snapshot.uri), snapshot.uri);
-        this.rebuildTypeLookup();
+        this.normalizedRecordKeys.set(this.normalizeKey(snapshot.uri), snapshot.uri);
+        this.normalizedResolvedTargetKeys.set(this.normalizeKey(snapshot.uri), snapshot.uri);
+        this.linkInheritTargets(snapshot.uri, true);
+        this.linkIncludes(snapshot.uri, true);
+        this.replaceTypeDefinitions(snapshot.uri, existingRecord?.typeDefinitions, this.records.get(snapshot.uri)?.typeDefinitions);
+        this.markChanged(snapshot.uri);
     }
 
     public updateFromSnapshot(snapshot: ProjectSemanticSnapshot): void {
@@ -101,16 +133,85 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
     public removeFile(uri: string): void {
         const recordKey = this.findRecordKey(uri);
         if (recordKey) {
+            this.linkIncludes(recordKey, false);
+            this.replaceTypeDefinitions(recordKey, this.records.get(recordKey)?.typeDefinitions, undefined);
             this.records.delete(recordKey);
-            this.normalizedRecordKeys.delete(normalizeUriKey(recordKey));
+            this.normalizedRecordKeys.delete(this.normalizeKey(recordKey));
         }
 
         const targetKey = this.findResolvedTargetKey(uri);
         if (targetKey) {
+            this.linkInheritTargets(targetKey, false);
             this.resolvedTargets.delete(targetKey);
-            this.normalizedResolvedTargetKeys.delete(normalizeUriKey(targetKey));
+            this.normalizedResolvedTargetKeys.delete(this.normalizeKey(targetKey));
+        }
+
+        if (recordKey || targetKey) {
+            this.markChanged(uri);
+        }
+    }
+
+    /**
+     * Re-resolve a stored record's inherit targets without re-summarizing the file.
+     * Used when a file appears or disappears on disk and only the derived links change.
+     */
+    public refreshInheritTargets(uri: string): boolean {
+        const recordKey = this.findRecordKey(uri);
+        const record = recordKey ? this.records.get(recordKey) : undefined;
+        if (!recordKey || !record) {
+            return false;
+        }
+
+        const resolvedTargets = this.inheritanceResolver.resolveInheritTargets(record);
+        const resolvedUriByValue = new Map<string, ResolvedInheritTarget>();
+        for (const target of resolvedTargets) {
+            resolvedUriByValue.set(`${target.expressionKind}:${target.rawValue}`, target);
+        }
+
+        this.linkInheritTargets(recordKey, false);
+        this.records.set(recordKey, freezeSemanticData({
+            ...record,
+            inheritStatements: record.inheritStatements.map(statement => {
+                const target = resolvedUriByValue.get(`${statement.expressionKind}:${statement.value}`);
+
+                return {
+                    ...statement,
+                    resolvedUri: target?.resolvedUri,
+                    isResolved: target?.isResolved ?? false
+                };
+            })
+        }));
+        this.resolvedTargets.set(recordKey, resolvedTargets.map(target => ({ ...target })));
+        this.normalizedResolvedTargetKeys.set(this.normalizeKey(recordKey), recordKey);
+        this.linkInheritTargets(recordKey, true);
+        this.markChanged(recordKey);
+        return true;
+    }
+
+    /**
+     * Records whose resolved inherit targets point at the given file.
+     */
+    public getInheritingUris(targetUri: string): string[] {
+        return Array.from(this.inheritorsByTarget.get(this.normalizeKey(targetUri)) ?? []);
+    }
+
+    /**
+     * Records that still carry unresolved inherit targets or include directives.
+     */
+    public getRecordsWithUnresolvedLinks(): FileSymbolRecord[] {
+        const records: FileSymbolRecord[] = [];
+
+        for (const record of this.records.values()) {
+            const targets = this.resolvedTargets.get(record.uri) || [];
+            if (
+                targets.some(target => !target.isResolved)
+                || record.includeStatements.some(statement => !statement.resolvedUri)
+            ) {
+                records.push(record);
+            }
         }
-        this.rebuildTypeLookup();
+
+        return records;
     }
 
     public clear(): void {
@@ -119,24 +220,25 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
         this.normalizedRecordKeys.clear();
         this.normalizedResolvedTargetKeys.clear();
         this.typeLookup.clear();
+        this.inheritorsByTarget.clear();
+        this.includersByTarget.clear();
+        this.generations.clear();
+        this.inheritedSetCache.clear();
+        this.includedSetCache.clear();
+        this.recordRevision += 1;
     }
 
     public getRecord(uri: string): FileSymbolRecord | undefined {
-        const record = this.records.get(this.findRecordKey(uri) ?? uri);
-        return record ? cloneFileSymbolRecord(record) : undefined;
+        return this.records.get(this.findRecordKey(uri) ?? uri);
     }
 
     public getOwnersIncluding(includeUri: string): FileSymbolRecord[] {
-        const normalizedIncludeUri = normalizeUriKey(includeUri);
         const owners: FileSymbolRecord[] = [];
 
-        for (const record of this.records.values()) {
-            if (
-                record.includeStatements.some((statement) =>
-                    statement.resolvedUri && normalizeUriKey(statement.resolvedUri) === normalizedIncludeUri
-                )
-            ) {
-                owners.push(cloneFileSymbolRecord(record));
+        for (const ownerKey of this.includersByTarget.get(this.normalizeKey(includeUri)) ?? []) {
+            const record = this.records.get(ownerKey);
+            if (record) {
+                owners.push(record);
             }
         }
 
@@ -147,7 +249,82 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
         return this.resolvedTargets.get(this.findResolvedTargetKey(uri) ?? uri)?.map(target => ({ ...target })) || [];
     }
 
+    /**
+     * 返回 `getInheritedSymbols` 与 `getIncludedSymbols` 为该文件读取的全部记录，文件自身的记录在首位。
+     * 记录在每次变更时整体替换，调用方可按引用比对判断派生数据是否仍然有效；缺失的记录以 `undefined` 占位。
+     */
+    public getDependencyRecords(uri: string): (FileSymbolRecord | undefined)[] {
+        const ownRecord = this.records.get(uri);
+        const dependencies: (FileSymbolRecord | undefined)[] = [ownRecord];
+        const visited = new Set<string>([uri]);
+
+        const traverse = (currentUri: string): void => {
+            for (const target of this.resolvedTargets.get(currentUri) || []) {
+                if (!target.isResolved || !target.resolvedUri || visited.has(target.resolvedUri)) {
+                    continue;
+                }
+
+                visited.add(target.resolvedUri);
+                const record = this.records.get(this.findRecordKey(target.resolvedUri) ?? target.resolvedUri);
+                dependencies.push(record);
+                if (record) {
+                    traverse(target.resolvedUri);
+                }
+            }
+        };
+
+        traverse(uri);
+
+        for (const includeStatement of ownRecord?.includeStatements || []) {
+            if (includeStatement.resolvedUri) {
+                dependencies.push(this.records.get(this.findRecordKey(includeStatement.resolvedUri) ?? includeStatement.resolvedUri));
+            }
+        }
+
+        return dependencies;
+    }
+
+    /**
+     * Flattened symbols of the whole inherit chain. The set is memoized per file and reused until
+     * the file or anything it inherits from changes; the returned set is frozen.
+     */
     public getInheritedSymbols(uri: string): InheritedSymbolSet {
+        const generation = this.getGeneration(uri);
+        const cached = this.inheritedSetCache.get(uri);
+        if (cached?.generation === generation) {
+            return cached.value;
+        }
+
+        const value = freezeSemanticData(this.collectInheritedSymbols(uri));
+        this.inheritedSetCache.set(uri, { generation, value });
+        return value;
+    }
+
+    /**
+     * Symbols of the directly included files, memoized like `getInheritedSymbols`.
+     */
+    public getIncludedSymbols(uri: string): IncludedSymbolSet {
+        const generation = this.getGeneration(uri);
+        const cached = this.includedSetCache.get(uri);
+        if (cached?.generation === generation) {
+            return cached.value;
+        }
+
+        const value = freezeSemanticData(this.collectIncludedSymbols(uri));
+        this.includedSetCache.set(uri, { generation, value });
+        return value;
+    }
+
+    public findType(typeName: string): TypeDefinitionSummary | undefined {
+        const definitionsByRecord = this.typeLookup.get(getTypeLookupName(typeName));
+        return definitionsByRecord?.values().next().value?.[0];
+    }
+
+    public getAllRecords(): FileSymbolRecord[] {
+        return Array.from(this.records.values());
+    }
+
+    private collectInheritedSymbols(uri: string): InheritedSymbolSet {
         const chain = this.inheritanceResolver.getInheritanceChain(uri);
         const functions: FunctionSummary[] = [];
         const types: TypeDefinitionSummary[] = [];
@@ -186,7 +363,7 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
                     }
 
                     seenFunctionKeys.add(key);
-                    functions.push({ ...cloneFunctionSummary(func), origin: 'inherited' });
+                    functions.push({ ...func, origin: 'inherited' });
                 }
 
                 for (const type of record.typeDefinitions) {
@@ -196,13 +373,7 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
                     }
 
                     seenTypeKeys.add(key);
-                    types.push({
-                        ...type,
-                        members: type.members.map(member => ({
-                            ...member,
-                            parameters: member.parameters?.map(parameter => ({ ...parameter }))
-                        }))
-                    });
+                    types.push(type);
                 }
 
                 for (const global of record.fileGlobals) {
@@ -212,7 +383,7 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
                     }
 
                     seenGlobalKeys.add(key);
-                    fileGlobals.push(cloneFileGlobalSummary(global));
+                    fileGlobals.push(global);
                 }
 
                 traverse(target.resolvedUri);
@@ -230,7 +401,7 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
         };
     }
 
-    public getIncludedSymbols(uri: string): IncludedSymbolSet {
+    private collectIncludedSymbols(uri: string): IncludedSymbolSet {
         const record = this.records.get(uri);
         const files: string[] = [];
         const functions: FunctionSummary[] = [];
@@ -258,36 +429,22 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
 
             files.push(includeStatement.resolvedUri);
             functions.push(...includeRecord.exportedFunctions.map((func) => ({
-                ...cloneFunctionSummary(func),
+                ...func,
                 origin: 'include' as const
             })));
-            types.push(...includeRecord.typeDefinitions.map((type) => ({
-                ...type,
-                members: type.members.map(member => ({
-                    ...member,
-                    parameters: member.parameters?.map(parameter => ({ ...parameter }))
-                }))
-            })));
-            fileGlobals.push(...includeRecord.fileGlobals.map((summary) => cloneFileGlobalSummary(summary)));
+            types.push(...includeRecord.typeDefinitions);
+            fileGlobals.push(...includeRecord.fileGlobals);
         }
 
         return { files, functions, types, fileGlobals, unresolvedIncludes };
     }
 
-    public findType(typeName: string): TypeDefinitionSummary | undefined {
-        return this.typeLookup.get(getTypeLookupName(typeName))?.[0];
-    }
-
-    public getAllRecords(): FileSymbolRecord[] {
-        return Array.from(this.records.values()).map(record => cloneFileSymbolRecord(record));
-    }
-
     private findRecordKey(uri: string): string | undefined {
         if (this.records.has(uri)) {
             return uri;
         }
 
-        return this.normalizedRecordKeys.get(normalizeUriKey(uri));
+        return this.normalizedRecordKeys.get(this.normalizeKey(uri));
     }
 
     private findResolvedTargetKey(uri: string): string | undefined {
@@ -295,48 +452,192 @@ export class ProjectSymbolIndex implements InheritanceIndexView {
             return uri;
         }
 
-        return this.normalizedResolvedTargetKeys.get(normalizeUriKey(uri));
+        return this.normalizedResolvedTargetKeys.get(this.normalizeKey(uri));
     }
 
     private removeNormalizedRecordCollision(uri: string): void {
-        const normalizedUri = normalizeUriKey(uri);
+        const normalizedUri = this.normalizeKey(uri);
         const previousRecordKey = this.normalizedRecordKeys.get(normalizedUri);
         if (previousRecordKey && previousRecordKey !== uri) {
+            this.linkIncludes(previousRecordKey, false);
+            this.replaceTypeDefinitions(previousRecordKey, this.records.get(previousRecordKey)?.typeDefinitions, undefined);
             this.records.delete(previousRecordKey);
             this.normalizedRecordKeys.delete(normalizedUri);
         }
 
         const previousTargetKey = this.normalizedResolvedTargetKeys.get(normalizedUri);
         if (previousTargetKey && previousTargetKey !== uri) {
+            this.linkInheritTargets(previousTargetKey, false);
             this.resolvedTargets.delete(previousTargetKey);
             this.normalizedResolvedTargetKeys.delete(normalizedUri);
         }
     }
 
-    private rebuildTypeLookup(): void {
-        this.typeLookup.clear();
+    private linkInheritTargets(ownerKey: string, link: boolean): void {
+        for (const target of this.resolvedTargets.get(ownerKey) || []) {
+            if (target.resolvedUri) {
+                updateReverseEdge(this.inheritorsByTarget, this.normalizeKey(target.resolvedUri), ownerKey, link);
+            }
+        }
+    }
 
-        for (const record of this.records.values()) {
-            for (const typeDefinition of record.typeDefinitions) {
-                const lookupName = getTypeLookupName(typeDefinition.name);
-                const existing = this.typeLookup.get(lookupName) || [];
-                existing.push({
-                    ...typeDefinition,
-                    members: typeDefinition.members.map(member => ({
-                        ...member,
-                        parameters: member.parameters?.map(parameter => ({ ...parameter }))
-                    }))
-                });
-                this.typeLookup.set(lookupName, existing);
+    private linkIncludes(ownerKey: string, link: boolean): void {
+        for (const statement of this.records.get(ownerKey)?.includeStatements || []) {
+            if (statement.resolvedUri) {
+                updateReverseEdge(this.includersByTarget, this.normalizeKey(statement.resolvedUri), ownerKey, link);
+            }
+        }
+    }
+
+    /**
+     * Bump the generation of a changed file and of every file whose memoized sets read it:
+     * inheritors transitively, includers one level (included sets are not transitive).
+     */
+    private markChanged(uri: string): void {
+        this.recordRevision += 1;
+        const pending = [this.normalizeKey(uri)];
+        const visited = new Set(pending);
+
+        for (let index = 0; index < pending.length; index += 1) {
+            const key = pending[index];
+            this.bumpGeneration(key);
+
+            for (const includerKey of this.includersByTarget.get(key) ?? []) {
+                this.bumpGeneration(this.normalizeKey(includerKey));
+            }
+
+            for (const inheritorKey of this.inheritorsByTarget.get(key) ?? []) {
+                const normalizedInheritor = this.normalizeKey(inheritorKey);
+                if (!visited.has(normalizedInheritor)) {
+                    visited.add(normalizedInheritor);
+                    pending.push(normalizedInheritor);
+                }
             }
         }
     }
+
+    private bumpGeneration(normalizedUri: string): void {
+        this.generations.set(normalizedUri, (this.generations.get(normalizedUri) ?? 0) + 1);
+    }
+
+    private getGeneration(uri: string): number {
+        return this.generations.get(this.normalizeKey(uri)) ?? 0;
+    }
+
+    /**
+     * Keep `typeLookup` in step with one record. Names the record keeps are updated in place so
+     * `findType` still prefers the earliest indexed definition.
+     */
+    private replaceTypeDefinitions(
+        recordKey: string,
+        previous: readonly TypeDefinitionSummary[] | undefined,
+        next: readonly TypeDefinitionSummary[] | undefined
+    ): void {
+        if (previous === next) {
+            return;
+        }
+
+        const nextByName = new Map<string, TypeDefinitionSummary[]>();
+        for (const typeDefinition of next || []) {
+            const lookupName = getTypeLookupName(typeDefinition.name);
+            const definitions = nextByName.get(lookupName) || [];
+            definitions.push(typeDefinition);
+            nextByName.set(lookupName, definitions);
+        }
+
+        for (const typeDefinition of previous || []) {
+            const lookupName = getTypeLookupName(typeDefinition.name);
+            const definitionsByRecord = this.typeLookup.get(lookupName);
+            if (nextByName.has(lookupName) || !definitionsByRecord) {
+                continue;
+            }
+
+            definitionsByRecord.delete(recordKey);
+            if (definitionsByRecord.size === 0) {
+                this.typeLookup.delete(lookupName);
+            }
+        }
+
+        for (const [lookupName, definitions] of nextByName) {
+            let definitionsByRecord = this.typeLookup.get(lookupName);
+            if (!definitionsByRecord) {
+                definitionsByRecord = new Map();
+                this.typeLookup.set(lookupName, definitionsByRecord);
+            }
+            definitionsByRecord.set(recordKey, definitions);
+        }
+    }
+
+    private normalizeKey(uri: string): string {
+        let key = this.normalizedUriKeys.get(uri);
+        if (key === undefined) {
+            if (this.normalizedUriKeys.size >= MAX_NORMALIZED_URI_KEYS) {
+                this.normalizedUriKeys.clear();
+            }
+            key = normalizeUriKey(uri);
+            this.normalizedUriKeys.set(uri, key);
+        }
+
+        return key;
+    }
 }
 
-function cloneFileGlobalSummary(summary: FileGlobalSummary): FileGlobalSummary {
-    return {
-        ...summary
-    };
+function updateReverseEdge(edges: Map<string, Set<string>>, targetKey: string, ownerKey: string, link: boolean): void {
+    let owners = edges.get(targetKey);
+    if (link) {
+        if (!owners) {
+            owners = new Set();
+            edges.set(targetKey, owners);
+        }
+        owners.add(ownerKey);
+        return;
+    }
+
+    owners?.delete(ownerKey);
+    if (owners?.size === 0) {
+        edges.delete(targetKey);
+    }
+}
+
+/**
+ * 记录是否正由该快照构建：冻结的摘要数组按引用采用，数组相同即为同一次分析结果。
+ */
+function isSameIndexedSnapshot(record: FileSymbolRecord, snapshot: ProjectSemanticSnapshot): boolean {
+    return record.version === snapshot.version
+        && record.updatedAt === snapshot.createdAt
+        && record.exportedFunctions === snapshot.exportedFunctions
+        && record.symbols === snapshot.symbols
+        && record.typeDefinitions === snapshot.typeDefinitions
+        && record.fileGlobals === snapshot.fileGlobals
+        && record.includeStatements === snapshot.includeStatements
+        && record.macroDefinitions === snapshot.macroDefinitions
+        && record.macroReferences === snapshot.macroReferences;
+}
+
+/**
+ * 两次解析得到的继承目标是否逐项一致；旧值缺失时视为不同。
+ */
+function sameResolvedTargets(
+    left: readonly ResolvedInheritTarget[] | undefined,
+    right: readonly ResolvedInheritTarget[]
+): boolean {
+    return left !== undefined
+        && left.length === right.length
+        && left.every((target, index) =>
+            target.rawValue === right[index].rawValue
+            && target.expressionKind === right[index].expressionKind
+            && target.sourceUri === right[index].sourceUri
+            && target.resolvedUri === right[index].resolvedUri
+            && target.isResolved === right[index].isResolved
+        );
+}
+
+/**
+ * 已冻结的摘要数组（来自语义快照服务）直接共享；其余输入拷贝一次后冻结，
+ * 避免调用方之后修改自己的对象影响索引。
+ */
+function adoptSummaries<T>(summaries: T[], clone: (summary: T) => T): T[] {
+    return Object.isFrozen(summaries) ? summaries : freezeSemanticData(summaries.map(summary => clone(summary)));
 }
 
 function cloneFunctionSummary(summary: FunctionSummary): FunctionSummary {
@@ -346,30 +647,20 @@ function cloneFunctionSummary(summary: FunctionSummary): FunctionSummary {
     };
 }
 
-function cloneMacroDefinitionSummary(summary: MacroDefinitionSummary): MacroDefinitionSummary {
+function cloneTypeDefinitionSummary(summary: TypeDefinitionSummary): TypeDefinitionSummary {
     return {
         ...summary,
-        parameters: summary.parameters ? [...summary.parameters] : undefined
+        members: summary.members.map(member => ({
+            ...member,
+            parameters: member.parameters?.map(parameter => ({ ...parameter }))
+        }))
     };
 }
 
-function cloneFileSymbolRecord(record: FileSymbolRecord): FileSymbolRecord {
+function cloneMacroDefinitionSummary(summary: MacroDefinitionSummary): MacroDefinitionSummary {
     return {
-        ...record,
-        exportedFunctions: record.exportedFunctions.map(func => cloneFunctionSummary(func)),
-        symbols: record.symbols?.map(symbol => ({ ...symbol })),
-        typeDefinitions: record.typeDefinitions.map(type => ({
-            ...type,
-            members: type.members.map(member => ({
-                ...member,
-                parameters: member.parameters?.map(parameter => ({ ...parameter }))
-            }))
-        })),
-        fileGlobals: record.fileGlobals.map(summary => cloneFileGlobalSummary(summary)),
-        inheritStatements: record.inheritStatements.map(statement => ({ ...statement })),
-        includeStatements: record.includeStatements.map(statement => ({ ...statement })),
-        macroDefinitions: record.macroDefinitions?.map(definition => cloneMacroDefinitionSummary(definition)),
-        macroReferences: record.macroReferences.map(reference => ({ ...reference }))
+        ...summary,
+        parameters: summary.parameters ? [...summary.parameters] : undefined
     };
 }
 
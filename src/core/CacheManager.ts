@@ -3,14 +3,17 @@
  * 提供类型安全、高性能的缓存解决方案
  *
  * 特性:
- * - LRU缓存策略
+ * - O(1) LRU缓存策略（侵入式双向链表）
+ * - 可选 TinyLFU 准入，避免一次性访问的条目冲掉热点条目
  * - TTL过期机制
- * - 内存限制
- * - 性能监控
+ * - 按字节计量的内存限制
+ * - 采样式性能监控
  * - 模式匹配失效
  */
 
-export interface CacheConfig {
+export type CacheAdmissionPolicy = 'lru' | 'tinylfu';
+
+export interface CacheConfig<T = unknown> {
     /** 最大缓存条目数 */
     maxSize: number;
     /** 最大内存使用（字节数），-1表示无限制 */
@@ -21,6 +24,14 @@ export interface CacheConfig {
     cleanupInterval: number;
     /** 是否启用性能监控 */
     enableMonitoring: boolean;
+    /** 准入策略：`lru` 总是接纳新条目；`tinylfu` 在缓存已满时只接纳访问频率高于淘汰候选的条目 */
+    admissionPolicy: CacheAdmissionPolicy;
+    /** 频率统计使用的键，例如把同一文档的不同版本归为一个频率键 */
+    frequencyKey?: (key: string) => string;
+    /** 调用方未显式给出大小时的字节数估算 */
+    sizeOf?: (value: T) => number;
+    /** 条目因删除、替换、过期或驱逐离开缓存时回调（`clear` 除外），供调用方维护二级索引 */
+    onDelete?: (key: string) => void;
 }
 
 export interface CacheEntry<T> {
@@ -29,7 +40,7 @@ export interface CacheEntry<T> {
     createdAt: number;
     lastAccessed: number;
     accessCount: number;
-    size: number; // 估算的内存大小
+    size: number; // 条目占用的字节数
 }
 
 export interface CacheStats {
@@ -45,115 +56,78 @@ export interface CacheStats {
     hitRate: number;
     /** 驱逐次数 */
     evictions: number;
-    /** 平均访问时间（毫秒） */
+    /** 平均访问时间（毫秒，采样） */
     avgAccessTime: number;
+    /** TinyLFU 拒绝准入的次数 */
+    admissionRejections: number;
 }
 
-/**
- * 驱逐策略接口
- */
-export interface EvictionStrategy<T> {
-    /**
-     * 判断条目是否应该被驱逐
-     */
-    shouldEvict(entry: CacheEntry<T>, totalSize: number, totalMemory: number): boolean;
-
-    /**
-     * 从候选条目中选择要驱逐的条目
-     */
-    selectVictim(entries: CacheEntry<T>[]): CacheEntry<T> | undefined;
-}
-
-/**
- * LRU驱逐策略
- */
-export class LRUEvictionStrategy<T> implements EvictionStrategy<T> {
-    constructor(private maxSize: number) {}
-
-    shouldEvict(entry: CacheEntry<T>, totalSize: number, totalMemory: number): boolean {
-        return totalSize > this.maxSize;
-    }
-
-    selectVictim(entries: CacheEntry<T>[]): CacheEntry<T> | undefined {
-        if (entries.length === 0) return undefined;
-
-        // 选择最久未访问的条目
-        return entries.reduce((oldest, current) =>
-            current.lastAccessed < oldest.lastAccessed ? current : oldest
-        );
-    }
+interface CacheNode<T> extends CacheEntry<T> {
+    prev: CacheNode<T> | undefined;
+    next: CacheNode<T> | undefined;
 }
 
-/**
- * TTL驱逐策略
- */
-export class TTLEvictionStrategy<T> implements EvictionStrategy<T> {
-    constructor(private ttl: number) {}
-
-    shouldEvict(entry: CacheEntry<T>, totalSize: number, totalMemory: number): boolean {
-        if (this.ttl <= 0) return false;
-        const now = Date.now();
-        return (now - entry.lastAccessed) > this.ttl;
-    }
-
-    selectVictim(entries: CacheEntry<T>[]): CacheEntry<T> | undefined {
-        const now = Date.now();
-        // 选择最早过期的条目
-        return entries
-            .filter(e => (now - e.lastAccessed) > this.ttl)
-            .reduce((oldest, current) =>
-                current.createdAt < oldest.createdAt ? current : oldest
-            , entries[0]);
-    }
-}
+/** 每 N 次访问采样一次耗时 */
+const ACCESS_TIME_SAMPLE_INTERVAL = 16;
+const ACCESS_TIME_SAMPLE_WINDOW = 256;
+const DEFAULT_ENTRY_SIZE = 1024;
 
 /**
- * 内存驱逐策略
+ * 近似频率统计（Count-Min Sketch，4 行 8 位计数器）。
+ * 累计增量达到阈值后所有计数减半，使频率随时间衰减。
  */
-export class MemoryEvictionStrategy<T> implements EvictionStrategy<T> {
-    constructor(private maxMemory: number) {}
-
-    shouldEvict(entry: CacheEntry<T>, totalSize: number, totalMemory: number): boolean {
-        return this.maxMemory > 0 && totalMemory > this.maxMemory;
+export class FrequencySketch {
+    private static readonly ROWS = 4;
+    private static readonly SEEDS = [0x9e3779b1, 0x85ebca6b, 0xc2b2ae35, 0x27d4eb2f];
+    private readonly counters: Uint8Array;
+    private readonly mask: number;
+    private readonly resetThreshold: number;
+    private additions = 0;
+
+    constructor(expectedEntries: number) {
+        const width = nextPowerOfTwo(Math.max(64, expectedEntries * 4));
+        this.counters = new Uint8Array(width * FrequencySketch.ROWS);
+        this.mask = width - 1;
+        this.resetThreshold = width * 10;
     }
 
-    selectVictim(entries: CacheEntry<T>[]): CacheEntry<T> | undefined {
-        if (entries.length === 0) return undefined;
-
-        // 选择最大且最久未访问的条目
-        return entries.reduce((largest, current) => {
-            if (current.size > largest.size) return current;
-            if (current.size === largest.size && current.lastAccessed < largest.lastAccessed) {
-                return current;
+    increment(key: string): void {
+        const hash = hashString(key);
+        const width = this.mask + 1;
+        for (let row = 0; row < FrequencySketch.ROWS; row++) {
+            const index = row * width + (mixHash(hash, FrequencySketch.SEEDS[row]) & this.mask);
+            if (this.counters[index] < 255) {
+                this.counters[index]++;
             }
-            return largest;
-        });
-    }
-}
+        }
 
-/**
- * 组合驱逐策略
- */
-export class CompositeEvictionStrategy<T> implements EvictionStrategy<T> {
-    private strategies: EvictionStrategy<T>[] = [];
+        this.additions++;
+        if (this.additions >= this.resetThreshold) {
+            this.halve();
+        }
+    }
 
-    addStrategy(strategy: EvictionStrategy<T>): this {
-        this.strategies.push(strategy);
-        return this;
+    frequency(key: string): number {
+        const hash = hashString(key);
+        const width = this.mask + 1;
+        let min = 255;
+        for (let row = 0; row < FrequencySketch.ROWS; row++) {
+            const index = row * width + (mixHash(hash, FrequencySketch.SEEDS[row]) & this.mask);
+            min = Math.min(min, this.counters[index]);
+        }
+        return min;
     }
 
-    shouldEvict(entry: CacheEntry<T>, totalSize: number, totalMemory: number): boolean {
-        // 任一策略认为应该驱逐，则驱逐
-        return this.strategies.some(s => s.shouldEvict(entry, totalSize, totalMemory));
+    clear(): void {
+        this.counters.fill(0);
+        this.additions = 0;
     }
 
-    selectVictim(entries: CacheEntry<T>[]): CacheEntry<T> | undefined {
-        // 按优先级依次尝试各策略
-        for (const strategy of this.strategies) {
-            const victim = strategy.selectVictim(entries);
-            if (victim) return victim;
+    private halve(): void {
+        for (let index = 0; index < this.counters.length; index++) {
+            this.counters[index] >>= 1;
         }
-        return undefined;
+        this.additions = Math.floor(this.additions / 2);
     }
 }
 
@@ -161,49 +135,41 @@ export class CompositeEvictionStrategy<T> implements EvictionStrategy<T> {
  * 通用缓存管理器
  */
 export class CacheManager<T> {
-    private cache = new Map<string, CacheEntry<T>>();
-    private strategy: EvictionStrategy<T>;
-    private config: CacheConfig;
-    private stats: CacheStats = {
-        size: 0,
-        memory: 0,
-        hits: 0,
-        misses: 0,
-        hitRate: 0,
-        evictions: 0,
-        avgAccessTime: 0
-    };
+    private cache = new Map<string, CacheNode<T>>();
+    /** 链表头是最近访问的条目，尾是最久未访问的条目 */
+    private head: CacheNode<T> | undefined;
+    private tail: CacheNode<T> | undefined;
+    private config: CacheConfig<T>;
+    private readonly sketch?: FrequencySketch;
+    private hits = 0;
+    private misses = 0;
+    private evictions = 0;
+    private admissionRejections = 0;
     private cleanupTimer: NodeJS.Timeout | null = null;
     private totalMemory = 0;
-    private accessTimes: number[] = [];
+    private accessCounter = 0;
+    private readonly accessTimes = new Float64Array(ACCESS_TIME_SAMPLE_WINDOW);
+    private accessTimeCount = 0;
+    private accessTimeCursor = 0;
+    private accessTimeSum = 0;
 
-    constructor(config: Partial<CacheConfig>) {
+    constructor(config: Partial<CacheConfig<T>>) {
         this.config = {
             maxSize: config.maxSize ?? 100,
             maxMemory: config.maxMemory ?? -1,
             ttl: config.ttl ?? -1,
             cleanupInterval: config.cleanupInterval ?? 60000,
-            enableMonitoring: config.enableMonitoring ?? true
+            enableMonitoring: config.enableMonitoring ?? true,
+            admissionPolicy: config.admissionPolicy ?? 'lru',
+            frequencyKey: config.frequencyKey,
+            sizeOf: config.sizeOf,
+            onDelete: config.onDelete
         };
 
-        // 构建组合驱逐策略
-        const composite = new CompositeEvictionStrategy<T>();
-
-        // 优先级1: TTL过期检查
-        if (this.config.ttl > 0) {
-            composite.addStrategy(new TTLEvictionStrategy<T>(this.config.ttl));
+        if (this.config.admissionPolicy === 'tinylfu') {
+            this.sketch = new FrequencySketch(this.config.maxSize);
         }
 
-        // 优先级2: 内存限制检查
-        if (this.config.maxMemory > 0) {
-            composite.addStrategy(new MemoryEvictionStrategy<T>(this.config.maxMemory));
-        }
-
-        // 优先级3: LRU检查
-        composite.addStrategy(new LRUEvictionStrategy<T>(this.config.maxSize));
-
-        this.strategy = composite;
-
         // 启动定期清理
         if (this.config.cleanupInterval > 0) {
             this.startCleanupTimer();
@@ -214,34 +180,33 @@ export class CacheManager<T> {
      * 获取缓存值
      */
     get(key: string): T | undefined {
-        const startTime = this.config.enableMonitoring ? performance.now() : 0;
+        const sampled = this.config.enableMonitoring
+            && (++this.accessCounter % ACCESS_TIME_SAMPLE_INTERVAL === 0);
+        const startTime = sampled ? performance.now() : 0;
 
+        this.recordFrequency(key);
         const entry = this.cache.get(key);
 
         if (!entry) {
-            this.stats.misses++;
-            this.updateStats();
+            this.misses++;
             return undefined;
         }
 
-        // 检查是否应该驱逐
-        if (this.strategy.shouldEvict(entry, this.cache.size, this.totalMemory)) {
+        const now = Date.now();
+        if (this.isExpired(entry, now)) {
             this.delete(key);
-            this.stats.misses++;
-            this.updateStats();
+            this.misses++;
             return undefined;
         }
 
-        // 更新访问信息
-        entry.lastAccessed = Date.now();
+        // 更新访问信息并移到链表头
+        entry.lastAccessed = now;
         entry.accessCount++;
+        this.moveToHead(entry);
+        this.hits++;
 
-        this.stats.hits++;
-        this.updateStats();
-
-        if (this.config.enableMonitoring) {
-            const accessTime = performance.now() - startTime;
-            this.recordAccessTime(accessTime);
+        if (sampled) {
+            this.recordAccessTime(performance.now() - startTime);
         }
 
         return entry.value;
@@ -251,36 +216,40 @@ export class CacheManager<T> {
      * 设置缓存值
      */
     set(key: string, value: T, size?: number): void {
-        const estimatedSize = size ?? this.estimateSize(value);
+        const entrySize = size ?? this.estimateSize(value);
         const now = Date.now();
 
-        // 如果键已存在，先删除旧值
-        if (this.cache.has(key)) {
-            this.delete(key);
+        // 如果键已存在，先删除旧值；替换已有条目不经过准入判断
+        const replacing = this.delete(key);
+        if (!replacing) {
+            this.recordFrequency(key);
         }
 
-        const entry: CacheEntry<T> = {
+        if (!replacing && this.sketch && this.wouldOverflow(entrySize) && !this.admit(key)) {
+            this.admissionRejections++;
+            return;
+        }
+
+        // 从链表尾依次驱逐，直到容纳新条目
+        while (this.tail && this.wouldOverflow(entrySize)) {
+            this.delete(this.tail.key);
+            this.evictions++;
+        }
+
+        const entry: CacheNode<T> = {
             key,
             value,
             createdAt: now,
             lastAccessed: now,
             accessCount: 0,
-            size: estimatedSize
+            size: entrySize,
+            prev: undefined,
+            next: undefined
         };
 
-        // 检查是否需要驱逐
-        while (this.strategy.shouldEvict(entry, this.cache.size + 1, this.totalMemory + estimatedSize)) {
-            const victim = this.strategy.selectVictim(Array.from(this.cache.values()));
-            if (!victim) break;
-
-            this.delete(victim.key);
-            this.stats.evictions++;
-        }
-
-        // 添加新条目
         this.cache.set(key, entry);
-        this.totalMemory += estimatedSize;
-        this.updateStats();
+        this.linkAtHead(entry);
+        this.totalMemory += entrySize;
     }
 
     /**
@@ -291,8 +260,9 @@ export class CacheManager<T> {
         if (!entry) return false;
 
         this.cache.delete(key);
+        this.unlink(entry);
         this.totalMemory -= entry.size;
-        this.updateStats();
+        this.config.onDelete?.(key);
 
         return true;
     }
@@ -302,8 +272,10 @@ export class CacheManager<T> {
      */
     clear(): void {
         this.cache.clear();
+        this.head = undefined;
+        this.tail = undefined;
         this.totalMemory = 0;
-        this.updateStats();
+        this.sketch?.clear();
     }
 
     /**
@@ -338,6 +310,20 @@ export class CacheManager<T> {
         return this.cache.has(key);
     }
 
+    /**
+     * 读取条目但不更新访问顺序与命中统计
+     */
+    peek(key: string): T | undefined {
+        return this.cache.get(key)?.value;
+    }
+
+    /**
+     * 最久未访问的条目（链表尾），供跨缓存的内存预算挑选驱逐对象
+     */
+    peekColdest(): Readonly<CacheEntry<T>> | undefined {
+        return this.tail;
+    }
+
     /**
      * 获取所有键
      */
@@ -346,46 +332,47 @@ export class CacheManager<T> {
     }
 
     /**
-     * 获取缓存统计信息
+     * 获取缓存统计信息（命中率与平均耗时在读取时计算）
      */
     getStats(): CacheStats {
-        return { ...this.stats };
+        const total = this.hits + this.misses;
+        return {
+            size: this.cache.size,
+            memory: this.totalMemory,
+            hits: this.hits,
+            misses: this.misses,
+            hitRate: total > 0 ? this.hits / total : 0,
+            evictions: this.evictions,
+            avgAccessTime: this.accessTimeCount > 0 ? this.accessTimeSum / this.accessTimeCount : 0,
+            admissionRejections: this.admissionRejections
+        };
     }
 
     /**
      * 重置统计信息
      */
     resetStats(): void {
-        this.stats = {
-            size: this.cache.size,
-            memory: this.totalMemory,
-            hits: 0,
-            misses: 0,
-            hitRate: 0,
-            evictions: 0,
-            avgAccessTime: 0
-        };
-        this.accessTimes = [];
+        this.hits = 0;
+        this.misses = 0;
+        this.evictions = 0;
+        this.admissionRejections = 0;
+        this.accessTimeCount = 0;
+        this.accessTimeCursor = 0;
+        this.accessTimeSum = 0;
     }
 
     /**
-     * 手动触发清理
+     * 手动触发清理：从最久未访问的一端移除过期条目，遇到未过期条目即停止
      */
     cleanup(): void {
-        const now = Date.now();
-        const keysToDelete: string[] = [];
-
-        // 转换为数组进行迭代
-        const entries = Array.from(this.cache.entries());
-        for (const [key, entry] of entries) {
-            if (this.strategy.shouldEvict(entry, this.cache.size, this.totalMemory)) {
-                keysToDelete.push(key);
-            }
+        if (this.config.ttl <= 0) {
+            return;
         }
 
-        for (const key of keysToDelete) {
-            this.delete(key);
-            this.stats.evictions++;
+        const now = Date.now();
+        while (this.tail && this.isExpired(this.tail, now)) {
+            this.delete(this.tail.key);
+            this.evictions++;
         }
     }
 
@@ -413,40 +400,139 @@ export class CacheManager<T> {
         }
     }
 
-    private updateStats(): void {
-        this.stats.size = this.cache.size;
-        this.stats.memory = this.totalMemory;
+    private isExpired(entry: CacheEntry<T>, now: number): boolean {
+        return this.config.ttl > 0 && (now - entry.lastAccessed) > this.config.ttl;
+    }
+
+    private wouldOverflow(entrySize: number): boolean {
+        if (this.cache.size + 1 > this.config.maxSize) {
+            return true;
+        }
 
-        const total = this.stats.hits + this.stats.misses;
-        this.stats.hitRate = total > 0 ? this.stats.hits / total : 0;
+        return this.config.maxMemory > 0
+            && this.cache.size > 0
+            && this.totalMemory + entrySize > this.config.maxMemory;
+    }
+
+    /**
+     * TinyLFU 准入：候选条目的访问频率必须高于即将被淘汰的条目
+     */
+    private admit(key: string): boolean {
+        if (!this.sketch || !this.tail) {
+            return true;
+        }
 
-        if (this.accessTimes.length > 0) {
-            const sum = this.accessTimes.reduce((a, b) => a + b, 0);
-            this.stats.avgAccessTime = sum / this.accessTimes.length;
+        const candidateKey = this.toFrequencyKey(key);
+        const victimKey = this.toFrequencyKey(this.tail.key);
+        if (candidateKey === victimKey) {
+            // 同一频率键的新版本总是替换旧版本
+            return true;
         }
+
+        return this.sketch.frequency(candidateKey) > this.sketch.frequency(victimKey);
     }
 
-    private recordAccessTime(time: number): void {
-        this.accessTimes.push(time);
+    private recordFrequency(key: string): void {
+        this.sketch?.increment(this.toFrequencyKey(key));
+    }
+
+    private toFrequencyKey(key: string): string {
+        return this.config.frequencyKey ? this.config.frequencyKey(key) : key;
+    }
 
-        // 只保留最近1000次访问的时间
-        if (this.accessTimes.length > 1000) {
-            this.accessTimes.shift();
+    private linkAtHead(entry: CacheNode<T>): void {
+        entry.prev = undefined;
+        entry.next = this.head;
+        if (this.head) {
+            this.head.prev = entry;
         }
+        this.head = entry;
+        if (!this.tail) {
+            this.tail = entry;
+        }
+    }
+
+    private unlink(entry: CacheNode<T>): void {
+        if (entry.prev) {
+            entry.prev.next = entry.next;
+        } else {
+            this.head = entry.next;
+        }
+
+        if (entry.next) {
+            entry.next.prev = entry.prev;
+        } else {
+            this.tail = entry.prev;
+        }
+
+        entry.prev = undefined;
+        entry.next = undefined;
+    }
+
+    private moveToHead(entry: CacheNode<T>): void {
+        if (this.head === entry) {
+            return;
+        }
+
+        this.unlink(entry);
+        this.linkAtHead(entry);
+    }
+
+    private recordAccessTime(time: number): void {
+        // 固定大小的环形窗口，增量维护总和
+        if (this.accessTimeCount === ACCESS_TIME_SAMPLE_WINDOW) {
+            this.accessTimeSum -= this.accessTimes[this.accessTimeCursor];
+        } else {
+            this.accessTimeCount++;
+        }
+
+        this.accessTimes[this.accessTimeCursor] = time;
+        this.accessTimeSum += time;
+        this.accessTimeCursor = (this.accessTimeCursor + 1) % ACCESS_TIME_SAMPLE_WINDOW;
     }
 
     /**
      * 估算对象大小（字节）
-     * 这是一个简化的实现，实际大小可能有差异
+     * 字符串与二进制数据按实际字节计；其他对象应由调用方通过 `size` 或 `sizeOf` 提供
      */
     private estimateSize(value: T): number {
-        try {
-            const json = JSON.stringify(value);
+        if (this.config.sizeOf) {
+            return this.config.sizeOf(value);
+        }
+
+        if (typeof value === 'string') {
             // UTF-16编码，每个字符2字节
-            return json.length * 2;
-        } catch {
-            // 无法序列化的对象，使用固定大小
-            return 1024;
+            return value.length * 2;
         }
+
+        if (ArrayBuffer.isView(value)) {
+            return value.byteLength;
+        }
+
+        return DEFAULT_ENTRY_SIZE;
+    }
+}
+
+function nextPowerOfTwo(value: number): number {
+    let result = 1;
+    while (result < value) {
+        result <<= 1;
     }
+    return result;
+}
+
+function hashString(value: string): number {
+    // FNV-1a
+    let hash = 0x811c9dc5;
+    for (let index = 0; index < value.length; index++) {
+        hash ^= value.charCodeAt(index);
+        hash = Math.imul(hash, 0x01000193);
+    }
+    return hash >>> 0;
+}
+
+function mixHash(hash: number, seed: number): number {
+    let mixed = Math.imul(hash ^ seed, 0x5bd1e995);
+    mixed ^= mixed >>> 15;
+    return mixed >>> 0;
 }
@@ -0,0 +1,204 @@
+/**
+ * 内容寻址的分析结果缓存
+ * 版本号缓存（`uri_v<version>`）在撤销/重做往返、无改动的保存与格式化、关闭后重新打开等场景下
+ * 会因版本号递增而失效，即使文本完全相同。本层以“文档 URI + 文本指纹”为键、按分析配置代次分区，
+ * 保留最近的若干分析结果；命中时再比对完整文本并执行调用方给出的依赖校验，
+ * 保证复用的结果与重新分析得到的一致。
+ * 条目按估算字节数计量，可向统一内存预算登记，旧版本与已关闭文档的结果同样受预算约束。
+ */
+
+import { MemoryBudgetGovernor, MemoryBudgetRegistration } from './MemoryBudgetGovernor';
+
+const DEFAULT_MAX_CONTENT_ENTRIES = 32;
+/** 内容层只是额外的复用副本，预算紧张时最先让出 */
+const CONTENT_REBUILD_COST = 1;
+
+let analysisConfigGeneration = 0;
+let lastHashedText: string | undefined;
+let lastHash = '';
+
+/**
+ * 当前分析配置代次。工作区配置同步等影响所有文档分析结果的事件发生后递增，
+ * 旧代次写入的内容条目随之作废。
+ */
+export function getAnalysisConfigGeneration(): number {
+    return analysisConfigGeneration;
+}
+
+export function advanceAnalysisConfigGeneration(): number {
+    analysisConfigGeneration += 1;
+    return analysisConfigGeneration;
+}
+
+/**
+ * FNV-1a 32 位文本指纹，附带长度降低碰撞概率。
+ * 同一段文本常被预处理、解析、语义三层连续查询，这里记住最近一次的结果。
+ */
+export function hashContent(text: string): string {
+    if (text === lastHashedText) {
+        return lastHash;
+    }
+
+    let hash = 0x811c9dc5;
+    for (let index = 0; index < text.length; index++) {
+        hash ^= text.charCodeAt(index);
+        hash = Math.imul(hash, 0x01000193);
+    }
+
+    lastHashedText = text;
+    lastHash = `${text.length.toString(36)}.${(hash >>> 0).toString(36)}`;
+    return lastHash;
+}
+
+interface ContentEntry<T> {
+    readonly uri: string;
+    readonly text: string;
+    readonly value: T;
+    readonly bytes: number;
+    lastAccessed: number;
+}
+
+export class ContentAddressedCache<T> {
+    /** Map 顺序即最近使用顺序 */
+    private readonly entries = new Map<string, ContentEntry<T>>();
+    private generation = analysisConfigGeneration;
+    private hits = 0;
+    private misses = 0;
+    private totalBytes = 0;
+    private memoryBudget?: MemoryBudgetRegistration;
+
+    /**
+     * @param sizeOf 条目的估算字节数；缺省只计文本本身（UTF-16）
+     */
+    constructor(
+        private readonly maxEntries: number = DEFAULT_MAX_CONTENT_ENTRIES,
+        private readonly sizeOf: (value: T, text: string) => number = (_value, text) => text.length * 2
+    ) {}
+
+    /**
+     * 查找同一文档、同一文本的结果。`isValid` 返回 false 时条目被丢弃。
+     */
+    public get(uri: string, text: string, isValid?: (value: T) => boolean): T | undefined {
+        this.syncGeneration();
+        const key = createContentKey(uri, text);
+        const entry = this.entries.get(key);
+        if (!entry || entry.text !== text || (isValid && !isValid(entry.value))) {
+            if (entry) {
+                this.deleteKey(key);
+            }
+            this.misses++;
+            return undefined;
+        }
+
+        this.entries.delete(key);
+        this.entries.set(key, entry);
+        entry.lastAccessed = Date.now();
+        this.hits++;
+        return entry.value;
+    }
+
+    public set(uri: string, text: string, value: T): void {
+        this.syncGeneration();
+        const key = createContentKey(uri, text);
+        this.deleteKey(key);
+        const bytes = this.sizeOf(value, text);
+        this.entries.set(key, { uri, text, value, bytes, lastAccessed: Date.now() });
+        this.totalBytes += bytes;
+        while (this.entries.size > this.maxEntries) {
+            this.deleteKey(this.entries.keys().next().value as string);
+        }
+        this.memoryBudget?.notifyGrowth();
+    }
+
+    /**
+     * 删除某文档的全部内容条目，返回删除的条目数
+     */
+    public deleteUri(uri: string): number {
+        let count = 0;
+        for (const [key, entry] of Array.from(this.entries.entries())) {
+            if (entry.uri === uri) {
+                this.deleteKey(key);
+                count++;
+            }
+        }
+        return count;
+    }
+
+    public clear(): void {
+        this.entries.clear();
+        this.totalBytes = 0;
+        this.hits = 0;
+        this.misses = 0;
+    }
+
+    public getStats(): { size: number; bytes: number; hits: number; misses: number } {
+        return { size: this.entries.size, bytes: this.totalBytes, hits: this.hits, misses: this.misses };
+    }
+
+    /**
+     * 以独立参与者身份向统一内存预算登记本层，驱逐时只丢弃内容条目本身。
+     * `isHeldElsewhere` 判断主缓存是否仍引用条目的主体：这类条目已由主缓存计量，
+     * 驱逐也释放不了内存，因此既不计入用量，也不作为驱逐候选。
+     */
+    public attachMemoryBudget(
+        governor: MemoryBudgetGovernor,
+        name: string,
+        isHeldElsewhere: (uri: string, value: T) => boolean = () => false
+    ): MemoryBudgetRegistration {
+        this.memoryBudget?.unregister();
+        this.memoryBudget = governor.register({
+            name,
+            rebuildCost: CONTENT_REBUILD_COST,
+            getUsage: () => {
+                let entries = 0;
+                let bytes = 0;
+                for (const entry of this.entries.values()) {
+                    if (!isHeldElsewhere(entry.uri, entry.value)) {
+                        entries++;
+                        bytes += entry.bytes;
+                    }
+                }
+                return { entries, bytes };
+            },
+            peekColdest: () => {
+                // 条目数有上限（默认 32），顺序扫描仍是常数代价。
+                for (const [key, entry] of this.entries) {
+                    if (!isHeldElsewhere(entry.uri, entry.value)) {
+                        return { key, bytes: entry.bytes, lastAccessed: entry.lastAccessed };
+                    }
+                }
+                return undefined;
+            },
+            evict: (key) => this.deleteKey(key)
+        });
+        return this.memoryBudget;
+    }
+
+    public detachMemoryBudget(): void {
+        this.memoryBudget?.unregister();
+        this.memoryBudget = undefined;
+    }
+
+    private deleteKey(key: string): number {
+        const entry = this.entries.get(key);
+        if (!entry) {
+            return 0;
+        }
+
+        this.entries.delete(key);
+        this.totalBytes -= entry.bytes;
+        return entry.bytes;
+    }
+
+    private syncGeneration(): void {
+        if (this.generation !== analysisConfigGeneration) {
+            this.entries.clear();
+            this.totalBytes = 0;
+            this.generation = analysisConfigGeneration;
+        }
+    }
+}
+
+function createContentKey(uri: string, text: string): string {
+    return `${uri}#${hashContent(text)}`;
+}
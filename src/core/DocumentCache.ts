@@ -6,7 +6,8 @@
  * - 文档版本感知
  * - 自动失效过期版本
  * - 监听文档变化事件
- * - 支持URI模式匹配失效
+ * - URI → 缓存键二级索引，按文档失效只触及该文档的条目
+ * - 有序 URI 列表上的前缀失效，以及URI模式匹配失效
  */
 
 import * as vscode from 'vscode';
@@ -69,7 +70,7 @@ export class VersionTracker {
     /**
      * 清理指定URI的版本信息
      */
-    clearVersion(uri: vscode.Uri): void {
+    clearVersion(uri: vscode.Uri | string): void {
         this.versions.delete(uri.toString());
     }
 
@@ -92,7 +93,7 @@ export class VersionTracker {
 /**
  * 文档缓存配置
  */
-export interface DocumentCacheConfig extends Partial<CacheConfig> {
+export interface DocumentCacheConfig<T = unknown> extends Partial<CacheConfig<T>> {
     /** 是否启用版本追踪 */
     enableVersionTracking?: boolean;
     /** 是否在文档变化时自动失效 */
@@ -105,16 +106,21 @@ export interface DocumentCacheConfig extends Partial<CacheConfig> {
 export class DocumentCache<T> {
     private cacheManager: CacheManager<T>;
     private versionTracker: VersionTracker;
-    private config: Required<DocumentCacheConfig>;
+    private config: Required<Omit<DocumentCacheConfig<T>, 'frequencyKey' | 'sizeOf' | 'onDelete'>>;
     private disposables: vscode.Disposable[] = [];
+    private readonly keysByUri = new Map<string, Set<string>>();
+    private readonly uriByKey = new Map<string, string>();
+    /** 按字典序排列的已缓存 URI，用于前缀失效 */
+    private sortedUris: string[] = [];
 
-    constructor(config: DocumentCacheConfig) {
+    constructor(config: DocumentCacheConfig<T>) {
         this.config = {
             maxSize: config.maxSize ?? 50,
             maxMemory: config.maxMemory ?? 10 * 1024 * 1024, // 10MB
             ttl: config.ttl ?? 5 * 60 * 1000, // 5分钟
             cleanupInterval: config.cleanupInterval ?? 60 * 1000, // 1分钟
             enableMonitoring: config.enableMonitoring ?? true,
+            admissionPolicy: config.admissionPolicy ?? 'lru',
             enableVersionTracking: config.enableVersionTracking ?? true,
             autoInvalidateOnChange: config.autoInvalidateOnChange ?? true
         };
@@ -124,7 +130,12 @@ export class DocumentCache<T> {
             maxMemory: this.config.maxMemory,
             ttl: this.config.ttl,
             cleanupInterval: this.config.cleanupInterval,
-            enableMonitoring: this.config.enableMonitoring
+            enableMonitoring: this.config.enableMonitoring,
+            admissionPolicy: this.config.admissionPolicy,
+            // 同一文档的不同版本共享访问频率，编辑中的文档不会因版本号变化被当作新条目拒绝
+            frequencyKey: config.frequencyKey ?? ((key) => key.replace(/_v\d+$/, '')),
+            sizeOf: config.sizeOf,
+            onDelete: (key) => this.unindexKey(key)
         });
 
         this.versionTracker = new VersionTracker();
@@ -159,11 +170,12 @@ export class DocumentCache<T> {
     set(document: vscode.TextDocument, value: T, size?: number): void {
         if (this.config.enableVersionTracking) {
             this.versionTracker.track(document);
-            const key = this.versionTracker.getKey(document);
-            this.cacheManager.set(key, value, size);
-        } else {
-            const key = document.uri.toString();
-            this.cacheManager.set(key, value, size);
+        }
+
+        const key = this.getCacheKey(document);
+        this.cacheManager.set(key, value, size);
+        if (this.cacheManager.has(key)) {
+            this.indexKey(document.uri.toString(), key);
         }
     }
 
@@ -171,20 +183,14 @@ export class DocumentCache<T> {
      * 删除文档的缓存
      */
     delete(document: vscode.TextDocument): boolean {
-        const key = this.config.enableVersionTracking
-            ? this.versionTracker.getKey(document)
-            : document.uri.toString();
-
-        return this.cacheManager.delete(key);
+        return this.cacheManager.delete(this.getCacheKey(document));
     }
 
     /**
      * 使指定文档的缓存失效
      */
     invalidateDocument(uri: vscode.Uri): void {
-        // 删除所有与该URI相关的缓存条目
-        const pattern = new RegExp(`^${this.escapeRegExp(uri.toString())}`);
-        this.cacheManager.invalidate(pattern);
+        this.invalidateUri(uri.toString());
 
         // 清理版本追踪信息
         if (this.config.enableVersionTracking) {
@@ -192,6 +198,30 @@ export class DocumentCache<T> {
         }
     }
 
+    /**
+     * 使 URI 以指定前缀开头的所有文档缓存失效，例如目录级事件或配置变化
+     */
+    invalidatePrefix(uriPrefix: string): number {
+        const matchedUris: string[] = [];
+        for (let index = lowerBound(this.sortedUris, uriPrefix); index < this.sortedUris.length; index++) {
+            const uri = this.sortedUris[index];
+            if (!uri.startsWith(uriPrefix)) {
+                break;
+            }
+            matchedUris.push(uri);
+        }
+
+        let count = 0;
+        for (const uri of matchedUris) {
+            count += this.invalidateUri(uri);
+            if (this.config.enableVersionTracking) {
+                this.versionTracker.clearVersion(uri);
+            }
+        }
+
+        return count;
+    }
+
     /**
      * 使匹配模式的所有文档缓存失效
      */
@@ -204,11 +234,73 @@ export class DocumentCache<T> {
      */
     clear(): void {
         this.cacheManager.clear();
+        this.keysByUri.clear();
+        this.uriByKey.clear();
+        this.sortedUris = [];
         if (this.config.enableVersionTracking) {
             this.versionTracker.clearAll();
         }
     }
 
+    /**
+     * 最久未访问的条目及其所属文档 URI
+     */
+    peekColdest(): { key: string; size: number; lastAccessed: number; uri?: string } | undefined {
+        const entry = this.cacheManager.peekColdest();
+        if (!entry) {
+            return undefined;
+        }
+
+        return {
+            key: entry.key,
+            size: entry.size,
+            lastAccessed: entry.lastAccessed,
+            uri: this.uriByKey.get(entry.key)
+        };
+    }
+
+    /**
+     * 某文档 URI 下仍缓存的全部值，不更新访问顺序
+     */
+    peekValues(uri: string): T[] {
+        const values: T[] = [];
+        for (const key of this.keysByUri.get(uri) ?? []) {
+            const value = this.cacheManager.peek(key);
+            if (value !== undefined) {
+                values.push(value);
+            }
+        }
+        return values;
+    }
+
+    /**
+     * 缓存键所属的文档 URI
+     */
+    getKeyUri(key: string): string | undefined {
+        return this.uriByKey.get(key);
+    }
+
+    /**
+     * 按缓存键删除条目，返回释放的字节数
+     */
+    evictKey(key: string): number {
+        const before = this.cacheManager.getStats().memory;
+        if (!this.cacheManager.delete(key)) {
+            return 0;
+        }
+
+        return before - this.cacheManager.getStats().memory;
+    }
+
+    /**
+     * 删除某文档 URI 下的全部条目，返回释放的字节数
+     */
+    evictUri(uri: string): number {
+        const before = this.cacheManager.getStats().memory;
+        this.invalidateUri(uri);
+        return before - this.cacheManager.getStats().memory;
+    }
+
     /**
      * 获取缓存统计信息
      */
@@ -229,11 +321,69 @@ export class DocumentCache<T> {
     dispose(): void {
         this.disposables.forEach(d => d.dispose());
         this.cacheManager.dispose();
+        this.keysByUri.clear();
+        this.uriByKey.clear();
+        this.sortedUris = [];
         this.versionTracker.dispose();
     }
 
     // ========== 私有方法 ==========
 
+    private getCacheKey(document: vscode.TextDocument): string {
+        return this.config.enableVersionTracking
+            ? this.versionTracker.getKey(document)
+            : document.uri.toString();
+    }
+
+    private invalidateUri(uri: string): number {
+        const keys = this.keysByUri.get(uri);
+        if (!keys) {
+            return 0;
+        }
+
+        let count = 0;
+        for (const key of Array.from(keys)) {
+            if (this.cacheManager.delete(key)) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    private indexKey(uri: string, key: string): void {
+        this.uriByKey.set(key, uri);
+        const keys = this.keysByUri.get(uri);
+        if (keys) {
+            keys.add(key);
+            return;
+        }
+
+        this.keysByUri.set(uri, new Set([key]));
+        this.sortedUris.splice(lowerBound(this.sortedUris, uri), 0, uri);
+    }
+
+    private unindexKey(key: string): void {
+        const uri = this.uriByKey.get(key);
+        if (uri === undefined) {
+            return;
+        }
+
+        this.uriByKey.delete(key);
+        const keys = this.keysByUri.get(uri);
+        if (!keys) {
+            return;
+        }
+
+        keys.delete(key);
+        if (keys.size === 0) {
+            this.keysByUri.delete(uri);
+            const index = lowerBound(this.sortedUris, uri);
+            if (this.sortedUris[index] === uri) {
+                this.sortedUris.splice(index, 1);
+            }
+        }
+    }
+
     /**
      * 设置自动失效机制
      */
@@ -267,11 +417,18 @@ export class DocumentCache<T> {
             );
         }
     }
+}
 
-    /**
-     * 转义正则表达式特殊字符
-     */
-    private escapeRegExp(str: string): string {
-        return str.replace(/[.*+?^${}()|[\]\\]/g, '\\$&');
+function lowerBound(values: readonly string[], target: string): number {
+    let low = 0;
+    let high = values.length;
+    while (low < high) {
+        const mid = (low + high) >>> 1;
+        if (values[mid] < target) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
     }
+    return low;
 }
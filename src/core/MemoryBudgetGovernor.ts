@@ -0,0 +1,228 @@
+import * as vscode from 'vscode';
+
+/**
+ * 统一内存预算
+ * 各层分析缓存（预处理快照、解析结果、语义分析、头文件、文件内容）向同一个治理器登记，
+ * 共享 `lpc.performance.maxCacheMemory` 字节预算。超出预算时按“体积 × 闲置时长 / 重建代价”
+ * 跨层挑选最冷的条目驱逐，并按文档 URI 级联失效持有其引用的下游层条目。
+ */
+
+export interface MemoryBudgetUsage {
+    entries: number;
+    bytes: number;
+}
+
+export interface MemoryBudgetCandidate {
+    readonly key: string;
+    readonly bytes: number;
+    readonly lastAccessed: number;
+    /** 条目所属文档，用于级联失效下游层 */
+    readonly documentUri?: string;
+}
+
+export interface MemoryBudgetParticipant {
+    readonly name: string;
+    /** 重建一个条目的相对代价；越大越晚被驱逐 */
+    readonly rebuildCost: number;
+    /** 持有本层条目引用的下游层名称；本层驱逐某文档时，下游层的同一文档一并失效 */
+    readonly dependents?: readonly string[];
+    getUsage(): MemoryBudgetUsage;
+    /** 本层最久未访问的条目，要求 O(1) */
+    peekColdest(): MemoryBudgetCandidate | undefined;
+    /** 驱逐指定条目，返回释放的字节数 */
+    evict(key: string): number;
+    /** 驱逐某文档在本层的全部条目，返回释放的字节数 */
+    evictDocument?(documentUri: string): number;
+}
+
+export interface MemoryBudgetRegistration {
+    /** 参与者写入新条目后调用；超出预算时同步驱逐 */
+    notifyGrowth(): void;
+    unregister(): void;
+}
+
+export interface MemoryBudgetCacheReport extends MemoryBudgetUsage {
+    name: string;
+    evictions: number;
+    cascadeEvictions: number;
+}
+
+export interface MemoryBudgetReport {
+    budgetBytes: number;
+    usedBytes: number;
+    caches: MemoryBudgetCacheReport[];
+}
+
+interface ParticipantState {
+    readonly participant: MemoryBudgetParticipant;
+    evictions: number;
+    cascadeEvictions: number;
+}
+
+export const DEFAULT_MEMORY_BUDGET_BYTES = 50_000_000;
+const MAX_EVICTIONS_PER_ENFORCE = 10_000;
+
+export class MemoryBudgetGovernor {
+    private readonly participants = new Map<string, ParticipantState>();
+    private enforcing = false;
+
+    constructor(private budgetBytes: number = DEFAULT_MEMORY_BUDGET_BYTES) {}
+
+    public register(participant: MemoryBudgetParticipant): MemoryBudgetRegistration {
+        const state: ParticipantState = { participant, evictions: 0, cascadeEvictions: 0 };
+        this.participants.set(participant.name, state);
+
+        return {
+            notifyGrowth: () => this.notifyGrowth(),
+            unregister: () => {
+                if (this.participants.get(participant.name) === state) {
+                    this.participants.delete(participant.name);
+                }
+            }
+        };
+    }
+
+    public setBudget(budgetBytes: number): void {
+        this.budgetBytes = budgetBytes;
+        this.notifyGrowth();
+    }
+
+    public getBudget(): number {
+        return this.budgetBytes;
+    }
+
+    public getUsedBytes(): number {
+        let total = 0;
+        for (const state of this.participants.values()) {
+            total += state.participant.getUsage().bytes;
+        }
+        return total;
+    }
+
+    public notifyGrowth(): void {
+        if (this.enforcing || this.budgetBytes <= 0 || this.getUsedBytes() <= this.budgetBytes) {
+            return;
+        }
+
+        this.enforce();
+    }
+
+    /**
+     * 驱逐直到回到预算以内，返回驱逐的条目数（含级联）
+     */
+    public enforce(): number {
+        if (this.enforcing) {
+            return 0;
+        }
+
+        this.enforcing = true;
+        let evicted = 0;
+        try {
+            let usedBytes = this.getUsedBytes();
+            while (usedBytes > this.budgetBytes && evicted < MAX_EVICTIONS_PER_ENFORCE) {
+                const victim = this.selectVictim();
+                if (!victim) {
+                    break;
+                }
+
+                victim.state.participant.evict(victim.candidate.key);
+                victim.state.evictions++;
+                evicted++;
+                if (victim.candidate.documentUri) {
+                    evicted += this.cascade(victim.state.participant, victim.candidate.documentUri, new Set());
+                }
+
+                // 参与者的用量统计是 O(1) 计数，驱逐与级联之后重新求和，比逐项扣减更不容易漂移。
+                const previousUsedBytes = usedBytes;
+                usedBytes = this.getUsedBytes();
+                if (usedBytes >= previousUsedBytes) {
+                    // 驱逐与级联都没有释放任何内容，避免在同一个条目上空转。
+                    break;
+                }
+            }
+        } finally {
+            this.enforcing = false;
+        }
+
+        return evicted;
+    }
+
+    public getReport(): MemoryBudgetReport {
+        const caches = Array.from(this.participants.values()).map((state) => ({
+            name: state.participant.name,
+            ...state.participant.getUsage(),
+            evictions: state.evictions,
+            cascadeEvictions: state.cascadeEvictions
+        }));
+
+        return {
+            budgetBytes: this.budgetBytes,
+            usedBytes: caches.reduce((total, cache) => total + cache.bytes, 0),
+            caches
+        };
+    }
+
+    private selectVictim(): { state: ParticipantState; candidate: MemoryBudgetCandidate } | undefined {
+        const now = Date.now();
+        let best: { state: ParticipantState; candidate: MemoryBudgetCandidate; score: number } | undefined;
+
+        for (const state of this.participants.values()) {
+            const candidate = state.participant.peekColdest();
+            if (!candidate) {
+                continue;
+            }
+
+            const idleMs = Math.max(0, now - candidate.lastAccessed) + 1;
+            const score = (candidate.bytes * idleMs) / Math.max(1, state.participant.rebuildCost);
+            if (!best || score > best.score) {
+                best = { state, candidate, score };
+            }
+        }
+
+        return best;
+    }
+
+    private cascade(source: MemoryBudgetParticipant, documentUri: string, visited: Set<string>): number {
+        visited.add(source.name);
+        let evicted = 0;
+
+        for (const dependentName of source.dependents ?? []) {
+            if (visited.has(dependentName)) {
+                continue;
+            }
+
+            const dependent = this.participants.get(dependentName);
+            if (!dependent?.participant.evictDocument) {
+                continue;
+            }
+
+            if (dependent.participant.evictDocument(documentUri) > 0) {
+                dependent.cascadeEvictions++;
+                evicted++;
+            }
+            evicted += this.cascade(dependent.participant, documentUri, visited);
+        }
+
+        return evicted;
+    }
+}
+
+let globalMemoryBudgetGovernor: MemoryBudgetGovernor | undefined;
+
+export function getGlobalMemoryBudgetGovernor(): MemoryBudgetGovernor {
+    if (!globalMemoryBudgetGovernor) {
+        globalMemoryBudgetGovernor = new MemoryBudgetGovernor(readConfiguredMemoryBudget());
+    }
+
+    return globalMemoryBudgetGovernor;
+}
+
+export function readConfiguredMemoryBudget(): number {
+    try {
+        const configured = vscode.workspace.getConfiguration('lpc.performance')
+            .get<number>('maxCacheMemory', DEFAULT_MEMORY_BUDGET_BYTES);
+        return typeof configured === 'number' && configured > 0 ? configured : DEFAULT_MEMORY_BUDGET_BYTES;
+    } catch {
+        return DEFAULT_MEMORY_BUDGET_BYTES;
+    }
+}
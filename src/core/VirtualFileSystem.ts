@@ -0,0 +1,371 @@
+import * as fs from 'fs';
+import * as path from 'path';
+
+export interface VirtualFileStat {
+    readonly isFile: boolean;
+    readonly isDirectory: boolean;
+    readonly mtimeMs: number;
+    readonly size: number;
+}
+
+export interface VirtualFileSystemOptions {
+    /** 是否已有文件监听负责失效；未监听时不信任缓存，每次都回到磁盘。 */
+    watched?: boolean;
+    /** 监听模式下条目的最长信任时间，兜底覆盖监听范围之外的目录（如工作区外的 include 目录）。 */
+    maxEntryAgeMs?: number;
+    maxStatEntries?: number;
+    maxContentEntries?: number;
+    maxDirectoryEntries?: number;
+}
+
+interface StatEntry {
+    /** null 表示路径不存在（负缓存）。 */
+    readonly stat: VirtualFileStat | null;
+    readonly checkedAt: number;
+}
+
+interface DirectoryEntry {
+    /** null 表示目录不存在；否则是目录下条目名（按平台大小写规则折叠）的集合。 */
+    readonly names: ReadonlySet<string> | null;
+    readonly checkedAt: number;
+}
+
+interface ContentEntry {
+    readonly text: string;
+    readonly checkedAt: number;
+}
+
+export interface VirtualFileSystemStats {
+    statHits: number;
+    statMisses: number;
+    contentHits: number;
+    contentMisses: number;
+    directoryHits: number;
+    directoryMisses: number;
+    statEntries: number;
+    contentEntries: number;
+    directoryEntries: number;
+}
+
+const DEFAULT_MAX_ENTRY_AGE_MS = 30_000;
+const DEFAULT_MAX_STAT_ENTRIES = 20_000;
+const DEFAULT_MAX_CONTENT_ENTRIES = 256;
+const DEFAULT_MAX_DIRECTORY_ENTRIES = 4_096;
+const CASE_INSENSITIVE_FILE_NAMES = process.platform === 'win32' || process.platform === 'darwin';
+
+/**
+ * 进程级文件系统视图：缓存存在性、stat 与文本内容（包括“不存在”的负结果）。
+ * 存在性查询通过父目录的列表索引回答，include 目录与 mudlib 根目录各只需列举一次，
+ * 之后每个候选路径都是一次集合查找。
+ * 由文件监听事件按路径失效；未接入监听时所有查询都直接落到磁盘。
+ */
+export class VirtualFileSystem {
+    private readonly statEntries = new Map<string, StatEntry>();
+    private readonly contentEntries = new Map<string, ContentEntry>();
+    private readonly directoryEntries = new Map<string, DirectoryEntry>();
+    private readonly pendingReads = new Map<string, Promise<string | undefined>>();
+    private readonly maxEntryAgeMs: number;
+    private readonly maxStatEntries: number;
+    private readonly maxContentEntries: number;
+    private readonly maxDirectoryEntries: number;
+    private watched: boolean;
+    private readonly stats = {
+        statHits: 0,
+        statMisses: 0,
+        contentHits: 0,
+        contentMisses: 0,
+        directoryHits: 0,
+        directoryMisses: 0
+    };
+
+    constructor(options: VirtualFileSystemOptions = {}) {
+        this.watched = options.watched ?? false;
+        this.maxEntryAgeMs = options.maxEntryAgeMs ?? DEFAULT_MAX_ENTRY_AGE_MS;
+        this.maxStatEntries = options.maxStatEntries ?? DEFAULT_MAX_STAT_ENTRIES;
+        this.maxContentEntries = options.maxContentEntries ?? DEFAULT_MAX_CONTENT_ENTRIES;
+        this.maxDirectoryEntries = options.maxDirectoryEntries ?? DEFAULT_MAX_DIRECTORY_ENTRIES;
+    }
+
+    public setWatched(watched: boolean): void {
+        if (this.watched !== watched) {
+            this.watched = watched;
+            this.clear();
+        }
+    }
+
+    public isWatched(): boolean {
+        return this.watched;
+    }
+
+    public exists(filePath: string): boolean {
+        if (!this.watched) {
+            return fs.existsSync(filePath);
+        }
+
+        const key = normalizeVirtualPathKey(filePath);
+        const cached = this.statEntries.get(key);
+        if (cached && this.isFresh(cached.checkedAt)) {
+            this.stats.statHits += 1;
+            return cached.stat !== null;
+        }
+
+        // 目录列表按规范化路径缓存，`..` 与重复分隔符不会产生各自的列表。
+        const normalizedPath = path.normalize(filePath);
+        const parentPath = path.dirname(normalizedPath);
+        const name = path.basename(normalizedPath);
+        if (!name || name === '.' || name === '..' || parentPath === normalizedPath) {
+            return this.stat(filePath) !== undefined;
+        }
+
+        const names = this.getDirectoryNames(parentPath);
+        return names !== null && names.has(foldFileName(name));
+    }
+
+    /** 返回目录下的条目名集合（大小写按平台折叠）；目录不存在时返回 undefined。 */
+    public listDirectory(directoryPath: string): ReadonlySet<string> | undefined {
+        return this.getDirectoryNames(directoryPath) ?? undefined;
+    }
+
+    public isFile(filePath: string): boolean {
+        return this.stat(filePath)?.isFile === true;
+    }
+
+    /** 按顺序返回第一个存在的候选路径。 */
+    public findFirstExisting(candidates: Iterable<string>): string | undefined {
+        for (const candidate of candidates) {
+            if (this.exists(candidate)) {
+                return candidate;
+            }
+        }
+
+        return undefined;
+    }
+
+    public stat(filePath: string): VirtualFileStat | undefined {
+        const key = normalizeVirtualPathKey(filePath);
+        const cached = this.statEntries.get(key);
+        if (cached && this.isFresh(cached.checkedAt)) {
+            this.stats.statHits += 1;
+            return cached.stat ?? undefined;
+        }
+
+        this.stats.statMisses += 1;
+        const stat = readStat(filePath);
+        this.rememberStat(key, stat);
+        return stat ?? undefined;
+    }
+
+    public readFile(filePath: string): string | undefined {
+        const key = normalizeVirtualPathKey(filePath);
+        const cached = this.getFreshContent(key);
+        if (cached !== undefined) {
+            return cached;
+        }
+
+        if (!this.isFile(filePath)) {
+            return undefined;
+        }
+
+        try {
+            const text = fs.readFileSync(filePath, 'utf8');
+            this.rememberContent(key, text);
+            return text;
+        } catch {
+            this.rememberStat(key, null);
+            return undefined;
+        }
+    }
+
+    public readFileAsync(filePath: string): Promise<string | undefined> {
+        const key = normalizeVirtualPathKey(filePath);
+        const cached = this.getFreshContent(key);
+        if (cached !== undefined) {
+            return Promise.resolve(cached);
+        }
+
+        const pending = this.pendingReads.get(key);
+        if (pending) {
+            return pending;
+        }
+
+        const read = fs.promises.readFile(filePath, 'utf8')
+            .then((text) => {
+                if (this.pendingReads.get(key) === read) {
+                    this.rememberContent(key, text);
+                }
+                return text as string | undefined;
+            }, () => {
+                if (this.pendingReads.get(key) === read) {
+                    this.rememberStat(key, null);
+                }
+                return undefined;
+            })
+            .finally(() => {
+                if (this.pendingReads.get(key) === read) {
+                    this.pendingReads.delete(key);
+                }
+            });
+        this.pendingReads.set(key, read);
+        return read;
+    }
+
+    public invalidate(filePath: string): void {
+        const key = normalizeVirtualPathKey(filePath);
+        this.statEntries.delete(key);
+        this.contentEntries.delete(key);
+        this.pendingReads.delete(key);
+        this.directoryEntries.delete(normalizeVirtualPathKey(path.normalize(filePath)));
+        this.invalidateAncestorListings(path.normalize(filePath));
+    }
+
+    public clear(): void {
+        this.statEntries.clear();
+        this.contentEntries.clear();
+        this.directoryEntries.clear();
+        this.pendingReads.clear();
+    }
+
+    public getStats(): VirtualFileSystemStats {
+        return {
+            ...this.stats,
+            statEntries: this.statEntries.size,
+            contentEntries: this.contentEntries.size,
+            directoryEntries: this.directoryEntries.size
+        };
+    }
+
+    private getDirectoryNames(directoryPath: string): ReadonlySet<string> | null {
+        const key = normalizeVirtualPathKey(path.normalize(directoryPath));
+        const cached = this.directoryEntries.get(key);
+        if (cached && this.isFresh(cached.checkedAt)) {
+            this.stats.directoryHits += 1;
+            return cached.names;
+        }
+
+        this.stats.directoryMisses += 1;
+        let names: Set<string> | null;
+        try {
+            names = new Set(fs.readdirSync(directoryPath).map(foldFileName));
+        } catch {
+            names = null;
+        }
+
+        if (this.watched) {
+            this.directoryEntries.delete(key);
+            this.directoryEntries.set(key, { names, checkedAt: Date.now() });
+            evictOldest(this.directoryEntries, this.maxDirectoryEntries);
+        }
+        return names;
+    }
+
+    /**
+     * 文件创建/删除会改变父目录列表；新建子目录时祖先目录的列表也可能缺少对应条目，
+     * 因此逐级向上丢弃不再一致的列表，直到遇到已包含该条目的祖先。
+     */
+    private invalidateAncestorListings(filePath: string): void {
+        let childPath = filePath;
+        let parentPath = path.dirname(childPath);
+        this.directoryEntries.delete(normalizeVirtualPathKey(parentPath));
+
+        while (parentPath !== childPath) {
+            childPath = parentPath;
+            parentPath = path.dirname(childPath);
+            if (parentPath === childPath) {
+                break;
+            }
+
+            const parentKey = normalizeVirtualPathKey(parentPath);
+            const listing = this.directoryEntries.get(parentKey);
+            if (!listing) {
+                continue;
+            }
+
+            if (listing.names?.has(foldFileName(path.basename(childPath)))) {
+                break;
+            }
+            this.directoryEntries.delete(parentKey);
+        }
+    }
+
+    private getFreshContent(key: string): string | undefined {
+        const cached = this.contentEntries.get(key);
+        if (cached && this.isFresh(cached.checkedAt)) {
+            this.stats.contentHits += 1;
+            this.contentEntries.delete(key);
+            this.contentEntries.set(key, cached);
+            return cached.text;
+        }
+
+        this.stats.contentMisses += 1;
+        return undefined;
+    }
+
+    private rememberStat(key: string, stat: VirtualFileStat | null): void {
+        if (!this.watched) {
+            return;
+        }
+
+        this.statEntries.delete(key);
+        this.statEntries.set(key, { stat, checkedAt: Date.now() });
+        if (!stat) {
+            this.contentEntries.delete(key);
+        }
+        evictOldest(this.statEntries, this.maxStatEntries);
+    }
+
+    private rememberContent(key: string, text: string): void {
+        if (!this.watched) {
+            return;
+        }
+
+        this.contentEntries.delete(key);
+        this.contentEntries.set(key, { text, checkedAt: Date.now() });
+        evictOldest(this.contentEntries, this.maxContentEntries);
+    }
+
+    private isFresh(checkedAt: number): boolean {
+        return this.watched && Date.now() - checkedAt < this.maxEntryAgeMs;
+    }
+}
+
+function readStat(filePath: string): VirtualFileStat | null {
+    try {
+        const stats = fs.statSync(filePath);
+        return {
+            isFile: stats.isFile(),
+            isDirectory: stats.isDirectory(),
+            mtimeMs: stats.mtimeMs,
+            size: stats.size
+        };
+    } catch {
+        return null;
+    }
+}
+
+function evictOldest<T>(entries: Map<string, T>, maxEntries: number): void {
+    while (entries.size > maxEntries) {
+        const oldestKey = entries.keys().next().value as string;
+        entries.delete(oldestKey);
+    }
+}
+
+function foldFileName(name: string): string {
+    return CASE_INSENSITIVE_FILE_NAMES ? name.toLowerCase() : name;
+}
+
+export function normalizeVirtualPathKey(filePath: string): string {
+    return filePath
+        .replace(/\\/g, '/')
+        .replace(/^\/+([A-Za-z]:\/)/, '$1')
+        .replace(/^([A-Za-z]):/, (_match, drive: string) => `${drive.toLowerCase()}:`);
+}
+
+let globalVirtualFileSystem: VirtualFileSystem | undefined;
+
+export function getGlobalVirtualFileSystem(): VirtualFileSystem {
+    if (!globalVirtualFileSystem) {
+        globalVirtualFileSystem = new VirtualFileSystem();
+    }
+
+    return globalVirtualFileSystem;
+}
@@ -0,0 +1,68 @@
+import { CacheManager } from '../CacheManager';
+
+describe('CacheManager', () => {
+    test('evicts the least recently used entry when the size limit is reached', () => {
+        const cache = new CacheManager<string>({ maxSize: 2, cleanupInterval: 0 });
+
+        cache.set('a', 'A');
+        cache.set('b', 'B');
+        expect(cache.get('a')).toBe('A');
+        cache.set('c', 'C');
+
+        expect(cache.keys().sort()).toEqual(['a', 'c']);
+        expect(cache.getStats()).toEqual(expect.objectContaining({
+            size: 2,
+            hits: 1,
+            evictions: 1
+        }));
+    });
+
+    test('evicts from the cold end until the byte budget fits', () => {
+        const cache = new CacheManager<string>({ maxSize: 10, maxMemory: 100, cleanupInterval: 0 });
+
+        cache.set('a', 'x', 40);
+        cache.set('b', 'x', 40);
+        cache.get('a');
+        cache.set('c', 'x', 50);
+
+        expect(cache.has('b')).toBe(false);
+        expect(cache.has('a')).toBe(true);
+        expect(cache.getStats().memory).toBe(90);
+
+        cache.set('a', 'y', 10);
+        expect(cache.getStats().memory).toBe(60);
+        expect(cache.getStats().size).toBe(2);
+    });
+
+    test('measures strings by their UTF-16 byte length', () => {
+        const cache = new CacheManager<string>({ cleanupInterval: 0 });
+
+        cache.set('text', 'abcd');
+
+        expect(cache.getStats().memory).toBe(8);
+    });
+
+    test('tinylfu admission keeps hot entries when a one-off key arrives at capacity', () => {
+        const cache = new CacheManager<string>({
+            maxSize: 2,
+            cleanupInterval: 0,
+            admissionPolicy: 'tinylfu',
+            frequencyKey: (key) => key.replace(/_v\d+$/, '')
+        });
+
+        cache.set('hot_v1', 'hot');
+        cache.set('warm_v1', 'warm');
+        for (let index = 0; index < 5; index++) {
+            cache.get('hot_v1');
+            cache.get('warm_v1');
+        }
+
+        cache.set('scan_v1', 'scan');
+        expect(cache.has('scan_v1')).toBe(false);
+        expect(cache.getStats().admissionRejections).toBe(1);
+
+        // A new version of a hot document shares its frequency and is admitted.
+        cache.set('hot_v2', 'hot again');
+        expect(cache.has('hot_v2')).toBe(true);
+    });
+});
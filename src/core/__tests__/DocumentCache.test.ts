@@ -0,0 +1,73 @@
+import * as vscode from 'vscode';
+import { DocumentCache } from '../DocumentCache';
+
+function createDocument(filePath: string, version: number): vscode.TextDocument {
+    return {
+        uri: vscode.Uri.file(filePath),
+        version
+    } as vscode.TextDocument;
+}
+
+function directoryPrefix(directoryPath: string): string {
+    return `${vscode.Uri.file(directoryPath).toString()}/`;
+}
+
+describe('DocumentCache', () => {
+    test('invalidates only the entries indexed under a document uri', () => {
+        const cache = new DocumentCache<string>({ cleanupInterval: 0, autoInvalidateOnChange: false });
+        const room = createDocument('/mud/room.c', 1);
+        const roomBackup = createDocument('/mud/room.c.bak', 1);
+
+        cache.set(room, 'room');
+        cache.set(roomBackup, 'backup');
+        cache.invalidateDocument(room.uri);
+
+        expect(cache.get(room)).toBeUndefined();
+        expect(cache.get(roomBackup)).toBe('backup');
+        expect(cache.getStats().size).toBe(1);
+        cache.dispose();
+    });
+
+    test('invalidates every document under a uri prefix', () => {
+        const cache = new DocumentCache<string>({ cleanupInterval: 0, autoInvalidateOnChange: false });
+        const documents = [
+            createDocument('/mud/std/room.c', 1),
+            createDocument('/mud/std/npc.c', 3),
+            createDocument('/mud/d/city/inn.c', 2)
+        ];
+        documents.forEach((document) => cache.set(document, document.uri.toString()));
+
+        expect(cache.invalidatePrefix(directoryPrefix('/mud/std'))).toBe(2);
+        expect(cache.get(documents[0])).toBeUndefined();
+        expect(cache.get(documents[1])).toBeUndefined();
+        expect(cache.get(documents[2])).toBe(documents[2].uri.toString());
+        expect(cache.invalidatePrefix(directoryPrefix('/mud/std'))).toBe(0);
+        cache.dispose();
+    });
+
+    test('keeps the uri index in sync with evictions', () => {
+        const cache = new DocumentCache<string>({ maxSize: 1, cleanupInterval: 0, autoInvalidateOnChange: false });
+        const first = createDocument('/mud/a.c', 1);
+        const second = createDocument('/mud/b.c', 1);
+
+        cache.set(first, 'a');
+        cache.set(second, 'b');
+
+        expect(cache.invalidatePrefix(directoryPrefix('/mud'))).toBe(1);
+        expect(cache.getStats().size).toBe(0);
+        cache.dispose();
+    });
+
+    test('peeks the values held for a uri without touching recency', () => {
+        const cache = new DocumentCache<string>({ maxSize: 2, cleanupInterval: 0, autoInvalidateOnChange: false });
+        const room = createDocument('/mud/room.c', 1);
+        const npc = createDocument('/mud/npc.c', 1);
+
+        cache.set(room, 'room');
+        cache.set(npc, 'npc');
+        expect(cache.peekValues(room.uri.toString())).toEqual(['room']);
+        expect(cache.peekValues('file:///mud/missing.c')).toEqual([]);
+        expect(cache.peekColdest()?.uri).toBe(room.uri.toString());
+        cache.dispose();
+    });
+});
@@ -0,0 +1,174 @@
+import { jest } from '@jest/globals';
+import { ContentAddressedCache } from '../ContentAddressedCache';
+import { MemoryBudgetCandidate, MemoryBudgetGovernor, MemoryBudgetParticipant } from '../MemoryBudgetGovernor';
+
+interface FakeEntry {
+    bytes: number;
+    lastAccessed: number;
+    documentUri?: string;
+}
+
+function createParticipant(
+    name: string,
+    rebuildCost: number,
+    entries: Array<[string, FakeEntry]>,
+    dependents?: string[]
+): MemoryBudgetParticipant & { entries: Map<string, FakeEntry> } {
+    const map = new Map(entries);
+    return {
+        name,
+        rebuildCost,
+        dependents,
+        entries: map,
+        getUsage: () => ({
+            entries: map.size,
+            bytes: Array.from(map.values()).reduce((total, entry) => total + entry.bytes, 0)
+        }),
+        peekColdest: (): MemoryBudgetCandidate | undefined => {
+            const first = map.entries().next();
+            return first.done ? undefined : { key: first.value[0], ...first.value[1] };
+        },
+        evict: (key) => {
+            const bytes = map.get(key)?.bytes ?? 0;
+            map.delete(key);
+            return bytes;
+        },
+        evictDocument: (uri) => {
+            let freed = 0;
+            for (const [key, entry] of Array.from(map.entries())) {
+                if (entry.documentUri === uri) {
+                    freed += entry.bytes;
+                    map.delete(key);
+                }
+            }
+            return freed;
+        }
+    };
+}
+
+describe('MemoryBudgetGovernor', () => {
+    test('evicts across caches by size, idle time and rebuild cost until the budget fits', () => {
+        const now = Date.now();
+        const governor = new MemoryBudgetGovernor(300);
+        const cheap = createParticipant('headers', 1, [
+            ['a.h', { bytes: 100, lastAccessed: now - 1000 }],
+            ['b.h', { bytes: 100, lastAccessed: now }]
+        ]);
+        const expensive = createParticipant('semantic', 100, [
+            ['room.c', { bytes: 200, lastAccessed: now - 1000 }]
+        ]);
+        governor.register(cheap);
+        governor.register(expensive);
+
+        governor.notifyGrowth();
+
+        expect(Array.from(cheap.entries.keys())).toEqual(['b.h']);
+        expect(expensive.entries.has('room.c')).toBe(true);
+        expect(governor.getReport()).toEqual(expect.objectContaining({ budgetBytes: 300, usedBytes: 300 }));
+    });
+
+    test('cascades an eviction to dependent caches that hold the same document', () => {
+        const governor = new MemoryBudgetGovernor(150);
+        const frontend = createParticipant('frontend', 1, [
+            ['room.c', { bytes: 100, lastAccessed: 0, documentUri: 'room.c' }]
+        ], ['parsed']);
+        const parsed = createParticipant('parsed', 1000, [
+            ['room.c_v1', { bytes: 50, lastAccessed: Date.now(), documentUri: 'room.c' }],
+            ['npc.c_v1', { bytes: 50, lastAccessed: Date.now(), documentUri: 'npc.c' }]
+        ], ['semantic']);
+        const semantic = createParticipant('semantic', 1000, [
+            ['room.c', { bytes: 10, lastAccessed: Date.now(), documentUri: 'room.c' }]
+        ]);
+        governor.register(frontend);
+        governor.register(parsed);
+        governor.register(semantic);
+
+        governor.notifyGrowth();
+
+        expect(frontend.entries.size).toBe(0);
+        expect(Array.from(parsed.entries.keys())).toEqual(['npc.c_v1']);
+        expect(semantic.entries.size).toBe(0);
+        expect(governor.getReport().caches).toEqual([
+            expect.objectContaining({ name: 'frontend', evictions: 1, cascadeEvictions: 0 }),
+            expect.objectContaining({ name: 'parsed', evictions: 0, cascadeEvictions: 1 }),
+            expect.objectContaining({ name: 'semantic', evictions: 0, cascadeEvictions: 1 })
+        ]);
+    });
+
+    test('counts cascaded bytes and stops when an eviction frees nothing', () => {
+        const governor = new MemoryBudgetGovernor(100);
+        const stuck = {
+            ...createParticipant('frontend', 1, [
+                ['room.c', { bytes: 100, lastAccessed: 0, documentUri: 'room.c' }]
+            ], ['parsed']),
+            evict: jest.fn(() => 0)
+        };
+        const parsed = createParticipant('parsed', 1000, [
+            ['room.c_v1', { bytes: 50, lastAccessed: Date.now(), documentUri: 'room.c' }],
+            ['npc.c_v1', { bytes: 40, lastAccessed: Date.now(), documentUri: 'npc.c' }]
+        ]);
+        governor.register(stuck);
+        governor.register(parsed);
+
+        // The first pass frees bytes only through the cascade; the second frees nothing and stops.
+        expect(governor.enforce()).toBe(3);
+        expect(stuck.evict).toHaveBeenCalledTimes(2);
+        expect(Array.from(parsed.entries.keys())).toEqual(['npc.c_v1']);
+
+        parsed.entries.set('npc.c_v2', { bytes: 40, lastAccessed: Date.now(), documentUri: 'npc.c' });
+        expect(governor.enforce()).toBe(1);
+        expect(stuck.evict).toHaveBeenCalledTimes(3);
+        expect(parsed.entries.size).toBe(2);
+    });
+
+    test('bounds content-addressed cache layers by their estimated bytes', () => {
+        const governor = new MemoryBudgetGovernor(250);
+        const cache = new ContentAddressedCache<string>(undefined, () => 100);
+        cache.attachMemoryBudget(governor, 'parsedDocumentContent');
+
+        cache.set('file:///room.c', 'int a;', 'a');
+        cache.set('file:///room.c', 'int b;', 'b');
+        cache.set('file:///room.c', 'int c;', 'c');
+
+        expect(cache.getStats()).toMatchObject({ size: 2, bytes: 200 });
+        expect(cache.get('file:///room.c', 'int a;')).toBeUndefined();
+        expect(cache.get('file:///room.c', 'int c;')).toBe('c');
+        expect(governor.getReport().caches).toEqual([
+            { name: 'parsedDocumentContent', entries: 2, bytes: 200, evictions: 1, cascadeEvictions: 0 }
+        ]);
+
+        cache.detachMemoryBudget();
+        expect(governor.getUsedBytes()).toBe(0);
+    });
+
+    test('charges a content layer only for entries the primary cache no longer holds', () => {
+        const governor = new MemoryBudgetGovernor(150);
+        const held = new Set(['file:///room.c']);
+        const cache = new ContentAddressedCache<string>(undefined, () => 100);
+        cache.attachMemoryBudget(governor, 'parsedDocumentContent', (uri) => held.has(uri));
+
+        cache.set('file:///room.c', 'int a;', 'room');
+        cache.set('file:///npc.c', 'int b;', 'npc');
+        expect(governor.getReport().caches).toEqual([
+            { name: 'parsedDocumentContent', entries: 1, bytes: 100, evictions: 0, cascadeEvictions: 0 }
+        ]);
+
+        // Over budget: only the entry the primary cache dropped can free memory.
+        cache.set('file:///sword.c', 'int c;', 'sword');
+        expect(cache.get('file:///room.c', 'int a;')).toBe('room');
+        expect(cache.get('file:///npc.c', 'int b;')).toBeUndefined();
+        expect(cache.get('file:///sword.c', 'int c;')).toBe('sword');
+        expect(governor.getUsedBytes()).toBe(100);
+    });
+
+    test('stops accounting for a cache once it unregisters', () => {
+        const governor = new MemoryBudgetGovernor(10);
+        const registration = governor.register(createParticipant('parsed', 1, [
+            ['room.c', { bytes: 5, lastAccessed: 0 }]
+        ]));
+
+        expect(governor.getUsedBytes()).toBe(5);
+        registration.unregister();
+        expect(governor.getReport()).toEqual({ budgetBytes: 10, usedBytes: 0, caches: [] });
+    });
+});
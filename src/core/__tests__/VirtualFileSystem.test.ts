@@ -0,0 +1,109 @@
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { VirtualFileSystem } from '../VirtualFileSystem';
+
+describe('VirtualFileSystem', () => {
+    let tempRoot: string | undefined;
+
+    afterEach(() => {
+        if (tempRoot) {
+            fs.rmSync(tempRoot, { recursive: true, force: true });
+            tempRoot = undefined;
+        }
+    });
+
+    test('caches positive and negative lookups until the path is invalidated', () => {
+        tempRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'lpc-vfs-'));
+        const presentPath = path.join(tempRoot, 'room.c');
+        const missingPath = path.join(tempRoot, 'room.h');
+        fs.writeFileSync(presentPath, 'void create() {}\n', 'utf8');
+        const fileSystem = new VirtualFileSystem({ watched: true });
+
+        expect(fileSystem.findFirstExisting([missingPath, presentPath])).toBe(presentPath);
+        expect(fileSystem.readFile(presentPath)).toBe('void create() {}\n');
+
+        fs.writeFileSync(missingPath, '#define ROOM 1\n', 'utf8');
+        fs.writeFileSync(presentPath, 'void reset() {}\n', 'utf8');
+
+        expect(fileSystem.exists(missingPath)).toBe(false);
+        expect(fileSystem.readFile(presentPath)).toBe('void create() {}\n');
+        expect(fileSystem.getStats()).toEqual(expect.objectContaining({ directoryHits: 2, contentHits: 1 }));
+
+        fileSystem.invalidate(missingPath);
+        fileSystem.invalidate(presentPath);
+
+        expect(fileSystem.exists(missingPath)).toBe(true);
+        expect(fileSystem.readFile(presentPath)).toBe('void reset() {}\n');
+    });
+
+    test('reads through to disk when no watcher owns invalidation', async () => {
+        tempRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'lpc-vfs-'));
+        const filePath = path.join(tempRoot, 'room.c');
+        const fileSystem = new VirtualFileSystem();
+
+        expect(fileSystem.exists(filePath)).toBe(false);
+        fs.writeFileSync(filePath, 'int x;\n', 'utf8');
+
+        expect(fileSystem.exists(filePath)).toBe(true);
+        await expect(fileSystem.readFileAsync(filePath)).resolves.toBe('int x;\n');
+        expect(fileSystem.getStats()).toEqual(expect.objectContaining({ statEntries: 0, contentEntries: 0 }));
+    });
+
+    test('shares concurrent async reads and caches the result', async () => {
+        tempRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'lpc-vfs-'));
+        const filePath = path.join(tempRoot, 'std.c');
+        fs.writeFileSync(filePath, 'inherit "/std/base";\n', 'utf8');
+        const fileSystem = new VirtualFileSystem({ watched: true });
+
+        const first = fileSystem.readFileAsync(filePath);
+        const second = fileSystem.readFileAsync(filePath);
+
+        expect(second).toBe(first);
+        await expect(first).resolves.toBe('inherit "/std/base";\n');
+        expect(fileSystem.readFile(filePath)).toBe('inherit "/std/base";\n');
+        await expect(fileSystem.readFileAsync(path.join(tempRoot, 'missing.c'))).resolves.toBeUndefined();
+        expect(fileSystem.exists(path.join(tempRoot, 'missing.c'))).toBe(false);
+    });
+
+    test('shares one directory listing across unnormalized spellings of the same directory', () => {
+        tempRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'lpc-vfs-'));
+        fs.mkdirSync(path.join(tempRoot, 'include'));
+        const headerPath = path.join(tempRoot, 'include', 'ansi.h');
+        const dottedPath = `${tempRoot}${path.sep}include${path.sep}..${path.sep}include${path.sep}${path.sep}ansi.h`;
+        const fileSystem = new VirtualFileSystem({ watched: true });
+
+        expect(fileSystem.exists(dottedPath)).toBe(false);
+        expect(fileSystem.exists(headerPath)).toBe(false);
+        expect(fileSystem.getStats()).toEqual(expect.objectContaining({ directoryMisses: 1, directoryEntries: 1 }));
+
+        fs.writeFileSync(headerPath, '#define NOR "reset"\n', 'utf8');
+        fileSystem.invalidate(headerPath);
+
+        expect(fileSystem.exists(dottedPath)).toBe(true);
+    });
+
+    test('answers existence probes from cached directory listings', () => {
+        tempRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'lpc-vfs-'));
+        const includeDir = path.join(tempRoot, 'include');
+        fs.mkdirSync(includeDir);
+        fs.writeFileSync(path.join(includeDir, 'ansi.h'), '#define NOR ""\n', 'utf8');
+        const fileSystem = new VirtualFileSystem({ watched: true });
+
+        expect(fileSystem.findFirstExisting([
+            path.join(includeDir, 'globals.h'),
+            path.join(includeDir, 'ansi.h')
+        ])).toBe(path.join(includeDir, 'ansi.h'));
+        expect(fileSystem.exists(path.join(includeDir, 'room.h'))).toBe(false);
+        expect(fileSystem.exists(path.join(tempRoot, 'missing', 'room.h'))).toBe(false);
+        expect(fileSystem.getStats()).toEqual(expect.objectContaining({ directoryMisses: 2, directoryHits: 2 }));
+
+        const nestedPath = path.join(tempRoot, 'missing', 'room.h');
+        fs.mkdirSync(path.dirname(nestedPath));
+        fs.writeFileSync(nestedPath, '', 'utf8');
+        fileSystem.invalidate(nestedPath);
+
+        expect(fileSystem.exists(nestedPath)).toBe(true);
+        expect(fileSystem.exists(path.join(tempRoot, 'missing'))).toBe(true);
+    });
+});
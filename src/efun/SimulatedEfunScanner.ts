@@ -1,6 +1,6 @@
-import * as fs from 'fs';
 import * as path from 'path';
 import * as vscode from 'vscode';
+import { getGlobalVirtualFileSystem } from '../core/VirtualFileSystem';
 import type { InheritDirective, IncludeDirective } from '../semantic/documentSemanticTypes';
 import { assertAnalysisService } from '../semantic/assertAnalysisService';
 import type { DocumentAnalysisService } from '../semantic/documentAnalysisService';
@@ -17,6 +17,7 @@ export class SimulatedEfunScanner {
     private readonly workspaceStates = new Map<string, SimulatedEfunWorkspaceState>();
     private readonly analysisService: SimulatedEfunAnalysisService;
     private readonly documentationService: FunctionDocumentationService;
+    private readonly fileSystem = getGlobalVirtualFileSystem();
     private activeWorkspaceStateKey: string | undefined;
 
     constructor(
@@ -210,7 +211,11 @@ export class SimulatedEfunScanner {
 
             visited.add(normalized);
 
-            const text = await fs.promises.readFile(currentFile, 'utf8');
+            const text = await this.fileSystem.readFileAsync(currentFile);
+            if (text === undefined) {
+                continue;
+            }
+
             this.storeParsedDocs(currentFile, text, docs);
 
             const relatedFiles = this.extractRelatedSourceFiles(currentFile, text, mudlibRoot);
@@ -309,17 +314,11 @@ export class SimulatedEfunScanner {
     }
 
     private resolveExistingCodePath(targetPath: string): string {
-        if (fs.existsSync(targetPath) || path.extname(targetPath)) {
+        if (path.extname(targetPath) || this.fileSystem.exists(targetPath)) {
             return targetPath;
         }
 
-        for (const candidate of [`${targetPath}.c`, `${targetPath}.h`]) {
-            if (fs.existsSync(candidate)) {
-                return candidate;
-            }
-        }
-
-        return targetPath;
+        return this.fileSystem.findFirstExisting([`${targetPath}.c`, `${targetPath}.h`]) ?? targetPath;
     }
 
     private resolveWorkspacePath(workspaceRoot: string, targetPath: string): string {
@@ -440,13 +439,7 @@ export class SimulatedEfunScanner {
             ? [resolvedBase]
             : [resolvedBase, ...extensions.map((extension) => `${resolvedBase}${extension}`)];
 
-        for (const candidate of candidates) {
-            if (fs.existsSync(candidate)) {
-                return candidate;
-            }
-        }
-
-        return undefined;
+        return this.fileSystem.findFirstExisting(candidates);
     }
 
     private getWorkspaceRoot(
@@ -0,0 +1,217 @@
+import {
+    getGlobalMemoryBudgetGovernor,
+    MemoryBudgetGovernor,
+    MemoryBudgetRegistration
+} from '../core/MemoryBudgetGovernor';
+import { getGlobalVirtualFileSystem, VirtualFileStat, VirtualFileSystem } from '../core/VirtualFileSystem';
+import { PreprocessorScanner } from './PreprocessorScanner';
+import { MacroDefinitionFact, PreprocessorSnapshot } from './types';
+
+export interface HeaderSnapshot {
+    readonly uri: string;
+    readonly path: string;
+    readonly mtimeMs: number;
+    readonly size: number;
+    readonly text: string;
+    readonly scanned: PreprocessorSnapshot;
+}
+
+interface HeaderSnapshotEntry {
+    readonly snapshot: HeaderSnapshot;
+    readonly bytes: number;
+    lastAccessed: number;
+}
+
+interface HeaderMacroSetEntry {
+    readonly macros: MacroDefinitionFact[];
+    readonly dependencies: readonly HeaderSnapshot[];
+}
+
+const DEFAULT_MAX_HEADER_SNAPSHOTS = 512;
+const DEFAULT_MAX_MACRO_SETS = 64;
+/** 指令扫描结果的估算字节数（每条指令） */
+const HEADER_DIRECTIVE_BYTES = 128;
+/** 头文件只需读盘并重新扫描，重建代价最低 */
+const HEADER_REBUILD_COST = 1;
+
+/**
+ * 进程级头文件快照缓存：按路径 + mtime/size 复用头文件文本与指令扫描结果，
+ * 并缓存由这些头文件推导出的宏集合。依赖的任一头文件变化后条目自动失效。
+ * stat 与读盘都经过 `VirtualFileSystem`，接入文件监听后头文件查询不再逐次访问磁盘。
+ */
+export class HeaderSnapshotCache {
+    private readonly snapshots = new Map<string, HeaderSnapshotEntry>();
+    private readonly macroSets = new Map<string, HeaderMacroSetEntry>();
+    private snapshotBytes = 0;
+    private memoryBudget?: MemoryBudgetRegistration;
+
+    constructor(
+        private readonly scanner: PreprocessorScanner = new PreprocessorScanner(),
+        private readonly maxHeaderSnapshots: number = DEFAULT_MAX_HEADER_SNAPSHOTS,
+        private readonly maxMacroSets: number = DEFAULT_MAX_MACRO_SETS,
+        private readonly fileSystem: Pick<VirtualFileSystem, 'stat' | 'readFile'> = getGlobalVirtualFileSystem()
+    ) {}
+
+    public getHeader(headerUri: string, headerPath: string): HeaderSnapshot | undefined {
+        const key = normalizeHeaderKey(headerPath);
+        const stats = this.statFile(headerPath);
+        if (!stats) {
+            this.deleteSnapshot(key);
+            return undefined;
+        }
+
+        const cached = this.snapshots.get(key);
+        if (cached && cached.snapshot.mtimeMs === stats.mtimeMs && cached.snapshot.size === stats.size) {
+            // 重新插入以维持 Map 的最近使用顺序。
+            cached.lastAccessed = Date.now();
+            this.snapshots.delete(key);
+            this.snapshots.set(key, cached);
+            return cached.snapshot;
+        }
+
+        const text = this.fileSystem.readFile(headerPath);
+        if (text === undefined) {
+            this.deleteSnapshot(key);
+            return undefined;
+        }
+
+        const snapshot: HeaderSnapshot = {
+            uri: headerUri,
+            path: headerPath,
+            mtimeMs: stats.mtimeMs,
+            size: stats.size,
+            text,
+            scanned: this.scanner.scan(headerUri, 1, text)
+        };
+        this.deleteSnapshot(key);
+        const bytes = text.length * 2 + snapshot.scanned.directives.length * HEADER_DIRECTIVE_BYTES;
+        this.snapshots.set(key, { snapshot, bytes, lastAccessed: Date.now() });
+        this.snapshotBytes += bytes;
+        while (this.snapshots.size > this.maxHeaderSnapshots) {
+            this.deleteSnapshot(this.snapshots.keys().next().value as string);
+        }
+        this.memoryBudget?.notifyGrowth();
+        return snapshot;
+    }
+
+    /**
+     * 读取缓存的宏集合；给出 `dependencies` 时把该集合依赖的头文件快照追加进去。
+     */
+    public getMacroSet(key: string, dependencies?: HeaderSnapshot[]): MacroDefinitionFact[] | undefined {
+        const entry = this.macroSets.get(key);
+        if (!entry) {
+            return undefined;
+        }
+
+        if (!this.areCurrent(entry.dependencies)) {
+            this.macroSets.delete(key);
+            return undefined;
+        }
+
+        this.macroSets.delete(key);
+        this.macroSets.set(key, entry);
+        dependencies?.push(...entry.dependencies);
+        return entry.macros;
+    }
+
+    /**
+     * 这些头文件快照是否仍与磁盘一致（按 mtime/size 判断）
+     */
+    public areCurrent(dependencies: readonly HeaderSnapshot[]): boolean {
+        for (const dependency of dependencies) {
+            const stats = this.statFile(dependency.path);
+            if (!stats || stats.mtimeMs !== dependency.mtimeMs || stats.size !== dependency.size) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    public setMacroSet(key: string, macros: MacroDefinitionFact[], dependencies: readonly HeaderSnapshot[]): void {
+        this.macroSets.delete(key);
+        this.macroSets.set(key, { macros, dependencies: [...dependencies] });
+        this.evictOldest(this.macroSets, this.maxMacroSets);
+    }
+
+    public invalidate(headerPath: string): void {
+        const key = normalizeHeaderKey(headerPath);
+        this.deleteSnapshot(key);
+
+        for (const [macroSetKey, entry] of Array.from(this.macroSets.entries())) {
+            if (entry.dependencies.some((dependency) => normalizeHeaderKey(dependency.path) === key)) {
+                this.macroSets.delete(macroSetKey);
+            }
+        }
+    }
+
+    public clear(): void {
+        this.snapshots.clear();
+        this.macroSets.clear();
+        this.snapshotBytes = 0;
+    }
+
+    /**
+     * 向统一内存预算登记头文件快照。宏集合只持有快照引用，不单独计量。
+     */
+    public attachMemoryBudget(governor: MemoryBudgetGovernor): MemoryBudgetRegistration {
+        this.memoryBudget?.unregister();
+        this.memoryBudget = governor.register({
+            name: 'headerSnapshots',
+            rebuildCost: HEADER_REBUILD_COST,
+            getUsage: () => ({ entries: this.snapshots.size, bytes: this.snapshotBytes }),
+            peekColdest: () => {
+                const coldest = this.snapshots.entries().next();
+                if (coldest.done) {
+                    return undefined;
+                }
+
+                const [key, entry] = coldest.value;
+                return { key, bytes: entry.bytes, lastAccessed: entry.lastAccessed };
+            },
+            evict: (key) => this.deleteSnapshot(key)
+        });
+        return this.memoryBudget;
+    }
+
+    private statFile(filePath: string): VirtualFileStat | undefined {
+        const stats = this.fileSystem.stat(filePath);
+        return stats?.isFile ? stats : undefined;
+    }
+
+    private deleteSnapshot(key: string): number {
+        const entry = this.snapshots.get(key);
+        if (!entry) {
+            return 0;
+        }
+
+        this.snapshots.delete(key);
+        this.snapshotBytes -= entry.bytes;
+        return entry.bytes;
+    }
+
+    private evictOldest<T>(entries: Map<string, T>, maxEntries: number): void {
+        while (entries.size > maxEntries) {
+            const oldestKey = entries.keys().next().value as string;
+            entries.delete(oldestKey);
+        }
+    }
+}
+
+function normalizeHeaderKey(filePath: string): string {
+    return filePath
+        .replace(/\\/g, '/')
+        .replace(/^\/+([A-Za-z]:\/)/, '$1')
+        .replace(/^([A-Za-z]):/, (_match, drive: string) => `${drive.toLowerCase()}:`);
+}
+
+let globalHeaderSnapshotCache: HeaderSnapshotCache | undefined;
+
+export function getGlobalHeaderSnapshotCache(): HeaderSnapshotCache {
+    if (!globalHeaderSnapshotCache) {
+        globalHeaderSnapshotCache = new HeaderSnapshotCache();
+        globalHeaderSnapshotCache.attachMemoryBudget(getGlobalMemoryBudgetGovernor());
+    }
+
+    return globalHeaderSnapshotCache;
+}
@@ -1,5 +1,5 @@
-import * as fs from 'fs';
 import * as vscode from 'vscode';
+import { getGlobalVirtualFileSystem, VirtualFileSystem } from '../core/VirtualFileSystem';
 import {
     IncludeGraph,
     IncludeReferenceFact,
@@ -16,21 +16,25 @@ export interface IncludeResolutionResult {
 export interface IncludeResolverOptions {
     includeDirectories?: string[];
     workspaceRoot?: string;
+    fileSystem?: VirtualFileSystem;
 }
 
 export class IncludeResolver {
     private readonly includeDirectories: string[];
     private readonly workspaceRoot: string | undefined;
+    private readonly fileSystem: VirtualFileSystem;
 
     constructor(options: IncludeResolverOptions | string[] = {}) {
         if (Array.isArray(options)) {
             this.includeDirectories = options;
             this.workspaceRoot = undefined;
+            this.fileSystem = getGlobalVirtualFileSystem();
             return;
         }
 
         this.includeDirectories = options.includeDirectories ?? [];
         this.workspaceRoot = options.workspaceRoot;
+        this.fileSystem = options.fileSystem ?? getGlobalVirtualFileSystem();
     }
 
     public resolve(
@@ -80,7 +84,7 @@ export class IncludeResolver {
             includeDirectories: this.includeDirectories,
             allowAncestorFallback: true
         });
-        return candidates.find((candidate) => fs.existsSync(candidate));
+        return this.fileSystem.findFirstExisting(candidates);
     }
 }
 
@@ -1,9 +1,17 @@
 import * as vscode from 'vscode';
-import * as fs from 'fs';
 import * as path from 'path';
+import { ContentAddressedCache } from '../core/ContentAddressedCache';
+import { getGlobalVirtualFileSystem, VirtualFileSystem } from '../core/VirtualFileSystem';
+import {
+    getGlobalMemoryBudgetGovernor,
+    MemoryBudgetGovernor,
+    MemoryBudgetRegistration
+} from '../core/MemoryBudgetGovernor';
 import { ActiveSourceBuilder } from './ActiveSourceBuilder';
 import { createDefaultFluffOSDialectProfile } from './dialect';
+import { getGlobalHeaderSnapshotCache, HeaderSnapshot, HeaderSnapshotCache } from './HeaderSnapshotCache';
 import { IncludeResolver } from './IncludeResolver';
+import { MacroEnvironment } from './MacroEnvironment';
 import { MacroExpansionBuilder } from './MacroExpansionBuilder';
 import { MacroFactResolver } from './MacroFactResolver';
 import { PreprocessorConditionEvaluator } from './PreprocessorConditionEvaluator';
@@ -15,8 +23,28 @@ import { getDocumentWorkspaceProjectConfig } from '../language/shared/documentWo
 export interface LpcFrontendServiceOptions {
     dialect?: LpcDialectProfile;
     includeDirectories?: string[];
+    headerCache?: HeaderSnapshotCache;
+    fileSystem?: VirtualFileSystem;
 }
 
+interface FrontendSnapshotEntry {
+    readonly snapshot: LpcFrontendSnapshot;
+    readonly bytes: number;
+    lastAccessed: number;
+}
+
+/** 内容寻址层的条目：复用前核对预处理配置与所依赖头文件是否变化 */
+interface FrontendContentEntry {
+    readonly snapshot: LpcFrontendSnapshot;
+    readonly configKey: string;
+    readonly dependencies: readonly HeaderSnapshot[];
+}
+
+/** 宏定义、宏引用等事实对象的估算字节数 */
+const FRONTEND_FACT_BYTES = 128;
+/** 相对其他分析层，重建一个预处理快照的代价 */
+const FRONTEND_REBUILD_COST = 2;
+
 interface ConfiguredPreprocessorConfig {
     includeDirectories: string[];
     globalIncludeFile?: string;
@@ -24,7 +52,15 @@ interface ConfiguredPreprocessorConfig {
 }
 
 export class LpcFrontendService {
-    private readonly snapshots = new Map<string, LpcFrontendSnapshot>();
+    /** 每个文档只保留最新版本的快照；Map 顺序即最近使用顺序 */
+    private readonly snapshots = new Map<string, FrontendSnapshotEntry>();
+    private snapshotBytes = 0;
+    /** 跨版本复用：文本未变时直接沿用旧快照 */
+    private readonly contentSnapshots = new ContentAddressedCache<FrontendContentEntry>(
+        undefined,
+        (entry) => estimateFrontendSnapshotBytes(entry.snapshot)
+    );
+    private memoryBudget?: MemoryBudgetRegistration;
     private readonly scanner = new PreprocessorScanner();
     private readonly conditionEvaluator = new PreprocessorConditionEvaluator();
     private readonly activeSourceBuilder = new ActiveSourceBuilder();
@@ -32,39 +68,61 @@ export class LpcFrontendService {
     private readonly macroExpansionBuilder = new MacroExpansionBuilder();
     private readonly dialect: LpcDialectProfile;
     private readonly includeDirectories: string[];
+    private readonly headerCache: HeaderSnapshotCache;
+    private readonly fileSystem: VirtualFileSystem;
     private readonly configuredPreprocessorConfigCache = new Map<string, ConfiguredPreprocessorConfig>();
+    /** 按 preprocessorDefines 缓存的配置宏环境 */
+    private readonly configuredMacroEnvironments = new Map<string, MacroEnvironment>();
+    /** 全局 include 宏集合（由头文件缓存持有）到“配置宏 + 全局宏”前导环境的映射 */
+    private readonly preludeEnvironments = new WeakMap<MacroDefinitionFact[], MacroEnvironment>();
 
     constructor(options: LpcFrontendServiceOptions = {}) {
         this.dialect = options.dialect ?? createDefaultFluffOSDialectProfile();
         this.includeDirectories = options.includeDirectories ?? [];
+        this.headerCache = options.headerCache ?? getGlobalHeaderSnapshotCache();
+        this.fileSystem = options.fileSystem ?? getGlobalVirtualFileSystem();
     }
 
     public get(document: vscode.TextDocument): LpcFrontendSnapshot {
-        const cacheKey = `${document.uri.toString()}@${document.version}`;
+        const cacheKey = document.uri.toString();
         const cached = this.snapshots.get(cacheKey);
-        if (cached) {
-            return cached;
+        if (cached?.snapshot.version === document.version) {
+            cached.lastAccessed = Date.now();
+            this.snapshots.delete(cacheKey);
+            this.snapshots.set(cacheKey, cached);
+            return cached.snapshot;
         }
 
         const text = document.getText();
-        const scanned = this.scanner.scan(document.uri.toString(), document.version, text);
         const preprocessorConfig = this.getPreprocessorConfigForDocument(document);
-        const includeResolver = new IncludeResolver(preprocessorConfig);
-        const configuredMacros = this.createConfiguredMacroFacts(preprocessorConfig.preprocessorDefines);
+        const configKey = createPreprocessorConfigKey(preprocessorConfig);
+        const reusable = this.contentSnapshots.get(
+            cacheKey,
+            text,
+            (entry) => entry.configKey === configKey && this.headerCache.areCurrent(entry.dependencies)
+        );
+        if (reusable) {
+            return this.storeSnapshot(cacheKey, rebindFrontendSnapshot(reusable.snapshot, document.version));
+        }
+
+        const scanned = this.scanner.scan(document.uri.toString(), document.version, text);
+        const includeResolver = new IncludeResolver({ ...preprocessorConfig, fileSystem: this.fileSystem });
         const includes = includeResolver.resolve(document.uri.toString(), scanned.includeReferences);
-        const globalIncludeMacros = this.collectGlobalIncludeMacros(
+        const dependencies: HeaderSnapshot[] = [];
+        const preludeMacros = this.getPreludeEnvironment(
             document.uri.toString(),
-            preprocessorConfig.globalIncludeFile,
+            preprocessorConfig,
             includeResolver,
-            configuredMacros
+            dependencies
         );
         const includeMacros = this.collectIncludeMacros(
             includes.includeReferences,
             includeResolver,
             new Set(),
-            [...configuredMacros, ...globalIncludeMacros]
+            preludeMacros,
+            dependencies
         );
-        const initialMacros = [...configuredMacros, ...globalIncludeMacros, ...includeMacros];
+        const initialMacros = preludeMacros.extend(includeMacros);
         const conditional = this.conditionEvaluator.evaluate(text, scanned.directives, initialMacros);
         const macroFacts = this.macroFactResolver.resolve(
             text,
@@ -76,7 +134,7 @@ export class LpcFrontendService {
         const activeView = this.macroExpansionBuilder.expand(
             this.activeSourceBuilder.build(text, scanned.directives, conditional.inactiveRanges),
             macroFacts.macroReferences,
-            macroFacts.activeMacros
+            macroFacts.macroScope
         );
         const preprocessor = {
             ...scanned,
@@ -98,22 +156,97 @@ export class LpcFrontendService {
             createdAt: Date.now()
         };
 
-        this.snapshots.set(cacheKey, snapshot);
-        return snapshot;
+        // 未解析的 include 可能因新建文件而改变结果，这类快照不进入内容寻址层。
+        if (includes.includeReferences.every((include) => include.resolvedUri)) {
+            this.contentSnapshots.set(cacheKey, text, { snapshot, configKey, dependencies });
+        }
+
+        return this.storeSnapshot(cacheKey, snapshot);
     }
 
-    public invalidate(uri: vscode.Uri): void {
-        const uriText = uri.toString();
-        for (const key of Array.from(this.snapshots.keys())) {
-            if (key.startsWith(`${uriText}@`)) {
-                this.snapshots.delete(key);
-            }
+    /**
+     * 丢弃内容寻址层的全部条目。新建的文件若位于 include 搜索路径中更靠前的位置，
+     * 会改变从未引用过它的文档的解析结果；条目命中时只核对已解析头文件的 mtime，察觉不到这种变化。
+     */
+    public discardContentSnapshots(): void {
+        this.contentSnapshots.clear();
+    }
+
+    /**
+     * 失效某文档的当前快照。内容寻址层的条目在命中时会自行核对配置与头文件，
+     * 默认保留；`discardContentEntries` 为 true 时一并丢弃，强制下次完整重建。
+     */
+    public invalidate(uri: vscode.Uri, discardContentEntries: boolean = false): void {
+        this.deleteSnapshot(uri.toString());
+        this.headerCache.invalidate(normalizeFsPath(uri.fsPath));
+        if (discardContentEntries) {
+            this.contentSnapshots.deleteUri(uri.toString());
         }
     }
 
+    /**
+     * 向统一内存预算登记预处理快照缓存；解析结果持有快照引用，驱逐时一并失效。
+     */
+    public attachMemoryBudget(governor: MemoryBudgetGovernor): MemoryBudgetRegistration {
+        this.memoryBudget?.unregister();
+        this.contentSnapshots.attachMemoryBudget(
+            governor,
+            'frontendSnapshotContent',
+            (uri, entry) => this.snapshots.get(uri)?.snapshot.preprocessor.activeView === entry.snapshot.preprocessor.activeView
+        );
+        this.memoryBudget = governor.register({
+            name: 'frontendSnapshots',
+            rebuildCost: FRONTEND_REBUILD_COST,
+            dependents: ['parsedDocuments'],
+            getUsage: () => ({ entries: this.snapshots.size, bytes: this.snapshotBytes }),
+            peekColdest: () => {
+                const coldest = this.snapshots.entries().next();
+                if (coldest.done) {
+                    return undefined;
+                }
+
+                const [key, entry] = coldest.value;
+                return { key, bytes: entry.bytes, lastAccessed: entry.lastAccessed, documentUri: key };
+            },
+            evict: (key) => this.evictSnapshot(key),
+            evictDocument: (uri) => this.evictSnapshot(uri)
+        });
+        return this.memoryBudget;
+    }
+
     public clear(): void {
         this.snapshots.clear();
+        this.contentSnapshots.clear();
+        this.snapshotBytes = 0;
         this.configuredPreprocessorConfigCache.clear();
+        this.configuredMacroEnvironments.clear();
+        this.headerCache.clear();
+    }
+
+    private storeSnapshot(cacheKey: string, snapshot: LpcFrontendSnapshot): LpcFrontendSnapshot {
+        this.deleteSnapshot(cacheKey);
+        const bytes = estimateFrontendSnapshotBytes(snapshot);
+        this.snapshots.set(cacheKey, { snapshot, bytes, lastAccessed: Date.now() });
+        this.snapshotBytes += bytes;
+        this.memoryBudget?.notifyGrowth();
+        return snapshot;
+    }
+
+    /** 预算驱逐要真正释放内存，内容寻址层对同一快照的引用也要去掉 */
+    private evictSnapshot(key: string): number {
+        this.contentSnapshots.deleteUri(key);
+        return this.deleteSnapshot(key);
+    }
+
+    private deleteSnapshot(key: string): number {
+        const entry = this.snapshots.get(key);
+        if (!entry) {
+            return 0;
+        }
+
+        this.snapshots.delete(key);
+        this.snapshotBytes -= entry.bytes;
+        return entry.bytes;
     }
 
     private getPreprocessorConfigForDocument(document: vscode.TextDocument): {
@@ -139,7 +272,7 @@ export class LpcFrontendService {
                     ...this.includeDirectories,
                     ...(attachedResolved.includeDirectories ?? [])
                         .map((includeDirectory) => this.resolveProjectPath(mudlibRoot, includeDirectory))
-                        .filter((includeDirectory) => fs.existsSync(includeDirectory))
+                        .filter((includeDirectory) => this.fileSystem.exists(includeDirectory))
                 ],
                 workspaceRoot,
                 globalIncludeFile: attachedResolved.globalIncludeFile,
@@ -176,13 +309,13 @@ export class LpcFrontendService {
 
     private findWorkspaceRoot(documentPath: string): string | undefined {
         const workspaceFolder = vscode.workspace.getWorkspaceFolder?.(vscode.Uri.file(documentPath));
-        if (workspaceFolder?.uri.fsPath && fs.existsSync(path.join(workspaceFolder.uri.fsPath, 'lpc-support.json'))) {
+        if (workspaceFolder?.uri.fsPath && this.fileSystem.exists(path.join(workspaceFolder.uri.fsPath, 'lpc-support.json'))) {
             return workspaceFolder.uri.fsPath;
         }
 
         let current = path.dirname(documentPath);
         while (true) {
-            if (fs.existsSync(path.join(current, 'lpc-support.json'))) {
+            if (this.fileSystem.exists(path.join(current, 'lpc-support.json'))) {
                 return current;
             }
 
@@ -197,12 +330,12 @@ export class LpcFrontendService {
 
     private readConfiguredPreprocessorConfig(workspaceRoot: string): ConfiguredPreprocessorConfig {
         const projectConfigPath = path.join(workspaceRoot, 'lpc-support.json');
-        if (!fs.existsSync(projectConfigPath)) {
+        if (!this.fileSystem.exists(projectConfigPath)) {
             return { includeDirectories: [], preprocessorDefines: [] };
         }
 
         try {
-            const projectConfig = JSON.parse(fs.readFileSync(projectConfigPath, 'utf8')) as {
+            const projectConfig = JSON.parse(this.fileSystem.readFile(projectConfigPath) ?? '{}') as {
                 configHellPath?: string;
                 preprocessorDefines?: unknown;
             };
@@ -214,16 +347,16 @@ export class LpcFrontendService {
             const configHellPath = path.isAbsolute(projectConfig.configHellPath)
                 ? projectConfig.configHellPath
                 : path.resolve(workspaceRoot, projectConfig.configHellPath);
-            if (!fs.existsSync(configHellPath)) {
+            if (!this.fileSystem.exists(configHellPath)) {
                 return { includeDirectories: [], preprocessorDefines };
             }
 
-            const resolved = parseConfigHell(fs.readFileSync(configHellPath, 'utf8'));
+            const resolved = parseConfigHell(this.fileSystem.readFile(configHellPath) ?? '');
             const mudlibRoot = this.resolveMudlibRoot(workspaceRoot, resolved.mudlibDirectory, projectConfig.configHellPath);
             return {
                 includeDirectories: (resolved.includeDirectories ?? [])
                     .map((includeDirectory) => this.resolveProjectPath(mudlibRoot, includeDirectory))
-                    .filter((includeDirectory) => fs.existsSync(includeDirectory)),
+                    .filter((includeDirectory) => this.fileSystem.exists(includeDirectory)),
                 globalIncludeFile: resolved.globalIncludeFile,
                 preprocessorDefines
             };
@@ -261,7 +394,8 @@ export class LpcFrontendService {
         includeReferences: IncludeReferenceFact[],
         includeResolver: IncludeResolver,
         visited: Set<string> = new Set(),
-        inheritedMacros: MacroDefinitionFact[] = []
+        inheritedMacros: MacroEnvironment = MacroEnvironment.EMPTY,
+        dependencies?: HeaderSnapshot[]
     ): MacroDefinitionFact[] {
         const macros: MacroDefinitionFact[] = [];
 
@@ -272,23 +406,24 @@ export class LpcFrontendService {
 
             visited.add(include.resolvedUri);
             const includeUri = vscode.Uri.parse(include.resolvedUri);
-            const includePath = normalizeFsPath(includeUri.fsPath);
-            if (!fs.existsSync(includePath)) {
+            const header = this.headerCache.getHeader(include.resolvedUri, normalizeFsPath(includeUri.fsPath));
+            if (!header) {
                 continue;
             }
 
-            const text = fs.readFileSync(includePath, 'utf8');
-            const scanned = this.scanner.scan(include.resolvedUri, 1, text);
+            dependencies?.push(header);
+            const { text, scanned } = header;
             const nestedIncludes = includeResolver.resolve(include.resolvedUri, scanned.includeReferences);
             const nestedMacros = this.collectIncludeMacros(
                 nestedIncludes.includeReferences,
                 includeResolver,
                 visited,
-                inheritedMacros
+                inheritedMacros,
+                dependencies
             );
             macros.push(...nestedMacros);
 
-            const availableMacros = [...inheritedMacros, ...nestedMacros];
+            const availableMacros = inheritedMacros.extend(nestedMacros);
             const conditional = this.conditionEvaluator.evaluate(text, scanned.directives, availableMacros);
             const facts = this.macroFactResolver.resolve(
                 text,
@@ -298,8 +433,8 @@ export class LpcFrontendService {
                 include.resolvedUri
             );
 
-            macros.push(...facts.activeMacros
-                .filter((macro) => !availableMacros.includes(macro))
+            // 只取该头文件自己定义（或重定义）的宏，继承的环境不必逐个头文件展开。
+            macros.push(...facts.definedMacros
                 .map((macro) => ({
                 ...macro,
                 sourceUri: macro.sourceUri ?? include.resolvedUri,
@@ -310,13 +445,55 @@ export class LpcFrontendService {
         return macros;
     }
 
+    /**
+     * 配置宏与全局 include 宏组成的前导环境。同一工作区的文档共享同一个不可变环境，
+     * 各文档的 include 宏与自身定义只在其上叠加，不再逐文档合并整份宏表。
+     */
+    private getPreludeEnvironment(
+        documentUri: string,
+        preprocessorConfig: {
+            includeDirectories: string[];
+            workspaceRoot?: string;
+            globalIncludeFile?: string;
+            preprocessorDefines: string[];
+        },
+        includeResolver: IncludeResolver,
+        dependencies: HeaderSnapshot[]
+    ): MacroEnvironment {
+        const configuredMacros = this.getConfiguredMacroEnvironment(preprocessorConfig.preprocessorDefines);
+        const globalIncludeMacros = this.collectGlobalIncludeMacros(
+            documentUri,
+            preprocessorConfig,
+            includeResolver,
+            configuredMacros,
+            dependencies
+        );
+        if (globalIncludeMacros.length === 0) {
+            return configuredMacros;
+        }
+
+        // 宏集合的缓存键包含配置宏名，同一集合总是叠加在等价的配置宏之上。
+        let prelude = this.preludeEnvironments.get(globalIncludeMacros);
+        if (!prelude) {
+            prelude = configuredMacros.extend(globalIncludeMacros);
+            this.preludeEnvironments.set(globalIncludeMacros, prelude);
+        }
+
+        return prelude;
+    }
+
     private collectGlobalIncludeMacros(
         documentUri: string,
-        globalIncludeFile: string | undefined,
+        preprocessorConfig: {
+            includeDirectories: string[];
+            workspaceRoot?: string;
+            globalIncludeFile?: string;
+        },
         includeResolver: IncludeResolver,
-        inheritedMacros: MacroDefinitionFact[]
+        inheritedMacros: MacroEnvironment,
+        dependencies?: HeaderSnapshot[]
     ): MacroDefinitionFact[] {
-        const implicitInclude = this.createImplicitGlobalIncludeReference(globalIncludeFile);
+        const implicitInclude = this.createImplicitGlobalIncludeReference(preprocessorConfig.globalIncludeFile);
         if (!implicitInclude) {
             return [];
         }
@@ -326,7 +503,35 @@ export class LpcFrontendService {
             return [];
         }
 
-        return this.collectIncludeMacros([resolved], includeResolver, new Set(), inheritedMacros);
+        // 全局 include 的宏集合只取决于入口文件、搜索路径和配置宏，同一工作区的文档可以直接复用。
+        const macroSetKey = [
+            resolved.resolvedUri,
+            preprocessorConfig.workspaceRoot ?? '',
+            ...preprocessorConfig.includeDirectories,
+            '|',
+            ...inheritedMacros.values().map((macro) => macro.name)
+        ].join('\n');
+        const cached = this.headerCache.getMacroSet(macroSetKey, dependencies);
+        if (cached) {
+            return cached;
+        }
+
+        const macroSetDependencies: HeaderSnapshot[] = [];
+        const macros = this.collectIncludeMacros([resolved], includeResolver, new Set(), inheritedMacros, macroSetDependencies);
+        this.headerCache.setMacroSet(macroSetKey, macros, macroSetDependencies);
+        dependencies?.push(...macroSetDependencies);
+        return macros;
+    }
+
+    private getConfiguredMacroEnvironment(defines: string[]): MacroEnvironment {
+        const key = defines.join('\n');
+        let environment = this.configuredMacroEnvironments.get(key);
+        if (!environment) {
+            environment = MacroEnvironment.from(this.createConfiguredMacroFacts(defines));
+            this.configuredMacroEnvironments.set(key, environment);
+        }
+
+        return environment;
     }
 
     private createConfiguredMacroFacts(defines: string[]): MacroDefinitionFact[] {
@@ -371,6 +576,44 @@ function normalizeFsPath(fsPath: string): string {
     return fsPath.replace(/^\/+([A-Za-z]:[\\/])/, '$1');
 }
 
+function createPreprocessorConfigKey(config: {
+    includeDirectories: string[];
+    workspaceRoot?: string;
+    globalIncludeFile?: string;
+    preprocessorDefines: string[];
+}): string {
+    return JSON.stringify([
+        config.workspaceRoot ?? '',
+        config.globalIncludeFile ?? '',
+        config.includeDirectories,
+        config.preprocessorDefines
+    ]);
+}
+
+/**
+ * 文本未变的新版本沿用旧快照的全部事实，只更新版本号
+ */
+function rebindFrontendSnapshot(snapshot: LpcFrontendSnapshot, version: number): LpcFrontendSnapshot {
+    if (snapshot.version === version) {
+        return snapshot;
+    }
+
+    return {
+        ...snapshot,
+        version,
+        preprocessor: { ...snapshot.preprocessor, version }
+    };
+}
+
+function estimateFrontendSnapshotBytes(snapshot: LpcFrontendSnapshot): number {
+    const { preprocessor } = snapshot;
+    const factCount = preprocessor.directives.length
+        + preprocessor.macros.length
+        + preprocessor.macroReferences.length
+        + preprocessor.activeView.sourceMap.length;
+    return (snapshot.text.length + preprocessor.activeView.text.length) * 2 + factCount * FRONTEND_FACT_BYTES;
+}
+
 function normalizePreprocessorDefines(value: unknown): string[] {
     if (!Array.isArray(value)) {
         return [];
@@ -387,6 +630,7 @@ let globalLpcFrontendService: LpcFrontendService | undefined;
 export function getGlobalLpcFrontendService(): LpcFrontendService {
     if (!globalLpcFrontendService) {
         globalLpcFrontendService = new LpcFrontendService();
+        globalLpcFrontendService.attachMemoryBudget(getGlobalMemoryBudgetGovernor());
     }
 
     return globalLpcFrontendService;
@@ -0,0 +1,165 @@
+import { MacroDefinitionFact } from './types';
+
+/**
+ * 按名称查找宏的只读视图。`Map` 本身满足该接口。
+ */
+export interface MacroLookup<T extends { name: string } = MacroDefinitionFact> {
+    readonly size: number;
+    get(name: string): T | undefined;
+    has(name: string): boolean;
+    values(): Iterable<T>;
+}
+
+/**
+ * 不可变的分层宏环境。配置宏与全局 include 的宏在工作区内只构建一次，
+ * 各文档的 include 宏作为新的一层叠加其上，父层按引用共享而不复制。
+ * 同名宏由上层覆盖；`values()` 的顺序与依次写入 `Map` 时一致。
+ */
+export class MacroEnvironment implements MacroLookup<MacroDefinitionFact> {
+    public static readonly EMPTY = new MacroEnvironment(undefined, new Map());
+
+    public readonly size: number;
+    private valuesCache: readonly MacroDefinitionFact[] | undefined;
+
+    private constructor(
+        private readonly parent: MacroEnvironment | undefined,
+        private readonly own: ReadonlyMap<string, MacroDefinitionFact>
+    ) {
+        let size = parent?.size ?? 0;
+        for (const name of own.keys()) {
+            if (!parent?.has(name)) {
+                size++;
+            }
+        }
+        this.size = size;
+    }
+
+    public static from(macros: readonly MacroDefinitionFact[]): MacroEnvironment {
+        return MacroEnvironment.EMPTY.extend(macros);
+    }
+
+    /**
+     * 返回叠加了 `macros` 的新环境；没有新宏时返回自身。
+     */
+    public extend(macros: readonly MacroDefinitionFact[]): MacroEnvironment {
+        if (macros.length === 0) {
+            return this;
+        }
+
+        const own = new Map<string, MacroDefinitionFact>();
+        for (const macro of macros) {
+            own.set(macro.name, macro);
+        }
+
+        return new MacroEnvironment(this.size === 0 ? undefined : this, own);
+    }
+
+    public get(name: string): MacroDefinitionFact | undefined {
+        return this.own.get(name) ?? this.parent?.get(name);
+    }
+
+    public has(name: string): boolean {
+        return this.own.has(name) || (this.parent?.has(name) ?? false);
+    }
+
+    public values(): readonly MacroDefinitionFact[] {
+        if (!this.valuesCache) {
+            const inherited = this.parent?.values() ?? [];
+            const values = inherited.map((macro) => this.own.get(macro.name) ?? macro);
+            for (const [name, macro] of this.own) {
+                if (!this.parent?.has(name)) {
+                    values.push(macro);
+                }
+            }
+            this.valuesCache = Object.freeze(values);
+        }
+
+        return this.valuesCache;
+    }
+}
+
+/**
+ * 单个文件处理期间的可变宏作用域：`#define` / `#undef` 只记录在本层，
+ * 底层环境保持不变（写时复制）。`values()` 的顺序与在底层 `Map` 副本上
+ * 执行同样的 set/delete 序列一致。
+ */
+export class MacroScope<T extends { name: string }> implements MacroLookup<T> {
+    /** `null` 表示在本作用域内被 `#undef` */
+    private readonly overrides = new Map<string, T | null>();
+    /** 先被删除、又重新定义的底层宏；按 `Map` 语义它们移到末尾 */
+    private readonly relocated = new Set<string>();
+    private sizeValue: number;
+
+    constructor(private readonly base: MacroLookup<T> = MacroEnvironment.EMPTY as unknown as MacroLookup<T>) {
+        this.sizeValue = base.size;
+    }
+
+    public get size(): number {
+        return this.sizeValue;
+    }
+
+    public get(name: string): T | undefined {
+        const override = this.overrides.get(name);
+        return override === undefined ? this.base.get(name) : override ?? undefined;
+    }
+
+    public has(name: string): boolean {
+        const override = this.overrides.get(name);
+        return override === undefined ? this.base.has(name) : override !== null;
+    }
+
+    public set(name: string, value: T): void {
+        if (!this.has(name)) {
+            this.sizeValue++;
+        }
+
+        if (this.overrides.get(name) === null) {
+            this.overrides.delete(name);
+            if (this.base.has(name)) {
+                this.relocated.add(name);
+            }
+        }
+
+        this.overrides.set(name, value);
+    }
+
+    public delete(name: string): boolean {
+        if (!this.has(name)) {
+            return false;
+        }
+
+        this.sizeValue--;
+        this.overrides.set(name, null);
+        return true;
+    }
+
+    /** 惰性遍历底层与本层的宏，不复制底层环境。 */
+    public *values(): IterableIterator<T> {
+        for (const macro of this.base.values()) {
+            const override = this.overrides.get(macro.name);
+            if (override === undefined) {
+                yield macro;
+            } else if (override !== null && !this.relocated.has(macro.name)) {
+                yield override;
+            }
+        }
+
+        for (const [name, override] of this.overrides) {
+            if (override !== null && (this.relocated.has(name) || !this.base.has(name))) {
+                yield override;
+            }
+        }
+    }
+
+    /** 本作用域自己定义（或重定义）且仍然有效的宏，按定义顺序；不遍历底层环境。 */
+    public definedValues(): T[] {
+        const values: T[] = [];
+        for (const override of this.overrides.values()) {
+            if (override !== null) {
+                values.push(override);
+            }
+        }
+
+        return values;
+    }
+}
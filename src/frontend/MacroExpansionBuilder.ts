@@ -5,17 +5,23 @@ import {
     PreprocessedSourceView,
     PreprocessorSourceMapEntry
 } from './types';
+import { MacroEnvironment, MacroLookup, MacroScope } from './MacroEnvironment';
+
+/** 每个宏定义最多缓存的不同实参组合数 */
+const MAX_EXPANSIONS_PER_MACRO = 32;
 
 export class MacroExpansionBuilder {
+    private readonly expansionCache = new MacroExpansionCache();
+
     public expand(
         activeView: PreprocessedSourceView,
         macroReferences: MacroReferenceFact[],
-        macros: MacroDefinitionFact[] = []
+        macros: MacroDefinitionFact[] | MacroLookup<MacroDefinitionFact> = []
     ): PreprocessedSourceView {
-        let text = activeView.text;
+        const output = new ReverseTextBuilder(activeView.text);
         const appliedExpansions: AppliedExpansion[] = [];
         const macroByName = buildMacroMap(macros, macroReferences);
-        const protectedRanges = collectDelimitedTextRanges(text);
+        const protectedRanges = collectDelimitedTextRanges(activeView.text);
         const sortedReferences = [...macroReferences]
             .sort((left, right) => right.startOffset - left.startOffset);
 
@@ -30,25 +36,34 @@ export class MacroExpansionBuilder {
             }
 
             if (macro.isFunctionLike) {
-                const expanded = this.tryExpandWholeLineInvocation(text, reference, macroByName)
-                    ?? this.tryExpandInlineInvocation(text, reference, macroByName);
+                // 调用必须写在同一行内，只需取出当前（已展开右侧引用后的）这一行来解析。
+                const line = output.lineAt(reference.startOffset);
+                const localReference = {
+                    ...reference,
+                    startOffset: reference.startOffset - line.offset,
+                    endOffset: reference.endOffset - line.offset
+                };
+                const expanded = this.tryExpandWholeLineInvocation(line.text, localReference, macroByName)
+                    ?? this.tryExpandInlineInvocation(line.text, localReference, macroByName);
                 if (!expanded) {
                     continue;
                 }
 
-                text = `${text.slice(0, expanded.originalStartOffset)}${expanded.replacementText}${text.slice(expanded.originalEndOffset)}`;
+                const originalStartOffset = expanded.originalStartOffset + line.offset;
+                const originalEndOffset = expanded.originalEndOffset + line.offset;
+                output.replace(originalStartOffset, originalEndOffset, expanded.replacementText);
                 appliedExpansions.push({
                     macroName: reference.name,
-                    originalStartOffset: expanded.originalStartOffset,
-                    originalEndOffset: expanded.originalEndOffset,
+                    originalStartOffset,
+                    originalEndOffset,
                     replacementText: expanded.replacementText
                 });
                 continue;
             }
 
-            if (isActiveIdentifierReference(text, reference)) {
-                const replacement = expandObjectMacroText(macro.replacement, macroByName);
-                text = `${text.slice(0, reference.startOffset)}${replacement}${text.slice(reference.endOffset)}`;
+            if (output.slice(reference.startOffset, reference.endOffset) === reference.name) {
+                const replacement = this.expandMacroText(macro, undefined, macroByName);
+                output.replace(reference.startOffset, reference.endOffset, replacement);
                 appliedExpansions.push({
                     macroName: reference.name,
                     originalStartOffset: reference.startOffset,
@@ -60,16 +75,40 @@ export class MacroExpansionBuilder {
 
         const expandedRanges = buildExpansionRanges(appliedExpansions);
         return {
-            text,
+            text: output.toString(),
             sourceMap: this.buildSourceMap(activeView, expandedRanges),
             expandedRanges
         };
     }
 
+    /**
+     * 展开宏的替换文本（函数式宏先代入实参）。结果按宏定义对象与实参缓存，
+     * 命中时核对展开过程中查过的标识符在当前宏表里仍解析到同一定义。
+     */
+    private expandMacroText(
+        macro: MacroDefinitionFact,
+        args: string[] | undefined,
+        macroByName: MacroLookup<MacroDefinitionFact>
+    ): string {
+        const argumentKey = args ? args.join('\u0000') : '';
+        const cached = this.expansionCache.get(macro, argumentKey, macroByName);
+        if (cached !== undefined) {
+            return cached;
+        }
+
+        const body = args && macro.parameters
+            ? expandFunctionMacroBody(macro.replacement, macro.parameters, args)
+            : macro.replacement;
+        const lookups = new Map<string, MacroDefinitionFact | undefined>();
+        const expanded = expandObjectMacroText(body, macroByName, new Set(), 0, lookups);
+        this.expansionCache.set(macro, argumentKey, expanded, lookups);
+        return expanded;
+    }
+
     private tryExpandWholeLineInvocation(
         text: string,
         reference: MacroReferenceFact,
-        macroByName: Map<string, MacroDefinitionFact>
+        macroByName: MacroLookup<MacroDefinitionFact>
     ): InlineExpansion | undefined {
         const macro = reference.resolved;
         if (!macro?.parameters) {
@@ -88,10 +127,7 @@ export class MacroExpansionBuilder {
             return undefined;
         }
 
-        const expandedBody = expandObjectMacroText(
-            expandFunctionMacroBody(macro.replacement, macro.parameters, args),
-            macroByName
-        );
+        const expandedBody = this.expandMacroText(macro, args, macroByName);
         return {
             originalStartOffset: lineStartOffset,
             originalEndOffset: lineEndOffset,
@@ -102,7 +138,7 @@ export class MacroExpansionBuilder {
     private tryExpandInlineInvocation(
         text: string,
         reference: MacroReferenceFact,
-        macroByName: Map<string, MacroDefinitionFact>
+        macroByName: MacroLookup<MacroDefinitionFact>
     ): InlineExpansion | undefined {
         const macro = reference.resolved;
         if (!macro?.parameters || !isActiveIdentifierReference(text, reference)) {
@@ -119,10 +155,7 @@ export class MacroExpansionBuilder {
             return undefined;
         }
 
-        const replacementText = expandObjectMacroText(
-            expandFunctionMacroBody(macro.replacement, macro.parameters, args),
-            macroByName
-        );
+        const replacementText = this.expandMacroText(macro, args, macroByName);
         return {
             originalStartOffset: reference.startOffset,
             originalEndOffset: invocation.endOffset,
@@ -183,6 +216,154 @@ interface InlineExpansion {
     replacementText: string;
 }
 
+interface CachedExpansion {
+    readonly text: string;
+    /** 展开时查过的标识符及其解析结果（undefined 表示当时不是宏） */
+    readonly lookups: ReadonlyArray<readonly [string, MacroDefinitionFact | undefined]>;
+}
+
+/**
+ * 以宏定义对象为键的展开缓存。共享前导环境里的定义（颜色码等）跨文档复用同一对象，
+ * 因而整个工作区只展开一次；定义对象被回收时缓存随之释放。
+ */
+class MacroExpansionCache {
+    private readonly entries = new WeakMap<MacroDefinitionFact, Map<string, CachedExpansion>>();
+
+    public get(
+        macro: MacroDefinitionFact,
+        argumentKey: string,
+        macroByName: MacroLookup<MacroDefinitionFact>
+    ): string | undefined {
+        const expansion = this.entries.get(macro)?.get(argumentKey);
+        if (!expansion) {
+            return undefined;
+        }
+
+        for (const [name, resolved] of expansion.lookups) {
+            if (macroByName.get(name) !== resolved) {
+                return undefined;
+            }
+        }
+
+        return expansion.text;
+    }
+
+    public set(
+        macro: MacroDefinitionFact,
+        argumentKey: string,
+        text: string,
+        lookups: Map<string, MacroDefinitionFact | undefined>
+    ): void {
+        let expansions = this.entries.get(macro);
+        if (!expansions) {
+            expansions = new Map();
+            this.entries.set(macro, expansions);
+        }
+
+        expansions.delete(argumentKey);
+        expansions.set(argumentKey, { text, lookups: Array.from(lookups) });
+        if (expansions.size > MAX_EXPANSIONS_PER_MACRO) {
+            expansions.delete(expansions.keys().next().value as string);
+        }
+    }
+}
+
+/**
+ * 自右向左应用替换的分块文本构建器。替换按起点降序进行：`boundary` 左侧仍是原文，
+ * 右侧已替换的内容按逆序分块保存，最后只拼接一次，避免每次替换都复制整段文本。
+ */
+class ReverseTextBuilder {
+    private boundary: number;
+    /** `boundary` 右侧的文本块，末尾元素紧邻 `boundary` */
+    private readonly tail: string[] = [];
+
+    constructor(private readonly source: string) {
+        this.boundary = source.length;
+    }
+
+    /** 当前文本中 `[start, end)` 的内容，`start` 不超过 `boundary` */
+    public slice(start: number, end: number): string {
+        if (end <= this.boundary) {
+            return this.source.slice(start, end);
+        }
+
+        return this.source.slice(start, this.boundary) + this.readTail(end - this.boundary, false);
+    }
+
+    /** 当前文本中 `offset` 所在行（不含换行符）及其行首偏移 */
+    public lineAt(offset: number): { text: string; offset: number } {
+        const lineStart = findLineStart(this.source, offset);
+        const newline = this.source.indexOf('\n', offset);
+        if (newline >= 0 && newline < this.boundary) {
+            return { text: this.source.slice(lineStart, newline), offset: lineStart };
+        }
+
+        return {
+            text: this.source.slice(lineStart, this.boundary) + this.readTail(Number.POSITIVE_INFINITY, true),
+            offset: lineStart
+        };
+    }
+
+    /** 用 `replacement` 替换当前文本的 `[start, end)`，`start` 不超过 `boundary` */
+    public replace(start: number, end: number, replacement: string): void {
+        if (end <= this.boundary) {
+            this.pushTail(this.source.slice(end, this.boundary));
+        } else {
+            this.dropTail(end - this.boundary);
+        }
+
+        this.pushTail(replacement);
+        this.boundary = start;
+    }
+
+    public toString(): string {
+        if (this.tail.length === 0) {
+            return this.source.slice(0, this.boundary);
+        }
+
+        const parts = [this.source.slice(0, this.boundary)];
+        for (let index = this.tail.length - 1; index >= 0; index--) {
+            parts.push(this.tail[index]);
+        }
+
+        return parts.join('');
+    }
+
+    private readTail(maxLength: number, stopAtNewline: boolean): string {
+        let result = '';
+        for (let index = this.tail.length - 1; index >= 0 && result.length < maxLength; index--) {
+            const chunk = this.tail[index];
+            const newline = stopAtNewline ? chunk.indexOf('\n') : -1;
+            if (newline >= 0) {
+                return result + chunk.slice(0, newline);
+            }
+
+            result += chunk;
+        }
+
+        return result.length > maxLength ? result.slice(0, maxLength) : result;
+    }
+
+    private pushTail(chunk: string): void {
+        if (chunk) {
+            this.tail.push(chunk);
+        }
+    }
+
+    private dropTail(length: number): void {
+        let remaining = length;
+        while (remaining > 0 && this.tail.length > 0) {
+            const chunk = this.tail.pop() as string;
+            if (chunk.length > remaining) {
+                this.tail.push(chunk.slice(remaining));
+                return;
+            }
+
+            remaining -= chunk.length;
+        }
+    }
+}
+
 function buildExpansionRanges(appliedExpansions: AppliedExpansion[]): MacroExpansionRange[] {
     const sorted = [...appliedExpansions]
         .sort((left, right) => left.originalStartOffset - right.originalStartOffset);
@@ -214,13 +395,11 @@ function buildExpansionRanges(appliedExpansions: AppliedExpansion[]): MacroExpan
 }
 
 function buildMacroMap(
-    macros: MacroDefinitionFact[],
+    macros: MacroDefinitionFact[] | MacroLookup<MacroDefinitionFact>,
     macroReferences: MacroReferenceFact[]
-): Map<string, MacroDefinitionFact> {
-    const result = new Map<string, MacroDefinitionFact>();
-    for (const macro of macros) {
-        result.set(macro.name, macro);
-    }
+): MacroLookup<MacroDefinitionFact> {
+    // 引用解析到的定义叠加在共享环境之上，不复制环境本身。
+    const result = new MacroScope<MacroDefinitionFact>(Array.isArray(macros) ? MacroEnvironment.from(macros) : macros);
     for (const reference of macroReferences) {
         if (reference.resolved) {
             result.set(reference.resolved.name, reference.resolved);
@@ -231,9 +410,10 @@ function buildMacroMap(
 
 function expandObjectMacroText(
     text: string,
-    macroByName: Map<string, MacroDefinitionFact>,
+    macroByName: MacroLookup<MacroDefinitionFact>,
     expanding: Set<string> = new Set(),
-    depth = 0
+    depth = 0,
+    lookups?: Map<string, MacroDefinitionFact | undefined>
 ): string {
     if (depth > 64 || macroByName.size === 0) {
         return text;
@@ -241,27 +421,29 @@ function expandObjectMacroText(
 
     return replaceCodeIdentifiers(text, (identifier) => {
         const macro = macroByName.get(identifier);
+        if (lookups && !lookups.has(identifier)) {
+            lookups.set(identifier, macro);
+        }
         if (!macro || macro.isFunctionLike || expanding.has(identifier)) {
             return identifier;
         }
 
         expanding.add(identifier);
-        const replacement = expandObjectMacroText(macro.replacement, macroByName, expanding, depth + 1);
+        const replacement = expandObjectMacroText(macro.replacement, macroByName, expanding, depth + 1, lookups);
         expanding.delete(identifier);
         return replacement;
     });
 }
 
 function replaceCodeIdentifiers(text: string, replaceIdentifier: (identifier: string) => string): string {
-    let result = '';
+    const parts: string[] = [];
+    let copiedUntil = 0;
     let index = 0;
 
     while (index < text.length) {
         const char = text[index];
         if (char === '"' || char === '\'') {
-            const end = consumeQuoted(text, index, char);
-            result += text.slice(index, end);
-            index = end;
+            index = consumeQuoted(text, index, char);
             continue;
         }
 
@@ -271,16 +453,25 @@ function replaceCodeIdentifiers(text: string, replaceIdentifier: (identifier: st
                 end += 1;
             }
 
-            result += replaceIdentifier(text.slice(index, end));
+            const identifier = text.slice(index, end);
+            const replacement = replaceIdentifier(identifier);
+            if (replacement !== identifier) {
+                parts.push(text.slice(copiedUntil, index), replacement);
+                copiedUntil = end;
+            }
             index = end;
             continue;
         }
 
-        result += char;
         index += 1;
     }
 
-    return result;
+    if (parts.length === 0) {
+        return text;
+    }
+
+    parts.push(text.slice(copiedUntil));
+    return parts.join('');
 }
 
 function consumeQuoted(text: string, start: number, quote: string): number {
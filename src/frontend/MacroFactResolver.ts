@@ -6,12 +6,18 @@ import {
     MacroUndefFact,
     PreprocessorDirective
 } from './types';
+import { MacroEnvironment, MacroLookup, MacroScope } from './MacroEnvironment';
 import { positionAt, stripReplacementComments } from './PreprocessorScanner';
 
 export interface MacroFactResolutionResult {
-    activeMacros: MacroDefinitionFact[];
+    /** 文件末尾仍生效的全部宏，含继承的环境；首次读取时才展开 */
+    readonly activeMacros: MacroDefinitionFact[];
+    /** 本文件自己定义（或重定义）且末尾仍生效的宏 */
+    definedMacros: MacroDefinitionFact[];
     macroReferences: MacroReferenceFact[];
     undefs: MacroUndefFact[];
+    /** 文件末尾仍生效的宏；叠加在传入的环境之上，供宏展开直接查找 */
+    macroScope: MacroLookup<MacroDefinitionFact>;
 }
 
 export class MacroFactResolver {
@@ -19,14 +25,14 @@ export class MacroFactResolver {
         text: string,
         directives: PreprocessorDirective[],
         inactiveRanges: InactiveRange[],
-        initialMacros: MacroDefinitionFact[] = [],
+        initialMacros: MacroDefinitionFact[] | MacroLookup<MacroDefinitionFact> = [],
         sourceUri?: string
     ): MacroFactResolutionResult {
         const lineStartOffsets = buildLineStartOffsets(text);
-        const activeMacros = new Map<string, MacroDefinitionFact>();
-        for (const macro of initialMacros) {
-            activeMacros.set(macro.name, macro);
-        }
+        // 共享的宏环境只读，本文件的 #define/#undef 写入自己的作用域。
+        const activeMacros = new MacroScope<MacroDefinitionFact>(
+            Array.isArray(initialMacros) ? MacroEnvironment.from(initialMacros) : initialMacros
+        );
         const macroReferences: MacroReferenceFact[] = [];
         const undefs: MacroUndefFact[] = [];
         let cursor = 0;
@@ -54,10 +60,15 @@ export class MacroFactResolver {
 
         this.collectReferences(text, lineStartOffsets, cursor, text.length, activeMacros, inactiveRanges, macroReferences);
 
+        let activeMacroValues: MacroDefinitionFact[] | undefined;
         return {
-            activeMacros: Array.from(activeMacros.values()),
+            get activeMacros() {
+                return activeMacroValues ??= Array.from(activeMacros.values());
+            },
+            definedMacros: activeMacros.definedValues(),
             macroReferences,
-            undefs
+            undefs,
+            macroScope: activeMacros
         };
     }
 
@@ -66,7 +77,7 @@ export class MacroFactResolver {
         lineStartOffsets: number[],
         startOffset: number,
         endOffset: number,
-        activeMacros: Map<string, MacroDefinitionFact>,
+        activeMacros: MacroLookup<MacroDefinitionFact>,
         inactiveRanges: InactiveRange[],
         macroReferences: MacroReferenceFact[]
     ): void {
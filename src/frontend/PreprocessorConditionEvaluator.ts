@@ -6,6 +6,7 @@ import {
     PreprocessorDiagnostic,
     PreprocessorDirective
 } from './types';
+import { MacroLookup, MacroScope } from './MacroEnvironment';
 import { positionAt } from './PreprocessorScanner';
 
 interface ConditionalFrame {
@@ -26,17 +27,13 @@ export class PreprocessorConditionEvaluator {
     public evaluate(
         text: string,
         directives: PreprocessorDirective[],
-        definedMacros: Array<string | MacroDefinitionFact> = []
+        definedMacros: Array<string | MacroDefinitionFact> | MacroLookup<MacroDefinitionFact> = []
     ): ConditionalEvaluationResult {
         const lineStartOffsets = buildLineStartOffsets(text);
-        const macroValues = new Map<string, MacroConditionValue>();
-        for (const macro of definedMacros) {
-            if (typeof macro === 'string') {
-                macroValues.set(macro, { name: macro, replacement: '1' });
-            } else {
-                macroValues.set(macro.name, { name: macro.name, replacement: macro.replacement });
-            }
-        }
+        // 传入的宏环境可能在整个工作区共享，这里只在其上叠加本文件的定义。
+        const macroValues = new MacroScope<MacroConditionValue>(
+            Array.isArray(definedMacros) ? createConditionValueLookup(definedMacros) : definedMacros
+        );
         const inactiveRanges: InactiveRange[] = [];
         const diagnostics: PreprocessorDiagnostic[] = [];
         const stack: ConditionalFrame[] = [];
@@ -104,7 +101,7 @@ export class PreprocessorConditionEvaluator {
         directive: PreprocessorDirective,
         stack: ConditionalFrame[],
         inactiveRanges: InactiveRange[],
-        macroValues: Map<string, MacroConditionValue>
+        macroValues: MacroLookup<MacroConditionValue>
     ): void {
         const parentActive = this.isCurrentActive(stack);
         const conditionActive = parentActive && this.evaluateDirectiveCondition(directive, macroValues);
@@ -131,7 +128,7 @@ export class PreprocessorConditionEvaluator {
         directive: PreprocessorDirective,
         stack: ConditionalFrame[],
         inactiveRanges: InactiveRange[],
-        macroValues: Map<string, MacroConditionValue>
+        macroValues: MacroLookup<MacroConditionValue>
     ): void {
         const frame = stack[stack.length - 1];
         if (!frame) {
@@ -248,7 +245,7 @@ export class PreprocessorConditionEvaluator {
         return stack.every((frame) => frame.branchActive);
     }
 
-    private evaluateDirectiveCondition(directive: PreprocessorDirective, macroValues: Map<string, MacroConditionValue>): boolean {
+    private evaluateDirectiveCondition(directive: PreprocessorDirective, macroValues: MacroLookup<MacroConditionValue>): boolean {
         const body = directive.body.trim();
         switch (directive.kind) {
             case 'ifdef':
@@ -264,7 +261,20 @@ export class PreprocessorConditionEvaluator {
     }
 }
 
-function evaluateConstantCondition(body: string, macroValues: Map<string, MacroConditionValue>): boolean {
+function createConditionValueLookup(definedMacros: Array<string | MacroDefinitionFact>): Map<string, MacroConditionValue> {
+    const macroValues = new Map<string, MacroConditionValue>();
+    for (const macro of definedMacros) {
+        if (typeof macro === 'string') {
+            macroValues.set(macro, { name: macro, replacement: '1' });
+        } else {
+            macroValues.set(macro.name, { name: macro.name, replacement: macro.replacement });
+        }
+    }
+
+    return macroValues;
+}
+
+function evaluateConstantCondition(body: string, macroValues: MacroLookup<MacroConditionValue>): boolean {
     const trimmed = body.trim();
     if (trimmed === '') {
         return false;
@@ -298,7 +308,7 @@ class ConditionExpressionParser {
 
     constructor(
         expression: string,
-        private readonly macroValues: Map<string, MacroConditionValue>
+        private readonly macroValues: MacroLookup<MacroConditionValue>
     ) {
         this.tokens = tokenizeConditionExpression(expression);
     }
@@ -0,0 +1,124 @@
+import { afterEach, describe, expect, jest, test } from '@jest/globals';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import * as vscode from 'vscode';
+import { VirtualFileSystem } from '../../core/VirtualFileSystem';
+import { HeaderSnapshotCache } from '../HeaderSnapshotCache';
+import { LpcFrontendService } from '../LpcFrontendService';
+import { PreprocessorScanner } from '../PreprocessorScanner';
+import { TestHelper } from '../../__tests__/utils/TestHelper';
+import { attachDocumentWorkspaceProjectConfig } from '../../language/shared/documentWorkspaceConfig';
+
+describe('HeaderSnapshotCache', () => {
+    let tempRoot: string | undefined;
+
+    afterEach(() => {
+        if (tempRoot) {
+            fs.rmSync(tempRoot, { recursive: true, force: true });
+            tempRoot = undefined;
+        }
+    });
+
+    test('reuses scanned headers until the file changes on disk', () => {
+        tempRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'lpc-header-cache-'));
+        const headerPath = path.join(tempRoot, 'ansi.h');
+        fs.writeFileSync(headerPath, '#define NOR "reset"\n', 'utf8');
+        const scanner = new PreprocessorScanner();
+        const scanSpy = jest.spyOn(scanner, 'scan');
+        const cache = new HeaderSnapshotCache(scanner);
+        const headerUri = vscode.Uri.file(headerPath).toString();
+
+        const first = cache.getHeader(headerUri, headerPath);
+        const second = cache.getHeader(headerUri, headerPath);
+
+        expect(second).toBe(first);
+        expect(scanSpy).toHaveBeenCalledTimes(1);
+
+        fs.writeFileSync(headerPath, '#define NOR "reset"\n#define HIY "yellow"\n', 'utf8');
+        const changed = cache.getHeader(headerUri, headerPath);
+
+        expect(changed).not.toBe(first);
+        expect(changed?.text).toContain('HIY');
+        expect(scanSpy).toHaveBeenCalledTimes(2);
+
+        cache.invalidate(headerPath);
+        cache.getHeader(headerUri, headerPath);
+        expect(scanSpy).toHaveBeenCalledTimes(3);
+
+        fs.rmSync(headerPath);
+        expect(cache.getHeader(headerUri, headerPath)).toBeUndefined();
+    });
+
+    test('reads headers through the watched file system until the watcher invalidates them', () => {
+        tempRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'lpc-header-cache-watched-'));
+        const headerPath = path.join(tempRoot, 'ansi.h');
+        fs.writeFileSync(headerPath, '#define NOR "reset"\n', 'utf8');
+        const fileSystem = new VirtualFileSystem({ watched: true });
+        const cache = new HeaderSnapshotCache(new PreprocessorScanner(), undefined, undefined, fileSystem);
+        const headerUri = vscode.Uri.file(headerPath).toString();
+
+        const first = cache.getHeader(headerUri, headerPath);
+        fs.writeFileSync(headerPath, '#define NOR "reset"\n#define HIY "yellow"\n', 'utf8');
+
+        expect(cache.getHeader(headerUri, headerPath)).toBe(first);
+        expect(fileSystem.getStats().statMisses).toBe(1);
+
+        fileSystem.invalidate(headerPath);
+        expect(cache.getHeader(headerUri, headerPath)?.text).toContain('HIY');
+    });
+
+    test('drops cached macro sets when a dependency header changes', () => {
+        tempRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'lpc-header-cache-'));
+        const headerPath = path.join(tempRoot, 'globals.h');
+        fs.writeFileSync(headerPath, '#define PROTOCOL_D "/adm/protocol"\n', 'utf8');
+        const cache = new HeaderSnapshotCache();
+        const header = cache.getHeader(vscode.Uri.file(headerPath).toString(), headerPath)!;
+        const macros = [{
+            name: 'PROTOCOL_D',
+            replacement: '"/adm/protocol"',
+            isFunctionLike: false,
+            source: 'include' as const,
+            startOffset: 0,
+            endOffset: 0,
+            range: new vscode.Range(0, 0, 0, 0)
+        }];
+
+        cache.setMacroSet('globals', macros, [header]);
+        expect(cache.getMacroSet('globals')).toBe(macros);
+
+        fs.writeFileSync(headerPath, '#define PROTOCOL_D "/adm/protocol_v2"\n', 'utf8');
+        expect(cache.getMacroSet('globals')).toBeUndefined();
+    });
+
+    test('shares global include macros across documents of the same workspace', () => {
+        tempRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'lpc-header-cache-global-'));
+        const includeDir = path.join(tempRoot, 'include');
+        fs.mkdirSync(includeDir, { recursive: true });
+        fs.writeFileSync(path.join(tempRoot, 'lpc-support.json'), JSON.stringify({ version: 1 }), 'utf8');
+        fs.writeFileSync(path.join(includeDir, 'globals.h'), '#include "ansi.h"\n#define PROTOCOL_D "/adm/protocol"\n', 'utf8');
+        fs.writeFileSync(path.join(includeDir, 'ansi.h'), '#define NOR "reset"\n', 'utf8');
+        const scanner = new PreprocessorScanner();
+        const scanSpy = jest.spyOn(scanner, 'scan');
+        const service = new LpcFrontendService({ headerCache: new HeaderSnapshotCache(scanner) });
+        const createDocument = (fileName: string) => attachDocumentWorkspaceProjectConfig(
+            TestHelper.createMockDocument('string reset = NOR;\n', 'lpc', path.join(tempRoot!, fileName)),
+            {
+                projectConfigPath: path.join(tempRoot!, 'lpc-support.json'),
+                configHellPath: 'config.hell',
+                resolvedConfig: {
+                    mudlibDirectory: './',
+                    includeDirectories: ['/include'],
+                    globalIncludeFile: '<globals.h>'
+                }
+            }
+        );
+
+        const first = service.get(createDocument('room.c'));
+        const second = service.get(createDocument('npc.c'));
+
+        expect(first.preprocessor.activeView.text).toContain('string reset = "reset";');
+        expect(second.preprocessor.activeView.text).toContain('string reset = "reset";');
+        expect(scanSpy).toHaveBeenCalledTimes(2);
+    });
+});
@@ -53,6 +53,26 @@ describe('LpcFrontendService', () => {
         expect(second).toBe(first);
     });
 
+    test('reuses the snapshot for a newer version whose text did not change', () => {
+        const document = TestHelper.createMockDocument('#define FOO 1\nint value = FOO;', 'lpc', 'content-reuse.c');
+        const service = new LpcFrontendService();
+
+        const first = service.get(document);
+        const bumped = service.get({ ...document, version: 2 } as vscode.TextDocument);
+        const edited = service.get({
+            ...document,
+            version: 3,
+            getText: () => '#define FOO 2\nint value = FOO;'
+        } as vscode.TextDocument);
+        const undone = service.get({ ...document, version: 4 } as vscode.TextDocument);
+
+        expect(bumped.version).toBe(2);
+        expect(bumped.preprocessor.activeView).toBe(first.preprocessor.activeView);
+        expect(edited.preprocessor.activeView.text).toContain('int value = 2;');
+        expect(undone.version).toBe(4);
+        expect(undone.preprocessor.activeView).toBe(first.preprocessor.activeView);
+    });
+
     test('imports include macros into conditional evaluation and macro expansion', () => {
         tempRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'lpc-frontend-include-'));
         const includeDir = path.join(tempRoot, 'include');
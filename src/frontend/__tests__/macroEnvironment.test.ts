@@ -0,0 +1,81 @@
+import { describe, expect, test } from '@jest/globals';
+import * as vscode from 'vscode';
+import { MacroEnvironment, MacroScope } from '../MacroEnvironment';
+import { MacroFactResolver } from '../MacroFactResolver';
+import { PreprocessorConditionEvaluator } from '../PreprocessorConditionEvaluator';
+import { PreprocessorScanner } from '../PreprocessorScanner';
+import { MacroDefinitionFact } from '../types';
+
+function createMacro(name: string, replacement: string): MacroDefinitionFact {
+    return {
+        name,
+        replacement,
+        isFunctionLike: false,
+        source: 'include',
+        startOffset: 0,
+        endOffset: 0,
+        range: new vscode.Range(0, 0, 0, 0)
+    };
+}
+
+describe('MacroEnvironment', () => {
+    test('layers macros over a shared parent without copying it', () => {
+        const prelude = MacroEnvironment.from([createMacro('NOR', '"reset"'), createMacro('HIR', '"red"')]);
+        const documentLayer = prelude.extend([createMacro('HIR', '"bright red"'), createMacro('ROOM_D', '"/d/room"')]);
+
+        expect(prelude.extend([])).toBe(prelude);
+        expect(prelude.get('HIR')?.replacement).toBe('"red"');
+        expect(documentLayer.get('HIR')?.replacement).toBe('"bright red"');
+        expect(documentLayer.get('NOR')).toBe(prelude.get('NOR'));
+        expect(documentLayer.size).toBe(3);
+        expect(documentLayer.values().map((macro) => macro.name)).toEqual(['NOR', 'HIR', 'ROOM_D']);
+    });
+
+    test('keeps scope edits local and orders values like a copied Map', () => {
+        const base = MacroEnvironment.from([createMacro('A', '1'), createMacro('B', '2'), createMacro('C', '3')]);
+        const scope = new MacroScope(base);
+        const expected = new Map(base.values().map((macro): [string, MacroDefinitionFact] => [macro.name, macro]));
+        const apply = (name: string, macro?: MacroDefinitionFact): void => {
+            if (macro) {
+                scope.set(name, macro);
+                expected.set(name, macro);
+            } else {
+                scope.delete(name);
+                expected.delete(name);
+            }
+        };
+
+        apply('B', createMacro('B', '20'));
+        apply('A');
+        apply('D', createMacro('D', '4'));
+        apply('A', createMacro('A', '10'));
+        apply('C');
+
+        expect(Array.from(scope.values())).toEqual(Array.from(expected.values()));
+        expect(scope.definedValues().map((macro) => macro.replacement)).toEqual(['20', '4', '10']);
+        expect(scope.size).toBe(expected.size);
+        expect(base.get('A')?.replacement).toBe('1');
+        expect(base.has('C')).toBe(true);
+    });
+
+    test('lets evaluators and resolvers read a shared environment directly', () => {
+        const text = [
+            '#ifdef USE_COLOR',
+            '#undef NOR',
+            '#define LOCAL_D "/d/local"',
+            '#endif',
+            'string dest = LOCAL_D;',
+            'string color = NOR;'
+        ].join('\n');
+        const environment = MacroEnvironment.from([createMacro('USE_COLOR', ''), createMacro('NOR', '"reset"')]);
+        const scanned = new PreprocessorScanner().scan('file:///shared-env.c', 1, text);
+        const conditional = new PreprocessorConditionEvaluator().evaluate(text, scanned.directives, environment);
+        const result = new MacroFactResolver().resolve(text, scanned.directives, conditional.inactiveRanges, environment);
+
+        expect(conditional.inactiveRanges).toEqual([]);
+        expect(result.activeMacros.map((macro) => macro.name)).toEqual(['USE_COLOR', 'LOCAL_D']);
+        expect(result.definedMacros.map((macro) => macro.name)).toEqual(['LOCAL_D']);
+        expect(result.macroReferences.map((reference) => reference.name)).toEqual(['LOCAL_D']);
+        expect(environment.has('NOR')).toBe(true);
+    });
+});
@@ -1,9 +1,11 @@
 import { afterAll, afterEach, beforeAll, beforeEach, describe, expect, jest, test } from '@jest/globals';
+import * as vscode from 'vscode';
 import { ActiveSourceBuilder } from '../ActiveSourceBuilder';
 import { MacroExpansionBuilder } from '../MacroExpansionBuilder';
 import { MacroFactResolver } from '../MacroFactResolver';
 import { PreprocessorConditionEvaluator } from '../PreprocessorConditionEvaluator';
 import { PreprocessorScanner } from '../PreprocessorScanner';
+import { MacroDefinitionFact } from '../types';
 
 describe('MacroExpansionBuilder', () => {
     test('expands whole-line function-like macro invocations with token paste and records expansion ranges', () => {
@@ -174,4 +176,26 @@ describe('MacroExpansionBuilder', () => {
         expect(expanded.text).toContain('LONG );');
         expect(expanded.text).not.toContain('@16');
     });
+
+    test('reuses cached expansions of shared definitions only while nested macros still resolve the same way', () => {
+        const sharedMacros: MacroDefinitionFact[] = [
+            { name: 'ESC', replacement: '"\\e"', isFunctionLike: false, source: 'include', startOffset: 0, endOffset: 0, range: new vscode.Range(0, 0, 0, 0) },
+            { name: 'HIY', replacement: 'ESC "[1;33m"', isFunctionLike: false, source: 'include', startOffset: 0, endOffset: 0, range: new vscode.Range(0, 0, 0, 0) },
+            { name: 'PAINT', replacement: '(HIY + x)', parameters: ['x'], isFunctionLike: true, source: 'include', startOffset: 0, endOffset: 0, range: new vscode.Range(0, 0, 0, 0) }
+        ];
+        const builder = new MacroExpansionBuilder();
+        const expandWith = (uri: string, text: string): string => {
+            const scanned = new PreprocessorScanner().scan(uri, 1, text);
+            const conditional = new PreprocessorConditionEvaluator().evaluate(text, scanned.directives, sharedMacros);
+            const macroFacts = new MacroFactResolver().resolve(text, scanned.directives, conditional.inactiveRanges, sharedMacros);
+            const activeView = new ActiveSourceBuilder().build(text, scanned.directives, conditional.inactiveRanges);
+            return builder.expand(activeView, macroFacts.macroReferences, macroFacts.macroScope).text;
+        };
+
+        expect(expandWith('file:///color-a.c', 'string a = HIY; string b = PAINT(HIY);'))
+            .toContain('string a = "\\e" "[1;33m"; string b = ("\\e" "[1;33m" + "\\e" "[1;33m");');
+        expect(expandWith('file:///color-b.c', '#define ESC "<esc>"\nstring a = HIY; string b = PAINT(name);'))
+            .toContain('string a = "<esc>" "[1;33m"; string b = ("<esc>" "[1;33m" + name);');
+        expect(expandWith('file:///color-c.c', 'string a = HIY;')).toContain('string a = "\\e" "[1;33m";');
+    });
 });
@@ -6,22 +6,40 @@ import type { LanguageNavigationService } from '../services/navigation/LanguageH
 import type { LanguageSignatureHelpService } from '../services/signatureHelp/LanguageSignatureHelpService';
 import type { LanguageStructureService } from '../services/structure/LanguageFoldingService';
 import type { HealthStatusResponse } from '../../lsp/shared/protocol/health';
+import type { SourceFileChangeType } from '../../lsp/shared/protocol/sourceFileChange';
 import type {
     WorkspaceIndexProgressPayload,
     WorkspaceIndexRebuildParams,
     WorkspaceIndexRebuildResult
 } from '../../lsp/shared/protocol/workspaceIndex';
 
+export interface LanguageWorkspaceIndexFileChange {
+    uri: string;
+    changeType: SourceFileChangeType;
+}
+
+export interface LanguageWorkspaceIndexUpdateResult {
+    updatedFiles: number;
+    removedFiles: number;
+    relinkedFiles: number;
+    skippedFiles: number;
+    failedFiles: number;
+    durationMs: number;
+}
+
 export interface LanguageWorkspaceIndexingService {
     rebuild(
         params: WorkspaceIndexRebuildParams,
         onProgress?: (progress: WorkspaceIndexProgressPayload) => void | Promise<void>
     ): Promise<WorkspaceIndexRebuildResult>;
+    applyFileChanges?(changes: readonly LanguageWorkspaceIndexFileChange[]): Promise<LanguageWorkspaceIndexUpdateResult>;
+    reset?(): void;
 }
 
 export interface LanguageHealthPerformanceProviders {
     getParserStats?: () => NonNullable<HealthStatusResponse['performance']>['parser'];
     getSemanticStats?: () => NonNullable<HealthStatusResponse['performance']>['semantic'];
+    getMemoryStats?: () => NonNullable<HealthStatusResponse['performance']>['memory'];
 }
 
 export interface LanguageFeatureServices {
@@ -31,7 +49,9 @@ export interface LanguageFeatureServices {
     diagnosticsService?: LanguageDiagnosticsService;
     formattingService?: LanguageFormattingService;
     navigationService?: LanguageNavigationService;
+    onDocumentChanged?: (uri: string) => void;
     onDocumentInvalidated?: (uri: string) => void;
+    onFileCreated?: (uri: string) => void;
     onWorkspaceConfigSync?: () => Promise<void>;
     signatureHelpService?: LanguageSignatureHelpService;
     structureService?: LanguageStructureService;
@@ -96,6 +96,11 @@ export class CompletionCandidateResolver {
             return result.candidates;
         }
 
+        // 结果已被截断时补回的条目会越过上限；客户端继续输入时会重新请求。
+        if (result.isIncomplete) {
+            return result.candidates;
+        }
+
         const inheritedSymbols = this.completionInheritedIndexService.getInheritedSymbols(document.uri.toString());
         if (inheritedSymbols.functions.length === 0 && inheritedSymbols.types.length === 0) {
             return result.candidates;
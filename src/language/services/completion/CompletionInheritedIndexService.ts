@@ -1,5 +1,5 @@
-import * as fs from 'fs';
 import * as vscode from 'vscode';
+import { getGlobalVirtualFileSystem } from '../../../core/VirtualFileSystem';
 import type { FileSymbolRecord, InheritedSymbolSet, ResolvedInheritTarget } from '../../../completion/types';
 import { normalizeLpcType } from '../../../ast/typeNormalization';
 import type { SemanticSnapshot } from '../../../semantic/semanticSnapshot';
@@ -190,12 +190,14 @@ export class CompletionInheritedIndexService {
 
     private createReadonlyDocumentFromUri(uri: string): vscode.TextDocument | undefined {
         const filePath = this.normalizeFilePath(vscode.Uri.parse(uri).fsPath);
-        if (!fs.existsSync(filePath)) {
+        const fileSystem = getGlobalVirtualFileSystem();
+        const content = fileSystem.readFile(filePath);
+        const stat = fileSystem.stat(filePath);
+        if (content === undefined || !stat) {
             return undefined;
         }
 
-        const content = fs.readFileSync(filePath, 'utf8');
-        const version = Math.max(1, Math.trunc(fs.statSync(filePath).mtimeMs));
+        const version = Math.max(1, Math.trunc(stat.mtimeMs));
         return this.createReadonlyDocument(filePath, content, version);
     }
 
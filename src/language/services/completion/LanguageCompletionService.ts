@@ -170,7 +170,7 @@ export class QueryBackedLanguageCompletionService implements LanguageCompletionS
             const candidates = resolution.candidates;
             const items = candidates.map(candidate => this.presentationService.createCompletionItem(candidate, result, document));
             trace.complete(result.context.kind, items.length);
-            return { items, isIncomplete: resolution.isIncomplete ?? false };
+            return { items, isIncomplete: Boolean(result.isIncomplete || resolution.isIncomplete) };
         } catch (error) {
             console.error('Error providing completions:', error);
             trace.complete('identifier', 0);
@@ -0,0 +1,198 @@
+import * as vscode from 'vscode';
+import { getGlobalLpcFrontendService, type LpcFrontendService } from '../../../frontend/LpcFrontendService';
+import type { MacroDefinitionFact, PreprocessorDirective, PreprocessorSnapshot } from '../../../frontend/types';
+import { assertOpenTextDocumentHost } from '../../shared/WorkspaceDocumentPathSupport';
+import { normalizeWorkspaceUri } from './navigationPathUtils';
+import { scanIdentifierOccurrences, type WorkspaceReferenceIndex } from './WorkspaceReferenceIndex';
+
+export interface MacroTarget {
+    name: string;
+    sourceUri: string;
+    /** Offset of the `#define` directive in `sourceUri`; together they identify one definition. */
+    startOffset: number;
+}
+
+export interface IncludedMacroRelationServiceOptions {
+    host: {
+        openTextDocument(target: string | vscode.Uri): Promise<vscode.TextDocument>;
+    };
+    referenceIndex?: Pick<WorkspaceReferenceIndex, 'getCandidateUris'>;
+    frontendService?: Pick<LpcFrontendService, 'get'>;
+}
+
+const MACRO_NAME_DIRECTIVES = new Set<PreprocessorDirective['kind']>(['define', 'undef', 'ifdef', 'ifndef', 'if', 'elif']);
+const DEFINE_NAME_PATTERN = /^\s*#\s*define\s+([A-Za-z_][A-Za-z0-9_]*)/;
+
+// Macro references across include relations, proved against each file's own preprocessor facts.
+export class IncludedMacroRelationService {
+    private readonly host: IncludedMacroRelationServiceOptions['host'];
+    private readonly referenceIndex?: Pick<WorkspaceReferenceIndex, 'getCandidateUris'>;
+    private readonly frontendService: Pick<LpcFrontendService, 'get'>;
+
+    public constructor(options: IncludedMacroRelationServiceOptions) {
+        this.host = assertOpenTextDocumentHost('IncludedMacroRelationService', options.host);
+        this.referenceIndex = options.referenceIndex;
+        this.frontendService = options.frontendService ?? getGlobalLpcFrontendService();
+    }
+
+    /**
+     * The macro under the cursor: a reference resolved to its definition, or the name in one of this
+     * file's own `#define` lines. Macros supplied by configuration live outside the workspace and are skipped.
+     */
+    public resolveMacroTarget(document: vscode.TextDocument, position: vscode.Position): MacroTarget | undefined {
+        const preprocessor = this.frontendService.get(document).preprocessor;
+        const offset = document.offsetAt(position);
+        const reference = preprocessor.macroReferences.find((candidate) =>
+            offset >= candidate.startOffset && offset <= candidate.endOffset
+        );
+        if (reference) {
+            return reference.resolved ? toMacroTarget(reference.resolved, document) : undefined;
+        }
+
+        const documentUri = normalizeWorkspaceUri(document.uri);
+        for (const directive of preprocessor.directives) {
+            if (directive.kind !== 'define' || offset < directive.startOffset || offset > directive.endOffset) {
+                continue;
+            }
+
+            const name = DEFINE_NAME_PATTERN.exec(directive.rawText)?.[1];
+            const nameOffset = findDefineNameOffset(directive);
+            if (!name || nameOffset === undefined || offset < nameOffset || offset > nameOffset + name.length) {
+                return undefined;
+            }
+
+            return { name, sourceUri: documentUri, startOffset: directive.startOffset };
+        }
+
+        return undefined;
+    }
+
+    public async collectMacroReferences(
+        document: vscode.TextDocument,
+        position: vscode.Position,
+        options: { includeDeclaration: boolean }
+    ): Promise<Array<{ uri: string; range: vscode.Range }>> {
+        const target = this.resolveMacroTarget(document, position);
+        if (!target) {
+            return [];
+        }
+
+        const candidateUris = new Set([
+            normalizeWorkspaceUri(document.uri),
+            target.sourceUri,
+            ...(this.referenceIndex ? await this.referenceIndex.getCandidateUris(target.name) : [])
+        ]);
+        const perFile = await Promise.all(Array.from(candidateUris, async (candidateUri) => {
+            try {
+                const candidateDocument = candidateUri === normalizeWorkspaceUri(document.uri)
+                    ? document
+                    : await this.host.openTextDocument(vscode.Uri.parse(candidateUri));
+                return this.collectFileMatches(candidateDocument, target, options);
+            } catch {
+                return [];
+            }
+        }));
+
+        return perFile.flat();
+    }
+
+    /**
+     * Positions in one file that provably mean `target`: expansions resolved to the same definition,
+     * plus same-named identifiers in `#ifdef`/`#undef`/`#define` lines once the macro is visible there.
+     * A file that defines its own macro of the same name keeps only the expansions.
+     */
+    private collectFileMatches(
+        document: vscode.TextDocument,
+        target: MacroTarget,
+        options: { includeDeclaration: boolean }
+    ): Array<{ uri: string; range: vscode.Range }> {
+        const uri = normalizeWorkspaceUri(document.uri);
+        const preprocessor = this.frontendService.get(document).preprocessor;
+        const matches = preprocessor.macroReferences
+            .filter((reference) => reference.resolved && isSameMacro(reference.resolved, target, document))
+            .map((reference) => ({ uri, range: reference.range }));
+
+        const isDefiner = uri === target.sourceUri;
+        const isVisible = isDefiner
+            || matches.length > 0
+            || preprocessor.macros.some((macro) => isSameMacro(macro, target, document));
+        if (!isVisible) {
+            return matches;
+        }
+
+        const directiveMatches = collectDirectiveMatches(document, preprocessor, target, isDefiner, options);
+        return directiveMatches ? [...matches, ...directiveMatches] : matches;
+    }
+}
+
+function collectDirectiveMatches(
+    document: vscode.TextDocument,
+    preprocessor: PreprocessorSnapshot,
+    target: MacroTarget,
+    isDefiner: boolean,
+    options: { includeDeclaration: boolean }
+): Array<{ uri: string; range: vscode.Range }> | undefined {
+    const uri = normalizeWorkspaceUri(document.uri);
+    const matches: Array<{ uri: string; range: vscode.Range }> = [];
+
+    for (const directive of preprocessor.directives) {
+        if (!MACRO_NAME_DIRECTIVES.has(directive.kind)) {
+            continue;
+        }
+
+        const nameOffset = directive.kind === 'define' ? findDefineNameOffset(directive) : undefined;
+        const isTargetDefinition = isDefiner && directive.startOffset === target.startOffset;
+        for (const occurrenceOffset of findIdentifierOffsets(directive.rawText, target.name)) {
+            const offset = directive.startOffset + occurrenceOffset;
+            if (offset === nameOffset) {
+                if (!isTargetDefinition) {
+                    return undefined;
+                }
+                if (!options.includeDeclaration) {
+                    continue;
+                }
+            }
+
+            matches.push({
+                uri,
+                range: new vscode.Range(document.positionAt(offset), document.positionAt(offset + target.name.length))
+            });
+        }
+    }
+
+    return matches;
+}
+
+function findIdentifierOffsets(text: string, name: string): number[] {
+    const lineStarts = [0];
+    for (let index = text.indexOf('\n'); index !== -1; index = text.indexOf('\n', index + 1)) {
+        lineStarts.push(index + 1);
+    }
+
+    return scanIdentifierOccurrences(text)
+        .filter((occurrence) => occurrence.name === name)
+        .map((occurrence) => lineStarts[occurrence.line] + occurrence.character);
+}
+
+function findDefineNameOffset(directive: PreprocessorDirective): number | undefined {
+    const match = DEFINE_NAME_PATTERN.exec(directive.rawText);
+    return match ? directive.startOffset + match[0].length - match[1].length : undefined;
+}
+
+function toMacroTarget(macro: MacroDefinitionFact, document: vscode.TextDocument): MacroTarget | undefined {
+    if (macro.source === 'config') {
+        return undefined;
+    }
+
+    return {
+        name: macro.name,
+        sourceUri: normalizeWorkspaceUri(macro.sourceUri ?? document.uri),
+        startOffset: macro.startOffset
+    };
+}
+
+function isSameMacro(macro: MacroDefinitionFact, target: MacroTarget, document: vscode.TextDocument): boolean {
+    return macro.name === target.name
+        && macro.startOffset === target.startOffset
+        && normalizeWorkspaceUri(macro.sourceUri ?? document.uri) === target.sourceUri;
+}
@@ -8,6 +8,10 @@ import { resolveScopedDirectInheritSeeds } from '../../../objectInference/scoped
 import { resolveVisibleSymbol } from '../../../symbolReferenceResolver';
 import { assertOpenTextDocumentHost } from '../../shared/WorkspaceDocumentPathSupport';
 import { normalizeWorkspaceUri } from './navigationPathUtils';
+import type { WorkspaceReferenceIndex } from './WorkspaceReferenceIndex';
+
+type FileGlobalReferenceIndex = Pick<WorkspaceReferenceIndex, 'getCandidateUris' | 'getFilePostings'>;
+
 export interface FileGlobalBinding {
     name: string;
     ownerUri: string;
@@ -27,6 +31,7 @@ export interface InheritedFileGlobalRelationServiceOptions {
     host: {
         openTextDocument(target: string | vscode.Uri): Promise<vscode.TextDocument>;
     };
+    referenceIndex?: FileGlobalReferenceIndex;
 }
 
 export class InheritedFileGlobalRelationService {
@@ -37,11 +42,13 @@ export class InheritedFileGlobalRelationService {
     private readonly host: {
         openTextDocument(target: string | vscode.Uri): Promise<vscode.TextDocument>;
     };
+    private readonly referenceIndex?: FileGlobalReferenceIndex;
 
     public constructor(options: InheritedFileGlobalRelationServiceOptions) {
         this.analysisService = assertAnalysisService('InheritedFileGlobalRelationService', options.analysisService);
         this.inheritanceResolver = options.inheritanceResolver;
         this.host = assertOpenTextDocumentHost('InheritedFileGlobalRelationService', options.host);
+        this.referenceIndex = options.referenceIndex;
     }
 
     public async resolveVisibleBinding(
@@ -59,8 +66,12 @@ export class InheritedFileGlobalRelationService {
         const matches: Array<{ uri: string; range: vscode.Range }> = [];
         const seen = new Set<string>();
         const cache = new Map<string, FileGlobalBindingResolution>();
+        const documents = mergePathDocuments(
+            ...binding.pathDocuments,
+            ...await this.collectIndexedCandidateDocuments(binding)
+        );
 
-        for (const chainDocument of binding.pathDocuments) {
+        for (const chainDocument of documents) {
             const parseResult = this.analysisService.parseDocument(chainDocument, 'cacheFirst');
             const tokenStream = parseResult.parsed?.tokens;
             if (!tokenStream) {
@@ -110,6 +121,37 @@ export class InheritedFileGlobalRelationService {
         return matches;
     }
 
+    /**
+     * Other workspace files the reference index says mention the binding's name. Each of their
+     * tokens still has to resolve back to the same owner and declaration below.
+     */
+    private async collectIndexedCandidateDocuments(binding: FileGlobalBinding): Promise<vscode.TextDocument[]> {
+        if (!this.referenceIndex) {
+            return [];
+        }
+
+        const pathUris = new Set(binding.pathDocuments.map((document) => normalizeWorkspaceUri(document.uri)));
+        const documents: vscode.TextDocument[] = [];
+        for (const candidateUri of await this.referenceIndex.getCandidateUris(binding.name)) {
+            if (pathUris.has(candidateUri)) {
+                continue;
+            }
+
+            const postings = this.referenceIndex.getFilePostings(candidateUri, binding.name);
+            if (postings.length > 0 && postings.every((posting) => posting.role === 'member')) {
+                continue;
+            }
+
+            try {
+                documents.push(await this.host.openTextDocument(vscode.Uri.parse(candidateUri)));
+            } catch {
+                continue;
+            }
+        }
+
+        return documents;
+    }
+
     private async resolveVisibleBindingInternal(
         document: vscode.TextDocument,
         symbolName: string,
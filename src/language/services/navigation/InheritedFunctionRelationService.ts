@@ -2,6 +2,7 @@ import * as vscode from 'vscode';
 import { Symbol as LPCSymbol, SymbolType } from '../../../ast/symbolTable';
 import type { ScopedMethodResolver } from '../../../objectInference/ScopedMethodResolver';
 import { resolveScopedDirectInheritSeeds } from '../../../objectInference/scopedInheritanceTraversal';
+import { isDefaultChannelToken, isIdentifierToken, isLeftParenToken } from '../../../parser/LpcTokenFacts';
 import { assertAnalysisService } from '../../../semantic/assertAnalysisService';
 import type { DocumentAnalysisService } from '../../../semantic/documentAnalysisService';
 import type { SemanticSnapshot } from '../../../semantic/semanticSnapshot';
@@ -12,6 +13,11 @@ import { normalizeWorkspaceUri } from './navigationPathUtils';
 import {
     isOnScopedMethodIdentifier
 } from './ScopedMethodIdentifierSupport';
+import type { WorkspaceReferenceIndex } from './WorkspaceReferenceIndex';
+
+type FunctionReferenceIndex = Pick<WorkspaceReferenceIndex, 'getCandidateUris' | 'getFilePostings'>;
+
+const UNBOUND_CALL_BLOCKING_PREFIXES = new Set(['->', '.', '::']);
 
 export interface InheritedFunctionRelationServiceOptions {
     analysisService?: Pick<DocumentAnalysisService, 'parseDocument' | 'getSemanticSnapshot' | 'getSyntaxDocument'>;
@@ -22,6 +28,7 @@ export interface InheritedFunctionRelationServiceOptions {
         openTextDocument(target: string | vscode.Uri): Promise<vscode.TextDocument>;
     };
     scopedMethodResolver?: Pick<ScopedMethodResolver, 'resolveCallAt'>;
+    referenceIndex?: FunctionReferenceIndex;
 }
 
 export class InheritedFunctionRelationService {
@@ -33,12 +40,14 @@ export class InheritedFunctionRelationService {
         openTextDocument(target: string | vscode.Uri): Promise<vscode.TextDocument>;
     };
     private readonly scopedMethodResolver?: Pick<ScopedMethodResolver, 'resolveCallAt'>;
+    private readonly referenceIndex?: FunctionReferenceIndex;
 
     public constructor(options: InheritedFunctionRelationServiceOptions) {
         this.analysisService = assertAnalysisService('InheritedFunctionRelationService', options.analysisService);
         this.inheritanceResolver = options.inheritanceResolver;
         this.host = assertOpenTextDocumentHost('InheritedFunctionRelationService', options.host);
         this.scopedMethodResolver = options.scopedMethodResolver;
+        this.referenceIndex = options.referenceIndex;
     }
 
     public async collectFunctionReferences(
@@ -46,10 +55,32 @@ export class InheritedFunctionRelationService {
         position: vscode.Position,
         options: { includeDeclaration: boolean }
     ): Promise<Array<{ uri: string; range: vscode.Range }>> {
-        const targetPosition = toVsCodePosition(position);
+        const family = await this.resolveFunctionFamilyAt(document, toVsCodePosition(position));
+        if (!family) {
+            return [];
+        }
+
+        return this.collectFunctionFamilyMatches(document, family.methodName, family.documents, options);
+    }
+
+    /**
+     * Whether the function under `position` belongs to a family whose every inherit edge resolves,
+     * which is what cross-file rename requires before touching other files.
+     */
+    public async hasProvableFunctionFamily(
+        document: vscode.TextDocument,
+        position: vscode.Position
+    ): Promise<boolean> {
+        return (await this.resolveFunctionFamilyAt(document, toVsCodePosition(position))) !== undefined;
+    }
+
+    private async resolveFunctionFamilyAt(
+        document: vscode.TextDocument,
+        targetPosition: vscode.Position
+    ): Promise<{ methodName: string; documents: vscode.TextDocument[] } | undefined> {
         const functionName = getWordAtPosition(document, targetPosition);
         if (!functionName) {
-            return [];
+            return undefined;
         }
 
         const snapshot = this.analysisService.getSemanticSnapshot(document, 'cacheFirst');
@@ -57,23 +88,21 @@ export class InheritedFunctionRelationService {
 
         if (resolvedSymbol?.type === SymbolType.FUNCTION) {
             const family = await this.resolveFunctionFamilyFromVisibleSymbol(document, functionName);
-            if (family.hasUnresolvedTargets) {
-                return [];
-            }
-
-            return this.collectFunctionFamilyMatches(document, functionName, family.documents, options);
+            return family.hasUnresolvedTargets
+                ? undefined
+                : { methodName: functionName, documents: family.documents };
         }
 
         if (resolvedSymbol?.type === SymbolType.STRUCT || resolvedSymbol?.type === SymbolType.CLASS) {
-            return [];
+            return undefined;
         }
 
         const scopedFamily = await this.resolveFunctionFamilyFromScopedCall(document, targetPosition);
-        if (!scopedFamily) {
-            return [];
+        if (scopedFamily || resolvedSymbol) {
+            return scopedFamily;
         }
 
-        return this.collectFunctionFamilyMatches(document, scopedFamily.methodName, scopedFamily.documents, options);
+        return this.resolveFunctionFamilyFromInheritedCall(document, snapshot, functionName, targetPosition);
     }
 
     private async collectFunctionFamilyMatches(
@@ -100,6 +129,152 @@ export class InheritedFunctionRelationService {
             }
         }
 
+        const descendantMatches = await this.collectDescendantMatches(document, functionName, familyUris, options);
+        for (const match of descendantMatches) {
+            pushUniqueMatch(matches, seen, match.uri, match.range);
+        }
+
+        return matches;
+    }
+
+    /**
+     * Files below the family: the requesting document plus whatever the workspace reference index
+     * says mentions `functionName`. A file contributes only when every inherited definition it can
+     * see already belongs to the family, so its unqualified calls provably bind there. A file that
+     * overrides the function joins the family, and candidates waiting on it are checked again.
+     * Each round verifies its candidates in parallel.
+     */
+    private async collectDescendantMatches(
+        document: vscode.TextDocument,
+        functionName: string,
+        familyUris: Set<string>,
+        options: { includeDeclaration: boolean }
+    ): Promise<Array<{ uri: string; range: vscode.Range }>> {
+        const pending = new Set(this.referenceIndex ? await this.referenceIndex.getCandidateUris(functionName) : []);
+        pending.add(normalizeWorkspaceUri(document.uri));
+        for (const familyUri of familyUris) {
+            pending.delete(familyUri);
+        }
+
+        const matches: Array<{ uri: string; range: vscode.Range }> = [];
+        let familyGrew = true;
+        while (pending.size > 0 && familyGrew) {
+            familyGrew = false;
+            const candidates = Array.from(pending);
+            const verdicts = await Promise.all(candidates.map((candidateUri) => this.verifyDescendant(
+                candidateUri,
+                document,
+                functionName,
+                familyUris,
+                options
+            )));
+
+            verdicts.forEach((verdict, index) => {
+                if (verdict.status === 'deferred') {
+                    return;
+                }
+
+                pending.delete(candidates[index]);
+                if (verdict.status === 'accepted') {
+                    matches.push(...verdict.matches);
+                    if (verdict.overrides) {
+                        familyUris.add(candidates[index]);
+                        familyGrew = true;
+                    }
+                }
+            });
+        }
+
+        return matches;
+    }
+
+    private async verifyDescendant(
+        candidateUri: string,
+        requestingDocument: vscode.TextDocument,
+        functionName: string,
+        familyUris: ReadonlySet<string>,
+        options: { includeDeclaration: boolean }
+    ): Promise<
+        | { status: 'accepted'; overrides: boolean; matches: Array<{ uri: string; range: vscode.Range }> }
+        | { status: 'rejected' | 'deferred' }
+    > {
+        const postings = this.referenceIndex?.getFilePostings(candidateUri, functionName) ?? [];
+        if (postings.length > 0 && postings.every((posting) => posting.role === 'member')) {
+            return { status: 'rejected' };
+        }
+
+        let candidateDocument: vscode.TextDocument;
+        try {
+            candidateDocument = candidateUri === normalizeWorkspaceUri(requestingDocument.uri)
+                ? requestingDocument
+                : await this.host.openTextDocument(vscode.Uri.parse(candidateUri));
+        } catch {
+            return { status: 'rejected' };
+        }
+
+        const inherited = await this.collectInheritedFunctionFamilyDocuments(
+            candidateDocument,
+            functionName,
+            new Set([candidateUri])
+        );
+        if (inherited.hasUnresolvedTargets || inherited.documents.length === 0) {
+            return { status: 'rejected' };
+        }
+        if (!inherited.documents.every((familyDocument) => familyUris.has(normalizeWorkspaceUri(familyDocument.uri)))) {
+            return { status: 'deferred' };
+        }
+
+        const snapshot = this.analysisService.getSemanticSnapshot(candidateDocument, 'cacheFirst');
+        const overrides = this.findGlobalFunctionSymbol(snapshot, functionName) !== undefined;
+        const matches = overrides
+            ? this.collectLocalFunctionMatches(candidateDocument, functionName, options)
+            : this.collectUnboundCallMatches(candidateDocument, snapshot, functionName);
+        if (this.scopedMethodResolver) {
+            matches.push(...await this.collectScopedFunctionMatches(
+                candidateDocument,
+                functionName,
+                new Set([...familyUris, ...(overrides ? [candidateUri] : [])])
+            ));
+        }
+
+        return { status: 'accepted', overrides, matches };
+    }
+
+    private collectUnboundCallMatches(
+        document: vscode.TextDocument,
+        snapshot: SemanticSnapshot,
+        functionName: string
+    ): Array<{ uri: string; range: vscode.Range }> {
+        const tokenStream = this.analysisService.parseDocument(document, 'cacheFirst').parsed?.tokens;
+        if (!tokenStream) {
+            return [];
+        }
+
+        const tokens = tokenStream.getTokens().filter(isDefaultChannelToken);
+        const matches: Array<{ uri: string; range: vscode.Range }> = [];
+        for (let index = 0; index < tokens.length; index += 1) {
+            const token = tokens[index];
+            if (!isIdentifierToken(token) || token.text !== functionName) {
+                continue;
+            }
+
+            const previous = tokens[index - 1];
+            const next = tokens[index + 1];
+            if (!next || !isLeftParenToken(next) || (previous && UNBOUND_CALL_BLOCKING_PREFIXES.has(previous.text ?? ''))) {
+                continue;
+            }
+
+            const range = new vscode.Range(
+                document.positionAt(token.startIndex),
+                document.positionAt(token.stopIndex + 1)
+            );
+            if (resolveVisibleSymbol(snapshot.symbolTable, functionName, range.start)) {
+                continue;
+            }
+
+            matches.push({ uri: normalizeWorkspaceUri(document.uri), range });
+        }
+
         return matches;
     }
 
@@ -196,6 +371,34 @@ export class InheritedFunctionRelationService {
         };
     }
 
+    /**
+     * An unqualified call to a function the document does not define: the family is every
+     * inherited definition it can see, provided all inherit edges resolve.
+     */
+    private async resolveFunctionFamilyFromInheritedCall(
+        document: vscode.TextDocument,
+        snapshot: SemanticSnapshot,
+        functionName: string,
+        position: vscode.Position
+    ): Promise<{ methodName: string; documents: vscode.TextDocument[] } | undefined> {
+        const isUnboundCall = this.collectUnboundCallMatches(document, snapshot, functionName)
+            .some((match) => match.range.contains(position));
+        if (!isUnboundCall) {
+            return undefined;
+        }
+
+        const inherited = await this.collectInheritedFunctionFamilyDocuments(
+            document,
+            functionName,
+            new Set([normalizeWorkspaceUri(document.uri)])
+        );
+        if (inherited.hasUnresolvedTargets || inherited.documents.length === 0) {
+            return undefined;
+        }
+
+        return { methodName: functionName, documents: inherited.documents };
+    }
+
     private async resolveFunctionFamilyFromScopedCall(
         document: vscode.TextDocument,
         position: vscode.Position
@@ -8,6 +8,7 @@ import {
     InheritedFileGlobalRelationService
 } from './InheritedFileGlobalRelationService';
 import { InheritedFunctionRelationService } from './InheritedFunctionRelationService';
+import type { IncludedMacroRelationService } from './IncludedMacroRelationService';
 
 export interface InheritedReferenceMatch {
     uri: string;
@@ -17,24 +18,33 @@ export interface InheritedReferenceMatch {
 export type RenameTargetClassification =
     | { kind: 'current-file-only' }
     | { kind: 'file-global' }
+    | { kind: 'function' }
+    | { kind: 'macro' }
     | { kind: 'unsupported' };
 
+type FunctionRelationSeam = Pick<InheritedFunctionRelationService, 'collectFunctionReferences'>
+    & Partial<Pick<InheritedFunctionRelationService, 'hasProvableFunctionFamily'>>;
+type MacroRelationSeam = Pick<IncludedMacroRelationService, 'resolveMacroTarget' | 'collectMacroReferences'>;
+
 export interface InheritedSymbolRelationServiceOptions {
     analysisService?: Pick<DocumentAnalysisService, 'getSemanticSnapshot'>;
-    functionRelationService: Pick<InheritedFunctionRelationService, 'collectFunctionReferences'>;
+    functionRelationService: FunctionRelationSeam;
     fileGlobalRelationService: Pick<InheritedFileGlobalRelationService, 'resolveVisibleBinding' | 'collectReferences'>;
+    macroRelationService?: MacroRelationSeam;
 }
 
 export class InheritedSymbolRelationService {
     private readonly analysisService: Pick<DocumentAnalysisService, 'getSemanticSnapshot'>;
-    private readonly functionRelationService: Pick<InheritedFunctionRelationService, 'collectFunctionReferences'>;
+    private readonly functionRelationService: FunctionRelationSeam;
     private readonly fileGlobalRelationService: Pick<InheritedFileGlobalRelationService, 'resolveVisibleBinding' | 'collectReferences'>;
+    private readonly macroRelationService?: MacroRelationSeam;
 
     public constructor(options: InheritedSymbolRelationServiceOptions) {
         const analysisService = assertAnalysisService('InheritedSymbolRelationService', options.analysisService);
         this.analysisService = analysisService;
         this.functionRelationService = options.functionRelationService;
         this.fileGlobalRelationService = options.fileGlobalRelationService;
+        this.macroRelationService = options.macroRelationService;
     }
 
     public async collectInheritedReferences(
@@ -55,7 +65,9 @@ export class InheritedSymbolRelationService {
 
         const globalBinding = await this.fileGlobalRelationService.resolveVisibleBinding(document, symbolName, targetPosition);
         if (globalBinding.status !== 'resolved') {
-            return [];
+            return this.macroRelationService
+                ? this.macroRelationService.collectMacroReferences(document, targetPosition, options)
+                : [];
         }
 
         return this.fileGlobalRelationService.collectReferences(globalBinding.binding, options);
@@ -81,7 +93,13 @@ export class InheritedSymbolRelationService {
             return { kind: 'current-file-only' };
         }
 
-        if (resolvedSymbol?.type === SymbolType.FUNCTION || resolvedSymbol?.type === SymbolType.STRUCT || resolvedSymbol?.type === SymbolType.CLASS) {
+        if (resolvedSymbol?.type === SymbolType.FUNCTION) {
+            return await this.hasProvableFunctionFamily(document, targetPosition)
+                ? { kind: 'function' }
+                : { kind: 'unsupported' };
+        }
+
+        if (resolvedSymbol?.type === SymbolType.STRUCT || resolvedSymbol?.type === SymbolType.CLASS) {
             return { kind: 'unsupported' };
         }
 
@@ -89,16 +107,29 @@ export class InheritedSymbolRelationService {
             return { kind: 'file-global' };
         }
 
+        if (!resolvedSymbol && this.macroRelationService?.resolveMacroTarget(document, targetPosition)) {
+            return { kind: 'macro' };
+        }
+
         const inheritedBinding = await this.fileGlobalRelationService.resolveVisibleBinding(document, symbolName, targetPosition);
-        return inheritedBinding.status === 'resolved'
-            ? { kind: 'file-global' }
+        if (inheritedBinding.status === 'resolved') {
+            return { kind: 'file-global' };
+        }
+
+        return await this.hasProvableFunctionFamily(document, targetPosition)
+            ? { kind: 'function' }
             : { kind: 'unsupported' };
     }
 
+    /**
+     * 一次重命名的全部跨文件编辑，按文件归并为单个 WorkspaceEdit 的 `changes`。
+     * 未传入 `target` 时先自行分类；只有能证明归属的目标才会产生编辑。
+     */
     public async buildInheritedRenameEdits(
         document: vscode.TextDocument,
         position: vscode.Position,
-        newName: string
+        newName: string,
+        target?: RenameTargetClassification
     ): Promise<Record<string, Array<{ range: vscode.Range; newText: string }>>> {
         const targetPosition = toVsCodePosition(position);
         const symbolName = getWordAtPosition(document, targetPosition);
@@ -106,12 +137,8 @@ export class InheritedSymbolRelationService {
             return {};
         }
 
-        const binding = await this.fileGlobalRelationService.resolveVisibleBinding(document, symbolName, targetPosition);
-        if (binding.status !== 'resolved') {
-            return {};
-        }
-
-        const matches = await this.fileGlobalRelationService.collectReferences(binding.binding, { includeDeclaration: true });
+        const renameTarget = target ?? await this.classifyRenameTarget(document, targetPosition);
+        const matches = await this.collectRenameMatches(document, targetPosition, symbolName, renameTarget);
         const changes: Record<string, Array<{ range: vscode.Range; newText: string }>> = {};
 
         for (const match of matches) {
@@ -125,6 +152,36 @@ export class InheritedSymbolRelationService {
 
         return changes;
     }
+
+    private async collectRenameMatches(
+        document: vscode.TextDocument,
+        position: vscode.Position,
+        symbolName: string,
+        target: RenameTargetClassification
+    ): Promise<InheritedReferenceMatch[]> {
+        switch (target.kind) {
+            case 'function':
+                return this.functionRelationService.collectFunctionReferences(document, position, { includeDeclaration: true });
+            case 'macro':
+                return this.macroRelationService
+                    ? this.macroRelationService.collectMacroReferences(document, position, { includeDeclaration: true })
+                    : [];
+            case 'file-global': {
+                const binding = await this.fileGlobalRelationService.resolveVisibleBinding(document, symbolName, position);
+                return binding.status === 'resolved'
+                    ? this.fileGlobalRelationService.collectReferences(binding.binding, { includeDeclaration: true })
+                    : [];
+            }
+            default:
+                return [];
+        }
+    }
+
+    private async hasProvableFunctionFamily(document: vscode.TextDocument, position: vscode.Position): Promise<boolean> {
+        return this.functionRelationService.hasProvableFunctionFamily
+            ? this.functionRelationService.hasProvableFunctionFamily(document, position)
+            : false;
+    }
 }
 
 function getWordAtPosition(document: vscode.TextDocument, position: vscode.Position): string | undefined {
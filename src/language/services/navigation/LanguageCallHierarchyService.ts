@@ -0,0 +1,95 @@
+import * as vscode from 'vscode';
+import type { LanguageCapabilityContext } from '../../contracts/LanguageCapabilityContext';
+import type { LanguagePosition, LanguageRange } from '../../contracts/LanguagePosition';
+import { normalizeWorkspaceUri } from './navigationPathUtils';
+import type { CallGraphFunction, WorkspaceCallGraph } from './WorkspaceCallGraph';
+
+// Supporting request/result types for the grouped navigation service seam.
+export interface LanguageCallHierarchyItem {
+    name: string;
+    kind: 'function';
+    uri: string;
+    range: LanguageRange;
+    selectionRange: LanguageRange;
+}
+
+export interface LanguageCallHierarchyPrepareRequest {
+    context: LanguageCapabilityContext;
+    position: LanguagePosition;
+}
+
+export interface LanguageCallHierarchyCallsRequest {
+    context: LanguageCapabilityContext;
+    item: LanguageCallHierarchyItem;
+}
+
+export interface LanguageCallHierarchyIncomingCall {
+    from: LanguageCallHierarchyItem;
+    fromRanges: LanguageRange[];
+}
+
+export interface LanguageCallHierarchyOutgoingCall {
+    to: LanguageCallHierarchyItem;
+    fromRanges: LanguageRange[];
+}
+
+export interface LanguageCallHierarchyService {
+    prepareCallHierarchy(request: LanguageCallHierarchyPrepareRequest): Promise<LanguageCallHierarchyItem[]>;
+    provideIncomingCalls(request: LanguageCallHierarchyCallsRequest): Promise<LanguageCallHierarchyIncomingCall[]>;
+    provideOutgoingCalls(request: LanguageCallHierarchyCallsRequest): Promise<LanguageCallHierarchyOutgoingCall[]>;
+}
+
+// Call hierarchy answers straight from the workspace call graph; items carry everything needed to re-identify a function.
+export class CallGraphLanguageCallHierarchyService implements LanguageCallHierarchyService {
+    public constructor(
+        private readonly callGraph: Pick<WorkspaceCallGraph, 'resolveFunctionsAt' | 'getIncomingCalls' | 'getOutgoingCalls'>
+    ) {}
+
+    public async prepareCallHierarchy(request: LanguageCallHierarchyPrepareRequest): Promise<LanguageCallHierarchyItem[]> {
+        const functions = await this.callGraph.resolveFunctionsAt(
+            request.context.document as unknown as vscode.TextDocument,
+            new vscode.Position(request.position.line, request.position.character)
+        );
+
+        return functions.map(toCallHierarchyItem);
+    }
+
+    public async provideIncomingCalls(request: LanguageCallHierarchyCallsRequest): Promise<LanguageCallHierarchyIncomingCall[]> {
+        const calls = await this.callGraph.getIncomingCalls(fromCallHierarchyItem(request.item));
+        return calls.map((call) => ({
+            from: toCallHierarchyItem(call.caller),
+            fromRanges: call.ranges
+        }));
+    }
+
+    public async provideOutgoingCalls(request: LanguageCallHierarchyCallsRequest): Promise<LanguageCallHierarchyOutgoingCall[]> {
+        const calls = await this.callGraph.getOutgoingCalls(fromCallHierarchyItem(request.item));
+        return calls.map((call) => ({
+            to: toCallHierarchyItem(call.callee),
+            fromRanges: call.ranges
+        }));
+    }
+}
+
+function toCallHierarchyItem(fn: CallGraphFunction): LanguageCallHierarchyItem {
+    return {
+        name: fn.name,
+        kind: 'function',
+        uri: fn.uri,
+        range: fn.range,
+        selectionRange: fn.selectionRange
+    };
+}
+
+function fromCallHierarchyItem(item: LanguageCallHierarchyItem): CallGraphFunction {
+    return {
+        uri: normalizeWorkspaceUri(vscode.Uri.parse(item.uri)),
+        name: item.name,
+        range: toVsCodeRange(item.range),
+        selectionRange: toVsCodeRange(item.selectionRange)
+    };
+}
+
+function toVsCodeRange(range: LanguageRange): vscode.Range {
+    return new vscode.Range(range.start.line, range.start.character, range.end.line, range.end.character);
+}
@@ -2,6 +2,13 @@ import * as vscode from 'vscode';
 import type { LanguageCapabilityContext } from '../../contracts/LanguageCapabilityContext';
 import type { LanguageMarkupContent } from '../../contracts/LanguageMarkup';
 import type { LanguageLocation, LanguagePosition, LanguageRange } from '../../contracts/LanguagePosition';
+import type {
+    LanguageCallHierarchyCallsRequest,
+    LanguageCallHierarchyIncomingCall,
+    LanguageCallHierarchyItem,
+    LanguageCallHierarchyOutgoingCall,
+    LanguageCallHierarchyPrepareRequest
+} from './LanguageCallHierarchyService';
 import type { LanguageDefinitionRequest } from './LanguageDefinitionService';
 import type { LanguageReferenceRequest } from './LanguageReferenceService';
 import type {
@@ -11,6 +18,7 @@ import type {
     LanguageWorkspaceEdit
 } from './LanguageRenameService';
 import type { LanguageDocumentSymbol, LanguageSymbolRequest } from './LanguageSymbolService';
+import type { LanguageWorkspaceSymbol, LanguageWorkspaceSymbolRequest } from './LanguageWorkspaceSymbolService';
 import { CallableDocRenderer } from '../../documentation/CallableDocRenderer';
 import { FunctionDocumentationService } from '../../documentation/FunctionDocumentationService';
 import { assertDocumentationService } from '../../documentation/assertDocumentationService';
@@ -45,6 +53,10 @@ export interface LanguageNavigationService {
     prepareRename(request: LanguagePrepareRenameRequest): Promise<LanguagePrepareRenameResult | undefined>;
     provideRenameEdits(request: LanguageRenameRequest): Promise<LanguageWorkspaceEdit>;
     provideDocumentSymbols(request: LanguageSymbolRequest): Promise<LanguageDocumentSymbol[]>;
+    prepareCallHierarchy?(request: LanguageCallHierarchyPrepareRequest): Promise<LanguageCallHierarchyItem[]>;
+    provideIncomingCalls?(request: LanguageCallHierarchyCallsRequest): Promise<LanguageCallHierarchyIncomingCall[]>;
+    provideOutgoingCalls?(request: LanguageCallHierarchyCallsRequest): Promise<LanguageCallHierarchyOutgoingCall[]>;
+    provideWorkspaceSymbols?(request: LanguageWorkspaceSymbolRequest): Promise<LanguageWorkspaceSymbol[]>;
 }
 
 interface HoverDocument {
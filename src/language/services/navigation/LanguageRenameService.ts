@@ -75,7 +75,7 @@ export class AstBackedLanguageRenameService implements LanguageRenameService {
             return currentFileRename;
         }
 
-        if (renameTarget.kind !== 'file-global') {
+        if (renameTarget.kind === 'current-file-only') {
             return undefined;
         }
 
@@ -106,17 +106,24 @@ export class AstBackedLanguageRenameService implements LanguageRenameService {
             return { changes: {} };
         }
 
-        const currentFileEdit = this.provideCurrentFileRenameEdits(request);
-        if (renameTarget.kind !== 'file-global') {
-            return currentFileEdit;
+        if (renameTarget.kind === 'current-file-only') {
+            return this.provideCurrentFileRenameEdits(request);
         }
 
         const inheritedChanges = await inheritedRelationService.buildInheritedRenameEdits(
             request.context.document as any,
             request.position as any,
-            request.newName
+            request.newName,
+            renameTarget
         );
 
+        // Functions and macros are proved across files including this one; the name-based
+        // single-file matches would also hit member calls and shadowing definitions.
+        if (renameTarget.kind !== 'file-global') {
+            return { changes: mergeWorkspaceEdits({}, inheritedChanges) };
+        }
+
+        const currentFileEdit = this.provideCurrentFileRenameEdits(request);
         return {
             changes: mergeWorkspaceEdits(currentFileEdit.changes, inheritedChanges)
         };
@@ -0,0 +1,85 @@
+import * as vscode from 'vscode';
+import type { LanguageLocation } from '../../contracts/LanguagePosition';
+import type { WorkspaceSymbolIndex, WorkspaceSymbolKind, WorkspaceSymbolMatch } from './WorkspaceSymbolIndex';
+
+// Supporting request/result types for the grouped navigation service seam.
+export interface LanguageWorkspaceSymbol {
+    name: string;
+    kind: WorkspaceSymbolKind;
+    location: LanguageLocation;
+    containerName?: string;
+}
+
+export interface LanguageWorkspaceSymbolRequest {
+    query: string;
+    /** Documents open in the editor; symbols near them rank higher. */
+    nearUris?: readonly string[];
+    isCancellationRequested?(): boolean;
+    /**
+     * When present, ranked results are delivered through this callback in batches and the
+     * returned array is empty.
+     */
+    onPartialResult?(symbols: LanguageWorkspaceSymbol[]): void;
+}
+
+export interface LanguageWorkspaceSymbolService {
+    provideWorkspaceSymbols(request: LanguageWorkspaceSymbolRequest): Promise<LanguageWorkspaceSymbol[]>;
+}
+
+const PARTIAL_RESULT_BATCH_SIZE = 64;
+
+export class IndexedLanguageWorkspaceSymbolService implements LanguageWorkspaceSymbolService {
+    public constructor(
+        private readonly symbolIndex: Pick<WorkspaceSymbolIndex, 'search'>,
+        private readonly limit?: number
+    ) {}
+
+    public async provideWorkspaceSymbols(request: LanguageWorkspaceSymbolRequest): Promise<LanguageWorkspaceSymbol[]> {
+        const symbols = this.symbolIndex
+            .search(request.query, { nearUris: request.nearUris, limit: this.limit })
+            .map(toLanguageWorkspaceSymbol);
+        if (!request.onPartialResult) {
+            return symbols;
+        }
+
+        for (let start = 0; start < symbols.length; start += PARTIAL_RESULT_BATCH_SIZE) {
+            if (start > 0) {
+                // Let the connection flush the previous batch and process a pending $/cancelRequest.
+                await yieldToEventLoop();
+            }
+            if (request.isCancellationRequested?.()) {
+                break;
+            }
+            request.onPartialResult(symbols.slice(start, start + PARTIAL_RESULT_BATCH_SIZE));
+        }
+
+        return [];
+    }
+}
+
+function yieldToEventLoop(): Promise<void> {
+    return new Promise((resolve) => setTimeout(resolve, 0));
+}
+
+function toLanguageWorkspaceSymbol(match: WorkspaceSymbolMatch): LanguageWorkspaceSymbol {
+    return {
+        name: match.name,
+        kind: match.kind,
+        location: {
+            uri: match.uri,
+            range: {
+                start: { line: match.range.start.line, character: match.range.start.character },
+                end: { line: match.range.end.line, character: match.range.end.character }
+            }
+        },
+        containerName: toContainerName(match.uri)
+    };
+}
+
+function toContainerName(uri: string): string | undefined {
+    try {
+        return vscode.Uri.parse(uri).path.split('/').pop() || undefined;
+    } catch {
+        return undefined;
+    }
+}
@@ -0,0 +1,408 @@
+import * as vscode from 'vscode';
+import { SymbolType } from '../../../ast/symbolTable';
+import type { InheritanceResolver } from '../../../completion/inheritanceResolver';
+import type { ObjectInferenceService } from '../../../objectInference/ObjectInferenceService';
+import {
+    matchesScopedQualifier,
+    resolveScopedDirectInheritSeeds,
+    type ResolvedScopedInheritTarget
+} from '../../../objectInference/scopedInheritanceTraversal';
+import { assertAnalysisService } from '../../../semantic/assertAnalysisService';
+import type { DocumentAnalysisService } from '../../../semantic/documentAnalysisService';
+import { resolveVisibleSymbol } from '../../../symbolReferenceResolver';
+import { SyntaxKind, type SyntaxDocument, type SyntaxNode } from '../../../syntax/types';
+import { assertOpenTextDocumentHost } from '../../shared/WorkspaceDocumentPathSupport';
+import { normalizeWorkspaceUri } from './navigationPathUtils';
+import type { WorkspaceReferenceIndex } from './WorkspaceReferenceIndex';
+
+export interface CallGraphFunction {
+    uri: string;
+    name: string;
+    range: vscode.Range;
+    selectionRange: vscode.Range;
+}
+
+export type CallGraphCallKind = 'direct' | 'scoped' | 'object';
+
+export interface CallGraphCallSite {
+    /** Name of the enclosing function; calls in global initializers have none. */
+    callerName?: string;
+    calleeName: string;
+    range: vscode.Range;
+    kind: CallGraphCallKind;
+    /** `room` in `room::create()`. */
+    qualifier?: string;
+    /** Files an `ob->method()` receiver provably refers to. */
+    targetUris?: string[];
+}
+
+export interface CallGraphCall {
+    caller: CallGraphFunction;
+    callee: CallGraphFunction;
+    /** Call sites, always inside `caller`'s file. */
+    ranges: vscode.Range[];
+}
+
+interface CallGraphFileRecord {
+    uri: string;
+    functions: CallGraphFunction[];
+    inheritSeeds: ResolvedScopedInheritTarget[];
+    hasUnresolvedInherits: boolean;
+    calls: CallGraphCallSite[];
+}
+
+export interface WorkspaceCallGraphOptions {
+    analysisService: Pick<DocumentAnalysisService, 'getSyntaxDocument' | 'getSemanticSnapshot'>;
+    inheritanceResolver: Pick<InheritanceResolver, 'resolveInheritTargets'>;
+    host: {
+        openTextDocument(target: string | vscode.Uri): Promise<vscode.TextDocument>;
+    };
+    objectInferenceService?: Pick<ObjectInferenceService, 'inferObjectAccess'>;
+    referenceIndex?: Pick<WorkspaceReferenceIndex, 'getCandidateUris' | 'getFilePostings'>;
+}
+
+/**
+ * Workspace call graph for call hierarchy requests.
+ *
+ * Each file is summarized once into its function definitions and outgoing call sites: plain
+ * calls, `::`/`room::` calls, and `ob->method()` calls whose receiver object inference resolves
+ * to a single file. Summaries are kept until the file changes. Call sites are bound to
+ * definitions when queried, walking the caller's inherit chain, so edits to a parent rebind
+ * its children's calls without re-summarizing them. A call that cannot be bound to exactly one
+ * definition produces no edge.
+ */
+export class WorkspaceCallGraph {
+    private readonly analysisService: WorkspaceCallGraphOptions['analysisService'];
+    private readonly inheritanceResolver: WorkspaceCallGraphOptions['inheritanceResolver'];
+    private readonly host: WorkspaceCallGraphOptions['host'];
+    private readonly objectInferenceService?: WorkspaceCallGraphOptions['objectInferenceService'];
+    private readonly referenceIndex?: WorkspaceCallGraphOptions['referenceIndex'];
+    private readonly records = new Map<string, { version: number; record: Promise<CallGraphFileRecord | undefined> }>();
+
+    public constructor(options: WorkspaceCallGraphOptions) {
+        this.analysisService = assertAnalysisService('WorkspaceCallGraph', options.analysisService);
+        this.inheritanceResolver = options.inheritanceResolver;
+        this.host = assertOpenTextDocumentHost('WorkspaceCallGraph', options.host);
+        this.objectInferenceService = options.objectInferenceService;
+        this.referenceIndex = options.referenceIndex;
+    }
+
+    public get fileCount(): number {
+        return this.records.size;
+    }
+
+    public invalidate(uri: string): void {
+        this.records.delete(normalizeWorkspaceUri(uri));
+    }
+
+    public removeFile(uri: string): void {
+        this.invalidate(uri);
+    }
+
+    public clear(): void {
+        this.records.clear();
+    }
+
+    /** The function defined at `position`, or the definition(s) the call under `position` binds to. */
+    public async resolveFunctionsAt(document: vscode.TextDocument, position: vscode.Position): Promise<CallGraphFunction[]> {
+        const record = await this.getRecord(document);
+        if (!record) {
+            return [];
+        }
+
+        const definition = record.functions.find((fn) => fn.selectionRange.contains(position));
+        if (definition) {
+            return [definition];
+        }
+
+        const call = record.calls.find((candidate) => candidate.range.contains(position));
+        return call ? this.bindCall(record, call) : [];
+    }
+
+    public async getOutgoingCalls(fn: CallGraphFunction): Promise<CallGraphCall[]> {
+        const record = await this.getRecordByUri(fn.uri);
+        if (!record) {
+            return [];
+        }
+
+        const grouped = new Map<string, CallGraphCall>();
+        for (const call of record.calls) {
+            if (call.callerName !== fn.name) {
+                continue;
+            }
+
+            for (const callee of await this.bindCall(record, call)) {
+                appendCall(grouped, fn, callee, call.range, functionKey(callee));
+            }
+        }
+
+        return Array.from(grouped.values());
+    }
+
+    /**
+     * Callers of `fn`. Only files the reference index lists for the name are summarized, and
+     * they are summarized in parallel; without an index the search covers files already summarized.
+     */
+    public async getIncomingCalls(fn: CallGraphFunction): Promise<CallGraphCall[]> {
+        const targetKey = functionKey(fn);
+        const candidateUris = new Set([normalizeWorkspaceUri(fn.uri), ...await this.collectCallerCandidates(fn.name)]);
+        const perFile = await Promise.all(Array.from(candidateUris, async (candidateUri) => {
+            const record = await this.getRecordByUri(candidateUri);
+            if (!record) {
+                return [];
+            }
+
+            const grouped = new Map<string, CallGraphCall>();
+            for (const call of record.calls) {
+                if (call.calleeName !== fn.name || !call.callerName) {
+                    continue;
+                }
+
+                const callees = await this.bindCall(record, call);
+                const caller = record.functions.find((candidate) => candidate.name === call.callerName);
+                if (caller && callees.some((callee) => functionKey(callee) === targetKey)) {
+                    appendCall(grouped, caller, fn, call.range, functionKey(caller));
+                }
+            }
+
+            return Array.from(grouped.values());
+        }));
+
+        return perFile.flat();
+    }
+
+    private async collectCallerCandidates(name: string): Promise<string[]> {
+        if (!this.referenceIndex) {
+            return Array.from(this.records.keys());
+        }
+
+        const candidates = await this.referenceIndex.getCandidateUris(name);
+        return candidates.filter((uri) => {
+            const postings = this.referenceIndex!.getFilePostings(uri, name);
+            // Stale files have no postings yet and must stay candidates.
+            return postings.length === 0 || postings.some((posting) => posting.role !== 'reference');
+        });
+    }
+
+    private async bindCall(record: CallGraphFileRecord, call: CallGraphCallSite): Promise<CallGraphFunction[]> {
+        switch (call.kind) {
+            case 'direct':
+                return this.findDefinition(record, call.calleeName, true, new Set());
+            case 'scoped': {
+                const seeds = call.qualifier
+                    ? record.inheritSeeds.filter((seed) => matchesScopedQualifier(seed, call.qualifier!))
+                    : record.inheritSeeds;
+                if (record.hasUnresolvedInherits && !call.qualifier) {
+                    return [];
+                }
+
+                return this.findInSeeds(seeds, call.calleeName, new Set([record.uri]));
+            }
+            case 'object': {
+                const definitions: CallGraphFunction[] = [];
+                for (const targetUri of call.targetUris ?? []) {
+                    const target = await this.getRecordByUri(targetUri);
+                    if (target) {
+                        definitions.push(...await this.findDefinition(target, call.calleeName, true, new Set()));
+                    }
+                }
+                return definitions;
+            }
+        }
+    }
+
+    private async findDefinition(
+        record: CallGraphFileRecord,
+        name: string,
+        includeSelf: boolean,
+        visitedUris: Set<string>
+    ): Promise<CallGraphFunction[]> {
+        visitedUris.add(record.uri);
+        const own = includeSelf ? record.functions.find((fn) => fn.name === name) : undefined;
+        if (own) {
+            return [own];
+        }
+        if (record.hasUnresolvedInherits) {
+            return [];
+        }
+
+        return this.findInSeeds(record.inheritSeeds, name, visitedUris);
+    }
+
+    // Exactly one inherited definition binds; none or several is not provable.
+    private async findInSeeds(
+        seeds: readonly ResolvedScopedInheritTarget[],
+        name: string,
+        visitedUris: Set<string>
+    ): Promise<CallGraphFunction[]> {
+        const found = new Map<string, CallGraphFunction>();
+        for (const seed of seeds) {
+            const seedUri = normalizeWorkspaceUri(seed.resolvedUri);
+            if (visitedUris.has(seedUri)) {
+                continue;
+            }
+
+            const seedRecord = await this.getRecordByUri(seedUri);
+            if (!seedRecord) {
+                return [];
+            }
+
+            for (const definition of await this.findDefinition(seedRecord, name, true, visitedUris)) {
+                found.set(functionKey(definition), definition);
+            }
+        }
+
+        return found.size === 1 ? Array.from(found.values()) : [];
+    }
+
+    private async getRecordByUri(uri: string): Promise<CallGraphFileRecord | undefined> {
+        try {
+            return await this.getRecord(await this.host.openTextDocument(vscode.Uri.parse(uri)));
+        } catch {
+            return undefined;
+        }
+    }
+
+    private getRecord(document: vscode.TextDocument): Promise<CallGraphFileRecord | undefined> {
+        const uri = normalizeWorkspaceUri(document.uri);
+        const cached = this.records.get(uri);
+        if (cached && cached.version === document.version) {
+            return cached.record;
+        }
+
+        const record = this.buildRecord(document, uri).catch(() => undefined);
+        this.records.set(uri, { version: document.version, record });
+        return record;
+    }
+
+    private async buildRecord(document: vscode.TextDocument, uri: string): Promise<CallGraphFileRecord | undefined> {
+        const syntax = this.analysisService.getSyntaxDocument(document, 'cacheFirst')
+            ?? this.analysisService.getSyntaxDocument(document, 'refreshIfStale');
+        if (!syntax) {
+            return undefined;
+        }
+
+        const snapshot = this.analysisService.getSemanticSnapshot(document, 'cacheFirst');
+        const seeds = resolveScopedDirectInheritSeeds(this.inheritanceResolver as InheritanceResolver, snapshot);
+        const functions = collectFunctionDefinitions(syntax, uri);
+        const calls: CallGraphCallSite[] = [];
+
+        for (const callExpression of syntax.nodes) {
+            if (callExpression.kind !== SyntaxKind.CallExpression) {
+                continue;
+            }
+
+            const call = await this.toCallSite(document, callExpression);
+            if (!call) {
+                continue;
+            }
+
+            if (call.kind === 'direct') {
+                const visible = resolveVisibleSymbol(snapshot.symbolTable, call.calleeName, call.range.start);
+                if (visible && visible.type !== SymbolType.FUNCTION) {
+                    // A local function pointer shadows the name.
+                    continue;
+                }
+            }
+
+            call.callerName = functions.find((fn) => fn.range.contains(call.range.start))?.name;
+            calls.push(call);
+        }
+
+        return {
+            uri,
+            functions,
+            inheritSeeds: seeds.resolvedTargets,
+            hasUnresolvedInherits: seeds.hasUnresolvedTargets,
+            calls
+        };
+    }
+
+    private async toCallSite(document: vscode.TextDocument, callExpression: SyntaxNode): Promise<CallGraphCallSite | undefined> {
+        const callee = callExpression.children[0];
+        if (!callee) {
+            return undefined;
+        }
+
+        if (callee.kind === SyntaxKind.Identifier && callee.name) {
+            const scopeQualifier = callee.metadata?.scopeQualifier;
+            if (scopeQualifier === undefined) {
+                return { calleeName: callee.name, range: callee.range, kind: 'direct' };
+            }
+            return scopeQualifier === '::'
+                ? { calleeName: callee.name, range: callee.range, kind: 'scoped' }
+                : undefined;
+        }
+
+        if (callee.kind !== SyntaxKind.MemberAccessExpression) {
+            return undefined;
+        }
+
+        const receiver = callee.children[0];
+        const member = callee.children[1];
+        if (member?.kind !== SyntaxKind.Identifier || !member.name) {
+            return undefined;
+        }
+
+        const operator = callee.metadata?.operator;
+        if (operator === '::') {
+            return receiver?.kind === SyntaxKind.Identifier && receiver.name
+                ? { calleeName: member.name, range: member.range, kind: 'scoped', qualifier: receiver.name }
+                : undefined;
+        }
+        if (operator !== '->' || !this.objectInferenceService) {
+            return undefined;
+        }
+
+        const access = await this.objectInferenceService.inferObjectAccess(document, member.range.start);
+        if (access?.inference.status !== 'resolved') {
+            return undefined;
+        }
+
+        return {
+            calleeName: member.name,
+            range: member.range,
+            kind: 'object',
+            targetUris: access.inference.candidates.map((candidate) => normalizeWorkspaceUri(vscode.Uri.file(candidate.path)))
+        };
+    }
+}
+
+function collectFunctionDefinitions(syntax: SyntaxDocument, uri: string): CallGraphFunction[] {
+    const functions: CallGraphFunction[] = [];
+    for (const node of syntax.nodes) {
+        if (node.kind !== SyntaxKind.FunctionDeclaration || !node.name || node.metadata?.hasBody !== true) {
+            continue;
+        }
+
+        const identifier = node.children.find((child) => child.kind === SyntaxKind.Identifier && child.name === node.name);
+        functions.push({
+            uri,
+            name: node.name,
+            range: node.range,
+            selectionRange: identifier?.range ?? node.range
+        });
+    }
+
+    return functions;
+}
+
+function appendCall(
+    grouped: Map<string, CallGraphCall>,
+    caller: CallGraphFunction,
+    callee: CallGraphFunction,
+    range: vscode.Range,
+    key: string
+): void {
+    const existing = grouped.get(key);
+    if (existing) {
+        existing.ranges.push(range);
+        return;
+    }
+
+    grouped.set(key, { caller, callee, ranges: [range] });
+}
+
+function functionKey(fn: CallGraphFunction): string {
+    return `${fn.uri}#${fn.name}`;
+}
@@ -0,0 +1,323 @@
+import * as vscode from 'vscode';
+import { isLpcBuiltinType, isLpcKeyword } from '../../../frontend/languageFacts';
+import { normalizeWorkspaceUri } from './navigationPathUtils';
+
+export type WorkspaceReferenceRole = 'reference' | 'call' | 'member' | 'scoped';
+
+export interface WorkspaceReferencePosting {
+    uri: string;
+    range: vscode.Range;
+    role: WorkspaceReferenceRole;
+}
+
+export interface IdentifierOccurrence {
+    name: string;
+    line: number;
+    character: number;
+    role: WorkspaceReferenceRole;
+}
+
+type WorkspaceReferenceDocument = Pick<vscode.TextDocument, 'uri' | 'getText'>;
+type WorkspaceReferenceDocumentLoader = (uri: string) => Promise<WorkspaceReferenceDocument | undefined>;
+
+const ROLES: readonly WorkspaceReferenceRole[] = ['reference', 'call', 'member', 'scoped'];
+// Each packed occurrence is (line, character, role index).
+const POSTING_STRIDE = 3;
+
+/**
+ * Workspace-wide inverted index from identifier text to the places it occurs.
+ *
+ * Postings are lexical only: the index narrows find-references and rename down to files that
+ * mention a name, and the relation services still prove each hit against the real parse.
+ * Files edited since they were indexed are reported as candidates for every name until they
+ * are re-scanned, so an in-flight edit can never hide a reference.
+ */
+export class WorkspaceReferenceIndex {
+    // uri -> name -> packed occurrences
+    private readonly files = new Map<string, Map<string, number[]>>();
+    private readonly urisByName = new Map<string, Set<string>>();
+    private readonly staleUris = new Set<string>();
+
+    public constructor(private readonly loadDocument?: WorkspaceReferenceDocumentLoader) {}
+
+    public get fileCount(): number {
+        return this.files.size;
+    }
+
+    public updateFile(document: WorkspaceReferenceDocument): void {
+        const uri = normalizeWorkspaceUri(document.uri);
+        this.removeFile(uri);
+
+        const occurrences = new Map<string, number[]>();
+        for (const occurrence of scanIdentifierOccurrences(document.getText())) {
+            let packed = occurrences.get(occurrence.name);
+            if (!packed) {
+                packed = [];
+                occurrences.set(occurrence.name, packed);
+                this.addUriForName(occurrence.name, uri);
+            }
+            packed.push(occurrence.line, occurrence.character, ROLES.indexOf(occurrence.role));
+        }
+
+        this.files.set(uri, occurrences);
+    }
+
+    public removeFile(uri: string): void {
+        const normalizedUri = normalizeWorkspaceUri(uri);
+        this.staleUris.delete(normalizedUri);
+        const occurrences = this.files.get(normalizedUri);
+        if (!occurrences) {
+            return;
+        }
+
+        for (const name of occurrences.keys()) {
+            const uris = this.urisByName.get(name);
+            uris?.delete(normalizedUri);
+            if (uris?.size === 0) {
+                this.urisByName.delete(name);
+            }
+        }
+        this.files.delete(normalizedUri);
+    }
+
+    // The document changed but has not been re-scanned yet; it is refreshed on the next query.
+    public invalidate(uri: string): void {
+        const normalizedUri = normalizeWorkspaceUri(uri);
+        if (this.files.has(normalizedUri)) {
+            this.staleUris.add(normalizedUri);
+        }
+    }
+
+    public clear(): void {
+        this.files.clear();
+        this.urisByName.clear();
+        this.staleUris.clear();
+    }
+
+    /**
+     * Files that may mention `name`. Stale files are re-scanned first when a loader is available;
+     * otherwise they are returned unconditionally.
+     */
+    public async getCandidateUris(name: string): Promise<string[]> {
+        await this.refreshStaleFiles();
+        const candidates = new Set(this.urisByName.get(name) ?? []);
+        for (const uri of this.staleUris) {
+            candidates.add(uri);
+        }
+
+        return Array.from(candidates);
+    }
+
+    public getFilePostings(uri: string, name: string): WorkspaceReferencePosting[] {
+        const normalizedUri = normalizeWorkspaceUri(uri);
+        const packed = this.files.get(normalizedUri)?.get(name);
+        if (!packed) {
+            return [];
+        }
+
+        const postings: WorkspaceReferencePosting[] = [];
+        for (let index = 0; index < packed.length; index += POSTING_STRIDE) {
+            const line = packed[index];
+            const character = packed[index + 1];
+            postings.push({
+                uri: normalizedUri,
+                range: new vscode.Range(line, character, line, character + name.length),
+                role: ROLES[packed[index + 2]]
+            });
+        }
+
+        return postings;
+    }
+
+    public async getPostings(name: string): Promise<WorkspaceReferencePosting[]> {
+        const postings: WorkspaceReferencePosting[] = [];
+        for (const uri of await this.getCandidateUris(name)) {
+            postings.push(...this.getFilePostings(uri, name));
+        }
+
+        return postings;
+    }
+
+    private async refreshStaleFiles(): Promise<void> {
+        if (!this.loadDocument || this.staleUris.size === 0) {
+            return;
+        }
+
+        for (const uri of Array.from(this.staleUris)) {
+            try {
+                const document = await this.loadDocument(uri);
+                if (document) {
+                    this.updateFile(document);
+                } else {
+                    this.removeFile(uri);
+                }
+            } catch {
+                // Keep the stale mark so the file stays a conservative candidate.
+            }
+        }
+    }
+
+    private addUriForName(name: string, uri: string): void {
+        let uris = this.urisByName.get(name);
+        if (!uris) {
+            uris = new Set();
+            this.urisByName.set(name, uris);
+        }
+        uris.add(uri);
+    }
+}
+
+/**
+ * Single linear pass over source text that skips comments, string/char literals and `@TEXT`
+ * blocks, and tags each identifier by its neighbouring `(`, `->`, `.` or `::`.
+ * Keywords and builtin type names are not indexed.
+ */
+export function scanIdentifierOccurrences(text: string): IdentifierOccurrence[] {
+    const occurrences: IdentifierOccurrence[] = [];
+    let line = 0;
+    let lineStart = 0;
+    let cursor = 0;
+
+    const advanceLines = (endOffset: number): void => {
+        for (let index = text.indexOf('\n', cursor); index !== -1 && index < endOffset; index = text.indexOf('\n', index + 1)) {
+            line += 1;
+            lineStart = index + 1;
+        }
+        cursor = endOffset;
+    };
+
+    while (cursor < text.length) {
+        const char = text[cursor];
+        if (char === '\n') {
+            line += 1;
+            cursor += 1;
+            lineStart = cursor;
+            continue;
+        }
+
+        if (char === '"' || char === '\'') {
+            advanceLines(consumeQuoted(text, cursor, char));
+            continue;
+        }
+
+        if (char === '/' && text[cursor + 1] === '/') {
+            const newlineOffset = text.indexOf('\n', cursor + 2);
+            cursor = newlineOffset === -1 ? text.length : newlineOffset;
+            continue;
+        }
+
+        if (char === '/' && text[cursor + 1] === '*') {
+            const closingOffset = text.indexOf('*/', cursor + 2);
+            advanceLines(closingOffset === -1 ? text.length : closingOffset + 2);
+            continue;
+        }
+
+        if (char === '@') {
+            const textBlockEnd = consumeTextBlock(text, cursor);
+            if (textBlockEnd !== undefined) {
+                advanceLines(textBlockEnd);
+                continue;
+            }
+        }
+
+        if (!isIdentifierStart(char)) {
+            cursor += 1;
+            continue;
+        }
+
+        const start = cursor;
+        let end = cursor + 1;
+        while (end < text.length && isIdentifierPart(text[end])) {
+            end += 1;
+        }
+        cursor = end;
+
+        const name = text.slice(start, end);
+        if (name === name.toLowerCase() && (isLpcKeyword(name) || isLpcBuiltinType(name))) {
+            continue;
+        }
+
+        occurrences.push({
+            name,
+            line,
+            character: start - lineStart,
+            role: classifyOccurrenceRole(text, start, end)
+        });
+    }
+
+    return occurrences;
+}
+
+function classifyOccurrenceRole(text: string, start: number, end: number): WorkspaceReferenceRole {
+    let before = start - 1;
+    while (before >= 0 && isWhitespace(text[before])) {
+        before -= 1;
+    }
+
+    if (before >= 1 && text[before - 1] === '-' && text[before] === '>') {
+        return 'member';
+    }
+    if (before >= 1 && text[before - 1] === ':' && text[before] === ':') {
+        return 'scoped';
+    }
+    if (before >= 0 && text[before] === '.' && text[before - 1] !== '.') {
+        return 'member';
+    }
+
+    let after = end;
+    while (after < text.length && isWhitespace(text[after])) {
+        after += 1;
+    }
+
+    return text[after] === '(' ? 'call' : 'reference';
+}
+
+function consumeQuoted(text: string, startOffset: number, quote: string): number {
+    let cursor = startOffset + 1;
+    while (cursor < text.length) {
+        const char = text[cursor];
+        if (char === '\\') {
+            cursor += 2;
+            continue;
+        }
+        cursor += 1;
+        if (char === quote || (char === '\n' && quote === '\'')) {
+            break;
+        }
+    }
+
+    return Math.min(cursor, text.length);
+}
+
+// `@NAME` / `@@NAME` text blocks run until a line starting with `NAME`; returns undefined otherwise.
+function consumeTextBlock(text: string, startOffset: number): number | undefined {
+    const match = /^@@?([A-Za-z_][A-Za-z0-9_]*)[ \t]*\r?\n/.exec(text.slice(startOffset, startOffset + 256));
+    if (!match) {
+        return undefined;
+    }
+
+    const terminator = match[1];
+    let lineStart = startOffset + match[0].length;
+    while (lineStart < text.length) {
+        const newlineOffset = text.indexOf('\n', lineStart);
+        const lineEnd = newlineOffset === -1 ? text.length : newlineOffset;
+        if (text.startsWith(terminator, lineStart)) {
+            return lineEnd;
+        }
+        lineStart = lineEnd + 1;
+    }
+
+    return text.length;
+}
+
+function isWhitespace(char: string | undefined): boolean {
+    return char === ' ' || char === '\t' || char === '\r' || char === '\n';
+}
+
+function isIdentifierStart(char: string | undefined): boolean {
+    return Boolean(char && /[A-Za-z_]/.test(char));
+}
+
+function isIdentifierPart(char: string | undefined): boolean {
+    return Boolean(char && /[A-Za-z0-9_]/.test(char));
+}
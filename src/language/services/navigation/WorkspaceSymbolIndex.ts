@@ -0,0 +1,294 @@
+import * as vscode from 'vscode';
+import type { ProjectSymbolIndex } from '../../../completion/projectSymbolIndex';
+import type { FileSymbolRecord } from '../../../semantic/documentSemanticTypes';
+
+export type WorkspaceSymbolKind = 'function' | 'variable' | 'struct' | 'class';
+
+export interface WorkspaceSymbolMatch {
+    name: string;
+    kind: WorkspaceSymbolKind;
+    uri: string;
+    range: vscode.Range;
+}
+
+export interface WorkspaceSymbolSearchOptions {
+    /** Files the user is working in; matches in or near them rank first. */
+    nearUris?: readonly string[];
+    limit?: number;
+}
+
+type WorkspaceSymbolSource = Pick<ProjectSymbolIndex, 'getAllRecords' | 'revision'>;
+
+interface SymbolEntry extends WorkspaceSymbolMatch {
+    lowerName: string;
+}
+
+interface IndexedFile {
+    exportedFunctions: FileSymbolRecord['exportedFunctions'];
+    fileGlobals: FileSymbolRecord['fileGlobals'];
+    typeDefinitions: FileSymbolRecord['typeDefinitions'];
+    directorySegments: string[];
+    entryIds: number[];
+}
+
+const DEFAULT_LIMIT = 256;
+// Names are padded on the left so one- and two-character queries still map to a single gram (as prefixes).
+const GRAM_PADDING = '\u0000\u0000';
+
+/**
+ * Trigram index over the names `ProjectSymbolIndex` exports: functions, file globals and types.
+ *
+ * The index follows the project index by record identity. Records are replaced on every change
+ * and their summary arrays are shared, so only files whose summaries actually changed are
+ * re-tokenized, and nothing at all happens while the project index revision stays put.
+ */
+export class WorkspaceSymbolIndex {
+    private readonly entries: (SymbolEntry | undefined)[] = [];
+    private readonly freeIds: number[] = [];
+    private readonly postings = new Map<string, Set<number>>();
+    private readonly files = new Map<string, IndexedFile>();
+    private syncedRevision = -1;
+
+    public constructor(private readonly source: WorkspaceSymbolSource) {}
+
+    public get symbolCount(): number {
+        return this.entries.length - this.freeIds.length;
+    }
+
+    /**
+     * Case-insensitive substring search. Queries shorter than a trigram match name prefixes only.
+     * Results are ordered by match quality (exact, prefix, word start, substring), then by
+     * directory distance to `nearUris`, then by name length.
+     */
+    public search(query: string, options: WorkspaceSymbolSearchOptions = {}): WorkspaceSymbolMatch[] {
+        const lowerQuery = query.trim().toLowerCase();
+        if (!lowerQuery) {
+            // An empty query would list the whole workspace; the client narrows as the user types.
+            return [];
+        }
+
+        this.sync();
+        const candidates = this.findCandidateIds(lowerQuery);
+        if (!candidates) {
+            return [];
+        }
+
+        const nearDirectories = (options.nearUris ?? []).map(uri => toDirectorySegments(uri));
+        const distances = new Map<string, number>();
+        const ranked: Array<{ entry: SymbolEntry; quality: number; distance: number }> = [];
+        for (const id of candidates) {
+            const entry = this.entries[id];
+            const quality = entry ? scoreMatch(entry, query.trim(), lowerQuery) : undefined;
+            if (!entry || quality === undefined) {
+                continue;
+            }
+
+            let distance = distances.get(entry.uri);
+            if (distance === undefined) {
+                distance = measureDistance(this.files.get(entry.uri)?.directorySegments ?? [], nearDirectories);
+                distances.set(entry.uri, distance);
+            }
+            ranked.push({ entry, quality, distance });
+        }
+
+        ranked.sort((left, right) =>
+            left.quality - right.quality
+            || left.distance - right.distance
+            || left.entry.name.length - right.entry.name.length
+            || compareText(left.entry.name, right.entry.name)
+            || compareText(left.entry.uri, right.entry.uri)
+        );
+
+        return ranked.slice(0, options.limit ?? DEFAULT_LIMIT).map(({ entry }) => ({
+            name: entry.name,
+            kind: entry.kind,
+            uri: entry.uri,
+            range: entry.range
+        }));
+    }
+
+    private findCandidateIds(lowerQuery: string): Iterable<number> | undefined {
+        if (lowerQuery.length < 3) {
+            return this.postings.get((GRAM_PADDING + lowerQuery).slice(-3));
+        }
+
+        // Walk the rarest gram's postings; every hit is verified against the full name anyway.
+        let smallest: Set<number> | undefined;
+        for (const gram of toGrams(lowerQuery, false)) {
+            const posting = this.postings.get(gram);
+            if (!posting) {
+                return undefined;
+            }
+            if (!smallest || posting.size < smallest.size) {
+                smallest = posting;
+            }
+        }
+
+        return smallest;
+    }
+
+    private sync(): void {
+        const revision = this.source.revision;
+        if (revision === this.syncedRevision) {
+            return;
+        }
+
+        const liveUris = new Set<string>();
+        for (const record of this.source.getAllRecords()) {
+            liveUris.add(record.uri);
+            const indexed = this.files.get(record.uri);
+            if (
+                indexed
+                && indexed.exportedFunctions === record.exportedFunctions
+                && indexed.fileGlobals === record.fileGlobals
+                && indexed.typeDefinitions === record.typeDefinitions
+            ) {
+                continue;
+            }
+
+            this.removeFile(record.uri);
+            this.addFile(record);
+        }
+
+        if (liveUris.size !== this.files.size) {
+            for (const uri of Array.from(this.files.keys())) {
+                if (!liveUris.has(uri)) {
+                    this.removeFile(uri);
+                }
+            }
+        }
+
+        this.syncedRevision = revision;
+    }
+
+    private addFile(record: FileSymbolRecord): void {
+        const entryIds: number[] = [];
+        const add = (name: string, kind: WorkspaceSymbolKind, range: vscode.Range): void => {
+            entryIds.push(this.addEntry({ name, kind, uri: record.uri, range, lowerName: name.toLowerCase() }));
+        };
+
+        for (const func of record.exportedFunctions) {
+            if (!func.isPrototype) {
+                add(func.name, 'function', func.range);
+            }
+        }
+        for (const global of record.fileGlobals) {
+            add(global.name, 'variable', global.selectionRange ?? global.range);
+        }
+        for (const type of record.typeDefinitions) {
+            add(type.name, type.kind, type.range);
+        }
+
+        this.files.set(record.uri, {
+            exportedFunctions: record.exportedFunctions,
+            fileGlobals: record.fileGlobals,
+            typeDefinitions: record.typeDefinitions,
+            directorySegments: toDirectorySegments(record.uri),
+            entryIds
+        });
+    }
+
+    private removeFile(uri: string): void {
+        const indexed = this.files.get(uri);
+        if (!indexed) {
+            return;
+        }
+
+        for (const id of indexed.entryIds) {
+            const entry = this.entries[id];
+            if (!entry) {
+                continue;
+            }
+
+            for (const gram of toGrams(entry.lowerName, true)) {
+                const posting = this.postings.get(gram);
+                posting?.delete(id);
+                if (posting?.size === 0) {
+                    this.postings.delete(gram);
+                }
+            }
+            this.entries[id] = undefined;
+            this.freeIds.push(id);
+        }
+        this.files.delete(uri);
+    }
+
+    private addEntry(entry: SymbolEntry): number {
+        const id = this.freeIds.pop() ?? this.entries.length;
+        this.entries[id] = entry;
+        for (const gram of toGrams(entry.lowerName, true)) {
+            let posting = this.postings.get(gram);
+            if (!posting) {
+                posting = new Set();
+                this.postings.set(gram, posting);
+            }
+            posting.add(id);
+        }
+
+        return id;
+    }
+}
+
+function toGrams(text: string, padded: boolean): Set<string> {
+    const source = padded ? GRAM_PADDING + text : text;
+    const grams = new Set<string>();
+    for (let index = 0; index + 3 <= source.length; index += 1) {
+        grams.add(source.slice(index, index + 3));
+    }
+
+    return grams;
+}
+
+// 0 exact, 1 exact ignoring case, 2 prefix, 3 word start (`_x` or `aX`), 4 substring.
+function scoreMatch(entry: SymbolEntry, query: string, lowerQuery: string): number | undefined {
+    if (entry.name === query) {
+        return 0;
+    }
+    if (entry.lowerName === lowerQuery) {
+        return 1;
+    }
+    if (entry.lowerName.startsWith(lowerQuery)) {
+        return 2;
+    }
+
+    let quality: number | undefined;
+    for (let index = entry.lowerName.indexOf(lowerQuery, 1); index !== -1; index = entry.lowerName.indexOf(lowerQuery, index + 1)) {
+        const previous = entry.name[index - 1];
+        const current = entry.name[index];
+        if (previous === '_' || (previous === previous.toLowerCase() && current !== current.toLowerCase())) {
+            return 3;
+        }
+        quality = 4;
+    }
+
+    return quality;
+}
+
+function toDirectorySegments(uri: string): string[] {
+    let uriPath: string;
+    try {
+        uriPath = vscode.Uri.parse(uri).path;
+    } catch {
+        uriPath = uri.replace(/\\/g, '/');
+    }
+
+    return uriPath.toLowerCase().split('/').filter(Boolean).slice(0, -1);
+}
+
+// Steps through the directory tree to the nearest of `nearDirectories`; 0 for the same directory.
+function measureDistance(directory: readonly string[], nearDirectories: readonly string[][]): number {
+    let best = Number.MAX_SAFE_INTEGER;
+    for (const near of nearDirectories) {
+        let common = 0;
+        while (common < directory.length && common < near.length && directory[common] === near[common]) {
+            common += 1;
+        }
+        best = Math.min(best, directory.length + near.length - 2 * common);
+    }
+
+    return best;
+}
+
+function compareText(left: string, right: string): number {
+    return left < right ? -1 : left > right ? 1 : 0;
+}
@@ -89,7 +89,10 @@ function createSupport(overrides: Partial<ConstructorParameters<typeof Definitio
 
 function createAnalysisBackedSupport(
     documents: vscode.TextDocument[],
-    mutateSnapshot?: (document: vscode.TextDocument, snapshot: ReturnType<DocumentSemanticSnapshotService['getSemanticSnapshot']>) => void
+    overrideSnapshot?: (
+        document: vscode.TextDocument,
+        snapshot: ReturnType<DocumentSemanticSnapshotService['getSemanticSnapshot']>
+    ) => ReturnType<DocumentSemanticSnapshotService['getSemanticSnapshot']>
 ): DefinitionResolverSupport {
     const byKey = new Map<string, vscode.TextDocument>();
     for (const document of documents) {
@@ -119,13 +122,11 @@ function createAnalysisBackedSupport(
         analysisService: {
             getSemanticSnapshot: jest.fn((targetDocument: vscode.TextDocument) => {
                 const snapshot = analysisService.getSemanticSnapshot(targetDocument, false);
-                mutateSnapshot?.(targetDocument, snapshot);
-                return snapshot;
+                return overrideSnapshot ? overrideSnapshot(targetDocument, snapshot) : snapshot;
             }),
             getBestAvailableSnapshot: jest.fn((targetDocument: vscode.TextDocument) => {
                 const snapshot = analysisService.getSemanticSnapshot(targetDocument, false);
-                mutateSnapshot?.(targetDocument, snapshot);
-                return snapshot;
+                return overrideSnapshot ? overrideSnapshot(targetDocument, snapshot) : snapshot;
             })
         } as any
     });
@@ -450,9 +451,14 @@ describe('DirectSymbolDefinitionResolver', () => {
             '}'
         ].join('\n'));
         const support = createAnalysisBackedSupport([sourceDocument, headerDocument], (document, snapshot) => {
-            if (document === sourceDocument && snapshot.includeStatements[0]) {
-                snapshot.includeStatements[0].resolvedUri = headerDocument.uri.toString();
+            if (document !== sourceDocument || !snapshot.includeStatements[0]) {
+                return snapshot;
             }
+
+            return {
+                ...snapshot,
+                includeStatements: [{ ...snapshot.includeStatements[0], resolvedUri: headerDocument.uri.toString() }]
+            };
         });
         const resolver = new DirectSymbolDefinitionResolver({
             support,
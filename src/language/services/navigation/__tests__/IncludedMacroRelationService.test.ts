@@ -0,0 +1,146 @@
+import { describe, expect, jest, test } from '@jest/globals';
+import * as vscode from 'vscode';
+import type { MacroDefinitionFact, PreprocessorDirective } from '../../../../frontend/types';
+import { IncludedMacroRelationService } from '../IncludedMacroRelationService';
+import { normalizeWorkspaceUri } from '../navigationPathUtils';
+
+function createTextDocument(uriValue: string, source: string): vscode.TextDocument {
+    const lineStarts = [0];
+    for (let index = 0; index < source.length; index += 1) {
+        if (source[index] === '\n') {
+            lineStarts.push(index + 1);
+        }
+    }
+
+    return {
+        uri: vscode.Uri.parse(uriValue),
+        getText: () => source,
+        offsetAt: (position: vscode.Position) => lineStarts[position.line] + position.character,
+        positionAt: (offset: number) => {
+            let line = 0;
+            while (line + 1 < lineStarts.length && lineStarts[line + 1] <= offset) {
+                line += 1;
+            }
+            return new vscode.Position(line, offset - lineStarts[line]);
+        }
+    } as unknown as vscode.TextDocument;
+}
+
+function directive(
+    document: vscode.TextDocument,
+    kind: PreprocessorDirective['kind'],
+    rawText: string
+): PreprocessorDirective {
+    const startOffset = document.getText().indexOf(rawText);
+    const endOffset = startOffset + rawText.length;
+    return {
+        kind,
+        rawText,
+        body: rawText.replace(/^#\s*\w+\s*/, ''),
+        startOffset,
+        endOffset,
+        range: new vscode.Range(document.positionAt(startOffset), document.positionAt(endOffset))
+    };
+}
+
+function macro(document: vscode.TextDocument, definition: PreprocessorDirective, source: MacroDefinitionFact['source']): MacroDefinitionFact {
+    const [, name, replacement] = /#define\s+(\w+)\s+(.*)/.exec(definition.rawText) ?? [];
+    return {
+        name,
+        replacement,
+        isFunctionLike: false,
+        source,
+        sourceUri: document.uri.toString(),
+        startOffset: definition.startOffset,
+        endOffset: definition.endOffset,
+        range: definition.range
+    };
+}
+
+function reference(document: vscode.TextDocument, name: string, resolved: MacroDefinitionFact) {
+    const startOffset = document.getText().lastIndexOf(name);
+    const endOffset = startOffset + name.length;
+    return {
+        name,
+        resolved,
+        startOffset,
+        endOffset,
+        range: new vscode.Range(document.positionAt(startOffset), document.positionAt(endOffset))
+    };
+}
+
+function createFixture() {
+    const header = createTextDocument('file:///D:/mud/include/defs.h', '#ifndef HP_MAX\n#define HP_MAX 100\n#endif\n');
+    const room = createTextDocument('file:///D:/mud/room.c', '#include "include/defs.h"\nint hp = HP_MAX;\n');
+    const other = createTextDocument('file:///D:/mud/other.c', '#define HP_MAX 5\nint hp = HP_MAX;\n');
+
+    const headerDefine = directive(header, 'define', '#define HP_MAX 100');
+    const headerMacro = macro(header, headerDefine, 'document');
+    const otherDefine = directive(other, 'define', '#define HP_MAX 5');
+    const otherMacro = macro(other, otherDefine, 'document');
+    const preprocessors = new Map<string, unknown>([
+        [header.uri.toString(), {
+            directives: [directive(header, 'ifndef', '#ifndef HP_MAX'), headerDefine, directive(header, 'endif', '#endif')],
+            macros: [headerMacro],
+            macroReferences: []
+        }],
+        [room.uri.toString(), {
+            directives: [directive(room, 'include', '#include "include/defs.h"')],
+            macros: [{ ...headerMacro, source: 'include' }],
+            macroReferences: [reference(room, 'HP_MAX', { ...headerMacro, source: 'include' })]
+        }],
+        [other.uri.toString(), {
+            directives: [otherDefine],
+            macros: [otherMacro],
+            macroReferences: [reference(other, 'HP_MAX', otherMacro)]
+        }]
+    ]);
+    const documents = new Map([header, room, other].map((document) => [normalizeWorkspaceUri(document.uri), document]));
+
+    const service = new IncludedMacroRelationService({
+        host: {
+            openTextDocument: jest.fn(async (target: string | vscode.Uri) => {
+                const document = documents.get(normalizeWorkspaceUri(target));
+                if (!document) {
+                    throw new Error(`Unknown document ${target.toString()}`);
+                }
+                return document;
+            })
+        },
+        referenceIndex: {
+            getCandidateUris: jest.fn(async () => Array.from(documents.keys()))
+        },
+        frontendService: {
+            get: jest.fn((document: vscode.TextDocument) => ({ preprocessor: preprocessors.get(document.uri.toString()) }))
+        } as any
+    });
+
+    return { service, header, room };
+}
+
+function describeMatches(matches: Array<{ uri: string; range: vscode.Range }>): string[] {
+    return matches.map((match) => `${match.uri.split('/').pop()}:${match.range.start.line}:${match.range.start.character}`);
+}
+
+describe('IncludedMacroRelationService', () => {
+    test('collects expansions and directive names bound to the same definition across includes', async () => {
+        const { service, room } = createFixture();
+
+        const matches = await service.collectMacroReferences(room, new vscode.Position(1, 10), { includeDeclaration: true });
+
+        expect(describeMatches(matches)).toEqual(['room.c:1:9', 'defs.h:0:8', 'defs.h:1:8']);
+    });
+
+    test('resolves the target from its own #define line and honours includeDeclaration', async () => {
+        const { service, header } = createFixture();
+
+        expect(service.resolveMacroTarget(header, new vscode.Position(1, 10))).toEqual({
+            name: 'HP_MAX',
+            sourceUri: 'file:///D:/mud/include/defs.h',
+            startOffset: 15
+        });
+        const matches = await service.collectMacroReferences(header, new vscode.Position(1, 10), { includeDeclaration: false });
+
+        expect(describeMatches(matches)).toEqual(['defs.h:0:8', 'room.c:1:9']);
+    });
+});
@@ -2,6 +2,7 @@ import { afterEach, beforeEach, describe, expect, jest, test } from '@jest/globa
 import * as vscode from 'vscode';
 import { DocumentSemanticSnapshotService } from '../../../../semantic/documentSemanticSnapshotService';
 import { InheritedFunctionRelationService } from '../InheritedFunctionRelationService';
+import { WorkspaceReferenceIndex } from '../WorkspaceReferenceIndex';
 import {
     configureAstManagerSingletonForTests,
     resetAstManagerSingletonForTests
@@ -203,6 +204,65 @@ describe('InheritedFunctionRelationService', () => {
         ]));
     });
 
+    test('extends function references to indexed descendants and overrides that provably bind to the family', async () => {
+        const baseSource = 'void create() {}\n';
+        const roomSource = 'inherit "/base";\nvoid demo(object ob) {\n    create();\n    ob->create();\n}\n';
+        const overrideSource = 'inherit "/base";\nvoid create() {}\nvoid demo() { create(); }\n';
+        const otherSource = 'void demo() { create(); }\n';
+        const baseDocument = createTextDocument('file:///D:/workspace/base.c', baseSource);
+        const roomDocument = createTextDocument('file:///D:/workspace/room.c', roomSource);
+        const overrideDocument = createTextDocument('file:///D:/workspace/override.c', overrideSource);
+        const otherDocument = createTextDocument('file:///D:/workspace/other.c', otherSource);
+        const documents = new Map([baseDocument, roomDocument, overrideDocument, otherDocument]
+            .map((document): [string, vscode.TextDocument] => [document.uri.toString(), document]));
+        const referenceIndex = new WorkspaceReferenceIndex();
+        for (const document of documents.values()) {
+            referenceIndex.updateFile(document);
+        }
+
+        const service = new InheritedFunctionRelationService({
+            analysisService,
+            inheritanceResolver: createInheritanceResolverStub((snapshot: { uri: string }) => {
+                if (snapshot.uri === roomDocument.uri.toString() || snapshot.uri === overrideDocument.uri.toString()) {
+                    return [{
+                        rawValue: '/base',
+                        expressionKind: 'string',
+                        sourceUri: snapshot.uri,
+                        resolvedUri: baseDocument.uri.toString(),
+                        isResolved: true
+                    }];
+                }
+
+                return [];
+            }),
+            host: {
+                openTextDocument: jest.fn(async (target: string | vscode.Uri) => {
+                    const key = typeof target === 'string' ? target : target.toString();
+                    const document = documents.get(key);
+                    if (!document) {
+                        throw new Error(`Unknown document ${key}`);
+                    }
+
+                    return document;
+                })
+            },
+            referenceIndex
+        });
+
+        const matches = await service.collectFunctionReferences(
+            baseDocument,
+            positionOn(baseSource, 'create'),
+            { includeDeclaration: true }
+        );
+
+        expect(matches.map((match) => `${match.uri.split('/').pop()}:${match.range.start.line}:${match.range.start.character}`)).toEqual([
+            'base.c:0:5',
+            'room.c:2:4',
+            'override.c:1:5',
+            'override.c:2:14'
+        ]);
+    });
+
     test('ignores scoped calls when room:: qualifier is not unique', async () => {
         const childSource = 'void demo() {\n    room::init();\n}\n';
         const childDocument = createTextDocument('file:///D:/workspace/room.c', childSource);
@@ -452,8 +452,26 @@ describe('InheritedSymbolRelationService', () => {
         )).resolves.toEqual({ kind: 'current-file-only' });
     });
 
+    test('classifyRenameTarget returns function for a function whose inherit family is fully resolved', async () => {
+        const source = 'int query_id() { return 1; }\n';
+        const document = createTextDocument('file:///D:/workspace/query_id.c', source);
+        const service = createInheritedSymbolRelationService({
+            analysisService,
+            inheritanceResolver: {
+                resolveInheritTargets: jest.fn(() => [])
+            } as any,
+            host: {
+                openTextDocument: jest.fn()
+            }
+        });
+
+        await expect(service.classifyRenameTarget(
+            document,
+            positionOn(source, 'query_id')
+        )).resolves.toEqual({ kind: 'function' });
+    });
+
     test.each([
-        ['function', 'int query_id() { return 1; }\n', 'query_id'],
         ['struct', 'struct Payload {\n    int hp;\n}\n', 'Payload'],
         ['class', 'class Payload {\n    int hp;\n}\n', 'Payload']
     ] as const)('classifyRenameTarget returns unsupported for %s symbols', async (_label, source, symbol) => {
@@ -884,6 +902,71 @@ describe('InheritedSymbolRelationService', () => {
         });
     });
 
+    test('buildInheritedRenameEdits renames an inherited function at its definition and unbound calls only', async () => {
+        const childSource = 'inherit "/base";\nvoid demo() {\n    create();\n    this_object()->create();\n}\n';
+        const parentSource = 'void create() {}\n';
+        const childDocument = createTextDocument('file:///D:/workspace/room.c', childSource);
+        const parentDocument = createTextDocument('file:///D:/workspace/base.c', parentSource);
+        const documents = new Map([
+            [childDocument.uri.fsPath, childDocument],
+            [parentDocument.uri.fsPath, parentDocument]
+        ]);
+        const service = createInheritedSymbolRelationService({
+            analysisService,
+            inheritanceResolver: {
+                resolveInheritTargets: jest.fn((snapshot: { uri: string }) => {
+                    if (snapshot.uri === childDocument.uri.toString()) {
+                        return [{
+                            rawValue: '/base',
+                            expressionKind: 'string',
+                            sourceUri: childDocument.uri.toString(),
+                            resolvedUri: parentDocument.uri.toString(),
+                            isResolved: true
+                        }];
+                    }
+
+                    return [];
+                })
+            } as any,
+            host: {
+                openTextDocument: jest.fn(async (target: string | vscode.Uri) => {
+                    const key = documentLookupKey(target);
+                    const document = documents.get(key);
+                    if (!document) {
+                        throw new Error(`Unknown document ${key}`);
+                    }
+
+                    return document;
+                })
+            }
+        });
+
+        await expect(service.classifyRenameTarget(
+            childDocument,
+            positionOn(childSource, 'create')
+        )).resolves.toEqual({ kind: 'function' });
+        const edits = await service.buildInheritedRenameEdits(
+            childDocument,
+            positionOn(childSource, 'create'),
+            'setup'
+        );
+
+        expect(edits).toEqual({
+            'file:///D:/workspace/base.c': [
+                {
+                    range: new vscode.Range(0, 5, 0, 11),
+                    newText: 'setup'
+                }
+            ],
+            'file:///D:/workspace/room.c': [
+                {
+                    range: new vscode.Range(2, 4, 2, 10),
+                    newText: 'setup'
+                }
+            ]
+        });
+    });
+
     test('buildInheritedRenameEdits returns no inherited edits when sibling inherit branches make the global binding ambiguous', async () => {
         const childSource = 'void demo() { GLOBAL_D += 1; }\n';
         const parentASource = 'int GLOBAL_D;\n';
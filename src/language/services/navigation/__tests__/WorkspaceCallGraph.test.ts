@@ -0,0 +1,193 @@
+import { afterEach, beforeEach, describe, expect, jest, test } from '@jest/globals';
+import * as vscode from 'vscode';
+import { DocumentSemanticSnapshotService } from '../../../../semantic/documentSemanticSnapshotService';
+import { WorkspaceCallGraph, type CallGraphCall } from '../WorkspaceCallGraph';
+import {
+    configureAstManagerSingletonForTests,
+    resetAstManagerSingletonForTests
+} from '../../../../__tests__/testAstManagerSingleton';
+
+function createTextDocument(uriValue: string, source: string, version: number = 1): vscode.TextDocument {
+    const uri = vscode.Uri.parse(uriValue);
+    const lines = source.split(/\r?\n/);
+    const lineStarts = [0];
+
+    for (let index = 0; index < source.length; index += 1) {
+        if (source[index] === '\n') {
+            lineStarts.push(index + 1);
+        }
+    }
+
+    const offsetAt = (position: vscode.Position): number => {
+        const lineStart = lineStarts[position.line] ?? source.length;
+        return Math.min(lineStart + position.character, source.length);
+    };
+
+    const positionAt = (offset: number): vscode.Position => {
+        let line = 0;
+        for (let index = 0; index < lineStarts.length; index += 1) {
+            if (lineStarts[index] <= offset) {
+                line = index;
+            } else {
+                break;
+            }
+        }
+
+        return new vscode.Position(line, offset - lineStarts[line]);
+    };
+
+    return {
+        uri,
+        fileName: uri.fsPath,
+        languageId: 'lpc',
+        version,
+        lineCount: lines.length,
+        isDirty: false,
+        isClosed: false,
+        isUntitled: false,
+        eol: vscode.EndOfLine.LF,
+        getText: jest.fn((range?: vscode.Range) => {
+            if (!range) {
+                return source;
+            }
+
+            return source.slice(offsetAt(range.start), offsetAt(range.end));
+        }),
+        lineAt: jest.fn((line: number) => ({ text: lines[line] ?? '' })),
+        getWordRangeAtPosition: jest.fn((position: vscode.Position) => {
+            const lineText = lines[position.line] ?? '';
+            const isWordCharacter = (char: string | undefined) => Boolean(char && /[A-Za-z0-9_]/.test(char));
+
+            let start = position.character;
+            while (start > 0 && isWordCharacter(lineText[start - 1])) {
+                start -= 1;
+            }
+
+            let end = position.character;
+            while (end < lineText.length && isWordCharacter(lineText[end])) {
+                end += 1;
+            }
+
+            if (start === end) {
+                return undefined;
+            }
+
+            return new vscode.Range(position.line, start, position.line, end);
+        }),
+        positionAt: jest.fn(positionAt),
+        offsetAt: jest.fn(offsetAt),
+        save: jest.fn(async () => true),
+        validateRange: jest.fn((range: vscode.Range) => range),
+        validatePosition: jest.fn((position: vscode.Position) => position)
+    } as unknown as vscode.TextDocument;
+}
+
+function documentKey(target: string | vscode.Uri): string {
+    const uri = typeof target === 'string' ? vscode.Uri.parse(target) : target;
+    return uri.fsPath.replace(/^[/\\]+(?=[A-Za-z]:)/, '').replace(/\\/g, '/');
+}
+
+function describeCalls(calls: CallGraphCall[], side: 'caller' | 'callee'): string[] {
+    return calls.map((call) => {
+        const fn = call[side];
+        const ranges = call.ranges.map((range) => `${range.start.line}:${range.start.character}`).join(',');
+        return `${fn.uri.split('/').pop()}#${fn.name}@${ranges}`;
+    });
+}
+
+describe('WorkspaceCallGraph', () => {
+    const analysisService = DocumentSemanticSnapshotService.getInstance();
+
+    beforeEach(() => {
+        configureAstManagerSingletonForTests(analysisService);
+    });
+
+    afterEach(() => {
+        resetAstManagerSingletonForTests();
+        jest.restoreAllMocks();
+    });
+
+    test('binds direct, inherited and provable object calls and answers both directions', async () => {
+        const baseDocument = createTextDocument('file:///D:/mud/base.c', 'void heal() {}\nvoid rest() { heal(); }\n');
+        const daemonDocument = createTextDocument('file:///D:/mud/daemon.c', 'void heal() {}\n');
+        const roomSource = 'inherit "/base";\nvoid create() {\n    heal();\n    ob->heal();\n    write("done");\n}\n';
+        const roomDocument = createTextDocument('file:///D:/mud/room.c', roomSource);
+        const documents = new Map([baseDocument, daemonDocument, roomDocument].map((document) => [documentKey(document.uri), document]));
+        const callGraph = new WorkspaceCallGraph({
+            analysisService,
+            inheritanceResolver: {
+                resolveInheritTargets: jest.fn((snapshot: { uri: string }) => snapshot.uri === roomDocument.uri.toString()
+                    ? [{
+                        rawValue: '/base',
+                        expressionKind: 'string',
+                        sourceUri: roomDocument.uri.toString(),
+                        resolvedUri: baseDocument.uri.toString(),
+                        isResolved: true
+                    }]
+                    : [])
+            } as any,
+            host: {
+                openTextDocument: jest.fn(async (target: string | vscode.Uri) => {
+                    const document = documents.get(documentKey(target));
+                    if (!document) {
+                        throw new Error(`Unknown document ${target.toString()}`);
+                    }
+                    return document;
+                })
+            },
+            objectInferenceService: {
+                inferObjectAccess: jest.fn(async (_document: vscode.TextDocument, position: vscode.Position) => position.line === 3
+                    ? {
+                        receiver: 'ob',
+                        memberName: 'heal',
+                        inference: { status: 'resolved', candidates: [{ path: daemonDocument.uri.fsPath, source: 'literal' }] }
+                    }
+                    : undefined)
+            } as any
+        });
+
+        const [inheritedHeal] = await callGraph.resolveFunctionsAt(roomDocument, new vscode.Position(2, 5));
+        expect(inheritedHeal).toEqual(expect.objectContaining({ name: 'heal', uri: 'file:///D:/mud/base.c' }));
+
+        const [create] = await callGraph.resolveFunctionsAt(roomDocument, new vscode.Position(1, 6));
+        expect(describeCalls(await callGraph.getOutgoingCalls(create), 'callee')).toEqual([
+            'base.c#heal@2:4',
+            'daemon.c#heal@3:8'
+        ]);
+        expect(describeCalls(await callGraph.getIncomingCalls(inheritedHeal), 'caller')).toEqual([
+            'base.c#rest@1:14',
+            'room.c#create@2:4'
+        ]);
+    });
+
+    test('drops calls that cannot be bound to exactly one definition and rebuilds invalidated files', async () => {
+        const leftDocument = createTextDocument('file:///D:/mud/left.c', 'void heal() {}\n');
+        const rightDocument = createTextDocument('file:///D:/mud/right.c', 'void heal() {}\n');
+        let hallDocument = createTextDocument('file:///D:/mud/hall.c', 'void create() { heal(); }\n');
+        const documents = new Map([leftDocument, rightDocument].map((document) => [documentKey(document.uri), document]));
+        const callGraph = new WorkspaceCallGraph({
+            analysisService,
+            inheritanceResolver: {
+                resolveInheritTargets: jest.fn((snapshot: { uri: string }) => snapshot.uri === hallDocument.uri.toString()
+                    ? [leftDocument, rightDocument].map((document) => ({
+                        rawValue: document.uri.path,
+                        expressionKind: 'string',
+                        sourceUri: hallDocument.uri.toString(),
+                        resolvedUri: document.uri.toString(),
+                        isResolved: true
+                    }))
+                    : [])
+            } as any,
+            host: {
+                openTextDocument: jest.fn(async (target: string | vscode.Uri) => documents.get(documentKey(target)) ?? hallDocument)
+            }
+        });
+
+        const [create] = await callGraph.resolveFunctionsAt(hallDocument, new vscode.Position(0, 6));
+        expect(await callGraph.getOutgoingCalls(create)).toEqual([]);
+
+        hallDocument = createTextDocument('file:///D:/mud/hall.c', 'void create() { heal(); }\nvoid heal() {}\n', 2);
+        callGraph.invalidate(hallDocument.uri.toString());
+        expect(describeCalls(await callGraph.getOutgoingCalls(create), 'callee')).toEqual(['hall.c#heal@0:16']);
+    });
+});
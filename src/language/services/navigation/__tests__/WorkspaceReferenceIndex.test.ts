@@ -0,0 +1,67 @@
+import { describe, expect, test } from '@jest/globals';
+import * as vscode from 'vscode';
+import { scanIdentifierOccurrences, WorkspaceReferenceIndex } from '../WorkspaceReferenceIndex';
+
+function createDocument(uri: string, text: string): Pick<vscode.TextDocument, 'uri' | 'getText'> {
+    return {
+        uri: vscode.Uri.parse(uri),
+        getText: () => text
+    };
+}
+
+describe('WorkspaceReferenceIndex', () => {
+    test('scans identifiers with call roles while skipping comments, strings and text blocks', () => {
+        const source = [
+            'int hp; // heal()',
+            'void demo(object ob) {',
+            '    string s = "heal()" + @TEXT',
+            'heal() inside a text block',
+            'TEXT;',
+            '    heal(hp);',
+            '    ob->heal();',
+            '    ::heal(); /* heal */ hp = 1;',
+            '}'
+        ].join('\n');
+
+        const occurrences = scanIdentifierOccurrences(source)
+            .filter((occurrence) => occurrence.name === 'heal' || occurrence.name === 'hp')
+            .map((occurrence) => `${occurrence.name}@${occurrence.line}:${occurrence.character}:${occurrence.role}`);
+
+        expect(occurrences).toEqual([
+            'hp@0:4:reference',
+            'heal@5:4:call',
+            'hp@5:9:reference',
+            'heal@6:8:member',
+            'heal@7:6:scoped',
+            'hp@7:25:reference'
+        ]);
+    });
+
+    test('replaces postings per file and reloads stale files on the next query', async () => {
+        const texts = new Map([
+            ['file:///D:/mud/a.c', 'void heal() {}\n'],
+            ['file:///D:/mud/b.c', 'void demo() { heal(); }\n']
+        ]);
+        const index = new WorkspaceReferenceIndex(async (uri) => {
+            const text = texts.get(uri);
+            return text === undefined ? undefined : createDocument(uri, text);
+        });
+        for (const [uri, text] of texts) {
+            index.updateFile(createDocument(uri, text));
+        }
+
+        expect((await index.getCandidateUris('heal')).sort()).toEqual(['file:///D:/mud/a.c', 'file:///D:/mud/b.c']);
+        expect(index.getFilePostings('file:///D:/mud/b.c', 'heal')).toEqual([
+            expect.objectContaining({ role: 'call', range: new vscode.Range(0, 14, 0, 18) })
+        ]);
+
+        texts.set('file:///D:/mud/b.c', 'void demo() { rest(); }\n');
+        index.invalidate('file:///D:/mud/b.c');
+        texts.delete('file:///D:/mud/a.c');
+        index.invalidate('file:///D:/mud/a.c');
+
+        expect(await index.getCandidateUris('heal')).toEqual([]);
+        expect(await index.getCandidateUris('rest')).toEqual(['file:///D:/mud/b.c']);
+        expect(index.fileCount).toBe(1);
+    });
+});
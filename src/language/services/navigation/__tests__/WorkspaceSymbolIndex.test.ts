@@ -0,0 +1,126 @@
+import { describe, expect, test } from '@jest/globals';
+import * as vscode from 'vscode';
+import type { FileSymbolRecord } from '../../../../semantic/documentSemanticTypes';
+import { IndexedLanguageWorkspaceSymbolService } from '../LanguageWorkspaceSymbolService';
+import { WorkspaceSymbolIndex } from '../WorkspaceSymbolIndex';
+
+function createRecord(
+    uri: string,
+    functions: string[],
+    globals: string[] = [],
+    types: Array<{ name: string; kind: 'struct' | 'class' }> = []
+): FileSymbolRecord {
+    const range = (line: number) => new vscode.Range(line, 0, line, 10);
+    return {
+        uri,
+        version: 1,
+        exportedFunctions: functions.map((name, line) => ({ name, range: range(line) })),
+        fileGlobals: globals.map((name, line) => ({ name, range: range(line) })),
+        typeDefinitions: types.map((type, line) => ({ ...type, range: range(line) })),
+        inheritStatements: [],
+        includeStatements: [],
+        macroReferences: [],
+        updatedAt: 0
+    } as unknown as FileSymbolRecord;
+}
+
+function createSource(records: FileSymbolRecord[]) {
+    const source = {
+        revision: 0,
+        records,
+        getAllRecords: () => source.records,
+        replace(next: FileSymbolRecord[]) {
+            source.records = next;
+            source.revision += 1;
+        }
+    };
+    return source;
+}
+
+function describeMatches(matches: Array<{ name: string; uri: string }>): string[] {
+    return matches.map((match) => `${match.name}@${match.uri.replace('file:///D:/mud/', '')}`);
+}
+
+describe('WorkspaceSymbolIndex', () => {
+    test('ranks by match quality, then proximity to open files, and matches short queries as prefixes', () => {
+        const source = createSource([
+            createRecord('file:///D:/mud/std/room.c', ['query_heal_rate', 'heal', 'reset'], ['heal_bonus']),
+            createRecord('file:///D:/mud/d/city/inn.c', ['heal', 'do_heal', 'create'], [], [{ name: 'HealInfo', kind: 'class' }]),
+            createRecord('file:///D:/mud/adm/daemons/combat.c', ['selfheal', 'Heal'])
+        ]);
+        const index = new WorkspaceSymbolIndex(source);
+
+        expect(describeMatches(index.search('heal', { nearUris: ['file:///D:/mud/d/city/bar.c'] }))).toEqual([
+            'heal@d/city/inn.c',
+            'heal@std/room.c',
+            'Heal@adm/daemons/combat.c',
+            'HealInfo@d/city/inn.c',
+            'heal_bonus@std/room.c',
+            'do_heal@d/city/inn.c',
+            'query_heal_rate@std/room.c',
+            'selfheal@adm/daemons/combat.c'
+        ]);
+        expect(index.search('HealInfo')[0]).toEqual(expect.objectContaining({ kind: 'class' }));
+        expect(describeMatches(index.search('re'))).toEqual(['reset@std/room.c']);
+        expect(index.search('he', { limit: 2 })).toHaveLength(2);
+        expect(index.search('xyz')).toEqual([]);
+        expect(index.search('')).toEqual([]);
+    });
+
+    test('re-tokenizes only changed records and drops removed files', () => {
+        const room = createRecord('file:///D:/mud/std/room.c', ['heal']);
+        const inn = createRecord('file:///D:/mud/d/city/inn.c', ['heal_all']);
+        const source = createSource([room, inn]);
+        const index = new WorkspaceSymbolIndex(source);
+
+        expect(describeMatches(index.search('heal'))).toEqual(['heal@std/room.c', 'heal_all@d/city/inn.c']);
+
+        source.replace([createRecord('file:///D:/mud/std/room.c', ['restore'])]);
+
+        expect(describeMatches(index.search('heal'))).toEqual([]);
+        expect(describeMatches(index.search('restore'))).toEqual(['restore@std/room.c']);
+        expect(index.symbolCount).toBe(1);
+    });
+
+    test('streams ranked results in batches when the caller accepts partial results', async () => {
+        const names = Array.from({ length: 100 }, (_, index) => `heal_${String(index).padStart(3, '0')}`);
+        const service = new IndexedLanguageWorkspaceSymbolService(
+            new WorkspaceSymbolIndex(createSource([createRecord('file:///D:/mud/std/room.c', names)])),
+            90
+        );
+        const batches: string[][] = [];
+
+        const result = await service.provideWorkspaceSymbols({
+            query: 'heal',
+            onPartialResult: (symbols) => batches.push(symbols.map((symbol) => symbol.name))
+        });
+
+        expect(result).toEqual([]);
+        expect(batches.map((batch) => batch.length)).toEqual([64, 26]);
+        expect(batches[0][0]).toBe('heal_000');
+        expect(batches[1][25]).toBe('heal_089');
+    });
+
+    test('stops streaming when the request is cancelled between batches', async () => {
+        const names = Array.from({ length: 200 }, (_, index) => `heal_${String(index).padStart(3, '0')}`);
+        const service = new IndexedLanguageWorkspaceSymbolService(
+            new WorkspaceSymbolIndex(createSource([createRecord('file:///D:/mud/std/room.c', names)]))
+        );
+        const batches: string[][] = [];
+        let cancelled = false;
+
+        await service.provideWorkspaceSymbols({
+            query: 'heal',
+            isCancellationRequested: () => cancelled,
+            onPartialResult: (symbols) => {
+                batches.push(symbols.map((symbol) => symbol.name));
+                // Simulates a cancellation notification arriving after the first batch was sent.
+                setTimeout(() => {
+                    cancelled = true;
+                }, 0);
+            }
+        });
+
+        expect(batches.map((batch) => batch.length)).toEqual([64]);
+    });
+});
@@ -1522,6 +1522,47 @@ describe('navigation services', () => {
         });
     });
 
+    test('rename service uses only the proved cross-file edits for function targets', async () => {
+        const document = createDocument('void heal() {} void demo(object ob) { heal(); ob->heal(); }');
+        const inheritedEdits = {
+            'file:///D:/workspace/test.c': [
+                {
+                    range: {
+                        start: { line: 0, character: 5 },
+                        end: { line: 0, character: 9 }
+                    },
+                    newText: 'cure'
+                }
+            ]
+        };
+        const inheritedRelationService = {
+            classifyRenameTarget: jest.fn().mockResolvedValue({ kind: 'function' }),
+            buildInheritedRenameEdits: jest.fn().mockResolvedValue(inheritedEdits)
+        };
+        const referenceResolver = {
+            resolveReferences: jest.fn()
+        };
+        const service: LanguageRenameService = new AstBackedLanguageRenameService({
+            referenceResolver,
+            inheritedRelationService
+        } as any);
+
+        const edit = await service.provideRenameEdits({
+            context: createContext(document),
+            position: { line: 0, character: 6 },
+            newName: 'cure'
+        });
+
+        expect(inheritedRelationService.buildInheritedRenameEdits).toHaveBeenCalledWith(
+            expect.anything(),
+            expect.anything(),
+            'cure',
+            { kind: 'function' }
+        );
+        expect(referenceResolver.resolveReferences).not.toHaveBeenCalled();
+        expect(edit).toEqual({ changes: inheritedEdits });
+    });
+
     test('rename service keeps current-file file-global edits when inherited expansion downgrades to empty', async () => {
         const document = createDocument('int round; round += 1;');
         const inheritedRelationService = {
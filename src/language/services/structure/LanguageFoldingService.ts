@@ -3,6 +3,7 @@ import type { DocumentAnalysisService } from '../../../semantic/documentAnalysis
 import { SyntaxKind, SyntaxNode } from '../../../syntax/types';
 import type { LanguageCapabilityContext } from '../../contracts/LanguageCapabilityContext';
 import type {
+    LanguageSemanticTokensRangeRequest,
     LanguageSemanticTokensRequest,
     LanguageSemanticTokensResult
 } from './LanguageSemanticTokensService';
@@ -28,6 +29,9 @@ export interface LanguageStructureService {
     provideSemanticTokens(
         request: LanguageSemanticTokensRequest
     ): Promise<LanguageSemanticTokensResult>;
+    provideSemanticTokensRange?(
+        request: LanguageSemanticTokensRangeRequest
+    ): Promise<LanguageSemanticTokensResult>;
 }
 
 interface HostPosition {
@@ -9,17 +9,24 @@ import {
 import { assertAnalysisService } from '../../../semantic/assertAnalysisService';
 import type { DocumentAnalysisService } from '../../../semantic/documentAnalysisService';
 import { DocumentSemanticSnapshot } from '../../../semantic/documentSemanticTypes';
+import { LPCLexer } from '../../../antlr/LPCLexer';
 import {
-    classifyLexicalSemanticToken,
-    isDefaultChannelToken,
-    isIdentifierToken,
+    classifyLexicalSemanticTokenType,
     type LpcTokenLike
 } from '../../../parser/LpcTokenFacts';
+import { TokenTable } from '../../../parser/TokenTable';
+import type { ParsedDocument } from '../../../parser/types';
 import type { LanguageCapabilityContext } from '../../contracts/LanguageCapabilityContext';
+import type { LanguageRange } from '../../contracts/LanguagePosition';
 import {
     DEFAULT_LANGUAGE_SEMANTIC_TOKEN_MODIFIERS,
     DEFAULT_LANGUAGE_SEMANTIC_TOKEN_TYPES
 } from './semanticTokenLegend';
+import {
+    decodeSemanticTokens,
+    SemanticTokenEncoder,
+    sliceSemanticTokenLines
+} from './semanticTokenEncoding';
 
 export {
     DEFAULT_LANGUAGE_SEMANTIC_TOKEN_MODIFIERS,
@@ -43,15 +50,34 @@ export interface LanguageSemanticTokensRequest {
     context: LanguageCapabilityContext;
 }
 
+export interface LanguageSemanticTokensRangeRequest extends LanguageSemanticTokensRequest {
+    range: LanguageRange;
+}
+
 export interface LanguageSemanticTokensResult {
     legend: LanguageSemanticTokensLegend;
     tokens: LanguageSemanticToken[];
+    /** 按 `legend` 编码好的 LSP 整数数组；提供时 `tokens` 只是它的解码视图 */
+    data?: readonly number[];
 }
 
 export interface LanguageSemanticTokensService {
     provideSemanticTokens(
         request: LanguageSemanticTokensRequest
     ): Promise<LanguageSemanticTokensResult>;
+    provideSemanticTokensRange?(
+        request: LanguageSemanticTokensRangeRequest
+    ): Promise<LanguageSemanticTokensResult>;
+}
+
+interface SemanticTokenLineRange {
+    startLine: number;
+    endLine: number;
+}
+
+interface EncodedSemanticTokens {
+    readonly snapshot: DocumentSemanticSnapshot;
+    readonly data: readonly number[];
 }
 
 interface HostPosition {
@@ -136,6 +162,9 @@ export function loadConfiguredEfunNames(runtimeDir: string = __dirname): Set<str
 const EFUNS = loadConfiguredEfunNames();
 
 export class DefaultLanguageSemanticTokensService implements LanguageSemanticTokensService {
+    /** 按解析结果缓存整篇编码；同一版本的预热、全量与增量请求共用一次分类 */
+    private readonly encodedTokens = new WeakMap<object, EncodedSemanticTokens>();
+
     public constructor(
         private readonly analysisService: Pick<DocumentAnalysisService, 'parseDocument'>
     ) {}
@@ -144,145 +173,178 @@ export class DefaultLanguageSemanticTokensService implements LanguageSemanticTok
         request: LanguageSemanticTokensRequest
     ): Promise<LanguageSemanticTokensResult> {
         const document = request.context.document;
-        const analysis = assertAnalysisService(
-            'DefaultLanguageSemanticTokensService',
-            this.analysisService
-        ).parseDocument(document as any);
+        const analysis = this.parseDocument(document);
         const parsed = analysis.parsed;
+        if (!parsed) {
+            return createSemanticTokensResult([]);
+        }
 
+        const cached = this.encodedTokens.get(parsed);
+        if (cached && cached.snapshot === analysis.snapshot) {
+            return createSemanticTokensResult(cached.data);
+        }
+
+        const data = this.encodeTokens(document.getText(), analysis.snapshot, parsed);
+        this.encodedTokens.set(parsed, { snapshot: analysis.snapshot, data });
+        return createSemanticTokensResult(data);
+    }
+
+    /**
+     * 只为 `range` 覆盖的行分类 token（通常是编辑器可见区域）；
+     * 已有整篇编码时直接截取。
+     */
+    public async provideSemanticTokensRange(
+        request: LanguageSemanticTokensRangeRequest
+    ): Promise<LanguageSemanticTokensResult> {
+        const document = request.context.document;
+        const analysis = this.parseDocument(document);
+        const parsed = analysis.parsed;
         if (!parsed) {
-            return {
-                legend: {
-                    tokenTypes: [...DEFAULT_LANGUAGE_SEMANTIC_TOKEN_TYPES],
-                    tokenModifiers: [...DEFAULT_LANGUAGE_SEMANTIC_TOKEN_MODIFIERS]
-                },
-                tokens: []
-            };
+            return createSemanticTokensResult([]);
         }
 
-        parsed.tokens.fill();
-        const tokens = parsed.tokens.getTokens();
-        const semanticTokens: LanguageSemanticToken[] = [];
-        const context = new SemanticTokenContext(document.getText(), analysis.snapshot, parsed);
+        const lineRange = { startLine: request.range.start.line, endLine: request.range.end.line };
+        const cached = this.encodedTokens.get(parsed);
+        if (cached && cached.snapshot === analysis.snapshot) {
+            return createSemanticTokensResult(sliceSemanticTokenLines(cached.data, lineRange.startLine, lineRange.endLine));
+        }
 
-        for (let index = 0; index < tokens.length; index++) {
-            const token = tokens[index];
-            if (context.isTokenInactive(token)) {
+        return createSemanticTokensResult(this.encodeTokens(document.getText(), analysis.snapshot, parsed, lineRange));
+    }
+
+    private parseDocument(document: LanguageSemanticTokensRequest['context']['document']) {
+        return assertAnalysisService(
+            'DefaultLanguageSemanticTokensService',
+            this.analysisService
+        ).parseDocument(document as any);
+    }
+
+    /**
+     * 按行列顺序直接产出 LSP 编码：词法 token 本身有序，宏展开引用与非活动区
+     * 这两类少量 token 预先排好，在写入词法 token 前按位置插入，不再整体排序。
+     */
+    private encodeTokens(
+        text: string,
+        snapshot: DocumentSemanticSnapshot,
+        parsed: ParsedDocument,
+        lineRange?: SemanticTokenLineRange
+    ): number[] {
+        const encoder = new SemanticTokenEncoder(createLegend());
+        const tokenTable = parsed.tokenTable ?? this.createTokenTable(parsed);
+        const context = new SemanticTokenContext(text, snapshot, parsed);
+        const isInRange = (token: LanguageSemanticToken): boolean =>
+            !lineRange || (token.line >= lineRange.startLine && token.line <= lineRange.endLine);
+        const insertedTokens = [
+            ...context.createExpandedMacroReferenceTokens(),
+            ...context.createInactiveTokens()
+        ].filter(isInRange).sort(compareSemanticTokens);
+        let insertedIndex = 0;
+        const emit = (token: LanguageSemanticToken): void => {
+            if (!isInRange(token)) {
+                return;
+            }
+            while (insertedIndex < insertedTokens.length && compareSemanticTokens(insertedTokens[insertedIndex], token) < 0) {
+                encoder.push(insertedTokens[insertedIndex++]);
+            }
+            encoder.push(token);
+        };
+
+        const firstIndex = lineRange ? context.findFirstTokenIndexForLine(tokenTable, lineRange.startLine) : 0;
+        for (let index = firstIndex; index < tokenTable.length; index++) {
+            // 先按类型列筛掉不着色的 token，只为需要着色的 token 生成视图。
+            const tokenType = tokenTable.types[index];
+            const lexicalType = tokenType === LPCLexer.Identifier
+                ? undefined
+                : normalizeLexicalTokenType(classifyLexicalSemanticTokenType(tokenType));
+            if (tokenType !== LPCLexer.Identifier && !lexicalType) {
                 continue;
             }
 
-            const classification = this.classifyToken(token, index, tokens, context);
-            if (!classification) {
+            if (lineRange) {
+                const startLine = context.mapActiveLine(tokenTable.lines[index] - 1, tokenTable.columns[index]);
+                if (startLine !== undefined && startLine > lineRange.endLine) {
+                    break;
+                }
+            }
+
+            const token = tokenTable.view(index);
+            if (context.isTokenInactive(token)) {
                 continue;
             }
 
-            semanticTokens.push(...this.createSemanticTokens(token, classification, context));
+            const classification = lexicalType
+                ? { tokenType: lexicalType }
+                : this.classifyIdentifier(token, index, tokenTable, context);
+            this.emitSemanticTokens(token, classification, context, emit);
         }
 
-        semanticTokens.push(...context.createExpandedMacroReferenceTokens());
-        semanticTokens.push(...context.createInactiveTokens());
-        semanticTokens.sort((left, right) =>
-            left.line - right.line || left.startCharacter - right.startCharacter || left.length - right.length
-        );
+        while (insertedIndex < insertedTokens.length) {
+            encoder.push(insertedTokens[insertedIndex++]);
+        }
 
-        return {
-            legend: {
-                tokenTypes: [...DEFAULT_LANGUAGE_SEMANTIC_TOKEN_TYPES],
-                tokenModifiers: [...DEFAULT_LANGUAGE_SEMANTIC_TOKEN_MODIFIERS]
-            },
-            tokens: semanticTokens
-        };
+        return encoder.build();
     }
 
-    private classifyToken(
-        token: LpcTokenLike,
-        tokenIndex: number,
-        tokens: LpcTokenLike[],
-        context: SemanticTokenContext
-    ): ClassifiedSemanticToken | undefined {
-        if (isIdentifierToken(token)) {
-            return this.classifyIdentifier(token, tokenIndex, tokens, context);
-        }
-
-        const tokenType = normalizeLexicalTokenType(classifyLexicalSemanticToken(token));
-        return tokenType ? { tokenType } : undefined;
+    /**
+     * 测试替身等没有 token 表的解析结果，从 token 流建一张不切片源码的表
+     */
+    private createTokenTable(parsed: ParsedDocument): TokenTable {
+        parsed.tokens.fill();
+        return TokenTable.fromTokens(parsed.tokens.getTokens());
     }
 
-    private createSemanticTokens(
+    private emitSemanticTokens(
         token: LpcTokenLike,
         classification: ClassifiedSemanticToken,
-        context: SemanticTokenContext
-    ): LanguageSemanticToken[] {
+        context: SemanticTokenContext,
+        emit: (token: LanguageSemanticToken) => void
+    ): void {
         const text = token.text ?? '';
         if (text.length === 0) {
-            return [];
+            return;
         }
 
         const lines = text.split(/\r\n|\r|\n/);
-        if (lines.length === 1) {
-            const mapped = context.mapActiveTokenSegment(token.line - 1, token.charPositionInLine, text.length);
-            if (!mapped) {
-                return [];
-            }
-
-            return [
-                {
-                    line: mapped.line,
-                    startCharacter: mapped.startCharacter,
-                    length: mapped.length,
-                    tokenType: classification.tokenType,
-                    ...createModifierData(classification.tokenModifiers)
-                }
-            ];
-        }
-
-        const tokens: LanguageSemanticToken[] = [];
         let activeLine = token.line - 1;
         let activeCharacter = token.charPositionInLine;
 
         for (let index = 0; index < lines.length; index++) {
             const length = lines[index].length;
-            if (length === 0) {
-                activeLine += 1;
-                activeCharacter = 0;
-                continue;
-            }
-
-            const mapped = context.mapActiveTokenSegment(activeLine, activeCharacter, length);
-            if (mapped) {
-                tokens.push({
-                    line: mapped.line,
-                    startCharacter: mapped.startCharacter,
-                    length: mapped.length,
-                    tokenType: classification.tokenType,
-                    ...createModifierData(classification.tokenModifiers)
-                });
+            if (length > 0) {
+                const mapped = context.mapActiveTokenSegment(activeLine, activeCharacter, length);
+                if (mapped) {
+                    emit({
+                        line: mapped.line,
+                        startCharacter: mapped.startCharacter,
+                        length: mapped.length,
+                        tokenType: classification.tokenType,
+                        ...createModifierData(classification.tokenModifiers)
+                    });
+                }
             }
 
             activeLine += 1;
             activeCharacter = 0;
         }
-
-        return tokens;
     }
 
     private classifyIdentifier(
         token: LpcTokenLike,
         tokenIndex: number,
-        tokens: LpcTokenLike[],
+        tokenTable: TokenTable,
         context: SemanticTokenContext
     ): ClassifiedSemanticToken {
         const text = token.text ?? '';
         const lowerText = text.toLowerCase();
 
-        if (this.isMacroReference(token, context.snapshot)) {
+        if (context.isMacroReference(token)) {
             return {
                 tokenType: TOKEN_TYPES.macro,
                 tokenModifiers: context.getModifiersForToken(token, SymbolType.VARIABLE)
             };
         }
 
-        if (this.isExplicitEfunScopedIdentifier(tokenIndex, tokens) && EFUNS.has(text)) {
+        if (this.isExplicitEfunScopedIdentifier(tokenIndex, tokenTable) && EFUNS.has(text)) {
             return { tokenType: TOKEN_TYPES.builtin, tokenModifiers: ['defaultLibrary'] };
         }
 
@@ -294,7 +356,7 @@ export class DefaultLanguageSemanticTokensService implements LanguageSemanticTok
             return { tokenType: TOKEN_TYPES.type };
         }
 
-        const contextualType = this.getContextualIdentifierType(tokenIndex, tokens);
+        const contextualType = this.getContextualIdentifierType(tokenIndex, tokenTable);
         if (contextualType === TOKEN_TYPES.method || contextualType === TOKEN_TYPES.property) {
             return {
                 tokenType: contextualType,
@@ -324,58 +386,32 @@ export class DefaultLanguageSemanticTokensService implements LanguageSemanticTok
         };
     }
 
-    private isExplicitEfunScopedIdentifier(tokenIndex: number, tokens: LpcTokenLike[]): boolean {
-        const previousToken = this.findAdjacentDefaultToken(tokens, tokenIndex, -1);
-        if (previousToken?.text !== '::') {
-            return false;
-        }
-
-        const scopeTokenIndex = tokens.indexOf(previousToken);
-        const qualifierToken = this.findAdjacentDefaultToken(tokens, scopeTokenIndex, -1);
-        return qualifierToken?.text === 'efun';
-    }
-
-    private isMacroReference(token: LpcTokenLike, snapshot: DocumentSemanticSnapshot): boolean {
-        const text = token.text ?? '';
-        if (!Array.isArray(snapshot.macroReferences) || !text) {
+    private isExplicitEfunScopedIdentifier(tokenIndex: number, tokenTable: TokenTable): boolean {
+        const scopeTokenIndex = tokenTable.findAdjacentVisible(tokenIndex, -1);
+        if (scopeTokenIndex < 0 || tokenTable.text(scopeTokenIndex) !== '::') {
             return false;
         }
 
-        return snapshot.macroReferences.some((reference) => (
-            reference.name === text
-            && reference.range.start.line === token.line - 1
-            && reference.range.start.character === token.charPositionInLine
-        ));
+        return this.getAdjacentDefaultTokenText(tokenTable, scopeTokenIndex, -1) === 'efun';
     }
 
-    private getContextualIdentifierType(tokenIndex: number, tokens: LpcTokenLike[]): string {
-        const previousToken = this.findAdjacentDefaultToken(tokens, tokenIndex, -1);
-        if (previousToken && (previousToken.text === '->' || previousToken.text === '.')) {
-            const nextToken = this.findAdjacentDefaultToken(tokens, tokenIndex, 1);
-            return nextToken?.text === '(' ? TOKEN_TYPES.method : TOKEN_TYPES.property;
+    private getContextualIdentifierType(tokenIndex: number, tokenTable: TokenTable): string {
+        const previousText = this.getAdjacentDefaultTokenText(tokenTable, tokenIndex, -1);
+        const nextText = this.getAdjacentDefaultTokenText(tokenTable, tokenIndex, 1);
+        if (previousText === '->' || previousText === '.') {
+            return nextText === '(' ? TOKEN_TYPES.method : TOKEN_TYPES.property;
         }
 
-        const nextToken = this.findAdjacentDefaultToken(tokens, tokenIndex, 1);
-        if (nextToken && nextToken.text === '(') {
+        if (nextText === '(') {
             return TOKEN_TYPES.function;
         }
 
         return TOKEN_TYPES.variable;
     }
 
-    private findAdjacentDefaultToken(tokens: LpcTokenLike[], tokenIndex: number, direction: -1 | 1): LpcTokenLike | undefined {
-        for (
-            let currentIndex = tokenIndex + direction;
-            currentIndex >= 0 && currentIndex < tokens.length;
-            currentIndex += direction
-        ) {
-            const token = tokens[currentIndex];
-            if (isDefaultChannelToken(token)) {
-                return token;
-            }
-        }
-
-        return undefined;
+    private getAdjacentDefaultTokenText(tokenTable: TokenTable, tokenIndex: number, direction: -1 | 1): string | undefined {
+        const adjacentIndex = tokenTable.findAdjacentVisible(tokenIndex, direction);
+        return adjacentIndex < 0 ? undefined : tokenTable.text(adjacentIndex);
     }
 
     private getTokenTypeFromSymbol(symbolType: SymbolType): string {
@@ -405,9 +441,38 @@ function createModifierData(tokenModifiers: string[] | undefined): Pick<Language
     return tokenModifiers && tokenModifiers.length > 0 ? { tokenModifiers } : {};
 }
 
+function createLegend(): LanguageSemanticTokensLegend {
+    return {
+        tokenTypes: [...DEFAULT_LANGUAGE_SEMANTIC_TOKEN_TYPES],
+        tokenModifiers: [...DEFAULT_LANGUAGE_SEMANTIC_TOKEN_MODIFIERS]
+    };
+}
+
+/**
+ * `tokens` 在首次访问时才从编码数组解码；LSP 路径只读取 `data`。
+ */
+function createSemanticTokensResult(data: readonly number[]): LanguageSemanticTokensResult {
+    const legend = createLegend();
+    let tokens: LanguageSemanticToken[] | undefined;
+    return {
+        legend,
+        data,
+        get tokens(): LanguageSemanticToken[] {
+            tokens ??= decodeSemanticTokens(data, legend);
+            return tokens;
+        }
+    };
+}
+
+function compareSemanticTokens(left: LanguageSemanticToken, right: LanguageSemanticToken): number {
+    return left.line - right.line || left.startCharacter - right.startCharacter || left.length - right.length;
+}
+
 class SemanticTokenContext {
     private readonly lineStarts: number[];
     private readonly activeLineStarts: number[];
+    private readonly sourceMap: Array<{ originalStartOffset: number; activeStartOffset: number; length: number }>;
+    private macroReferenceKeys: Set<string> | undefined;
 
     public constructor(
         private readonly text: string,
@@ -416,6 +481,57 @@ class SemanticTokenContext {
     ) {
         this.lineStarts = computeLineStarts(text);
         this.activeLineStarts = computeLineStarts(this.getActiveText());
+        this.sourceMap = this.getSourceMap();
+    }
+
+    public isMacroReference(token: LpcTokenLike): boolean {
+        const text = token.text ?? '';
+        if (!text) {
+            return false;
+        }
+
+        if (!this.macroReferenceKeys) {
+            const references = Array.isArray(this.snapshot.macroReferences) ? this.snapshot.macroReferences : [];
+            this.macroReferenceKeys = new Set(references.map((reference) =>
+                createMacroReferenceKey(reference.name, reference.range.start.line, reference.range.start.character)
+            ));
+        }
+
+        return this.macroReferenceKeys.has(createMacroReferenceKey(text, token.line - 1, token.charPositionInLine));
+    }
+
+    /**
+     * 活动文本中某位置对应的源码行；落在宏展开内容中时返回 undefined
+     */
+    public mapActiveLine(activeLine: number, activeCharacter: number): number | undefined {
+        const activeOffset = this.activeOffsetAt(activeLine, activeCharacter);
+        const originalRange = this.mapActiveRangeToOriginal(activeOffset, activeOffset);
+        return originalRange ? this.positionAt(originalRange.startOffset).line : undefined;
+    }
+
+    /**
+     * 可能覆盖源码第 `line` 行的第一个 token 下标：定位该行在活动文本中的位置，
+     * 再退一个 token，以免漏掉从上一行开始的跨行 token（如块注释）。
+     */
+    public findFirstTokenIndexForLine(tokenTable: TokenTable, line: number): number {
+        const originalOffset = this.lineStarts[line] ?? this.text.length;
+        const entry = this.sourceMap[upperBoundBy(this.sourceMap, originalOffset, (candidate) => candidate.originalStartOffset) - 1];
+        const activeOffset = entry
+            ? entry.activeStartOffset + Math.min(originalOffset - entry.originalStartOffset, entry.length)
+            : 0;
+
+        let low = 0;
+        let high = tokenTable.length;
+        while (low < high) {
+            const mid = (low + high) >>> 1;
+            if (tokenTable.startOffsets[mid] < activeOffset) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        return Math.max(0, low - 1);
     }
 
     public getModifiersForToken(
@@ -543,11 +659,8 @@ class SemanticTokenContext {
         activeStartOffset: number,
         activeEndOffset: number
     ): { startOffset: number; endOffset: number } | undefined {
-        const entry = this.getSourceMap().find((candidate) =>
-            activeStartOffset >= candidate.activeStartOffset
-            && activeEndOffset <= candidate.activeStartOffset + candidate.length
-        );
-        if (!entry) {
+        const entry = this.sourceMap[upperBoundBy(this.sourceMap, activeStartOffset, (candidate) => candidate.activeStartOffset) - 1];
+        if (!entry || activeEndOffset > entry.activeStartOffset + entry.length) {
             return undefined;
         }
 
@@ -636,6 +749,26 @@ class SemanticTokenContext {
     }
 }
 
+function createMacroReferenceKey(name: string, line: number, character: number): string {
+    return `${line}:${character}:${name}`;
+}
+
+/** 第一个键大于 `value` 的下标；`items` 须按键升序 */
+function upperBoundBy<T>(items: readonly T[], value: number, keyOf: (item: T) => number): number {
+    let low = 0;
+    let high = items.length;
+    while (low < high) {
+        const mid = (low + high) >>> 1;
+        if (keyOf(items[mid]) <= value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
 function normalizeLexicalTokenType(tokenType: string | undefined): string | undefined {
     return tokenType === 'type' ? TOKEN_TYPES.type : tokenType;
 }
@@ -46,6 +46,40 @@ describe('DefaultLanguageSemanticTokensService', () => {
             tokenType: 'macro'
         }));
     });
+
+    test('classifies only the requested lines for range requests and matches the full encoding', async () => {
+        const source = [
+            '/* header',
+            '   comment */',
+            'int counter;',
+            'void demo(int amount) {',
+            '    counter += amount;',
+            '    write("done");',
+            '}'
+        ].join('\n');
+        const context = {
+            document: createDocument('/virtual/range-highlight.c', source),
+            workspace: { workspaceRoot: '/virtual' },
+            mode: 'lsp' as const,
+            cancellation: { isCancellationRequested: false }
+        };
+        const range = { start: { line: 1, character: 0 }, end: { line: 4, character: 0 } };
+
+        const rangeResult = await new DefaultLanguageSemanticTokensService(DocumentSemanticSnapshotService.getInstance())
+            .provideSemanticTokensRange({ context, range });
+        const fullService = new DefaultLanguageSemanticTokensService(DocumentSemanticSnapshotService.getInstance());
+        const fullResult = await fullService.provideSemanticTokens({ context });
+        const cachedRangeResult = await fullService.provideSemanticTokensRange({ context, range });
+        const expectedTokens = fullResult.tokens.filter((token) => token.line >= 1 && token.line <= 4);
+
+        expect(expectedTokens.map((token) => token.line)).toEqual(expect.arrayContaining([1, 2, 3, 4]));
+        expect(rangeResult.tokens).toEqual(expectedTokens);
+        expect(cachedRangeResult.data).toEqual(rangeResult.data);
+        expect(fullResult.tokens.map((token) => [token.line, token.startCharacter]))
+            .toEqual([...fullResult.tokens].sort((left, right) =>
+                left.line - right.line || left.startCharacter - right.startCharacter
+            ).map((token) => [token.line, token.startCharacter]));
+    });
 });
 
 function createDocument(filePath: string, content: string, version = 1): vscode.TextDocument {
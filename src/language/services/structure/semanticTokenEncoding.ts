@@ -0,0 +1,183 @@
+import type {
+    LanguageSemanticToken,
+    LanguageSemanticTokensLegend
+} from './LanguageSemanticTokensService';
+
+/** LSP 语义 token 编码中每个 token 占用的整数个数 */
+const TOKEN_STRIDE = 5;
+
+export interface SemanticTokensEdit {
+    start: number;
+    deleteCount: number;
+    data: number[];
+}
+
+/**
+ * 按 LSP 的相对整数编码（deltaLine, deltaStart, length, tokenType, modifierMask）逐个写入 token。
+ * 调用方须按行、列升序写入；图例中不存在的类型直接忽略。
+ */
+export class SemanticTokenEncoder {
+    private readonly data: number[] = [];
+    private readonly typeIndexes = new Map<string, number>();
+    private readonly modifierIndexes = new Map<string, number>();
+    private previousLine = 0;
+    private previousCharacter = 0;
+
+    public constructor(legend: LanguageSemanticTokensLegend) {
+        legend.tokenTypes.forEach((tokenType, index) => this.typeIndexes.set(tokenType, index));
+        legend.tokenModifiers.forEach((modifier, index) => this.modifierIndexes.set(modifier, index));
+    }
+
+    public push(token: LanguageSemanticToken): void {
+        const typeIndex = this.typeIndexes.get(token.tokenType);
+        if (typeIndex === undefined) {
+            return;
+        }
+
+        let modifierMask = 0;
+        for (const modifier of token.tokenModifiers ?? []) {
+            const modifierIndex = this.modifierIndexes.get(modifier);
+            if (modifierIndex !== undefined) {
+                modifierMask |= 1 << modifierIndex;
+            }
+        }
+
+        this.pushEncoded(token.line, token.startCharacter, token.length, typeIndex, modifierMask);
+    }
+
+    public build(): number[] {
+        return this.data;
+    }
+
+    private pushEncoded(line: number, startCharacter: number, length: number, typeIndex: number, modifierMask: number): void {
+        const deltaLine = line - this.previousLine;
+        this.data.push(
+            deltaLine,
+            deltaLine === 0 ? startCharacter - this.previousCharacter : startCharacter,
+            length,
+            typeIndex,
+            modifierMask
+        );
+        this.previousLine = line;
+        this.previousCharacter = startCharacter;
+    }
+}
+
+export function encodeSemanticTokens(
+    tokens: readonly LanguageSemanticToken[],
+    legend: LanguageSemanticTokensLegend
+): number[] {
+    const encoder = new SemanticTokenEncoder(legend);
+    for (const token of tokens) {
+        encoder.push(token);
+    }
+    return encoder.build();
+}
+
+export function decodeSemanticTokens(
+    data: readonly number[],
+    legend: LanguageSemanticTokensLegend
+): LanguageSemanticToken[] {
+    const tokens: LanguageSemanticToken[] = [];
+    let line = 0;
+    let character = 0;
+
+    for (let index = 0; index + TOKEN_STRIDE <= data.length; index += TOKEN_STRIDE) {
+        line += data[index];
+        character = data[index] === 0 ? character + data[index + 1] : data[index + 1];
+        const tokenModifiers = legend.tokenModifiers.filter((_, modifierIndex) => (data[index + 4] & (1 << modifierIndex)) !== 0);
+        tokens.push({
+            line,
+            startCharacter: character,
+            length: data[index + 2],
+            tokenType: legend.tokenTypes[data[index + 3]],
+            ...(tokenModifiers.length > 0 ? { tokenModifiers } : {})
+        });
+    }
+
+    return tokens;
+}
+
+/**
+ * 从整篇编码中取出 `[startLine, endLine]` 行内的 token，重新以第 0 行为基准编码。
+ */
+export function sliceSemanticTokenLines(data: readonly number[], startLine: number, endLine: number): number[] {
+    const sliced: number[] = [];
+    let line = 0;
+    let previousLine = 0;
+
+    for (let index = 0; index + TOKEN_STRIDE <= data.length; index += TOKEN_STRIDE) {
+        line += data[index];
+        if (line > endLine) {
+            break;
+        }
+        if (line < startLine) {
+            continue;
+        }
+
+        const isFirst = sliced.length === 0;
+        const deltaLine = line - previousLine;
+        sliced.push(
+            deltaLine,
+            isFirst || data[index] !== 0 ? absoluteCharacter(data, index) : data[index + 1],
+            data[index + 2],
+            data[index + 3],
+            data[index + 4]
+        );
+        previousLine = line;
+    }
+
+    return sliced;
+}
+
+/**
+ * 两次编码之间的最小单段编辑：跳过相同的开头与结尾整 token，其余作为一次替换。
+ * 两者相同时返回空数组。
+ */
+export function diffSemanticTokenData(previous: readonly number[], next: readonly number[]): SemanticTokensEdit[] {
+    const previousCount = Math.floor(previous.length / TOKEN_STRIDE);
+    const nextCount = Math.floor(next.length / TOKEN_STRIDE);
+    let prefix = 0;
+    while (prefix < previousCount && prefix < nextCount && sameToken(previous, prefix, next, prefix)) {
+        prefix++;
+    }
+
+    if (prefix === previousCount && prefix === nextCount) {
+        return [];
+    }
+
+    let suffix = 0;
+    while (
+        suffix < previousCount - prefix
+        && suffix < nextCount - prefix
+        && sameToken(previous, previousCount - suffix - 1, next, nextCount - suffix - 1)
+    ) {
+        suffix++;
+    }
+
+    return [{
+        start: prefix * TOKEN_STRIDE,
+        deleteCount: (previousCount - prefix - suffix) * TOKEN_STRIDE,
+        data: next.slice(prefix * TOKEN_STRIDE, (nextCount - suffix) * TOKEN_STRIDE)
+    }];
+}
+
+/** 同一行内的 token 起始列是相对前一个 token 的，这里回溯求绝对列 */
+function absoluteCharacter(data: readonly number[], index: number): number {
+    let character = data[index + 1];
+    for (let cursor = index; cursor > 0 && data[cursor] === 0; cursor -= TOKEN_STRIDE) {
+        character += data[cursor - TOKEN_STRIDE + 1];
+    }
+    return character;
+}
+
+function sameToken(left: readonly number[], leftToken: number, right: readonly number[], rightToken: number): boolean {
+    const leftOffset = leftToken * TOKEN_STRIDE;
+    const rightOffset = rightToken * TOKEN_STRIDE;
+    for (let index = 0; index < TOKEN_STRIDE; index++) {
+        if (left[leftOffset + index] !== right[rightOffset + index]) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -1,6 +1,7 @@
 import * as fs from 'fs';
 import * as path from 'path';
 import * as vscode from 'vscode';
+import { getGlobalVirtualFileSystem } from '../../core/VirtualFileSystem';
 import type { LpcProjectConfigService } from '../../projectConfig/LpcProjectConfigService';
 import type { DocumentAnalysisService } from '../../semantic/documentAnalysisService';
 import type { LanguageWorkspaceProjectConfig } from '../contracts/LanguageWorkspaceContext';
@@ -37,7 +38,7 @@ export function createVsCodeTextDocumentHost(): TextDocumentHost {
         openTextDocument: async (target) => typeof target === 'string'
             ? vscode.workspace.openTextDocument(target)
             : vscode.workspace.openTextDocument(target),
-        fileExists: (filePath) => fs.existsSync(filePath),
+        fileExists: (filePath) => getGlobalVirtualFileSystem().exists(filePath),
         getWorkspaceFolder: (uri) => vscode.workspace.getWorkspaceFolder(uri)
     };
 }
@@ -830,7 +830,8 @@ describe('LSP capability matrix', () => {
                         tokenTypes: [...DEFAULT_LANGUAGE_SEMANTIC_TOKEN_TYPES],
                         tokenModifiers: [...DEFAULT_LANGUAGE_SEMANTIC_TOKEN_MODIFIERS]
                     },
-                    full: true
+                    full: { delta: true },
+                    range: true
                 },
                 textDocumentSync: 1
             },
@@ -21,7 +21,7 @@ describe('DocumentStore', () => {
         expect(store.get(uri)).toBeUndefined();
     });
 
-    test('get returns a defensive snapshot instead of the internal object', () => {
+    test('get returns a frozen record shared across reads', () => {
         const store = new DocumentStore();
         const uri = 'file:///phase-a-test.c';
 
@@ -40,10 +40,12 @@ describe('DocumentStore', () => {
         };
 
         expect(mutated.text).toBe('mutated');
+        expect(Object.isFrozen(snapshot)).toBe(true);
+        expect(store.get(uri)).toBe(snapshot);
         expect(store.get(uri)?.text).toBe('one');
     });
 
-    test('list returns defensive snapshots for all stored documents', () => {
+    test('list returns the stored records without exposing the internal map', () => {
         const store = new DocumentStore();
         store.open('file:///one.c', 1, 'one');
         store.open('file:///two.c', 2, 'two');
@@ -63,4 +65,18 @@ describe('DocumentStore', () => {
             text: 'one'
         });
     });
+
+    test('applies ranged content changes on top of the shared buffer', () => {
+        const store = new DocumentStore();
+        const uri = 'file:///incremental.c';
+
+        store.open(uri, 1, 'int a;\nint b;\n');
+        store.applyContentChanges(uri, 2, [
+            { range: { start: { line: 1, character: 4 }, end: { line: 1, character: 5 } }, text: 'count' }
+        ]);
+
+        expect(store.get(uri)).toEqual({ uri, version: 2, text: 'int a;\nint count;\n' });
+        expect(store.getBuffer(uri)?.lineText(1)).toBe('int count;');
+        expect(store.getBuffer(uri)?.text).toBe(store.get(uri)?.text);
+    });
 });
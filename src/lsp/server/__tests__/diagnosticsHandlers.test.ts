@@ -230,6 +230,7 @@ describe('diagnostics session and handlers', () => {
         const documentStore = new DocumentStore();
         const changeIndex = new WorkspaceChangeIndex();
         const onDocumentInvalidated = jest.fn();
+        const onFileCreated = jest.fn();
         const workspaceSession = new WorkspaceSession({
             workspaceRoots: ['D:/workspace']
         });
@@ -248,7 +249,8 @@ describe('diagnostics session and handlers', () => {
             serverVersion: '0.40.0-test',
             workspaceSession,
             diagnosticsSession: diagnosticsSession as any,
-            onDocumentInvalidated
+            onDocumentInvalidated,
+            onFileCreated
         });
 
         sourceFileChangeHandler?.({
@@ -261,6 +263,7 @@ describe('diagnostics session and handlers', () => {
             deleted: false
         }));
         expect(onDocumentInvalidated).toHaveBeenCalledWith('file:///D:/workspace/include/settings.h');
+        expect(onFileCreated).not.toHaveBeenCalled();
         expect(diagnosticsSession.refresh).not.toHaveBeenCalled();
         expect(diagnosticsSession.clear).not.toHaveBeenCalled();
 
@@ -274,6 +277,14 @@ describe('diagnostics session and handlers', () => {
             deleted: true
         }));
         expect(diagnosticsSession.clear).toHaveBeenCalledWith('file:///D:/workspace/include/settings.h');
+
+        sourceFileChangeHandler?.({
+            uri: 'file:///D:/workspace/include/settings.h',
+            changeType: 'created'
+        });
+
+        expect(onFileCreated).toHaveBeenCalledTimes(1);
+        expect(onFileCreated).toHaveBeenCalledWith('file:///D:/workspace/include/settings.h');
     });
 
     test('didOpen schedules semantic token prewarm after the first interaction window', async () => {
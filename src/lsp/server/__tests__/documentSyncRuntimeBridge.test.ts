@@ -55,7 +55,15 @@ describe('document sync runtime bridge', () => {
 
     test('didChange emits a runtime change event after the mirror update', () => {
         const uri = 'file:///D:/workspace/runtime-bridge-change-test.c';
-        const { openHandlers, changeHandlers, listener, changeIndex, onDocumentInvalidated, cleanup } = createBridgeHarness(uri);
+        const {
+            openHandlers,
+            changeHandlers,
+            listener,
+            changeIndex,
+            onDocumentChanged,
+            onDocumentInvalidated,
+            cleanup
+        } = createBridgeHarness(uri);
 
         try {
             openHandlers[0]?.({
@@ -92,6 +100,8 @@ describe('document sync runtime bridge', () => {
                 deleted: false
             }));
             expect(onDocumentInvalidated).not.toHaveBeenCalled();
+            expect(onDocumentChanged).toHaveBeenCalledTimes(1);
+            expect(onDocumentChanged).toHaveBeenCalledWith(uri);
         } finally {
             cleanup();
         }
@@ -214,6 +224,7 @@ function createBridgeHarness(uri: string): {
     changeHandlers: Array<(params: DidChangeTextDocumentParams) => void>;
     documentStore: DocumentStore;
     changeIndex: WorkspaceChangeIndex;
+    onDocumentChanged: jest.Mock;
     onDocumentInvalidated: jest.Mock;
     listener: {
         changeEvents: Array<{ uri: string; text: string; version: number }>;
@@ -235,6 +246,7 @@ function createBridgeHarness(uri: string): {
     });
     const documentStore = new DocumentStore();
     const changeIndex = new WorkspaceChangeIndex();
+    const onDocumentChanged = jest.fn();
     const onDocumentInvalidated = jest.fn();
     const workspaceSession = new WorkspaceSession({
         workspaceRoots: ['D:/workspace']
@@ -261,6 +273,7 @@ function createBridgeHarness(uri: string): {
         logger,
         serverVersion: '0.40.0-test',
         workspaceSession,
+        onDocumentChanged,
         onDocumentInvalidated
     });
 
@@ -269,6 +282,7 @@ function createBridgeHarness(uri: string): {
         changeHandlers,
         documentStore,
         changeIndex,
+        onDocumentChanged,
         onDocumentInvalidated,
         listener: {
             changeEvents,
@@ -102,6 +102,11 @@ describe('registerCapabilities', () => {
                     totalSnapshots: 2,
                     buildCount: 5,
                     totalBuildTimeMs: 20
+                }),
+                getMemoryStats: () => ({
+                    budgetBytes: 1000,
+                    usedBytes: 400,
+                    caches: [{ name: 'parsedDocuments', entries: 1, bytes: 400, evictions: 0, cascadeEvictions: 0 }]
                 })
             }
         });
@@ -186,6 +191,10 @@ describe('registerCapabilities', () => {
                     totalSnapshots: expect.any(Number),
                     buildCount: expect.any(Number),
                     totalBuildTimeMs: expect.any(Number)
+                }),
+                memory: expect.objectContaining({
+                    budgetBytes: 1000,
+                    usedBytes: 400
                 })
             }
         }));
@@ -50,11 +50,13 @@ import {
 } from '../../../language/services/navigation/LanguageRenameService';
 import type { LanguageSymbolService } from '../../../language/services/navigation/LanguageSymbolService';
 import { registerCapabilities, type ServerConnection } from '../bootstrap/registerCapabilities';
+import { registerCallHierarchyHandler } from '../handlers/navigation/registerCallHierarchyHandler';
 import { registerDefinitionHandler } from '../handlers/navigation/registerDefinitionHandler';
 import { registerDocumentSymbolHandler } from '../handlers/navigation/registerDocumentSymbolHandler';
 import { registerHoverHandler } from '../handlers/navigation/registerHoverHandler';
 import { registerReferencesHandler } from '../handlers/navigation/registerReferencesHandler';
 import { registerRenameHandler } from '../handlers/navigation/registerRenameHandler';
+import { registerWorkspaceSymbolHandler } from '../handlers/navigation/registerWorkspaceSymbolHandler';
 import { DocumentStore } from '../runtime/DocumentStore';
 import { ServerLanguageContextFactory } from '../runtime/ServerLanguageContextFactory';
 import { ServerLogger } from '../runtime/ServerLogger';
@@ -1095,6 +1097,104 @@ describe('navigation handlers', () => {
         ]);
     });
 
+    test('registerCallHierarchyHandler converts call hierarchy items and calls in both directions', async () => {
+        const handlers: Record<string, (params: any) => Promise<any>> = {};
+        const connection = {
+            languages: {
+                callHierarchy: {
+                    onPrepare: jest.fn((handler: any) => { handlers.prepare = handler; }),
+                    onIncomingCalls: jest.fn((handler: any) => { handlers.incoming = handler; }),
+                    onOutgoingCalls: jest.fn((handler: any) => { handlers.outgoing = handler; })
+                }
+            }
+        };
+        const heal = {
+            name: 'heal',
+            kind: 'function' as const,
+            uri: 'file:///D:/workspace/base.c',
+            range: { start: { line: 0, character: 0 }, end: { line: 0, character: 14 } },
+            selectionRange: { start: { line: 0, character: 5 }, end: { line: 0, character: 9 } }
+        };
+        const create = {
+            ...heal,
+            name: 'create',
+            uri: 'file:///D:/workspace/nav.c',
+            selectionRange: { start: { line: 0, character: 5 }, end: { line: 0, character: 11 } }
+        };
+        const callRange = { start: { line: 1, character: 4 }, end: { line: 1, character: 8 } };
+        const navigationService = createNavigationServiceStub({
+            prepareCallHierarchy: jest.fn(async (request: any) => {
+                expect(request.position).toEqual({ line: 1, character: 5 });
+                return [heal];
+            }),
+            provideIncomingCalls: jest.fn(async () => [{ from: create, fromRanges: [callRange] }]),
+            provideOutgoingCalls: jest.fn(async () => [])
+        } as any);
+        const documentStore = new DocumentStore();
+        documentStore.open('file:///D:/workspace/nav.c', 1, 'void create() {\n    heal();\n}\n');
+
+        registerCallHierarchyHandler({
+            connection,
+            contextFactory: new ServerLanguageContextFactory(documentStore, new WorkspaceSession({ workspaceRoots: ['D:/workspace'] })),
+            navigationService
+        });
+
+        const [item] = await handlers.prepare({
+            textDocument: { uri: 'file:///D:/workspace/nav.c' },
+            position: { line: 1, character: 5 }
+        });
+        expect(item).toEqual({ ...heal, kind: SymbolKind.Function });
+        expect(await handlers.incoming({ item })).toEqual([
+            { from: { ...create, kind: SymbolKind.Function }, fromRanges: [callRange] }
+        ]);
+        expect(await handlers.outgoing({ item })).toEqual([]);
+        expect(navigationService.provideIncomingCalls).toHaveBeenCalledWith(expect.objectContaining({
+            item: expect.objectContaining({ name: 'heal', uri: 'file:///D:/workspace/base.c' })
+        }));
+    });
+
+    test('registerWorkspaceSymbolHandler passes open documents as proximity hints and forwards partial results', async () => {
+        let workspaceSymbolHandler: ((...args: any[]) => Promise<any>) | undefined;
+        const connection = {
+            onWorkspaceSymbol: jest.fn((handler: any) => {
+                workspaceSymbolHandler = handler;
+            })
+        };
+        const symbol = {
+            name: 'heal',
+            kind: 'function' as const,
+            location: {
+                uri: 'file:///D:/workspace/std/room.c',
+                range: { start: { line: 3, character: 5 }, end: { line: 3, character: 9 } }
+            },
+            containerName: 'room.c'
+        };
+        const navigationService = createNavigationServiceStub({
+            provideWorkspaceSymbols: jest.fn(async (request: any) => {
+                expect(request.query).toBe('hea');
+                expect(request.nearUris).toEqual(['file:///D:/workspace/nav.c']);
+                request.onPartialResult?.([symbol]);
+                return request.onPartialResult ? [] : [symbol];
+            })
+        } as any);
+        const documentStore = new DocumentStore();
+        documentStore.open('file:///D:/workspace/nav.c', 1, 'void create() {}\n');
+
+        registerWorkspaceSymbolHandler({ connection, documentStore, navigationService });
+
+        const lspSymbol = {
+            name: 'heal',
+            kind: SymbolKind.Function,
+            location: symbol.location,
+            containerName: 'room.c'
+        };
+        const token = { isCancellationRequested: false };
+        const report = jest.fn();
+        expect(await workspaceSymbolHandler?.({ query: 'hea' }, token, undefined, { report })).toEqual([]);
+        expect(report).toHaveBeenCalledWith([lspSymbol]);
+        expect(await workspaceSymbolHandler?.({ query: 'hea' }, token, undefined)).toEqual([lspSymbol]);
+    });
+
     test('registerCapabilities advertises and registers navigation handlers when the shared navigation service is present', async () => {
         let initializeHandler: ((params: InitializeParams) => InitializeResult) | undefined;
         let hoverHandler: ((params: HoverParams) => Promise<Hover | undefined> | Hover | undefined) | undefined;
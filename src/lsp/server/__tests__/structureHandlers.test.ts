@@ -9,7 +9,10 @@ import {
     type InitializeParams,
     type InitializeResult,
     type SemanticTokens,
-    type SemanticTokensParams
+    type SemanticTokensDelta,
+    type SemanticTokensDeltaParams,
+    type SemanticTokensParams,
+    type SemanticTokensRangeParams
 } from 'vscode-languageserver/node';
 import type { LanguageStructureService } from '../../../language/services/structure/LanguageFoldingService';
 import {
@@ -29,6 +32,8 @@ interface StructureConnection extends ServerConnection {
     languages: {
         semanticTokens: {
             on: jest.Mock;
+            onDelta?: jest.Mock;
+            onRange?: jest.Mock;
         };
     };
 }
@@ -191,6 +196,74 @@ describe('structure handlers', () => {
         expect(result?.resultId).toEqual(expect.any(String));
     });
 
+    test('registerSemanticTokensHandler answers delta requests with edits and range requests with a line slice', async () => {
+        type Handler<P, R> = (params: P) => Promise<R>;
+        let fullHandler: Handler<SemanticTokensParams, SemanticTokens> | undefined;
+        let deltaHandler: Handler<SemanticTokensDeltaParams, SemanticTokens | SemanticTokensDelta> | undefined;
+        let rangeHandler: Handler<SemanticTokensRangeParams, SemanticTokens> | undefined;
+        const legend = { tokenTypes: ['keyword', 'variable'], tokenModifiers: [] };
+        const firstTokens = [
+            { line: 0, startCharacter: 0, length: 3, tokenType: 'keyword' },
+            { line: 1, startCharacter: 4, length: 2, tokenType: 'variable' },
+            { line: 2, startCharacter: 4, length: 2, tokenType: 'variable' }
+        ];
+        const secondTokens = [
+            firstTokens[0],
+            { line: 1, startCharacter: 4, length: 5, tokenType: 'variable' },
+            firstTokens[2]
+        ];
+        const provideSemanticTokens = jest.fn(async () => ({ legend, tokens: firstTokens }));
+        const connection = createStructureConnection({
+            languages: {
+                semanticTokens: {
+                    on: jest.fn(handler => {
+                        fullHandler = handler as typeof fullHandler;
+                        return Disposable.create(() => undefined);
+                    }),
+                    onDelta: jest.fn(handler => {
+                        deltaHandler = handler as typeof deltaHandler;
+                        return Disposable.create(() => undefined);
+                    }),
+                    onRange: jest.fn(handler => {
+                        rangeHandler = handler as typeof rangeHandler;
+                        return Disposable.create(() => undefined);
+                    })
+                }
+            }
+        });
+        const structureService = createStructureServiceStub({ provideSemanticTokens });
+        const documentStore = new DocumentStore();
+        const uri = 'file:///D:/workspace/delta.c';
+        documentStore.open(uri, 1, 'int\n    hp\n    sp\n');
+
+        registerSemanticTokensHandler({
+            connection,
+            contextFactory: new ServerLanguageContextFactory(
+                documentStore,
+                new WorkspaceSession({ workspaceRoots: ['D:/workspace'], featureServices: { structureService } })
+            ),
+            structureService
+        });
+
+        const full = await fullHandler!({ textDocument: { uri } } as SemanticTokensParams);
+        provideSemanticTokens.mockResolvedValue({ legend, tokens: secondTokens });
+        const delta = await deltaHandler!({ textDocument: { uri }, previousResultId: full.resultId! } as SemanticTokensDeltaParams);
+        const unknownBase = await deltaHandler!({ textDocument: { uri }, previousResultId: 'stale' } as SemanticTokensDeltaParams);
+        const range = await rangeHandler!({
+            textDocument: { uri },
+            range: { start: { line: 1, character: 0 }, end: { line: 2, character: 0 } }
+        } as SemanticTokensRangeParams);
+
+        expect(full.data).toEqual([0, 0, 3, 0, 0, 1, 4, 2, 1, 0, 1, 4, 2, 1, 0]);
+        expect(delta).toEqual({
+            resultId: expect.any(String),
+            edits: [{ start: 5, deleteCount: 5, data: [1, 4, 5, 1, 0] }]
+        });
+        expect((delta as SemanticTokensDelta).resultId).not.toBe(full.resultId);
+        expect(unknownBase).toEqual({ resultId: expect.any(String), data: [0, 0, 3, 0, 0, 1, 4, 5, 1, 0, 1, 4, 2, 1, 0] });
+        expect(range.data).toEqual([1, 4, 5, 1, 0, 1, 4, 2, 1, 0]);
+    });
+
     test('registerCapabilities and createServer expose only structure capabilities when structure service is provided', async () => {
         let initializeHandler: ((params: InitializeParams) => InitializeResult) | undefined;
         const connection = createStructureConnection({
@@ -230,7 +303,8 @@ describe('structure handlers', () => {
                         tokenTypes: [...DEFAULT_LANGUAGE_SEMANTIC_TOKEN_TYPES],
                         tokenModifiers: [...DEFAULT_LANGUAGE_SEMANTIC_TOKEN_MODIFIERS]
                     },
-                    full: true
+                    full: { delta: true },
+                    range: true
                 },
                 textDocumentSync: TextDocumentSyncKind.Full
             },
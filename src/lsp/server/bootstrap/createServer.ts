@@ -32,7 +32,9 @@ export interface CreateServerOptions {
     diagnosticsService?: LanguageDiagnosticsService;
     formattingService?: LanguageFormattingService;
     navigationService?: LanguageNavigationService;
+    onDocumentChanged?: (uri: string) => void;
     onDocumentInvalidated?: (uri: string) => void;
+    onFileCreated?: (uri: string) => void;
     onWorkspaceConfigSync?: () => Promise<void>;
     signatureHelpService?: LanguageSignatureHelpService;
     structureService?: LanguageStructureService;
@@ -81,7 +83,9 @@ export function createServer(options: CreateServerOptions = {}): LspServerRuntim
         codeActionsService: options.codeActionsService,
         completionService: options.completionService,
         formattingService: options.formattingService,
+        onDocumentChanged: options.onDocumentChanged,
         onDocumentInvalidated: options.onDocumentInvalidated,
+        onFileCreated: options.onFileCreated,
         signatureHelpService: options.signatureHelpService,
         structureService: options.structureService,
         onWorkspaceConfigSync: options.onWorkspaceConfigSync,
@@ -40,7 +40,8 @@ import type {
 import { HealthRequest } from '../../shared/protocol/health';
 import {
     SourceFileChangeNotification,
-    type SourceFileChangePayload
+    type SourceFileChangePayload,
+    type SourceFileChangeType
 } from '../../shared/protocol/sourceFileChange';
 import {
     WorkspaceConfigSyncNotification,
@@ -54,11 +55,13 @@ import { registerCompletionHandler } from '../handlers/completion/registerComple
 import { registerCodeActionHandler } from '../handlers/codeActions/registerCodeActionHandler';
 import { createHealthHandler } from '../handlers/health/healthHandler';
 import { registerFormattingHandlers } from '../handlers/formatting/registerFormattingHandlers';
+import { registerCallHierarchyHandler } from '../handlers/navigation/registerCallHierarchyHandler';
 import { registerDefinitionHandler } from '../handlers/navigation/registerDefinitionHandler';
 import { registerDocumentSymbolHandler } from '../handlers/navigation/registerDocumentSymbolHandler';
 import { registerHoverHandler } from '../handlers/navigation/registerHoverHandler';
 import { registerReferencesHandler } from '../handlers/navigation/registerReferencesHandler';
 import { registerRenameHandler } from '../handlers/navigation/registerRenameHandler';
+import { registerWorkspaceSymbolHandler } from '../handlers/navigation/registerWorkspaceSymbolHandler';
 import { registerSignatureHelpHandler } from '../handlers/signatureHelp/registerSignatureHelpHandler';
 import { registerFoldingRangeHandler } from '../handlers/structure/registerFoldingRangeHandler';
 import { registerSemanticTokensHandler } from '../handlers/structure/registerSemanticTokensHandler';
@@ -80,6 +83,7 @@ const OPEN_PREWARM_DELAY_MS = 350;
 const OPEN_DIAGNOSTIC_REFRESH_DELAY_MS = 2500;
 const COMPLETION_TRIGGER_CHARACTERS = ['>', '.', ':', '#', '"', '<', '/'];
 const CHANGE_DIAGNOSTIC_REFRESH_DELAY_MS = 300;
+const WORKSPACE_INDEX_UPDATE_DELAY_MS = 300;
 
 export type ServerConnection = Pick<
     Connection,
@@ -105,6 +109,7 @@ export type ServerConnection = Pick<
     onSignatureHelp?: Connection['onSignatureHelp'];
     onDocumentFormatting?: Connection['onDocumentFormatting'];
     onDocumentRangeFormatting?: Connection['onDocumentRangeFormatting'];
+    onWorkspaceSymbol?: Connection['onWorkspaceSymbol'];
 };
 
 export interface ServerRegistrationContext {
@@ -120,7 +125,9 @@ export interface ServerRegistrationContext {
     completionService?: LanguageCompletionService;
     codeActionsService?: LanguageCodeActionService;
     formattingService?: LanguageFormattingService;
+    onDocumentChanged?: (uri: string) => void;
     onDocumentInvalidated?: (uri: string) => void;
+    onFileCreated?: (uri: string) => void;
     signatureHelpService?: LanguageSignatureHelpService;
     structureService?: LanguageStructureService;
     onWorkspaceConfigSync?: () => Promise<void>;
@@ -143,7 +150,9 @@ export function registerCapabilities(context: ServerRegistrationContext): void {
         formattingService,
         signatureHelpService,
         structureService,
+        onDocumentChanged,
         onDocumentInvalidated,
+        onFileCreated,
         onWorkspaceConfigSync,
         workspaceIndexingService,
         healthPerformanceProviders
@@ -169,6 +178,8 @@ export function registerCapabilities(context: ServerRegistrationContext): void {
     const pendingOpenPrewarmTimers = new Map<string, ReturnType<typeof setTimeout>>();
     const pendingOpenDiagnosticRefreshTimers = new Map<string, ReturnType<typeof setTimeout>>();
     let maybeStaleDiagnosticRefreshTimer: ReturnType<typeof setTimeout> | undefined;
+    const pendingWorkspaceIndexChanges = new Map<string, SourceFileChangeType>();
+    let workspaceIndexUpdateTimer: ReturnType<typeof setTimeout> | undefined;
 
     const refreshDiagnosticsWhenReady = (uri: string): void => {
         if (!diagnosticsSession) {
@@ -243,6 +254,37 @@ export function registerCapabilities(context: ServerRegistrationContext): void {
             MAYBE_STALE_DIAGNOSTIC_REFRESH_DELAY_MS
         );
     };
+    const flushWorkspaceIndexChanges = (): void => {
+        workspaceIndexUpdateTimer = undefined;
+        if (!workspaceIndexingService?.applyFileChanges || pendingWorkspaceIndexChanges.size === 0) {
+            pendingWorkspaceIndexChanges.clear();
+            return;
+        }
+
+        const changes = Array.from(pendingWorkspaceIndexChanges, ([uri, changeType]) => ({ uri, changeType }));
+        pendingWorkspaceIndexChanges.clear();
+        void workspaceIndexingService.applyFileChanges(changes).catch((error) => {
+            logger.error(`Failed to update workspace index: ${error instanceof Error ? error.message : String(error)}`);
+        });
+    };
+
+    const scheduleWorkspaceIndexChange = (uri: string, changeType: SourceFileChangeType): void => {
+        if (!workspaceIndexingService?.applyFileChanges) {
+            return;
+        }
+
+        // A burst of watcher events collapses to one update per file; a create followed by edits stays a create.
+        const previousChangeType = pendingWorkspaceIndexChanges.get(uri);
+        pendingWorkspaceIndexChanges.set(
+            uri,
+            previousChangeType === 'created' && changeType === 'changed' ? 'created' : changeType
+        );
+
+        if (workspaceIndexUpdateTimer) {
+            clearTimeout(workspaceIndexUpdateTimer);
+        }
+        workspaceIndexUpdateTimer = setTimeout(flushWorkspaceIndexChanges, WORKSPACE_INDEX_UPDATE_DELAY_MS);
+    };
     const clearPendingOpenDiagnosticRefresh = (uri: string): void => {
         const timer = pendingOpenDiagnosticRefreshTimers.get(uri);
         if (!timer) {
@@ -348,7 +390,11 @@ export function registerCapabilities(context: ServerRegistrationContext): void {
                     renameProvider: {
                         prepareProvider: true
                     },
-                    documentSymbolProvider: true
+                    documentSymbolProvider: true,
+                    ...(navigationService.prepareCallHierarchy ? { callHierarchyProvider: true } : {}),
+                    ...(navigationService.provideWorkspaceSymbols && connection.onWorkspaceSymbol ? {
+                        workspaceSymbolProvider: true
+                    } : {})
                 } : {}),
                 ...(completionService ? {
                     completionProvider: {
@@ -378,7 +424,8 @@ export function registerCapabilities(context: ServerRegistrationContext): void {
                             tokenTypes: [...SERVER_LANGUAGE_SEMANTIC_TOKEN_TYPES],
                             tokenModifiers: [...SERVER_LANGUAGE_SEMANTIC_TOKEN_MODIFIERS]
                         },
-                        full: true
+                        full: { delta: true },
+                        range: true
                     }
                 } : {}),
                 textDocumentSync: TextDocumentSyncKind.Full
@@ -400,15 +447,13 @@ export function registerCapabilities(context: ServerRegistrationContext): void {
     });
 
     connection.onDidChangeTextDocument(({ textDocument, contentChanges }: DidChangeTextDocumentParams) => {
-        const nextText = contentChanges.length > 0
-            ? contentChanges[contentChanges.length - 1].text
-            : documentStore.get(textDocument.uri)?.text ?? '';
-
         changeIndex?.markChanged(textDocument.uri, textDocument.version);
         clearPendingOpenPrewarm(textDocument.uri);
         clearPendingOpenDiagnosticRefresh(textDocument.uri);
-        documentStore.applyFullChange(textDocument.uri, textDocument.version, nextText);
+        documentStore.applyContentChanges(textDocument.uri, textDocument.version, contentChanges);
+        const nextText = documentStore.get(textDocument.uri)?.text ?? '';
         __syncTextDocument(textDocument.uri, nextText, textDocument.version);
+        onDocumentChanged?.(textDocument.uri);
         __emitTextDocumentChange(textDocument.uri);
         scheduleChangedDiagnosticRefresh(textDocument.uri);
     });
@@ -431,11 +476,15 @@ export function registerCapabilities(context: ServerRegistrationContext): void {
 
     connection.onNotification(SourceFileChangeNotification.type, (payload: SourceFileChangePayload) => {
         changeIndex?.markDiskChanged(payload.uri, payload.changeType);
+        if (payload.changeType === 'created') {
+            onFileCreated?.(payload.uri);
+        }
         freshnessService.invalidateDocument(payload.uri);
         scheduleMaybeStaleDiagnosticRefreshes(changeIndex?.getMaybeStaleOpenUris() ?? []);
         if (payload.changeType === 'deleted') {
             diagnosticsSession?.clear(payload.uri);
         }
+        scheduleWorkspaceIndexChange(payload.uri, payload.changeType);
     });
 
     connection.onRequest(
@@ -444,7 +493,8 @@ export function registerCapabilities(context: ServerRegistrationContext): void {
             documentStore,
             serverVersion,
             getParserStats: healthPerformanceProviders?.getParserStats,
-            getSemanticStats: healthPerformanceProviders?.getSemanticStats
+            getSemanticStats: healthPerformanceProviders?.getSemanticStats,
+            getMemoryStats: healthPerformanceProviders?.getMemoryStats
         })
     );
 
@@ -509,6 +559,16 @@ export function registerCapabilities(context: ServerRegistrationContext): void {
             contextFactory,
             navigationService
         });
+        registerCallHierarchyHandler({
+            connection,
+            contextFactory,
+            navigationService
+        });
+        registerWorkspaceSymbolHandler({
+            connection,
+            documentStore,
+            navigationService
+        });
     }
 
     if (signatureHelpService && connection.onSignatureHelp) {
@@ -6,6 +6,7 @@ type HealthHandlerDependencies = {
     serverVersion: string;
     getParserStats?: () => NonNullable<HealthStatusResponse['performance']>['parser'];
     getSemanticStats?: () => NonNullable<HealthStatusResponse['performance']>['semantic'];
+    getMemoryStats?: () => NonNullable<HealthStatusResponse['performance']>['memory'];
 };
 
 export function createHealthHandler(
@@ -14,12 +15,15 @@ export function createHealthHandler(
     return async () => {
         const parser = dependencies.getParserStats?.();
         const semantic = dependencies.getSemanticStats?.();
+        const memory = dependencies.getMemoryStats?.();
         return {
             status: 'ok',
             mode: 'phase-a',
             serverVersion: dependencies.serverVersion,
             documentCount: dependencies.documentStore.count(),
-            performance: parser || semantic ? { parser, semantic } : undefined
+            performance: parser || semantic || memory
+                ? { parser, semantic, ...(memory ? { memory } : {}) }
+                : undefined
         };
     };
 }
@@ -0,0 +1,94 @@
+import {
+    SymbolKind,
+    type CallHierarchyIncomingCall,
+    type CallHierarchyIncomingCallsParams,
+    type CallHierarchyItem,
+    type CallHierarchyOutgoingCall,
+    type CallHierarchyOutgoingCallsParams,
+    type CallHierarchyPrepareParams
+} from 'vscode-languageserver/node';
+import { toLspRange } from '../../../../language/adapters/lsp/conversions';
+import type { LanguageCallHierarchyItem } from '../../../../language/services/navigation/LanguageCallHierarchyService';
+import type { LanguageNavigationService } from '../../../../language/services/navigation/LanguageHoverService';
+import type { ServerLanguageContextFactory } from '../../runtime/ServerLanguageContextFactory';
+
+type CallHierarchyConnection = {
+    languages?: {
+        callHierarchy?: {
+            onPrepare(handler: (params: CallHierarchyPrepareParams) => Promise<CallHierarchyItem[] | null>): unknown;
+            onIncomingCalls(handler: (params: CallHierarchyIncomingCallsParams) => Promise<CallHierarchyIncomingCall[] | null>): unknown;
+            onOutgoingCalls(handler: (params: CallHierarchyOutgoingCallsParams) => Promise<CallHierarchyOutgoingCall[] | null>): unknown;
+        };
+    };
+};
+
+export interface CallHierarchyRegistrationContext {
+    connection: CallHierarchyConnection;
+    contextFactory: Pick<ServerLanguageContextFactory, 'createCapabilityContext'>;
+    navigationService: LanguageNavigationService;
+}
+
+export function registerCallHierarchyHandler(context: CallHierarchyRegistrationContext): void {
+    const { connection, contextFactory, navigationService } = context;
+    const callHierarchy = connection.languages?.callHierarchy;
+    const { prepareCallHierarchy, provideIncomingCalls, provideOutgoingCalls } = navigationService;
+    if (!callHierarchy || !prepareCallHierarchy || !provideIncomingCalls || !provideOutgoingCalls) {
+        return;
+    }
+
+    callHierarchy.onPrepare(async (params: CallHierarchyPrepareParams): Promise<CallHierarchyItem[] | null> => {
+        const items = await prepareCallHierarchy.call(navigationService, {
+            context: contextFactory.createCapabilityContext(params.textDocument.uri),
+            position: {
+                line: params.position.line,
+                character: params.position.character
+            }
+        });
+
+        return items.length > 0 ? items.map(toLspCallHierarchyItem) : null;
+    });
+
+    callHierarchy.onIncomingCalls(async (params: CallHierarchyIncomingCallsParams): Promise<CallHierarchyIncomingCall[]> => {
+        const calls = await provideIncomingCalls.call(navigationService, {
+            context: contextFactory.createCapabilityContext(params.item.uri),
+            item: fromLspCallHierarchyItem(params.item)
+        });
+
+        return calls.map(call => ({
+            from: toLspCallHierarchyItem(call.from),
+            fromRanges: call.fromRanges.map(range => toLspRange(range))
+        }));
+    });
+
+    callHierarchy.onOutgoingCalls(async (params: CallHierarchyOutgoingCallsParams): Promise<CallHierarchyOutgoingCall[]> => {
+        const calls = await provideOutgoingCalls.call(navigationService, {
+            context: contextFactory.createCapabilityContext(params.item.uri),
+            item: fromLspCallHierarchyItem(params.item)
+        });
+
+        return calls.map(call => ({
+            to: toLspCallHierarchyItem(call.to),
+            fromRanges: call.fromRanges.map(range => toLspRange(range))
+        }));
+    });
+}
+
+function toLspCallHierarchyItem(item: LanguageCallHierarchyItem): CallHierarchyItem {
+    return {
+        name: item.name,
+        kind: SymbolKind.Function,
+        uri: item.uri,
+        range: toLspRange(item.range),
+        selectionRange: toLspRange(item.selectionRange)
+    };
+}
+
+function fromLspCallHierarchyItem(item: CallHierarchyItem): LanguageCallHierarchyItem {
+    return {
+        name: item.name,
+        kind: 'function',
+        uri: item.uri,
+        range: item.range,
+        selectionRange: item.selectionRange
+    };
+}
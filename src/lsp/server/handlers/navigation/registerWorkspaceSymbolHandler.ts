@@ -0,0 +1,71 @@
+import {
+    SymbolKind,
+    type CancellationToken,
+    type SymbolInformation,
+    type WorkspaceSymbolParams
+} from 'vscode-languageserver/node';
+import { toLspLocation } from '../../../../language/adapters/lsp/conversions';
+import type { LanguageNavigationService } from '../../../../language/services/navigation/LanguageHoverService';
+import type { LanguageWorkspaceSymbol } from '../../../../language/services/navigation/LanguageWorkspaceSymbolService';
+import type { DocumentStore } from '../../runtime/DocumentStore';
+
+type WorkspaceSymbolConnection = {
+    onWorkspaceSymbol?(
+        handler: (
+            params: WorkspaceSymbolParams,
+            token: CancellationToken,
+            workDoneProgress: unknown,
+            resultProgress?: { report(data: SymbolInformation[]): void }
+        ) => Promise<SymbolInformation[]>
+    ): unknown;
+};
+
+export interface WorkspaceSymbolRegistrationContext {
+    connection: WorkspaceSymbolConnection;
+    documentStore: Pick<DocumentStore, 'list'>;
+    navigationService: LanguageNavigationService;
+}
+
+export function registerWorkspaceSymbolHandler(context: WorkspaceSymbolRegistrationContext): void {
+    const { connection, documentStore, navigationService } = context;
+    const { provideWorkspaceSymbols } = navigationService;
+    if (!connection.onWorkspaceSymbol || !provideWorkspaceSymbols) {
+        return;
+    }
+
+    connection.onWorkspaceSymbol(async (params, token, _workDoneProgress, resultProgress): Promise<SymbolInformation[]> => {
+        const symbols = await provideWorkspaceSymbols.call(navigationService, {
+            query: params.query,
+            nearUris: documentStore.list().map(document => document.uri),
+            isCancellationRequested: () => token.isCancellationRequested,
+            onPartialResult: resultProgress
+                ? (batch: LanguageWorkspaceSymbol[]) => resultProgress.report(batch.map(toLspSymbolInformation))
+                : undefined
+        });
+
+        return symbols.map(toLspSymbolInformation);
+    });
+}
+
+function toLspSymbolInformation(symbol: LanguageWorkspaceSymbol): SymbolInformation {
+    return {
+        name: symbol.name,
+        kind: toLspWorkspaceSymbolKind(symbol.kind),
+        location: toLspLocation(symbol.location),
+        containerName: symbol.containerName
+    };
+}
+
+function toLspWorkspaceSymbolKind(kind: LanguageWorkspaceSymbol['kind']): SymbolKind {
+    switch (kind) {
+        case 'variable':
+            return SymbolKind.Variable;
+        case 'struct':
+            return SymbolKind.Struct;
+        case 'class':
+            return SymbolKind.Class;
+        case 'function':
+        default:
+            return SymbolKind.Function;
+    }
+}
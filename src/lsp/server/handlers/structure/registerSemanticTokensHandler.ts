@@ -1,16 +1,25 @@
-import {
-    SemanticTokensBuilder,
-    type SemanticTokens,
-    type SemanticTokensParams
+import type {
+    SemanticTokens,
+    SemanticTokensDelta,
+    SemanticTokensDeltaParams,
+    SemanticTokensParams,
+    SemanticTokensRangeParams
 } from 'vscode-languageserver/node';
 import type { LanguageStructureService } from '../../../../language/services/structure/LanguageFoldingService';
 import type { LanguageSemanticTokensResult } from '../../../../language/services/structure/LanguageSemanticTokensService';
+import {
+    diffSemanticTokenData,
+    encodeSemanticTokens,
+    sliceSemanticTokenLines
+} from '../../../../language/services/structure/semanticTokenEncoding';
 import type { ServerLanguageContextFactory } from '../../runtime/ServerLanguageContextFactory';
 
 type SemanticTokensConnection = {
     languages: {
         semanticTokens: {
             on(handler: (params: SemanticTokensParams) => Promise<SemanticTokens>): unknown;
+            onDelta?(handler: (params: SemanticTokensDeltaParams) => Promise<SemanticTokens | SemanticTokensDelta>): unknown;
+            onRange?(handler: (params: SemanticTokensRangeParams) => Promise<SemanticTokens>): unknown;
         };
     };
 };
@@ -22,42 +31,78 @@ export interface SemanticTokensRegistrationContext {
     onSemanticTokensRequested?: (uri: string) => void;
 }
 
+/** 为增量请求保留上一次结果的文档数上限 */
+const MAX_PREVIOUS_RESULTS = 64;
+
+interface PreviousSemanticTokens {
+    resultId: string;
+    data: readonly number[];
+}
+
 export function registerSemanticTokensHandler(context: SemanticTokensRegistrationContext): void {
     const { connection, contextFactory, structureService, onSemanticTokensRequested } = context;
+    // Map 顺序即最近使用顺序
+    const previousResults = new Map<string, PreviousSemanticTokens>();
+    let nextResultId = 1;
 
-    connection.languages.semanticTokens.on(async (params: SemanticTokensParams): Promise<SemanticTokens> => {
-        onSemanticTokensRequested?.(params.textDocument.uri);
+    const provideData = async (uri: string): Promise<readonly number[]> => {
+        onSemanticTokensRequested?.(uri);
         const result = await structureService.provideSemanticTokens({
-            context: contextFactory.createCapabilityContext(params.textDocument.uri)
+            context: contextFactory.createCapabilityContext(uri)
         });
+        return toLspSemanticTokenData(result);
+    };
+    const remember = (uri: string, data: readonly number[]): string => {
+        const resultId = String(nextResultId++);
+        previousResults.delete(uri);
+        previousResults.set(uri, { resultId, data });
+        while (previousResults.size > MAX_PREVIOUS_RESULTS) {
+            previousResults.delete(previousResults.keys().next().value as string);
+        }
+        return resultId;
+    };
 
-        return toLspSemanticTokens(result);
+    connection.languages.semanticTokens.on(async (params: SemanticTokensParams): Promise<SemanticTokens> => {
+        const data = await provideData(params.textDocument.uri);
+        return {
+            resultId: remember(params.textDocument.uri, data),
+            data: [...data]
+        };
     });
-}
 
-function toLspSemanticTokens(result: LanguageSemanticTokensResult): SemanticTokens {
-    const builder = new SemanticTokensBuilder();
-    const tokenTypeIndex = new Map<string, number>();
-    const tokenModifierIndex = new Map<string, number>();
+    connection.languages.semanticTokens.onDelta?.(async (params: SemanticTokensDeltaParams): Promise<SemanticTokens | SemanticTokensDelta> => {
+        const uri = params.textDocument.uri;
+        const previous = previousResults.get(uri);
+        const data = await provideData(uri);
+        const resultId = remember(uri, data);
+        if (!previous || previous.resultId !== params.previousResultId) {
+            return { resultId, data: [...data] };
+        }
 
-    result.legend.tokenTypes.forEach((tokenType, index) => tokenTypeIndex.set(tokenType, index));
-    result.legend.tokenModifiers.forEach((tokenModifier, index) => {
-        tokenModifierIndex.set(tokenModifier, index);
+        return {
+            resultId,
+            edits: diffSemanticTokenData(previous.data, data)
+        };
     });
 
-    for (const token of result.tokens) {
-        const typeIndex = tokenTypeIndex.get(token.tokenType);
-        if (typeIndex === undefined) {
-            continue;
-        }
+    connection.languages.semanticTokens.onRange?.(async (params: SemanticTokensRangeParams): Promise<SemanticTokens> => {
+        const uri = params.textDocument.uri;
+        onSemanticTokensRequested?.(uri);
+        const { start, end } = params.range;
+        const request = {
+            context: contextFactory.createCapabilityContext(uri),
+            range: { start, end }
+        };
 
-        const modifierMask = (token.tokenModifiers ?? []).reduce((mask, modifier) => {
-            const modifierIndex = tokenModifierIndex.get(modifier);
-            return modifierIndex === undefined ? mask : mask | (1 << modifierIndex);
-        }, 0);
+        if (structureService.provideSemanticTokensRange) {
+            return { data: [...toLspSemanticTokenData(await structureService.provideSemanticTokensRange(request))] };
+        }
 
-        builder.push(token.line, token.startCharacter, token.length, typeIndex, modifierMask);
-    }
+        const result = await structureService.provideSemanticTokens(request);
+        return { data: sliceSemanticTokenLines(toLspSemanticTokenData(result), start.line, end.line) };
+    });
+}
 
-    return builder.build();
+function toLspSemanticTokenData(result: LanguageSemanticTokensResult): readonly number[] {
+    return result.data ?? encodeSemanticTokens(result.tokens, result.legend);
 }
@@ -1,39 +1,50 @@
+import { TextBuffer, TextBufferContentChange } from './TextBuffer';
+
 export interface StoredDocument {
     readonly uri: string;
     readonly version: number;
     readonly text: string;
 }
 
+interface StoredDocumentEntry {
+    /** 冻结的对外记录，`get`/`list` 直接返回它 */
+    readonly document: Readonly<StoredDocument>;
+    readonly buffer: TextBuffer;
+}
+
 export class DocumentStore {
-    private readonly documents = new Map<string, StoredDocument>();
+    private readonly documents = new Map<string, StoredDocumentEntry>();
 
     public open(uri: string, version: number, text: string): void {
-        this.documents.set(uri, { uri, version, text });
+        this.store(uri, version, new TextBuffer(text));
     }
 
     public applyFullChange(uri: string, version: number, text: string): void {
-        this.documents.set(uri, { uri, version, text });
+        this.store(uri, version, new TextBuffer(text));
+    }
+
+    /**
+     * 按顺序应用 LSP `contentChanges`：带 range 的条目在当前缓冲上增量编辑，
+     * 已构建的行索引随之平移；不带 range 的条目整篇替换。
+     */
+    public applyContentChanges(uri: string, version: number, changes: readonly TextBufferContentChange[]): void {
+        const current = this.documents.get(uri)?.buffer ?? new TextBuffer('');
+        this.store(uri, version, current.applyContentChanges(changes));
     }
 
     public get(uri: string): Readonly<StoredDocument> | undefined {
-        const document = this.documents.get(uri);
-        if (!document) {
-            return undefined;
-        }
+        return this.documents.get(uri)?.document;
+    }
 
-        return {
-            uri: document.uri,
-            version: document.version,
-            text: document.text
-        };
+    /**
+     * 当前版本的文本缓冲。同一版本多次投影成文档时共用它的行索引。
+     */
+    public getBuffer(uri: string): TextBuffer | undefined {
+        return this.documents.get(uri)?.buffer;
     }
 
     public list(): Readonly<StoredDocument>[] {
-        return Array.from(this.documents.values()).map((document) => ({
-            uri: document.uri,
-            version: document.version,
-            text: document.text
-        }));
+        return Array.from(this.documents.values(), (entry) => entry.document);
     }
 
     public close(uri: string): void {
@@ -43,4 +54,11 @@ export class DocumentStore {
     public count(): number {
         return this.documents.size;
     }
+
+    private store(uri: string, version: number, buffer: TextBuffer): void {
+        this.documents.set(uri, {
+            document: Object.freeze({ uri, version, text: buffer.text }),
+            buffer
+        });
+    }
 }
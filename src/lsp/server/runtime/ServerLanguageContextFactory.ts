@@ -5,6 +5,7 @@ import type { LanguageWorkspaceContext } from '../../../language/contracts/Langu
 import { attachDocumentWorkspaceProjectConfig } from '../../../language/shared/documentWorkspaceConfig';
 import { DocumentStore } from './DocumentStore';
 import { fromFileUri, resolveWorkspaceRootFromRoots } from './serverPathUtils';
+import { TextBuffer } from './TextBuffer';
 import { WorkspaceSession } from './WorkspaceSession';
 
 export interface ServerLanguageContextFactoryOptions {
@@ -59,8 +60,8 @@ export class ServerLanguageContextFactory {
         const text = storedDocument?.text ?? '';
         const version = storedDocument?.version ?? 0;
         const fileName = fromFileUri(documentUri);
-        const lines = text.split(/\r?\n/);
-        const lineStarts = buildLineStarts(text);
+        const storedBuffer = storedDocument ? this.documentStore.getBuffer(storedDocument.uri) : undefined;
+        const buffer = storedBuffer && storedBuffer.text === text ? storedBuffer : new TextBuffer(text);
         const uriLike = createUriLike(documentUri, fileName);
 
         return attachDocumentWorkspaceProjectConfig({
@@ -68,16 +69,18 @@ export class ServerLanguageContextFactory {
             version,
             fileName,
             languageId: 'lpc',
-            lineCount: lines.length,
+            get lineCount(): number {
+                return buffer.lineCount;
+            },
             getText: (range?: { start: { line: number; character: number }; end: { line: number; character: number } }) => {
                 if (!range) {
                     return text;
                 }
 
-                return text.slice(offsetAt(range.start, lineStarts, text), offsetAt(range.end, lineStarts, text));
+                return text.slice(buffer.offsetAt(range.start), buffer.offsetAt(range.end));
             },
             getWordRangeAtPosition: (position: { line: number; character: number }) => {
-                const lineText = lines[position.line] ?? '';
+                const lineText = buffer.lineText(position.line);
                 if (lineText.length === 0) {
                     return undefined;
                 }
@@ -108,9 +111,8 @@ export class ServerLanguageContextFactory {
             },
             lineAt: (lineOrPosition: number | { line: number }) => {
                 const line = typeof lineOrPosition === 'number' ? lineOrPosition : lineOrPosition.line;
-                const lineText = lines[line] ?? '';
-                const lineStart = lineStarts[line] ?? text.length;
-                const lineEnd = lineStart + lineText.length;
+                const lineText = buffer.lineText(line);
+                const lineEnd = buffer.lineEndOffset(line);
                 const range = createHostRange(
                     createHostPosition(line, 0),
                     createHostPosition(line, lineText.length)
@@ -128,20 +130,10 @@ export class ServerLanguageContextFactory {
                     isEmptyOrWhitespace: lineText.trim().length === 0
                 };
             },
-            offsetAt: (position: { line: number; character: number }) => offsetAt(position, lineStarts, text),
+            offsetAt: (position: { line: number; character: number }) => buffer.offsetAt(position),
             positionAt: (offset: number) => {
-                const safeOffset = Math.max(0, Math.min(offset, text.length));
-                let line = 0;
-
-                for (let index = 0; index < lineStarts.length; index += 1) {
-                    if (lineStarts[index] <= safeOffset) {
-                        line = index;
-                    } else {
-                        break;
-                    }
-                }
-
-                return createHostPosition(line, safeOffset - lineStarts[line]);
+                const position = buffer.positionAt(offset);
+                return createHostPosition(position.line, position.character);
             }
         } as unknown as LanguageCapabilityContext['document'], workspace.projectConfig);
     }
@@ -164,27 +156,6 @@ function createUriLike(uri: string, fileName: string): { fsPath: string; path: s
     };
 }
 
-function offsetAt(
-    position: { line: number; character: number },
-    lineStarts: number[],
-    text: string
-): number {
-    const lineStart = lineStarts[position.line] ?? text.length;
-    return Math.min(lineStart + position.character, text.length);
-}
-
-function buildLineStarts(text: string): number[] {
-    const lineStarts = [0];
-
-    for (let index = 0; index < text.length; index += 1) {
-        if (text[index] === '\n') {
-            lineStarts.push(index + 1);
-        }
-    }
-
-    return lineStarts;
-}
-
 function isWordCharacter(char: string | undefined): boolean {
     return Boolean(char && /[A-Za-z0-9_]/.test(char));
 }
@@ -0,0 +1,154 @@
+export interface TextBufferPosition {
+    line: number;
+    character: number;
+}
+
+export interface TextBufferRange {
+    start: TextBufferPosition;
+    end: TextBufferPosition;
+}
+
+export interface TextBufferContentChange {
+    range?: TextBufferRange;
+    text: string;
+}
+
+/**
+ * 不可变的文本缓冲：行首偏移索引在首次按行/按位置访问时才构建，
+ * `positionAt` 用二分查找。编辑生成新缓冲，若旧缓冲已建索引，
+ * 则复用编辑点之前的行首、平移其后的行首，只扫描插入的文本。
+ */
+export class TextBuffer {
+    private lineStartsCache: number[] | undefined;
+
+    public constructor(
+        public readonly text: string,
+        lineStarts?: number[]
+    ) {
+        this.lineStartsCache = lineStarts;
+    }
+
+    public get length(): number {
+        return this.text.length;
+    }
+
+    public get lineCount(): number {
+        return this.getLineStarts().length;
+    }
+
+    /** 是否已经构建过行索引（供测试与诊断使用） */
+    public get hasLineIndex(): boolean {
+        return this.lineStartsCache !== undefined;
+    }
+
+    public getLineStarts(): readonly number[] {
+        this.lineStartsCache ??= buildLineStarts(this.text, 0, [0]);
+        return this.lineStartsCache;
+    }
+
+    public offsetAt(position: TextBufferPosition): number {
+        const lineStarts = this.getLineStarts();
+        const lineStart = lineStarts[position.line] ?? this.text.length;
+        return Math.min(lineStart + position.character, this.text.length);
+    }
+
+    public positionAt(offset: number): TextBufferPosition {
+        const lineStarts = this.getLineStarts();
+        const safeOffset = Math.max(0, Math.min(offset, this.text.length));
+        const line = findLineIndex(lineStarts, safeOffset);
+        return { line, character: safeOffset - lineStarts[line] };
+    }
+
+    /** 第 `line` 行的文本，不含行尾的 `\n` / `\r\n`；越界时返回空串 */
+    public lineText(line: number): string {
+        const lineStarts = this.getLineStarts();
+        if (line < 0 || line >= lineStarts.length) {
+            return '';
+        }
+
+        const start = lineStarts[line];
+        if (line + 1 >= lineStarts.length) {
+            return this.text.slice(start);
+        }
+
+        let end = lineStarts[line + 1] - 1;
+        if (end > start && this.text.charCodeAt(end - 1) === 13) {
+            end -= 1;
+        }
+
+        return this.text.slice(start, end);
+    }
+
+    /** 第 `line` 行末尾（不含换行）的偏移 */
+    public lineEndOffset(line: number): number {
+        const lineStarts = this.getLineStarts();
+        return (lineStarts[line] ?? this.text.length) + this.lineText(line).length;
+    }
+
+    /**
+     * 用 `newText` 替换 `[startOffset, endOffset)`，返回新缓冲。
+     */
+    public withEdit(startOffset: number, endOffset: number, newText: string): TextBuffer {
+        const start = Math.max(0, Math.min(startOffset, this.text.length));
+        const end = Math.max(start, Math.min(endOffset, this.text.length));
+        const text = this.text.slice(0, start) + newText + this.text.slice(end);
+        if (!this.lineStartsCache) {
+            return new TextBuffer(text);
+        }
+
+        const previous = this.lineStartsCache;
+        const delta = newText.length - (end - start);
+        // 行首 <= start 的行不受影响；(start, end] 内的行首随被删除文本消失。
+        const keepCount = findLineIndex(previous, start) + 1;
+        const lineStarts = previous.slice(0, keepCount);
+        buildLineStarts(newText, start, lineStarts);
+        for (let index = upperBound(previous, end); index < previous.length; index++) {
+            lineStarts.push(previous[index] + delta);
+        }
+
+        return new TextBuffer(text, lineStarts);
+    }
+
+    /**
+     * 按 LSP `contentChanges` 的顺序依次应用；不带 range 的条目表示整篇替换。
+     */
+    public applyContentChanges(changes: readonly TextBufferContentChange[]): TextBuffer {
+        return changes.reduce<TextBuffer>(
+            (buffer, change) => change.range
+                ? buffer.withEdit(buffer.offsetAt(change.range.start), buffer.offsetAt(change.range.end), change.text)
+                : new TextBuffer(change.text),
+            this
+        );
+    }
+}
+
+function buildLineStarts(text: string, baseOffset: number, target: number[]): number[] {
+    for (let index = 0; index < text.length; index++) {
+        if (text.charCodeAt(index) === 10) {
+            target.push(baseOffset + index + 1);
+        }
+    }
+
+    return target;
+}
+
+/** 行首不大于 `offset` 的最后一行 */
+function findLineIndex(lineStarts: readonly number[], offset: number): number {
+    return Math.max(0, upperBound(lineStarts, offset) - 1);
+}
+
+/** 第一个大于 `value` 的位置 */
+function upperBound(values: readonly number[], value: number): number {
+    let low = 0;
+    let high = values.length;
+    while (low < high) {
+        const mid = (low + high) >>> 1;
+        if (values[mid] <= value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
@@ -1,3 +1,5 @@
+import { toDependencyKey, WorkspaceDependencyGraph } from './WorkspaceDependencyGraph';
+
 export interface WorkspaceFileState {
     readonly uri: string;
     readonly openVersion?: number;
@@ -18,6 +20,12 @@ export class WorkspaceChangeIndex {
     private lastChangeTimestamp = 0;
     private workspaceConfigGeneration = 0;
 
+    /**
+     * `dependencyGraph` is shared with the workspace indexer, which adds inherit/include edges for
+     * every file; this index adds the footprints that diagnostics and target lookups record.
+     */
+    public constructor(public readonly dependencyGraph: WorkspaceDependencyGraph = new WorkspaceDependencyGraph()) {}
+
     public markOpened(uri: string, version: number): WorkspaceFileState {
         return this.update(uri, {
             openVersion: version,
@@ -81,6 +89,7 @@ export class WorkspaceChangeIndex {
     }
 
     public recordDependencyFootprint(ownerUri: string, dependencies: readonly string[]): WorkspaceFileState {
+        this.dependencyGraph.setDependencies(ownerUri, 'diagnostic-footprint', dependencies);
         const existing = this.states.get(ownerUri);
         const next: WorkspaceFileState = {
             uri: ownerUri,
@@ -107,6 +116,7 @@ export class WorkspaceChangeIndex {
             ...(existing?.lastTargetDependencyFootprint ?? []),
             ...dependencies
         ]);
+        this.dependencyGraph.setDependencies(ownerUri, 'target-footprint', targetDependencies);
         const next: WorkspaceFileState = {
             uri: ownerUri,
             openVersion: existing?.openVersion,
@@ -148,6 +158,7 @@ export class WorkspaceChangeIndex {
 
     public clear(): void {
         this.states.clear();
+        this.dependencyGraph.clear();
         this.lastChangeTimestamp = 0;
         this.workspaceConfigGeneration = 0;
     }
@@ -177,14 +188,17 @@ export class WorkspaceChangeIndex {
         return next;
     }
 
+    // Open documents that read the changed file directly or through any chain of inherits/includes.
     private markAffectedOpenDocumentsMaybeStale(changedUri: string): void {
-        const normalizedChangedUri = normalizeUri(changedUri);
+        const affectedKeys = new Set(
+            this.dependencyGraph.getTransitiveDependents([changedUri]).map(uri => toDependencyKey(uri))
+        );
+        if (affectedKeys.size === 0) {
+            return;
+        }
+
         for (const state of this.states.values()) {
-            if (
-                state.openVersion === undefined
-                || normalizeUri(state.uri) === normalizedChangedUri
-                || !state.lastDependencyFootprint.some(dependencyUri => normalizeUri(dependencyUri) === normalizedChangedUri)
-            ) {
+            if (state.openVersion === undefined || !affectedKeys.has(toDependencyKey(state.uri))) {
                 continue;
             }
 
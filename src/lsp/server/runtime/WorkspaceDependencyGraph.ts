@@ -0,0 +1,239 @@
+export type WorkspaceDependencyKind =
+    | 'inherit'
+    | 'include'
+    | 'global-include'
+    | 'simul-efun'
+    | 'diagnostic-footprint'
+    | 'target-footprint';
+
+interface DependencyNode {
+    uri: string;
+    // dependency key -> kinds of the edges from this node to it
+    dependencies: Map<string, Set<WorkspaceDependencyKind>>;
+    dependents: Set<string>;
+}
+
+/**
+ * Workspace-wide file dependency graph with edges stored in both directions.
+ *
+ * An edge `owner -> dependency` means the owner's analysis reads the dependency. Each producer
+ * replaces only the edges of its own kind, so the indexer's inherit/include edges and the
+ * footprints recorded by diagnostics or target lookups coexist on the same owner.
+ * Nodes are keyed case- and encoding-insensitively; results use the spelling last recorded.
+ */
+export class WorkspaceDependencyGraph {
+    private readonly nodes = new Map<string, DependencyNode>();
+
+    public setDependencies(ownerUri: string, kind: WorkspaceDependencyKind, dependencyUris: readonly string[]): void {
+        const ownerKey = toDependencyKey(ownerUri);
+        const owner = this.getOrCreateNode(ownerUri, ownerKey);
+        const nextKeys = new Set<string>();
+
+        for (const dependencyUri of dependencyUris) {
+            const dependencyKey = toDependencyKey(dependencyUri);
+            if (dependencyKey === ownerKey) {
+                continue;
+            }
+
+            nextKeys.add(dependencyKey);
+            const dependency = this.getOrCreateNode(dependencyUri, dependencyKey);
+            let kinds = owner.dependencies.get(dependencyKey);
+            if (!kinds) {
+                kinds = new Set();
+                owner.dependencies.set(dependencyKey, kinds);
+            }
+            kinds.add(kind);
+            dependency.dependents.add(ownerKey);
+        }
+
+        for (const [dependencyKey, kinds] of owner.dependencies) {
+            if (nextKeys.has(dependencyKey) || !kinds.delete(kind) || kinds.size > 0) {
+                continue;
+            }
+
+            owner.dependencies.delete(dependencyKey);
+            const dependency = this.nodes.get(dependencyKey);
+            dependency?.dependents.delete(ownerKey);
+            this.dropIfIsolated(dependencyKey);
+        }
+        this.dropIfIsolated(ownerKey);
+    }
+
+    /**
+     * Drop the file's outgoing edges. Incoming edges stay, so files that still name it are
+     * reported as dependents if it comes back.
+     */
+    public removeFile(uri: string): void {
+        const ownerKey = toDependencyKey(uri);
+        const owner = this.nodes.get(ownerKey);
+        if (!owner) {
+            return;
+        }
+
+        for (const dependencyKey of owner.dependencies.keys()) {
+            this.nodes.get(dependencyKey)?.dependents.delete(ownerKey);
+            this.dropIfIsolated(dependencyKey);
+        }
+        owner.dependencies.clear();
+        this.dropIfIsolated(ownerKey);
+    }
+
+    /** Drop every edge, or only the edges of the given kinds. */
+    public clear(kinds?: readonly WorkspaceDependencyKind[]): void {
+        if (!kinds) {
+            this.nodes.clear();
+            return;
+        }
+
+        for (const node of Array.from(this.nodes.values())) {
+            for (const kind of kinds) {
+                this.setDependencies(node.uri, kind, []);
+            }
+        }
+    }
+
+    public getDependencies(uri: string, kinds?: readonly WorkspaceDependencyKind[]): string[] {
+        const node = this.nodes.get(toDependencyKey(uri));
+        if (!node) {
+            return [];
+        }
+
+        const result: string[] = [];
+        for (const [dependencyKey, edgeKinds] of node.dependencies) {
+            if (!kinds || kinds.some(kind => edgeKinds.has(kind))) {
+                result.push(this.nodes.get(dependencyKey)?.uri ?? dependencyKey);
+            }
+        }
+        return result;
+    }
+
+    public getDependents(uri: string, kinds?: readonly WorkspaceDependencyKind[]): string[] {
+        const key = toDependencyKey(uri);
+        return Array.from(this.collectDirectDependents(key, kinds), dependentKey => this.nodes.get(dependentKey)?.uri ?? dependentKey);
+    }
+
+    /**
+     * Every file that reads any of `uris` directly or through other files, in breadth-first order.
+     * The starting files themselves are not included.
+     */
+    public getTransitiveDependents(uris: readonly string[], kinds?: readonly WorkspaceDependencyKind[]): string[] {
+        const startKeys = new Set(uris.map(uri => toDependencyKey(uri)));
+        const visited = new Set(startKeys);
+        const pending = Array.from(startKeys);
+        const result: string[] = [];
+
+        for (let index = 0; index < pending.length; index += 1) {
+            for (const dependentKey of this.collectDirectDependents(pending[index], kinds)) {
+                if (visited.has(dependentKey)) {
+                    continue;
+                }
+
+                visited.add(dependentKey);
+                pending.push(dependentKey);
+                result.push(this.nodes.get(dependentKey)?.uri ?? dependentKey);
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Order `uris` so that each file comes after the files it depends on within the same set.
+     * Files caught in a cycle keep their input order after everything that could be ordered.
+     */
+    public topologicalOrder(uris: readonly string[], kinds?: readonly WorkspaceDependencyKind[]): string[] {
+        const uriByKey = new Map<string, string>();
+        for (const uri of uris) {
+            const key = toDependencyKey(uri);
+            if (!uriByKey.has(key)) {
+                uriByKey.set(key, uri);
+            }
+        }
+
+        const remainingDependencies = new Map<string, number>();
+        for (const key of uriByKey.keys()) {
+            let count = 0;
+            for (const [dependencyKey, edgeKinds] of this.nodes.get(key)?.dependencies ?? []) {
+                if (uriByKey.has(dependencyKey) && (!kinds || kinds.some(kind => edgeKinds.has(kind)))) {
+                    count += 1;
+                }
+            }
+            remainingDependencies.set(key, count);
+        }
+
+        const ready = Array.from(uriByKey.keys()).filter(key => remainingDependencies.get(key) === 0);
+        const ordered: string[] = [];
+        const emitted = new Set<string>();
+        for (let index = 0; index < ready.length; index += 1) {
+            const key = ready[index];
+            emitted.add(key);
+            ordered.push(uriByKey.get(key) as string);
+
+            for (const dependentKey of this.collectDirectDependents(key, kinds)) {
+                const remaining = remainingDependencies.get(dependentKey);
+                if (remaining === undefined) {
+                    continue;
+                }
+
+                remainingDependencies.set(dependentKey, remaining - 1);
+                if (remaining === 1) {
+                    ready.push(dependentKey);
+                }
+            }
+        }
+
+        for (const [key, uri] of uriByKey) {
+            if (!emitted.has(key)) {
+                ordered.push(uri);
+            }
+        }
+
+        return ordered;
+    }
+
+    private collectDirectDependents(key: string, kinds?: readonly WorkspaceDependencyKind[]): string[] {
+        const node = this.nodes.get(key);
+        if (!node) {
+            return [];
+        }
+        if (!kinds) {
+            return Array.from(node.dependents);
+        }
+
+        return Array.from(node.dependents).filter(dependentKey => {
+            const edgeKinds = this.nodes.get(dependentKey)?.dependencies.get(key);
+            return Boolean(edgeKinds && kinds.some(kind => edgeKinds.has(kind)));
+        });
+    }
+
+    private getOrCreateNode(uri: string, key: string): DependencyNode {
+        let node = this.nodes.get(key);
+        if (!node) {
+            node = { uri, dependencies: new Map(), dependents: new Set() };
+            this.nodes.set(key, node);
+        } else {
+            node.uri = uri;
+        }
+
+        return node;
+    }
+
+    private dropIfIsolated(key: string): void {
+        const node = this.nodes.get(key);
+        if (node && node.dependencies.size === 0 && node.dependents.size === 0) {
+            this.nodes.delete(key);
+        }
+    }
+}
+
+/**
+ * Case-insensitive key that also folds an encoded drive colon (`d%3A`) and the extra slash
+ * some hosts put in front of a drive letter, so URIs from the client and from `Uri.file` meet.
+ */
+export function toDependencyKey(uri: string): string {
+    return uri
+        .replace(/\\/g, '/')
+        .replace(/%3a/gi, ':')
+        .replace(/^file:\/{4,}(?=[A-Za-z]:)/, 'file:///')
+        .toLowerCase();
+}
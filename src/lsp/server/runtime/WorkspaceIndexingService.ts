@@ -1,34 +1,92 @@
+import * as path from 'path';
 import * as vscode from 'vscode';
 import type { ProjectSymbolIndex } from '../../../completion/projectSymbolIndex';
 import type { IncludeDirective } from '../../../semantic/documentSemanticTypes';
 import type { SemanticSnapshot } from '../../../semantic/semanticSnapshot';
 import type { DocumentAnalysisService } from '../../../semantic/documentAnalysisService';
+import type {
+    LanguageWorkspaceIndexFileChange,
+    LanguageWorkspaceIndexUpdateResult
+} from '../../../language/contracts/LanguageFeatureServices';
 import type { LanguageWorkspaceProjectConfig } from '../../../language/contracts/LanguageWorkspaceContext';
 import type { WorkspaceDocumentPathSupport } from '../../../language/shared/WorkspaceDocumentPathSupport';
+import type { WorkspaceCallGraph } from '../../../language/services/navigation/WorkspaceCallGraph';
+import type { WorkspaceReferenceIndex } from '../../../language/services/navigation/WorkspaceReferenceIndex';
+import type { FunctionReturnSummaryStore } from '../../../semanticEvaluation/calls/FunctionReturnSummaryStore';
 import type {
     WorkspaceIndexProgressPayload,
     WorkspaceIndexRebuildParams,
     WorkspaceIndexRebuildResult
 } from '../../shared/protocol/workspaceIndex';
+import type { WorkspaceDependencyGraph, WorkspaceDependencyKind } from './WorkspaceDependencyGraph';
 
 type WorkspaceIndexAnalysisService = Pick<
     DocumentAnalysisService,
     'getSemanticSnapshot'
-> & Partial<Pick<DocumentAnalysisService, 'getBestAvailableSemanticSnapshot'>>;
+> & Partial<Pick<DocumentAnalysisService, 'getBestAvailableSemanticSnapshot' | 'getDeclarationSnapshot'>>;
 
 export interface WorkspaceIndexingServiceOptions {
     readonly analysisService: WorkspaceIndexAnalysisService;
     readonly pathSupport: WorkspaceDocumentPathSupport;
     readonly projectSymbolIndex: ProjectSymbolIndex;
+    readonly referenceIndex?: Pick<WorkspaceReferenceIndex, 'updateFile' | 'removeFile' | 'clear'>;
+    readonly callGraph?: Pick<WorkspaceCallGraph, 'invalidate' | 'removeFile' | 'clear'>;
+    readonly dependencyGraph?: Pick<WorkspaceDependencyGraph, 'setDependencies' | 'removeFile' | 'clear' | 'topologicalOrder'>;
+    readonly returnSummaries?: Pick<FunctionReturnSummaryStore, 'invalidateDocument' | 'clear'>;
+}
+
+// Files every source in a workspace reads without naming them: the global include and the simul-efun object.
+interface ImplicitDependencies {
+    globalInclude: string[];
+    simulatedEfun: string[];
 }
 
+type WorkspaceProjectConfigMap = Map<string, LanguageWorkspaceProjectConfig>;
+type IndexFileOutcome = 'indexed' | 'skipped' | 'failed';
+
 const INDEXED_EXTENSIONS = ['.c', '.h', '.lpc'] as const;
 const PROGRESS_REPORT_INTERVAL = 20;
+// Edge kinds this service owns in the shared dependency graph; footprint edges belong to the change index.
+const INDEX_DEPENDENCY_KINDS: readonly WorkspaceDependencyKind[] = ['inherit', 'include', 'global-include', 'simul-efun'];
 
 export class WorkspaceIndexingService {
+    private workspacesByRoot?: WorkspaceProjectConfigMap;
+    private updateQueue: Promise<unknown> = Promise.resolve();
+    private readonly implicitDependenciesByRoot = new Map<string, Promise<ImplicitDependencies>>();
+
     public constructor(private readonly options: WorkspaceIndexingServiceOptions) {}
 
-    public async rebuild(
+    /** Rebuild the whole index; queued behind in-flight incremental updates so `clear` never interleaves with them. */
+    public rebuild(
+        params: WorkspaceIndexRebuildParams,
+        onProgress?: (progress: WorkspaceIndexProgressPayload) => void | Promise<void>
+    ): Promise<WorkspaceIndexRebuildResult> {
+        return this.enqueue(() => this.rebuildNow(params, onProgress));
+    }
+
+    /**
+     * Apply a coalesced batch of disk changes to the index built by the last `rebuild`.
+     * Only the changed files are re-summarized; records that merely link to them are re-linked.
+     */
+    public applyFileChanges(
+        changes: readonly LanguageWorkspaceIndexFileChange[]
+    ): Promise<LanguageWorkspaceIndexUpdateResult> {
+        return this.enqueue(() => this.applyFileChangesNow(changes));
+    }
+
+    public reset(): void {
+        this.workspacesByRoot = undefined;
+        this.implicitDependenciesByRoot.clear();
+    }
+
+    // Rebuilds and incremental updates share one queue; a failed task does not block the ones behind it.
+    private enqueue<T>(task: () => Promise<T>): Promise<T> {
+        const run = this.updateQueue.then(task);
+        this.updateQueue = run.catch(() => undefined);
+        return run;
+    }
+
+    private async rebuildNow(
         params: WorkspaceIndexRebuildParams,
         onProgress?: (progress: WorkspaceIndexProgressPayload) => void | Promise<void>
     ): Promise<WorkspaceIndexRebuildResult> {
@@ -36,6 +94,12 @@ export class WorkspaceIndexingService {
         const workspacesByRoot = new Map(params.workspaces.map(workspace => [normalizePath(workspace.workspaceRoot), workspace]));
         const files = await this.collectWorkspaceFiles(params.workspaceRoots);
         this.options.projectSymbolIndex.clear();
+        this.options.referenceIndex?.clear();
+        this.options.callGraph?.clear();
+        this.options.dependencyGraph?.clear(INDEX_DEPENDENCY_KINDS);
+        this.options.returnSummaries?.clear();
+        this.implicitDependenciesByRoot.clear();
+        this.workspacesByRoot = workspacesByRoot;
         let indexedFiles = 0;
         let skippedFiles = 0;
         let failedFiles = 0;
@@ -51,54 +115,12 @@ export class WorkspaceIndexingService {
         });
 
         for (const filePath of files) {
-            const document = await this.options.pathSupport.tryOpenTextDocument(filePath);
-            if (!document) {
-                skippedFiles += 1;
-                processedFiles += 1;
-                await reportProgressIfNeeded(
-                    onProgress,
-                    files.length,
-                    processedFiles,
-                    indexedFiles,
-                    skippedFiles,
-                    failedFiles
-                );
-                continue;
-            }
-
-            const semantic = this.getSemanticSnapshot(document);
-            if (!semantic || semantic.degraded) {
-                skippedFiles += 1;
-                processedFiles += 1;
-                await reportProgressIfNeeded(
-                    onProgress,
-                    files.length,
-                    processedFiles,
-                    indexedFiles,
-                    skippedFiles,
-                    failedFiles
-                );
-                continue;
-            }
-
-            try {
-                const workspaceRoot = this.options.pathSupport.getWorkspaceFolderRoot(document);
-                const projectConfig = workspaceRoot
-                    ? workspacesByRoot.get(normalizePath(workspaceRoot))
-                    : undefined;
-                const includeStatements = await this.resolveIncludeStatements(
-                    document,
-                    semantic,
-                    workspaceRoot,
-                    projectConfig
-                );
-
-                this.options.projectSymbolIndex.updateFromSemanticSnapshot({
-                    ...semantic,
-                    includeStatements
-                });
+            const outcome = await this.indexFile(filePath, workspacesByRoot);
+            if (outcome === 'indexed') {
                 indexedFiles += 1;
-            } catch {
+            } else if (outcome === 'skipped') {
+                skippedFiles += 1;
+            } else {
                 failedFiles += 1;
             }
             processedFiles += 1;
@@ -131,6 +153,236 @@ export class WorkspaceIndexingService {
         };
     }
 
+    private async applyFileChangesNow(
+        changes: readonly LanguageWorkspaceIndexFileChange[]
+    ): Promise<LanguageWorkspaceIndexUpdateResult> {
+        const startedAt = Date.now();
+        const result: LanguageWorkspaceIndexUpdateResult = {
+            updatedFiles: 0,
+            removedFiles: 0,
+            relinkedFiles: 0,
+            skippedFiles: 0,
+            failedFiles: 0,
+            durationMs: 0
+        };
+        const workspacesByRoot = this.workspacesByRoot;
+        if (!workspacesByRoot) {
+            // No index has been built yet; the next rebuild will pick the changes up.
+            return { ...result, durationMs: Date.now() - startedAt };
+        }
+
+        const projectSymbolIndex = this.options.projectSymbolIndex;
+        const reindexPaths = new Map<string, string>();
+        const relinkUris = new Set<string>();
+        const createdNames = new Set<string>();
+
+        for (const change of changes) {
+            const filePath = toIndexedFilePath(change.uri);
+            if (!filePath) {
+                continue;
+            }
+
+            if (change.changeType === 'deleted') {
+                for (const ownerUri of projectSymbolIndex.getInheritingUris(change.uri)) {
+                    relinkUris.add(ownerUri);
+                }
+                // Includers still record the deleted header as resolved; re-summarize them so the link is dropped.
+                for (const owner of projectSymbolIndex.getOwnersIncluding(change.uri)) {
+                    const ownerPath = vscode.Uri.parse(owner.uri).fsPath;
+                    reindexPaths.set(normalizePath(ownerPath), ownerPath);
+                }
+                projectSymbolIndex.removeFile(change.uri);
+                this.options.referenceIndex?.removeFile(change.uri);
+                this.options.callGraph?.removeFile(change.uri);
+                this.options.dependencyGraph?.removeFile(change.uri);
+                this.options.returnSummaries?.invalidateDocument(change.uri);
+                reindexPaths.delete(normalizePath(filePath));
+                result.removedFiles += 1;
+                continue;
+            }
+
+            if (change.changeType === 'created') {
+                createdNames.add(toDirectiveNameKey(filePath));
+            }
+            reindexPaths.set(normalizePath(filePath), filePath);
+        }
+
+        if (createdNames.size > 0) {
+            for (const record of projectSymbolIndex.getRecordsWithUnresolvedLinks()) {
+                const recordPath = vscode.Uri.parse(record.uri).fsPath;
+                if (record.includeStatements.some(statement =>
+                    !statement.resolvedUri && createdNames.has(toDirectiveNameKey(statement.value))
+                )) {
+                    // Include resolution needs the owning document and project config, so re-summarize the owner.
+                    reindexPaths.set(normalizePath(recordPath), recordPath);
+                    continue;
+                }
+
+                if (record.inheritStatements.some(statement =>
+                    !statement.isResolved
+                    && (statement.expressionKind === 'macro' || createdNames.has(toDirectiveNameKey(statement.value)))
+                )) {
+                    relinkUris.add(record.uri);
+                }
+            }
+        }
+
+        for (const filePath of this.orderByDependencies(Array.from(reindexPaths.values()))) {
+            const outcome = await this.indexFile(filePath, workspacesByRoot);
+            if (outcome === 'indexed') {
+                result.updatedFiles += 1;
+            } else if (outcome === 'skipped') {
+                result.skippedFiles += 1;
+            } else {
+                result.failedFiles += 1;
+            }
+        }
+
+        for (const ownerUri of relinkUris) {
+            if (reindexPaths.has(normalizePath(vscode.Uri.parse(ownerUri).fsPath))) {
+                continue;
+            }
+
+            if (projectSymbolIndex.refreshInheritTargets(ownerUri)) {
+                this.recordInheritDependencies(ownerUri);
+                result.relinkedFiles += 1;
+            }
+        }
+
+        return { ...result, durationMs: Date.now() - startedAt };
+    }
+
+    private async indexFile(filePath: string, workspacesByRoot: WorkspaceProjectConfigMap): Promise<IndexFileOutcome> {
+        const document = await this.options.pathSupport.tryOpenTextDocument(filePath);
+        if (!document) {
+            return 'skipped';
+        }
+
+        // The reference index is lexical, so it stays current even for files whose parse degrades.
+        this.options.referenceIndex?.updateFile(document);
+        // Call graph summaries need function bodies; they are rebuilt from the new text on first query.
+        this.options.callGraph?.invalidate(document.uri.toString());
+        // Return summaries of the file's functions and of every function calling into them are recomputed on demand.
+        this.options.returnSummaries?.invalidateDocument(document.uri.toString());
+        const semantic = this.getSemanticSnapshot(document);
+        if (!semantic || semantic.degraded) {
+            return 'skipped';
+        }
+
+        try {
+            const workspaceRoot = this.options.pathSupport.getWorkspaceFolderRoot(document);
+            const projectConfig = workspaceRoot
+                ? workspacesByRoot.get(normalizePath(workspaceRoot))
+                : undefined;
+            const includeStatements = await this.resolveIncludeStatements(
+                document,
+                semantic,
+                workspaceRoot,
+                projectConfig
+            );
+
+            this.options.projectSymbolIndex.updateFromSemanticSnapshot({
+                ...semantic,
+                includeStatements
+            });
+            await this.recordDependencies(document, includeStatements, workspaceRoot, projectConfig);
+            return 'indexed';
+        } catch {
+            return 'failed';
+        }
+    }
+
+    /** Re-summarize dependencies before the files that read them; files in a cycle keep batch order. */
+    private orderByDependencies(filePaths: string[]): string[] {
+        const dependencyGraph = this.options.dependencyGraph;
+        if (!dependencyGraph || filePaths.length < 2) {
+            return filePaths;
+        }
+
+        const pathByUri = new Map(filePaths.map(filePath => [vscode.Uri.file(filePath).toString(), filePath]));
+        return dependencyGraph
+            .topologicalOrder(Array.from(pathByUri.keys()), INDEX_DEPENDENCY_KINDS)
+            .map(uri => pathByUri.get(uri) as string);
+    }
+
+    private async recordDependencies(
+        document: vscode.TextDocument,
+        includeStatements: readonly IncludeDirective[],
+        workspaceRoot: string | undefined,
+        projectConfig: LanguageWorkspaceProjectConfig | undefined
+    ): Promise<void> {
+        const dependencyGraph = this.options.dependencyGraph;
+        if (!dependencyGraph) {
+            return;
+        }
+
+        const uri = document.uri.toString();
+        const implicitDependencies = workspaceRoot
+            ? await this.getImplicitDependencies(document, workspaceRoot, projectConfig)
+            : undefined;
+        dependencyGraph.setDependencies(
+            uri,
+            'include',
+            includeStatements.flatMap(statement => statement.resolvedUri ? [statement.resolvedUri] : [])
+        );
+        dependencyGraph.setDependencies(uri, 'global-include', implicitDependencies?.globalInclude ?? []);
+        dependencyGraph.setDependencies(uri, 'simul-efun', implicitDependencies?.simulatedEfun ?? []);
+        this.recordInheritDependencies(uri);
+    }
+
+    private recordInheritDependencies(uri: string): void {
+        this.options.dependencyGraph?.setDependencies(
+            uri,
+            'inherit',
+            this.options.projectSymbolIndex
+                .getResolvedInheritTargets(uri)
+                .flatMap(target => target.resolvedUri ? [target.resolvedUri] : [])
+        );
+    }
+
+    // Resolved once per workspace root and build; the project config only changes through a rebuild.
+    private getImplicitDependencies(
+        document: vscode.TextDocument,
+        workspaceRoot: string,
+        projectConfig: LanguageWorkspaceProjectConfig | undefined
+    ): Promise<ImplicitDependencies> {
+        const key = normalizePath(workspaceRoot);
+        let pending = this.implicitDependenciesByRoot.get(key);
+        if (!pending) {
+            pending = this.resolveImplicitDependencies(document, workspaceRoot, projectConfig)
+                .catch(() => ({ globalInclude: [], simulatedEfun: [] }));
+            this.implicitDependenciesByRoot.set(key, pending);
+        }
+
+        return pending;
+    }
+
+    private async resolveImplicitDependencies(
+        document: vscode.TextDocument,
+        workspaceRoot: string,
+        projectConfig: LanguageWorkspaceProjectConfig | undefined
+    ): Promise<ImplicitDependencies> {
+        const pathSupport = this.options.pathSupport;
+        const toExistingUris = (filePaths: readonly (string | undefined)[]): string[] => {
+            const existing = filePaths.find(filePath => filePath && pathSupport.fileExists(filePath));
+            return existing ? [vscode.Uri.file(existing).toString()] : [];
+        };
+
+        const globalInclude = parseGlobalIncludeFile(projectConfig?.resolvedConfig?.globalIncludeFile);
+        return {
+            globalInclude: globalInclude
+                ? toExistingUris(await pathSupport.resolveIncludeFilePaths(
+                    document,
+                    globalInclude.value,
+                    globalInclude.isSystemInclude,
+                    workspaceRoot,
+                    projectConfig
+                ))
+                : [],
+            simulatedEfun: toExistingUris([await pathSupport.getConfiguredSimulatedEfunFile(workspaceRoot, projectConfig)])
+        };
+    }
+
     private async collectWorkspaceFiles(workspaceRoots: readonly string[]): Promise<string[]> {
         const result: string[] = [];
         const seen = new Set<string>();
@@ -155,7 +407,11 @@ export class WorkspaceIndexingService {
 
     private getSemanticSnapshot(document: vscode.TextDocument): SemanticSnapshot | undefined {
         try {
-            return this.options.analysisService.getSemanticSnapshot(document, false);
+            // The index only needs declaration-level facts, so skip function bodies when the analysis service can.
+            const getDeclarationSnapshot = this.options.analysisService.getDeclarationSnapshot;
+            return getDeclarationSnapshot
+                ? getDeclarationSnapshot.call(this.options.analysisService, document)
+                : this.options.analysisService.getSemanticSnapshot(document, false);
         } catch {
             try {
                 return this.options.analysisService.getBestAvailableSemanticSnapshot?.(document);
@@ -174,7 +430,9 @@ export class WorkspaceIndexingService {
         const resolvedStatements: IncludeDirective[] = [];
 
         for (const includeStatement of semantic.includeStatements) {
-            if (includeStatement.resolvedUri) {
+            // A header deleted since the snapshot was taken is resolved again along the include path.
+            if (includeStatement.resolvedUri
+                && this.options.pathSupport.fileExists(vscode.Uri.parse(includeStatement.resolvedUri).fsPath)) {
                 resolvedStatements.push({ ...includeStatement });
                 continue;
             }
@@ -201,6 +459,37 @@ function normalizePath(filePath: string): string {
     return filePath.replace(/\\/g, '/').toLowerCase();
 }
 
+// Same reading of `globalIncludeFile` as the frontend's implicit include: `<x>` and bare names search the include path.
+function parseGlobalIncludeFile(globalIncludeFile: string | undefined): { value: string; isSystemInclude: boolean } | undefined {
+    const trimmed = globalIncludeFile?.trim();
+    if (!trimmed) {
+        return undefined;
+    }
+
+    const isAngleInclude = trimmed.startsWith('<') && trimmed.endsWith('>');
+    const isQuotedInclude = trimmed.startsWith('"') && trimmed.endsWith('"');
+    const value = isAngleInclude || isQuotedInclude ? trimmed.slice(1, -1) : trimmed;
+    return value ? { value, isSystemInclude: isAngleInclude || !value.startsWith('/') } : undefined;
+}
+
+function toIndexedFilePath(uri: string): string | undefined {
+    let filePath: string;
+    try {
+        filePath = vscode.Uri.parse(uri).fsPath;
+    } catch {
+        return undefined;
+    }
+
+    const extension = path.extname(filePath).toLowerCase();
+    return (INDEXED_EXTENSIONS as readonly string[]).includes(extension) ? filePath : undefined;
+}
+
+function toDirectiveNameKey(value: string): string {
+    const baseName = path.posix.basename(value.trim().replace(/^["'<]|["'>]$/g, '').replace(/\\/g, '/'));
+    const extension = path.posix.extname(baseName);
+    return (extension ? baseName.slice(0, -extension.length) : baseName).toLowerCase();
+}
+
 async function reportProgressIfNeeded(
     onProgress: ((progress: WorkspaceIndexProgressPayload) => void | Promise<void>) | undefined,
     totalFiles: number,
@@ -0,0 +1,42 @@
+import { describe, expect, test } from '@jest/globals';
+import { TextBuffer } from '../TextBuffer';
+
+describe('TextBuffer', () => {
+    test('builds the line index on first positional access and maps offsets both ways', () => {
+        const buffer = new TextBuffer('int a;\r\nint b;\n\nint c;');
+
+        expect(buffer.hasLineIndex).toBe(false);
+        expect(buffer.lineCount).toBe(4);
+        expect(buffer.hasLineIndex).toBe(true);
+        expect(buffer.positionAt(0)).toEqual({ line: 0, character: 0 });
+        expect(buffer.positionAt(8)).toEqual({ line: 1, character: 0 });
+        expect(buffer.positionAt(15)).toEqual({ line: 2, character: 0 });
+        expect(buffer.positionAt(999)).toEqual({ line: 3, character: 6 });
+        expect(buffer.offsetAt({ line: 3, character: 4 })).toBe(20);
+        expect(buffer.lineText(0)).toBe('int a;');
+        expect(buffer.lineText(2)).toBe('');
+        expect(buffer.lineText(7)).toBe('');
+    });
+
+    test('patches an existing line index on edits to match a fresh build', () => {
+        const original = new TextBuffer('one\ntwo\nthree\nfour\n');
+        original.getLineStarts();
+
+        const edited = original.applyContentChanges([
+            { range: { start: { line: 1, character: 1 }, end: { line: 2, character: 2 } }, text: 'X\nY\nZ' },
+            { range: { start: { line: 5, character: 0 }, end: { line: 5, character: 0 } }, text: 'five' }
+        ]);
+
+        expect(edited.hasLineIndex).toBe(true);
+        expect(edited.text).toBe('one\ntX\nY\nZree\nfour\nfive');
+        expect(edited.getLineStarts()).toEqual(new TextBuffer(edited.text).getLineStarts());
+        expect(original.text).toBe('one\ntwo\nthree\nfour\n');
+    });
+
+    test('treats a change without a range as a full replacement', () => {
+        const buffer = new TextBuffer('old').applyContentChanges([{ text: 'new\ntext' }]);
+
+        expect(buffer.text).toBe('new\ntext');
+        expect(buffer.lineCount).toBe(2);
+    });
+});
@@ -115,6 +115,27 @@ describe('WorkspaceChangeIndex', () => {
         expect(index.getMaybeStaleOpenUris()).toEqual([ownerUri]);
     });
 
+    test('marks open owners maybe stale through transitive inherit and include edges', () => {
+        const index = new WorkspaceChangeIndex();
+        const roomUri = 'file:///D:/workspace/d/city/inn.c';
+        const baseUri = 'file:///D:/workspace/std/room.c';
+        const headerUri = 'file:///D:/workspace/include/room.h';
+        const unrelatedUri = 'file:///D:/workspace/d/city/bar.c';
+
+        index.markOpened(roomUri, 1);
+        index.markOpened(unrelatedUri, 1);
+        index.dependencyGraph.setDependencies(roomUri, 'inherit', [baseUri]);
+        index.dependencyGraph.setDependencies(baseUri, 'include', [headerUri]);
+        index.markDiskChanged('file:///d%3A/workspace/include/room.h', 'changed');
+
+        expect(index.getMaybeStaleOpenUris()).toEqual([roomUri]);
+        expect(index.get(roomUri)).toEqual(expect.objectContaining({
+            openVersion: 1,
+            maybeStale: true,
+            lastDependencyFootprint: []
+        }));
+    });
+
     test('keeps closed owners out of maybe stale open files', () => {
         const index = new WorkspaceChangeIndex();
         const ownerUri = 'file:///D:/workspace/room.c';
@@ -0,0 +1,50 @@
+import { describe, expect, test } from '@jest/globals';
+import { WorkspaceDependencyGraph } from '../WorkspaceDependencyGraph';
+
+describe('WorkspaceDependencyGraph', () => {
+    test('replaces edges per kind and answers direct and transitive dependents', () => {
+        const graph = new WorkspaceDependencyGraph();
+        const inn = 'file:///D:/mud/d/city/inn.c';
+        const room = 'file:///D:/mud/std/room.c';
+        const header = 'file:///D:/mud/include/room.h';
+        const simulEfun = 'file:///D:/mud/adm/simul_efun.c';
+
+        graph.setDependencies(inn, 'inherit', [room]);
+        graph.setDependencies(inn, 'diagnostic-footprint', [room, header]);
+        graph.setDependencies(room, 'include', [header]);
+        graph.setDependencies(room, 'simul-efun', [simulEfun, room]);
+
+        expect(graph.getDependencies(inn)).toEqual([room, header]);
+        expect(graph.getDependencies(inn, ['inherit'])).toEqual([room]);
+        expect(graph.getDependents('file:///d:/mud/include/room.h')).toEqual([inn, room]);
+        expect(graph.getDependents(header, ['include'])).toEqual([room]);
+        expect(graph.getTransitiveDependents([simulEfun])).toEqual([room, inn]);
+
+        graph.setDependencies(inn, 'diagnostic-footprint', []);
+        expect(graph.getDependencies(inn)).toEqual([room]);
+
+        graph.clear(['inherit']);
+        expect(graph.getTransitiveDependents([simulEfun])).toEqual([room]);
+
+        graph.removeFile(room);
+        expect(graph.getDependents(header)).toEqual([]);
+        expect(graph.getTransitiveDependents([simulEfun])).toEqual([]);
+    });
+
+    test('orders files dependencies first and keeps cycles in input order', () => {
+        const graph = new WorkspaceDependencyGraph();
+        const a = 'file:///D:/mud/a.c';
+        const b = 'file:///D:/mud/b.c';
+        const c = 'file:///D:/mud/c.c';
+        const x = 'file:///D:/mud/x.c';
+        const y = 'file:///D:/mud/y.c';
+
+        graph.setDependencies(a, 'inherit', [b]);
+        graph.setDependencies(b, 'include', [c]);
+        graph.setDependencies(x, 'inherit', [y]);
+        graph.setDependencies(y, 'inherit', [x]);
+
+        expect(graph.topologicalOrder([a, x, c, b, y])).toEqual([c, b, a, x, y]);
+        expect(graph.topologicalOrder([a, b, c], ['inherit'])).toEqual([b, c, a]);
+    });
+});
@@ -131,6 +131,185 @@ describe('WorkspaceIndexingService', () => {
         expect(projectSymbolIndex.clear).not.toHaveBeenCalled();
         expect(projectSymbolIndex.updateFromSemanticSnapshot).not.toHaveBeenCalled();
     });
+
+    test('applies file changes incrementally after a rebuild', async () => {
+        const roomDocument = createDocument('file:///D:/mud/room/main.c', 'D:/mud/room/main.c');
+        const projectSymbolIndex = {
+            clear: jest.fn(),
+            updateFromSemanticSnapshot: jest.fn(),
+            removeFile: jest.fn(),
+            refreshInheritTargets: jest.fn(() => true),
+            getInheritingUris: jest.fn((uri: string) => uri.endsWith('old_base.c')
+                ? ['file:///D:/mud/room/child.c']
+                : []),
+            getOwnersIncluding: jest.fn(() => []),
+            getRecordsWithUnresolvedLinks: jest.fn(() => [{
+                uri: 'file:///D:/mud/room/orphan.c',
+                inheritStatements: [{ value: '/std/new_base', expressionKind: 'string', isResolved: false }],
+                includeStatements: []
+            }])
+        };
+        const referenceIndex = {
+            clear: jest.fn(),
+            updateFile: jest.fn(),
+            removeFile: jest.fn()
+        };
+        const callGraph = {
+            clear: jest.fn(),
+            invalidate: jest.fn(),
+            removeFile: jest.fn()
+        };
+        const pathSupport = {
+            findWorkspaceSourceFiles: jest.fn(async () => []),
+            tryOpenTextDocument: jest.fn(async (filePath: string) => filePath.endsWith('main.c') ? roomDocument : undefined),
+            getWorkspaceFolderRoot: jest.fn(() => 'D:/mud'),
+            resolveIncludeFilePaths: jest.fn(async () => []),
+            fileExists: jest.fn(() => false)
+        };
+        const analysisService = {
+            getSemanticSnapshot: jest.fn((document: vscode.TextDocument) => createSemanticSnapshot(document))
+        };
+        const service = new WorkspaceIndexingService({
+            analysisService,
+            pathSupport: pathSupport as any,
+            projectSymbolIndex: projectSymbolIndex as any,
+            referenceIndex,
+            callGraph
+        });
+
+        const beforeRebuild = await service.applyFileChanges([
+            { uri: 'file:///D:/mud/room/main.c', changeType: 'changed' }
+        ]);
+        expect(beforeRebuild.updatedFiles).toBe(0);
+        expect(pathSupport.tryOpenTextDocument).not.toHaveBeenCalled();
+
+        await service.rebuild({
+            workspaceRoots: ['D:/mud'],
+            workspaces: []
+        });
+        const result = await service.applyFileChanges([
+            { uri: 'file:///D:/mud/room/main.c', changeType: 'changed' },
+            { uri: 'file:///D:/mud/std/old_base.c', changeType: 'deleted' },
+            { uri: 'file:///D:/mud/std/new_base.c', changeType: 'created' },
+            { uri: 'file:///D:/mud/notes.txt', changeType: 'changed' }
+        ]);
+
+        expect(projectSymbolIndex.clear).toHaveBeenCalledTimes(1);
+        expect(projectSymbolIndex.updateFromSemanticSnapshot).toHaveBeenCalledTimes(1);
+        expect(projectSymbolIndex.updateFromSemanticSnapshot).toHaveBeenCalledWith(expect.objectContaining({
+            uri: roomDocument.uri.toString()
+        }));
+        expect(projectSymbolIndex.removeFile).toHaveBeenCalledWith('file:///D:/mud/std/old_base.c');
+        expect(referenceIndex.clear).toHaveBeenCalledTimes(1);
+        expect(referenceIndex.updateFile).toHaveBeenCalledWith(roomDocument);
+        expect(referenceIndex.removeFile).toHaveBeenCalledWith('file:///D:/mud/std/old_base.c');
+        expect(callGraph.clear).toHaveBeenCalledTimes(1);
+        expect(callGraph.invalidate).toHaveBeenCalledWith(roomDocument.uri.toString());
+        expect(callGraph.removeFile).toHaveBeenCalledWith('file:///D:/mud/std/old_base.c');
+        expect(projectSymbolIndex.refreshInheritTargets).toHaveBeenCalledWith('file:///D:/mud/room/child.c');
+        expect(projectSymbolIndex.refreshInheritTargets).toHaveBeenCalledWith('file:///D:/mud/room/orphan.c');
+        expect(pathSupport.tryOpenTextDocument).not.toHaveBeenCalledWith(expect.stringContaining('notes.txt'));
+        expect(result).toEqual(expect.objectContaining({
+            updatedFiles: 1,
+            removedFiles: 1,
+            relinkedFiles: 2,
+            skippedFiles: 1,
+            failedFiles: 0
+        }));
+    });
+
+    test('runs a rebuild queued behind an in-flight incremental update', async () => {
+        const roomDocument = createDocument('file:///D:/mud/room/main.c', 'D:/mud/room/main.c');
+        const events: string[] = [];
+        let releaseOpen: () => void = () => undefined;
+        const projectSymbolIndex = {
+            clear: jest.fn(() => events.push('clear')),
+            updateFromSemanticSnapshot: jest.fn(() => events.push('update')),
+            removeFile: jest.fn(),
+            refreshInheritTargets: jest.fn(() => false),
+            getInheritingUris: jest.fn(() => []),
+            getOwnersIncluding: jest.fn(() => []),
+            getRecordsWithUnresolvedLinks: jest.fn(() => [])
+        };
+        const pathSupport = {
+            findWorkspaceSourceFiles: jest.fn(async () => []),
+            tryOpenTextDocument: jest.fn(() => new Promise(resolve => {
+                releaseOpen = () => resolve(roomDocument);
+            })),
+            getWorkspaceFolderRoot: jest.fn(() => 'D:/mud'),
+            resolveIncludeFilePaths: jest.fn(async () => []),
+            fileExists: jest.fn(() => false)
+        };
+        const service = new WorkspaceIndexingService({
+            analysisService: {
+                getSemanticSnapshot: jest.fn((document: vscode.TextDocument) => createSemanticSnapshot(document))
+            },
+            pathSupport: pathSupport as any,
+            projectSymbolIndex: projectSymbolIndex as any
+        });
+
+        await service.rebuild({ workspaceRoots: ['D:/mud'], workspaces: [] });
+        events.length = 0;
+        const update = service.applyFileChanges([
+            { uri: 'file:///D:/mud/room/main.c', changeType: 'changed' }
+        ]);
+        const rebuild = service.rebuild({ workspaceRoots: ['D:/mud'], workspaces: [] });
+        await new Promise(resolve => setTimeout(resolve, 0));
+        releaseOpen();
+        await Promise.all([update, rebuild]);
+
+        expect(events).toEqual(['update', 'clear']);
+    });
+
+    test('re-summarizes includers when an included header is deleted', async () => {
+        const roomDocument = createDocument('file:///D:/mud/room/main.c', 'D:/mud/room/main.c');
+        const headerUri = vscode.Uri.file('D:/mud/include/base.h').toString();
+        const projectSymbolIndex = {
+            clear: jest.fn(),
+            updateFromSemanticSnapshot: jest.fn(),
+            removeFile: jest.fn(),
+            refreshInheritTargets: jest.fn(() => false),
+            getInheritingUris: jest.fn(() => []),
+            getOwnersIncluding: jest.fn((uri: string) => uri === headerUri ? [{ uri: roomDocument.uri.toString() }] : []),
+            getRecordsWithUnresolvedLinks: jest.fn(() => [])
+        };
+        const pathSupport = {
+            findWorkspaceSourceFiles: jest.fn(async () => []),
+            tryOpenTextDocument: jest.fn(async (filePath: string) => filePath.endsWith('main.c') ? roomDocument : undefined),
+            getWorkspaceFolderRoot: jest.fn(() => 'D:/mud'),
+            resolveIncludeFilePaths: jest.fn(async () => ['D:/mud/include/base.h']),
+            fileExists: jest.fn(() => false)
+        };
+        const analysisService = {
+            // The cached snapshot still carries the resolution made before the header was deleted.
+            getSemanticSnapshot: jest.fn((document: vscode.TextDocument) => createSemanticSnapshot(document, {
+                includeStatements: [{
+                    value: '/include/base.h',
+                    isSystemInclude: false,
+                    resolvedUri: headerUri,
+                    range: createRange()
+                }]
+            }))
+        };
+        const service = new WorkspaceIndexingService({
+            analysisService,
+            pathSupport: pathSupport as any,
+            projectSymbolIndex: projectSymbolIndex as any
+        });
+
+        await service.rebuild({ workspaceRoots: ['D:/mud'], workspaces: [] });
+        const result = await service.applyFileChanges([
+            { uri: headerUri, changeType: 'deleted' }
+        ]);
+
+        expect(projectSymbolIndex.removeFile).toHaveBeenCalledWith(headerUri);
+        expect(pathSupport.tryOpenTextDocument).toHaveBeenCalledWith(vscode.Uri.parse(roomDocument.uri.toString()).fsPath);
+        expect(projectSymbolIndex.updateFromSemanticSnapshot).toHaveBeenLastCalledWith(expect.objectContaining({
+            uri: roomDocument.uri.toString(),
+            includeStatements: [expect.objectContaining({ resolvedUri: undefined })]
+        }));
+        expect(result).toEqual(expect.objectContaining({ updatedFiles: 1, removedFiles: 1 }));
+    });
 });
 
 function createDocument(uri: string, fileName: string): vscode.TextDocument {
@@ -5,10 +5,13 @@ import type { ExtensionContext } from 'vscode';
 import { CompletionInstrumentation } from '../../../completion/completionInstrumentation';
 import { InheritanceResolver } from '../../../completion/inheritanceResolver';
 import { ProjectSymbolIndex } from '../../../completion/projectSymbolIndex';
+import { advanceAnalysisConfigGeneration } from '../../../core/ContentAddressedCache';
+import { getGlobalMemoryBudgetGovernor, readConfiguredMemoryBudget } from '../../../core/MemoryBudgetGovernor';
+import { getGlobalVirtualFileSystem } from '../../../core/VirtualFileSystem';
 import { createDiagnosticsStack } from '../../../diagnostics';
 import { EfunDocsManager } from '../../../efunDocs';
 import { FunctionDocLookupBuilder } from '../../../efun/FunctionDocLookupBuilder';
-import { clearGlobalLpcFrontendService } from '../../../frontend/LpcFrontendService';
+import { clearGlobalLpcFrontendService, getGlobalLpcFrontendService } from '../../../frontend/LpcFrontendService';
 import { CallableDocRenderer } from '../../../language/documentation/CallableDocRenderer';
 import { createDefaultFunctionDocumentationService } from '../../../language/documentation/FunctionDocumentationService';
 import { CompletionContextAnalyzer } from '../../../completion/completionContextAnalyzer';
@@ -23,6 +26,7 @@ import { createLanguageCodeActionService } from '../../../language/services/code
 import { createDefaultQueryBackedLanguageCompletionService } from '../../../language/services/completion/LanguageCompletionService';
 import { createDefaultScopedMethodCompletionSupport } from '../../../language/services/completion/ScopedMethodCompletionSupport';
 import { createLanguageFormattingService } from '../../../language/services/formatting/LanguageFormattingService';
+import { CallGraphLanguageCallHierarchyService } from '../../../language/services/navigation/LanguageCallHierarchyService';
 import { AstBackedLanguageDefinitionService } from '../../../language/services/navigation/LanguageDefinitionService';
 import { EfunLanguageHoverService } from '../../../language/services/navigation/EfunLanguageHoverService';
 import {
@@ -35,9 +39,14 @@ import {
 import { InheritedFileGlobalRelationService } from '../../../language/services/navigation/InheritedFileGlobalRelationService';
 import { InheritedFunctionRelationService } from '../../../language/services/navigation/InheritedFunctionRelationService';
 import { InheritedSymbolRelationService } from '../../../language/services/navigation/InheritedSymbolRelationService';
+import { IncludedMacroRelationService } from '../../../language/services/navigation/IncludedMacroRelationService';
 import { UnifiedLanguageHoverService } from '../../../language/services/navigation/UnifiedLanguageHoverService';
 import { createDefaultAstBackedLanguageReferenceService } from '../../../language/services/navigation/LanguageReferenceService';
 import { createDefaultAstBackedLanguageRenameService } from '../../../language/services/navigation/LanguageRenameService';
+import { IndexedLanguageWorkspaceSymbolService } from '../../../language/services/navigation/LanguageWorkspaceSymbolService';
+import { WorkspaceCallGraph } from '../../../language/services/navigation/WorkspaceCallGraph';
+import { WorkspaceReferenceIndex } from '../../../language/services/navigation/WorkspaceReferenceIndex';
+import { WorkspaceSymbolIndex } from '../../../language/services/navigation/WorkspaceSymbolIndex';
 import { DefaultCallableDocResolver } from '../../../language/services/signatureHelp/DefaultCallableDocResolver';
 import { DefaultCallableTargetDiscoveryService } from '../../../language/services/signatureHelp/DefaultCallableTargetDiscoveryService';
 import { LanguageSignatureHelpService } from '../../../language/services/signatureHelp/LanguageSignatureHelpService';
@@ -50,6 +59,7 @@ import {
 } from '../../../language/services/structure/LanguageFoldingService';
 import { DefaultLanguageSemanticTokensService } from '../../../language/services/structure/LanguageSemanticTokensService';
 import { createDefaultObjectInferenceService } from '../../../objectInference/ObjectInferenceService';
+import { ReceiverOutcomeCache } from '../../../objectInference/ReceiverOutcomeCache';
 import { createDefaultScopedMethodDiscoveryService } from '../../../objectInference/ScopedMethodDiscoveryService';
 import { ScopedMethodResolver } from '../../../objectInference/ScopedMethodResolver';
 import { DocumentSemanticSnapshotService } from '../../../semantic/documentSemanticSnapshotService';
@@ -58,6 +68,7 @@ import {
     getGlobalParsedDocumentService
 } from '../../../parser/ParsedDocumentService';
 import { createDefaultSemanticEvaluationService } from '../../../semanticEvaluation/SemanticEvaluationService';
+import { FunctionReturnSummaryStore } from '../../../semanticEvaluation/calls/FunctionReturnSummaryStore';
 import { TargetMethodLookup } from '../../../targetMethodLookup';
 import { setServerWorkspaceRoots } from './serverHostState';
 import type { WorkspaceChangeIndex } from './WorkspaceChangeIndex';
@@ -67,13 +78,16 @@ export interface ProductionLanguageServicesOptions {
     changeIndex?: Pick<
         WorkspaceChangeIndex,
         'addDependencyFootprint' | 'recordDependencyFootprint' | 'get' | 'getWorkspaceConfigGeneration' | 'markClean'
-    >;
+    > & Partial<Pick<WorkspaceChangeIndex, 'dependencyGraph'>>;
 }
 
 export function createProductionLanguageServices(
     options: ProductionLanguageServicesOptions = {}
 ): LanguageFeatureServices {
     setServerWorkspaceRoots([process.cwd()]);
+    // The client forwards source file watcher events, so cached path probes can be trusted until invalidated.
+    const fileSystem = getGlobalVirtualFileSystem();
+    fileSystem.setWatched(true);
 
     const analysisService = DocumentSemanticSnapshotService.getInstance();
 
@@ -95,16 +109,27 @@ export function createProductionLanguageServices(
         analysisService,
         pathSupport: documentPathSupport
     });
+    const dependencyGraph = options.changeIndex?.dependencyGraph;
+    const getDependentUris = dependencyGraph
+        ? (uri: string) => dependencyGraph.getTransitiveDependents([uri])
+        : undefined;
+    // Function return summaries live next to the workspace index and are dropped through reverse call edges
+    // and the documents that depend on the changed file.
+    const returnSummaryStore = new FunctionReturnSummaryStore({ getDependentUris });
     const semanticEvaluationService = createDefaultSemanticEvaluationService({
         analysisService,
-        pathSupport: documentPathSupport
+        pathSupport: documentPathSupport,
+        returnSummaryStore
     });
+    // Shared by hover, completion, definition and diagnostics; a file's change drops its dependents' outcomes.
+    const receiverOutcomeCache = new ReceiverOutcomeCache({ getDependentUris });
     const objectInferenceService = createDefaultObjectInferenceService({
         analysisService,
         dependencyFootprintRecorder: options.changeIndex,
         documentationService,
         host: workspaceDocumentHost,
         pathSupport: documentPathSupport,
+        receiverOutcomeCache,
         semanticEvaluationService
     });
     const inheritanceResolver = new InheritanceResolver();
@@ -114,6 +139,9 @@ export function createProductionLanguageServices(
         host: workspaceDocumentHost
     });
     const projectSymbolIndex = new ProjectSymbolIndex(inheritanceResolver);
+    const referenceIndex = new WorkspaceReferenceIndex(
+        (uri) => baseWorkspaceDocumentHost.openTextDocument(vscode.Uri.parse(uri))
+    );
     const targetMethodLookup = new TargetMethodLookup(analysisService, documentPathSupport, options.changeIndex);
     const efunDocsManager = new EfunDocsManager(
         createServerExtensionContext(),
@@ -127,17 +155,23 @@ export function createProductionLanguageServices(
         analysisService,
         inheritanceResolver,
         scopedMethodResolver,
-        host: workspaceDocumentHost
+        host: workspaceDocumentHost,
+        referenceIndex
     });
     const inheritedFileGlobalRelationService = new InheritedFileGlobalRelationService({
         analysisService,
         inheritanceResolver,
-        host: workspaceDocumentHost
+        host: workspaceDocumentHost,
+        referenceIndex
     });
     const inheritedRelationService = new InheritedSymbolRelationService({
         analysisService,
         functionRelationService: inheritedFunctionRelationService,
-        fileGlobalRelationService: inheritedFileGlobalRelationService
+        fileGlobalRelationService: inheritedFileGlobalRelationService,
+        macroRelationService: new IncludedMacroRelationService({
+            host: workspaceDocumentHost,
+            referenceIndex
+        })
     });
     const scopedMethodDiscoveryService = createDefaultScopedMethodDiscoveryService({
         analysisService,
@@ -224,6 +258,15 @@ export function createProductionLanguageServices(
     const symbolService = createDefaultAstBackedLanguageSymbolService({
         analysisService
     });
+    const callGraph = new WorkspaceCallGraph({
+        analysisService,
+        inheritanceResolver,
+        host: workspaceDocumentHost,
+        objectInferenceService,
+        referenceIndex
+    });
+    const callHierarchyService = new CallGraphLanguageCallHierarchyService(callGraph);
+    const workspaceSymbolService = new IndexedLanguageWorkspaceSymbolService(new WorkspaceSymbolIndex(projectSymbolIndex));
     const callableTargetDiscoveryService = new DefaultCallableTargetDiscoveryService(
         efunDocsManager,
         objectInferenceService,
@@ -247,7 +290,11 @@ export function createProductionLanguageServices(
     const workspaceIndexingService = new WorkspaceIndexingService({
         analysisService,
         pathSupport: documentPathSupport,
-        projectSymbolIndex
+        projectSymbolIndex,
+        referenceIndex,
+        callGraph,
+        dependencyGraph,
+        returnSummaries: returnSummaryStore
     });
 
     const navigationService: LanguageNavigationService = {
@@ -256,18 +303,30 @@ export function createProductionLanguageServices(
         provideReferences: (request) => referenceService.provideReferences(request),
         prepareRename: (request) => renameService.prepareRename(request),
         provideRenameEdits: (request) => renameService.provideRenameEdits(request),
-        provideDocumentSymbols: (request) => symbolService.provideDocumentSymbols(request)
+        provideDocumentSymbols: (request) => symbolService.provideDocumentSymbols(request),
+        prepareCallHierarchy: (request) => callHierarchyService.prepareCallHierarchy(request),
+        provideIncomingCalls: (request) => callHierarchyService.provideIncomingCalls(request),
+        provideOutgoingCalls: (request) => callHierarchyService.provideOutgoingCalls(request),
+        provideWorkspaceSymbols: (request) => workspaceSymbolService.provideWorkspaceSymbols(request)
     };
     const structureService: LanguageStructureService = {
         provideFoldingRanges: (request) => foldingService.provideFoldingRanges(request),
-        provideSemanticTokens: (request) => semanticTokensService.provideSemanticTokens(request)
+        provideSemanticTokens: (request) => semanticTokensService.provideSemanticTokens(request),
+        provideSemanticTokensRange: (request) => semanticTokensService.provideSemanticTokensRange(request)
     };
     const invalidateProductionDocument = (uri: string): void => {
         headerOwnerContextService.clear();
         const parsedUri = vscode.Uri.parse(uri);
+        if (parsedUri.scheme === 'file') {
+            fileSystem.invalidate(parsedUri.fsPath);
+        }
         getGlobalParsedDocumentService().invalidate(parsedUri);
         analysisService.clearCache(uri);
         projectSymbolIndex.removeFile(uri);
+        referenceIndex.invalidate(uri);
+        callGraph.invalidate(uri);
+        receiverOutcomeCache.invalidate(uri);
+        returnSummaryStore.invalidateDocument(uri);
     };
     ensureFreshDocument = (uri) => {
         const uriString = uri.toString();
@@ -295,15 +354,32 @@ export function createProductionLanguageServices(
         navigationService,
         onWorkspaceConfigSync: async () => {
             headerOwnerContextService.clear();
+            fileSystem.clear();
+            advanceAnalysisConfigGeneration();
             clearGlobalLpcFrontendService();
             clearGlobalParsedDocumentService();
             analysisService.clearAllCache();
             projectSymbolIndex.clear();
+            referenceIndex.clear();
+            callGraph.clear();
+            receiverOutcomeCache.clear();
+            returnSummaryStore.clear();
+            workspaceIndexingService.reset();
             efunDocsManager.invalidateWorkspaceState();
+            getGlobalMemoryBudgetGovernor().setBudget(readConfiguredMemoryBudget());
+        },
+        onDocumentChanged: (uri) => {
+            // Unsaved edits never reach onDocumentInvalidated; drop the outcomes and summaries derived from the old text.
+            receiverOutcomeCache.invalidate(uri);
+            returnSummaryStore.invalidateDocument(uri);
         },
         onDocumentInvalidated: (uri) => {
             invalidateProductionDocument(uri);
         },
+        onFileCreated: () => {
+            // A new header earlier on the include search path changes resolution for documents that never referenced it.
+            getGlobalLpcFrontendService().discardContentSnapshots();
+        },
         signatureHelpService,
         structureService,
         workspaceIndexingService,
@@ -325,7 +401,8 @@ export function createProductionLanguageServices(
                     totalBuildTimeMs: stats.totalBuildTimeMs,
                     buildFiles: stats.buildFiles
                 };
-            }
+            },
+            getMemoryStats: () => getGlobalMemoryBudgetGovernor().getReport()
         }
     };
 }
@@ -3,6 +3,7 @@ import * as path from 'path';
 import { getServerWorkspaceRoots } from './serverHostState';
 import { fromFileUri, isPathPrefix, normalizeComparablePath, resolveWorkspaceRootFromRoots } from './serverPathUtils';
 import type { DocumentStore, StoredDocument } from './DocumentStore';
+import { TextBuffer } from './TextBuffer';
 
 export class Disposable {
     private readonly onDispose?: () => void;
@@ -324,10 +325,12 @@ interface TextDocumentLike {
     validatePosition(position: Position): Position;
 }
 
-type SyncedDocumentSource = Pick<DocumentStore, 'get' | 'list'>;
+type SyncedDocumentSource = Pick<DocumentStore, 'get' | 'list'> & Partial<Pick<DocumentStore, 'getBuffer'>>;
 
 const openedReadonlyDocuments = new Map<string, TextDocumentLike>();
 const openedReadonlyDocumentStats = new Map<string, { mtimeMs: number; size: number }>();
+// 同一个同步版本的缓冲只投影一次，多次访问共用同一文档及其行索引。
+const projectedSyncedDocuments = new WeakMap<TextBuffer, TextDocumentLike>();
 let syncedDocumentSource: SyncedDocumentSource | undefined;
 const configurationValues = new Map<string, unknown>();
 const textDocumentChangedEmitter = new EventEmitter<{ document: TextDocumentLike }>();
@@ -535,7 +538,7 @@ export const workspace = {
         }
 
         const content = await fs.promises.readFile(uri.fsPath, 'utf8');
-        const document = createTextDocument(uri, content, toDocumentVersion(currentStats));
+        const document = createTextDocument(uri, new TextBuffer(content), toDocumentVersion(currentStats));
         openedReadonlyDocuments.set(cacheKey, document);
         openedReadonlyDocumentStats.set(cacheKey, {
             mtimeMs: currentStats.mtimeMs,
@@ -556,7 +559,7 @@ export function __setConfigurationValue(key: string, value: unknown): void {
 export function __syncTextDocument(uri: string, text: string, version: number): void {
     if (!syncedDocumentSource) {
         const parsedUri = Uri.parse(uri);
-        openedReadonlyDocuments.set(parsedUri.toString(), createTextDocument(parsedUri, text, version));
+        openedReadonlyDocuments.set(parsedUri.toString(), createTextDocument(parsedUri, new TextBuffer(text), version));
         openedReadonlyDocumentStats.delete(parsedUri.toString());
     }
 }
@@ -586,28 +589,12 @@ export function __invalidateTextDocument(uri: string): void {
     openedReadonlyDocumentStats.delete(key);
 }
 
-function createTextDocument(uri: Uri, content: string, version: number): TextDocumentLike {
-    const lineStarts = buildLineStarts(content);
-    const lines = content.split(/\r?\n/);
-
-    const offsetAt = (position: Position): number => {
-        const lineStart = lineStarts[position.line] ?? content.length;
-        return Math.min(lineStart + position.character, content.length);
-    };
+function createTextDocument(uri: Uri, buffer: TextBuffer, version: number): TextDocumentLike {
+    const offsetAt = (position: Position): number => buffer.offsetAt(position);
 
     const positionAt = (offset: number): Position => {
-        const safeOffset = Math.max(0, Math.min(offset, content.length));
-        let line = 0;
-
-        for (let index = 0; index < lineStarts.length; index += 1) {
-            if (lineStarts[index] <= safeOffset) {
-                line = index;
-            } else {
-                break;
-            }
-        }
-
-        return new Position(line, safeOffset - lineStarts[line]);
+        const position = buffer.positionAt(offset);
+        return new Position(position.line, position.character);
     };
 
     return {
@@ -615,21 +602,23 @@ function createTextDocument(uri: Uri, content: string, version: number): TextDoc
         fileName: uri.fsPath,
         languageId: 'lpc',
         version,
-        lineCount: lines.length,
+        get lineCount(): number {
+            return buffer.lineCount;
+        },
         isDirty: false,
         isClosed: false,
         isUntitled: false,
         eol: EndOfLine.LF,
         getText: (range?: Range) => {
             if (!range) {
-                return content;
+                return buffer.text;
             }
 
-            return content.slice(offsetAt(range.start), offsetAt(range.end));
+            return buffer.text.slice(offsetAt(range.start), offsetAt(range.end));
         },
         lineAt: (lineOrPosition: number | Position): TextLine => {
             const line = typeof lineOrPosition === 'number' ? lineOrPosition : lineOrPosition.line;
-            const text = lines[line] ?? '';
+            const text = buffer.lineText(line);
             const range = new Range(new Position(line, 0), new Position(line, text.length));
             return {
                 lineNumber: line,
@@ -643,7 +632,7 @@ function createTextDocument(uri: Uri, content: string, version: number): TextDoc
         positionAt,
         offsetAt,
         getWordRangeAtPosition: (position: Position): Range | undefined => {
-            const lineText = lines[position.line] ?? '';
+            const lineText = buffer.lineText(position.line);
             if (lineText.length === 0) {
                 return undefined;
             }
@@ -675,16 +664,6 @@ function createTextDocument(uri: Uri, content: string, version: number): TextDoc
     };
 }
 
-function buildLineStarts(text: string): number[] {
-    const lineStarts = [0];
-    for (let index = 0; index < text.length; index += 1) {
-        if (text[index] === '\n') {
-            lineStarts.push(index + 1);
-        }
-    }
-    return lineStarts;
-}
-
 function globToRegExp(glob: string): RegExp {
     const normalized = normalizePath(glob)
         .replace(/\./g, '\\.')
@@ -736,7 +715,19 @@ function isWordCharacter(char: string | undefined): boolean {
 }
 
 function createProjectedSyncedDocument(document: Readonly<StoredDocument>): TextDocumentLike {
-    return createTextDocument(Uri.parse(document.uri), document.text, document.version);
+    const storedBuffer = syncedDocumentSource?.getBuffer?.(document.uri);
+    if (!storedBuffer || storedBuffer.text !== document.text) {
+        return createTextDocument(Uri.parse(document.uri), new TextBuffer(document.text), document.version);
+    }
+
+    const cached = projectedSyncedDocuments.get(storedBuffer);
+    if (cached && cached.version === document.version) {
+        return cached;
+    }
+
+    const projected = createTextDocument(Uri.parse(document.uri), storedBuffer, document.version);
+    projectedSyncedDocuments.set(storedBuffer, projected);
+    return projected;
 }
 
 function toDocumentVersion(stats: fs.Stats): number {
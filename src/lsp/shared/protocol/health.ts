@@ -29,6 +29,17 @@ export interface HealthStatusResponse {
                 totalTimeMs: number;
             }>;
         };
+        memory?: {
+            budgetBytes: number;
+            usedBytes: number;
+            caches: Array<{
+                name: string;
+                entries: number;
+                bytes: number;
+                evictions: number;
+                cascadeEvictions: number;
+            }>;
+        };
     };
 }
 
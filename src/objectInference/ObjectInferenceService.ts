@@ -25,6 +25,7 @@ import { ReceiverBindingResolver } from './ReceiverBindingResolver';
 import { ReceiverClassifier } from './ReceiverClassifier';
 import { ReceiverFlowCollector } from './ReceiverFlowCollector';
 import { ReceiverFunctionLocator } from './ReceiverFunctionLocator';
+import { ReceiverOutcomeCache } from './ReceiverOutcomeCache';
 import { ReceiverTraceService } from './ReceiverTraceService';
 import { ObjectResolutionOutcome, ReturnObjectResolver } from './ReturnObjectResolver';
 import { ScopedMethodResolver } from './ScopedMethodResolver';
@@ -34,6 +35,7 @@ import { ClassifiedReceiver, InferredObjectAccess, ObjectCandidate } from './typ
 export interface ObjectInferenceServiceDependencies {
     analysisService?: Pick<DocumentAnalysisService, 'getSyntaxDocument' | 'getSemanticSnapshot'>;
     pathSupport?: WorkspaceDocumentPathSupport;
+    receiverOutcomeCache?: Pick<ReceiverOutcomeCache, 'getOrResolve'>;
     returnObjectResolver: ReturnObjectResolver;
     semanticEvaluationService?: Pick<SemanticEvaluationService, 'evaluateExpressionAtPosition'>;
     traceService: ReceiverTraceService;
@@ -47,6 +49,7 @@ export interface DefaultObjectInferenceServiceDependencies {
     documentationService?: FunctionDocumentationService;
     host?: TextDocumentHost;
     pathSupport?: WorkspaceDocumentPathSupport;
+    receiverOutcomeCache?: Pick<ReceiverOutcomeCache, 'getOrResolve'>;
     semanticEvaluationService?: SemanticEvaluationService;
 }
 
@@ -58,6 +61,7 @@ export class ObjectInferenceService {
     private readonly bindingResolver = new ReceiverBindingResolver();
     private readonly flowCollector = new ReceiverFlowCollector(this.bindingResolver);
     private readonly pathSupport: WorkspaceDocumentPathSupport;
+    private readonly receiverOutcomeCache?: Pick<ReceiverOutcomeCache, 'getOrResolve'>;
     private readonly returnObjectResolver: ReturnObjectResolver;
     private readonly semanticEvaluationService?: Pick<SemanticEvaluationService, 'evaluateExpressionAtPosition'>;
     private readonly traceService: ReceiverTraceService;
@@ -67,6 +71,7 @@ export class ObjectInferenceService {
     constructor(dependencies: ObjectInferenceServiceDependencies) {
         this.analysisService = assertAnalysisService('ObjectInferenceService', dependencies.analysisService);
         this.pathSupport = assertDocumentPathSupport('ObjectInferenceService', dependencies.pathSupport);
+        this.receiverOutcomeCache = dependencies.receiverOutcomeCache;
         this.returnObjectResolver = dependencies.returnObjectResolver;
         this.semanticEvaluationService = dependencies.semanticEvaluationService;
         this.traceService = dependencies.traceService;
@@ -103,7 +108,14 @@ export class ObjectInferenceService {
             };
         }
 
-        const resolution = await this.resolveCandidates(document, syntax, receiverNode, classifiedReceiver);
+        const resolution = this.receiverOutcomeCache
+            ? await this.receiverOutcomeCache.getOrResolve(
+                document,
+                syntax,
+                receiverNode,
+                () => this.resolveCandidates(document, syntax, receiverNode, classifiedReceiver)
+            )
+            : await this.resolveCandidates(document, syntax, receiverNode, classifiedReceiver);
         const inferenceReason = resolution.reason ?? this.getInferenceReason(classifiedReceiver);
 
         return {
@@ -589,6 +601,7 @@ export function createDefaultObjectInferenceService(
     return new ObjectInferenceService({
         analysisService,
         pathSupport,
+        receiverOutcomeCache: dependencies.receiverOutcomeCache,
         returnObjectResolver,
         semanticEvaluationService,
         traceService,
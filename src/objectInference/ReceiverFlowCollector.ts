@@ -5,6 +5,8 @@ import { FlowState } from './ReceiverTraceTypes';
 import { isBeforeOrEqual } from './ReceiverTraceSupport';
 
 export class ReceiverFlowCollector {
+    private readonly flowStatesByFunction = new WeakMap<SyntaxNode, Map<string, FlowState>>();
+
     public constructor(private readonly bindingResolver: ReceiverBindingResolver) {}
 
     public collectSourceExpressions(
@@ -13,12 +15,25 @@ export class ReceiverFlowCollector {
         usagePosition: vscode.Position,
         binding: SyntaxNode | undefined
     ): FlowState {
-        const body = functionNode.children.find((child) => child.kind === SyntaxKind.Block);
-        if (!body) {
-            return this.createFlowState();
+        // Syntax nodes are rebuilt for every document version, so flow states keyed by the function node never go stale.
+        let flowStates = this.flowStatesByFunction.get(functionNode);
+        if (!flowStates) {
+            flowStates = new Map();
+            this.flowStatesByFunction.set(functionNode, flowStates);
         }
 
-        return this.collectFlowExpressions(body, functionNode, identifierName, usagePosition, binding, this.createFlowState());
+        const key = `${identifierName}|${this.bindingResolver.bindingKey(identifierName, binding)}@${usagePosition.line}:${usagePosition.character}`;
+        const cached = flowStates.get(key);
+        if (cached) {
+            return this.createFlowState([...cached.expressions], cached.isConservativeUnknown);
+        }
+
+        const body = functionNode.children.find((child) => child.kind === SyntaxKind.Block);
+        const state = body
+            ? this.collectFlowExpressions(body, functionNode, identifierName, usagePosition, binding, this.createFlowState())
+            : this.createFlowState();
+        flowStates.set(key, state);
+        return this.createFlowState([...state.expressions], state.isConservativeUnknown);
     }
 
     private collectFlowExpressions(
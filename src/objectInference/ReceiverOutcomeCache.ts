@@ -0,0 +1,87 @@
+import * as vscode from 'vscode';
+import { toDependencyKey } from '../lsp/server/runtime/WorkspaceDependencyGraph';
+import { SyntaxDocument, SyntaxNode } from '../syntax/types';
+import { ObjectResolutionOutcome } from './ReturnObjectResolver';
+
+export interface ReceiverOutcomeCacheOptions {
+    maxDocuments?: number;
+    getDependentUris?: (uri: string) => readonly string[];
+}
+
+interface DocumentOutcomes {
+    syntax: SyntaxDocument;
+    outcomes: Map<SyntaxNode, Promise<ObjectResolutionOutcome>>;
+}
+
+const DEFAULT_MAX_DOCUMENTS = 64;
+
+/**
+ * Receiver outcomes per document version, keyed by receiver node. A new syntax document drops the
+ * previous version's entries. The owner reports edits and disk changes through `invalidate`, which drops
+ * the documents that depend on the changed file, or every document when no dependency lookup is configured.
+ */
+export class ReceiverOutcomeCache {
+    private readonly documents = new Map<string, DocumentOutcomes>();
+    private readonly maxDocuments: number;
+    private readonly getDependentUris?: (uri: string) => readonly string[];
+
+    public constructor(options: ReceiverOutcomeCacheOptions = {}) {
+        this.maxDocuments = Math.max(1, options.maxDocuments ?? DEFAULT_MAX_DOCUMENTS);
+        this.getDependentUris = options.getDependentUris;
+    }
+
+    public getOrResolve(
+        document: vscode.TextDocument,
+        syntax: SyntaxDocument,
+        receiverNode: SyntaxNode,
+        resolve: () => Promise<ObjectResolutionOutcome>
+    ): Promise<ObjectResolutionOutcome> {
+        const key = toDependencyKey(document.uri.toString());
+        let entry = this.documents.get(key);
+        if (!entry || entry.syntax !== syntax) {
+            entry = { syntax, outcomes: new Map() };
+        }
+        this.documents.delete(key);
+        this.documents.set(key, entry);
+        this.evictOverflow();
+
+        const cached = entry.outcomes.get(receiverNode);
+        if (cached) {
+            return cached;
+        }
+
+        const outcomes = entry.outcomes;
+        const pending = resolve();
+        outcomes.set(receiverNode, pending);
+        pending.catch(() => {
+            if (outcomes.get(receiverNode) === pending) {
+                outcomes.delete(receiverNode);
+            }
+        });
+
+        return pending;
+    }
+
+    public invalidate(uri: string): void {
+        if (!this.getDependentUris) {
+            this.documents.clear();
+            return;
+        }
+
+        this.documents.delete(toDependencyKey(uri));
+        for (const dependentUri of this.getDependentUris(uri)) {
+            this.documents.delete(toDependencyKey(dependentUri));
+        }
+    }
+
+    public clear(): void {
+        this.documents.clear();
+    }
+
+    private evictOverflow(): void {
+        while (this.documents.size > this.maxDocuments) {
+            const oldestKey = this.documents.keys().next().value as string;
+            this.documents.delete(oldestKey);
+        }
+    }
+}
@@ -17,6 +17,7 @@ import {
     ObjectInferenceService,
     createDefaultObjectInferenceService
 } from '../ObjectInferenceService';
+import { ReceiverOutcomeCache } from '../ReceiverOutcomeCache';
 import {
     candidateSetValue,
     configuredCandidateSetValue,
@@ -108,7 +109,11 @@ describe('ObjectInferenceService', () => {
     const analysisService = DocumentSemanticSnapshotService.getInstance();
     let documentationService: FunctionDocumentationService;
     const documentHost = createVsCodeTextDocumentHost();
-    const createService = (_instanceResolutionOrProjectConfig?: unknown, overrideSemanticEvaluationService?: unknown) => {
+    const createService = (
+        _instanceResolutionOrProjectConfig?: unknown,
+        overrideSemanticEvaluationService?: unknown,
+        receiverOutcomeCache?: ReceiverOutcomeCache
+    ) => {
         const projectConfigProvider = typeof _instanceResolutionOrProjectConfig === 'string'
             ? undefined
             : _instanceResolutionOrProjectConfig as any;
@@ -140,6 +145,7 @@ describe('ObjectInferenceService', () => {
             documentationService,
             host: documentHost,
             pathSupport,
+            receiverOutcomeCache,
             semanticEvaluationService: semanticEvaluationServiceWithDefaults as any
         });
     };
@@ -1944,6 +1950,108 @@ describe('ObjectInferenceService', () => {
         });
     });
 
+    test('receiver outcome cache reuses outcomes per document version until a dependency is invalidated', async () => {
+        const baseFactoryPath = path.join(fixtureRoot, 'adm', 'objects', 'cached-base-factory.c');
+        const writeBaseFactory = (target: string) => fs.writeFileSync(
+            baseFactoryPath,
+            [
+                '/**',
+                ' * @return object weapon',
+                ` * @lpc-return-objects {"/adm/objects/${target}"}`,
+                ' */',
+                'object method() {',
+                `    return clone_object("/adm/objects/${target}");`,
+                '}'
+            ].join('\n'),
+            'utf8'
+        );
+        writeBaseFactory('sword');
+        fs.writeFileSync(
+            path.join(fixtureRoot, 'adm', 'objects', 'cached-child-factory.c'),
+            'inherit "/adm/objects/cached-base-factory";\n',
+            'utf8'
+        );
+
+        const source = [
+            'void demo() {',
+            '    object factory = load_object("/adm/objects/cached-child-factory");',
+            '    object weapon = factory->method();',
+            '    weapon->query();',
+            '}'
+        ].join('\n');
+        const document = createDocument(path.join(fixtureRoot, 'room', 'cached-method-resolution.c'), source);
+        const dependents = new Map<string, string[]>([
+            [vscode.Uri.file(baseFactoryPath).toString(), [document.uri.toString()]]
+        ]);
+        const cache = new ReceiverOutcomeCache({ getDependentUris: (uri) => dependents.get(uri) ?? [] });
+        const cachedService = createService(undefined, undefined, cache);
+        const candidatePaths = async () => (await cachedService.inferObjectAccess(document, positionAfter(source, 'weapon->query')))
+            ?.inference.candidates.map((candidate) => path.basename(candidate.path));
+
+        expect(await candidatePaths()).toEqual(['sword.c']);
+
+        writeBaseFactory('shield');
+        expect(await candidatePaths()).toEqual(['sword.c']);
+
+        cache.invalidate(path.join(fixtureRoot, 'room', 'unrelated.c'));
+        expect(await candidatePaths()).toEqual(['sword.c']);
+
+        cache.invalidate(vscode.Uri.file(baseFactoryPath).toString());
+        expect(await candidatePaths()).toEqual(['shield.c']);
+    });
+
+    test('receiver outcome cache recomputes outcomes after an unsaved edit to an inherited file', async () => {
+        const baseFactoryPath = path.join(fixtureRoot, 'adm', 'objects', 'edited-base-factory.c');
+        const baseFactorySource = (target: string) => [
+            '/**',
+            ' * @return object weapon',
+            ` * @lpc-return-objects {"/adm/objects/${target}"}`,
+            ' */',
+            'object method() {',
+            `    return clone_object("/adm/objects/${target}");`,
+            '}'
+        ].join('\n');
+        fs.writeFileSync(baseFactoryPath, baseFactorySource('sword'), 'utf8');
+        fs.writeFileSync(
+            path.join(fixtureRoot, 'adm', 'objects', 'edited-child-factory.c'),
+            'inherit "/adm/objects/edited-base-factory";\n',
+            'utf8'
+        );
+
+        const source = [
+            'void demo() {',
+            '    object factory = load_object("/adm/objects/edited-child-factory");',
+            '    object weapon = factory->method();',
+            '    weapon->query();',
+            '}'
+        ].join('\n');
+        const document = createDocument(path.join(fixtureRoot, 'room', 'edited-method-resolution.c'), source);
+        const baseUri = vscode.Uri.file(baseFactoryPath).toString();
+        const cache = new ReceiverOutcomeCache({ getDependentUris: (uri) => uri === baseUri ? [document.uri.toString()] : [] });
+        const cachedService = createService(undefined, undefined, cache);
+        const candidatePaths = async () => (await cachedService.inferObjectAccess(document, positionAfter(source, 'weapon->query')))
+            ?.inference.candidates.map((candidate) => path.basename(candidate.path));
+
+        expect(await candidatePaths()).toEqual(['sword.c']);
+
+        // The editor holds a newer version of the base file; the file on disk is unchanged.
+        const readFromDisk = (vscode.workspace.openTextDocument as jest.Mock).getMockImplementation() as
+            (target: string | vscode.Uri) => Promise<vscode.TextDocument>;
+        (vscode.workspace.openTextDocument as jest.Mock).mockImplementation(async (target: string | vscode.Uri) => {
+            const filePath = typeof target === 'string' ? target : target.fsPath;
+            return path.normalize(filePath.replace(/^[/\\]+([A-Za-z]:[\\/])/, '$1')) === baseFactoryPath
+                ? createDocument(baseFactoryPath, baseFactorySource('shield'), 2)
+                : readFromDisk(target);
+        });
+
+        expect(await candidatePaths()).toEqual(['sword.c']);
+
+        // didChange of the base file reaches the cache through the server's onDocumentChanged hook.
+        cache.invalidate(baseUri);
+        expect(await candidatePaths()).toEqual(['shield.c']);
+        expect(fs.readFileSync(baseFactoryPath, 'utf8')).toContain('/adm/objects/sword');
+    });
+
     test('method return inference reflects updated inherited implementations without stale cached docs', async () => {
         const baseFactoryPath = path.join(fixtureRoot, 'adm', 'objects', 'refreshable-base-factory.c');
         fs.writeFileSync(
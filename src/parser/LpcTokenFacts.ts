@@ -163,31 +163,35 @@ export function isReceiverBoundaryToken(token: LpcTokenLike): boolean {
 }
 
 export function classifyLexicalSemanticToken(token: LpcTokenLike): LpcLexicalSemanticTokenKind | undefined {
-    if (isTypeKeywordToken(token)) {
+    return classifyLexicalSemanticTokenType(token.type);
+}
+
+export function classifyLexicalSemanticTokenType(tokenType: number): LpcLexicalSemanticTokenKind | undefined {
+    if (TYPE_TOKENS.has(tokenType)) {
         return 'type';
     }
 
-    if (token.type === LPCLexer.STRING_LITERAL || token.type === LPCLexer.CHAR_LITERAL) {
+    if (tokenType === LPCLexer.STRING_LITERAL || tokenType === LPCLexer.CHAR_LITERAL) {
         return 'string';
     }
 
-    if (token.type === LPCLexer.INTEGER || token.type === LPCLexer.FLOAT) {
+    if (tokenType === LPCLexer.INTEGER || tokenType === LPCLexer.FLOAT) {
         return 'number';
     }
 
-    if (token.type === LPCLexer.LINE_COMMENT || token.type === LPCLexer.BLOCK_COMMENT) {
+    if (tokenType === LPCLexer.LINE_COMMENT || tokenType === LPCLexer.BLOCK_COMMENT) {
         return 'comment';
     }
 
-    if (token.type === LPCLexer.KW_NEW || token.type === LPCLexer.MODIFIER) {
+    if (tokenType === LPCLexer.KW_NEW || tokenType === LPCLexer.MODIFIER) {
         return 'keyword';
     }
 
-    if (token.type >= LPCLexer.IF && token.type <= LPCLexer.IN) {
+    if (tokenType >= LPCLexer.IF && tokenType <= LPCLexer.IN) {
         return 'keyword';
     }
 
-    if (OPERATOR_TOKENS.has(token.type)) {
+    if (OPERATOR_TOKENS.has(tokenType)) {
         return 'operator';
     }
 
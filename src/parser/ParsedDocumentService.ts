@@ -1,11 +1,19 @@
-import { CharStreams, CommonTokenStream } from 'antlr4ts';
+import { CharStreams, CommonTokenStream, ListTokenSource, Token, TokenSource } from 'antlr4ts';
 import * as vscode from 'vscode';
 import { LPCLexer } from '../antlr/LPCLexer';
 import { LPCParser } from '../antlr/LPCParser';
+import { ContentAddressedCache } from '../core/ContentAddressedCache';
 import { DocumentCache } from '../core/DocumentCache';
+import {
+    getGlobalMemoryBudgetGovernor,
+    MemoryBudgetGovernor,
+    MemoryBudgetRegistration
+} from '../core/MemoryBudgetGovernor';
 import { getGlobalLpcFrontendService, LpcFrontendService } from '../frontend/LpcFrontendService';
 import { PreprocessorDiagnostic } from '../frontend/types';
 import { CollectingErrorListener } from './CollectingErrorListener';
+import { selectDeclarationTokens } from './declarationTokens';
+import { TokenTable } from './TokenTable';
 import { TokenTriviaIndex } from './TokenTriviaIndex';
 import {
     ParsedDocument,
@@ -13,11 +21,31 @@ import {
     ParsedDocumentStats
 } from './types';
 
+/** 单个 token 对象及其在 parse tree 中分摊的节点开销（字节，经验值） */
+const PARSED_TOKEN_BYTES = 160;
+/** 相对预处理快照，重新解析一个文档的代价 */
+const PARSED_REBUILD_COST = 4;
+
+interface ParseInput {
+    startedAt: number;
+    startTime: number;
+    text: string;
+    parseText: string;
+    frontend: ReturnType<LpcFrontendService['get']>;
+    errorListener: CollectingErrorListener;
+}
+
 export class ParsedDocumentService {
     private readonly documentCache: DocumentCache<ParsedDocument>;
+    /** 跨版本复用：预处理结果沿用同一份 active view 时，解析结果也可以直接沿用 */
+    private readonly contentDocuments = new ContentAddressedCache<ParsedDocument>(
+        undefined,
+        (parsed) => estimateParsedDocumentBytes(parsed)
+    );
     private parseCount = 0;
     private totalParseTime = 0;
     private readonly parseStatsByUri = new Map<string, { count: number; totalTimeMs: number }>();
+    private memoryBudget?: MemoryBudgetRegistration;
 
     constructor(
         config: ParsedDocumentServiceConfig,
@@ -27,10 +55,12 @@ export class ParsedDocumentService {
 
         this.documentCache = new DocumentCache<ParsedDocument>({
             maxSize: config.maxSize ?? vscodeConfig.get<number>('maxCacheSize', 50),
-            maxMemory: config.maxMemory ?? vscodeConfig.get<number>('maxCacheMemory', 5_000_000),
+            maxMemory: config.maxMemory ?? vscodeConfig.get<number>('maxCacheMemory', 50_000_000),
             ttl: config.ttl ?? 5 * 60 * 1000,
             cleanupInterval: config.cleanupInterval ?? 60 * 1000,
             enableMonitoring: config.enableMonitoring ?? vscodeConfig.get<boolean>('enableMonitoring', true),
+            // 文件夹扫描等一次性解析不应挤掉正在编辑的热点文档。
+            admissionPolicy: 'tinylfu',
             enableVersionTracking: true,
             autoInvalidateOnChange: true
         });
@@ -43,20 +73,99 @@ export class ParsedDocumentService {
             return cached;
         }
 
-        return this.parse(document);
+        return this.reuseUnchangedContent(document) ?? this.parse(document);
+    }
+
+    /**
+     * 索引模式解析：跳过函数体，只为声明层摘要构建 parse tree。
+     * 结果不写入文档缓存；打开的文档仍然走 `get()` 的完整解析。
+     */
+    public parseDeclarations(document: vscode.TextDocument): ParsedDocument {
+        const cached = this.documentCache.get(document);
+        if (cached) {
+            return cached;
+        }
+
+        const input = this.prepareParseInput(document);
+        try {
+            return this.buildParsedDocument(
+                document,
+                input,
+                (lexer) => new ListTokenSource(selectDeclarationTokens(this.readTokens(new CommonTokenStream(lexer)))),
+                { cacheResult: false, declarationOnly: true }
+            );
+        } catch (error) {
+            console.error('Failed to build declaration-only parse, falling back to full parse:', error);
+            return this.get(document);
+        }
+    }
+
+    /**
+     * 向统一内存预算登记解析结果缓存；驱逐某文档时级联失效持有其解析结果的语义分析。
+     */
+    public attachMemoryBudget(governor: MemoryBudgetGovernor): MemoryBudgetRegistration {
+        this.memoryBudget?.unregister();
+        this.contentDocuments.attachMemoryBudget(
+            governor,
+            'parsedDocumentContent',
+            (uri, parsed) => this.documentCache.peekValues(uri).some((held) => held.tree === parsed.tree)
+        );
+        this.memoryBudget = governor.register({
+            name: 'parsedDocuments',
+            rebuildCost: PARSED_REBUILD_COST,
+            dependents: ['semanticAnalyses'],
+            getUsage: () => {
+                const stats = this.documentCache.getStats();
+                return { entries: stats.size, bytes: stats.memory };
+            },
+            peekColdest: () => {
+                const entry = this.documentCache.peekColdest();
+                return entry && {
+                    key: entry.key,
+                    bytes: entry.size,
+                    lastAccessed: entry.lastAccessed,
+                    documentUri: entry.uri
+                };
+            },
+            evict: (key) => {
+                // 预算驱逐要真正释放内存，内容寻址层对同一文档的引用也要去掉。
+                const uri = this.documentCache.getKeyUri(key);
+                if (uri) {
+                    this.contentDocuments.deleteUri(uri);
+                }
+                return this.documentCache.evictKey(key);
+            },
+            evictDocument: (uri) => {
+                this.contentDocuments.deleteUri(uri);
+                return this.documentCache.evictUri(uri);
+            }
+        });
+        return this.memoryBudget;
     }
 
-    public invalidate(uri: vscode.Uri): void {
+    /**
+     * 失效某文档的当前解析结果。内容寻址层默认保留（命中时会核对预处理结果），
+     * `discardContentEntries` 为 true 时连同预处理层一起丢弃，强制完整重建。
+     */
+    public invalidate(uri: vscode.Uri, discardContentEntries: boolean = false): void {
         this.documentCache.invalidateDocument(uri);
-        this.frontendService.invalidate(uri);
+        this.frontendService.invalidate(uri, discardContentEntries);
+        if (discardContentEntries) {
+            this.contentDocuments.deleteUri(uri.toString());
+        }
     }
 
     public invalidatePattern(pattern: RegExp): number {
         return this.documentCache.invalidatePattern(pattern);
     }
 
+    public invalidatePrefix(uriPrefix: string): number {
+        return this.documentCache.invalidatePrefix(uriPrefix);
+    }
+
     public clear(): void {
         this.documentCache.clear();
+        this.contentDocuments.clear();
         this.frontendService.clear();
         this.parseCount = 0;
         this.totalParseTime = 0;
@@ -68,6 +177,9 @@ export class ParsedDocumentService {
     }
 
     public dispose(): void {
+        this.memoryBudget?.unregister();
+        this.memoryBudget = undefined;
+        this.contentDocuments.detachMemoryBudget();
         this.documentCache.dispose();
     }
 
@@ -88,88 +200,127 @@ export class ParsedDocumentService {
         };
     }
 
-    private parse(document: vscode.TextDocument): ParsedDocument {
-        const startedAt = Date.now();
-        const startTime = performance.now();
+    /**
+     * 文本与预处理结果都未变化的新版本：沿用旧解析结果，只更新版本与预处理快照引用
+     */
+    private reuseUnchangedContent(document: vscode.TextDocument): ParsedDocument | undefined {
+        const uri = document.uri.toString();
         const text = document.getText();
         const frontend = this.frontendService.get(document);
-        const parseText = frontend.preprocessor.activeView.text;
-        const errorListener = new CollectingErrorListener(document);
+        const reusable = this.contentDocuments.get(
+            uri,
+            text,
+            (parsed) => parsed.frontend?.preprocessor.activeView === frontend.preprocessor.activeView
+        );
+        if (!reusable) {
+            return undefined;
+        }
+
+        const parsed = rebindParsedDocument(reusable, document.version, frontend);
+        this.documentCache.set(document, parsed, estimateParsedDocumentBytes(parsed));
+        this.memoryBudget?.notifyGrowth();
+        return parsed;
+    }
 
+    private parse(document: vscode.TextDocument): ParsedDocument {
+        const input = this.prepareParseInput(document);
         try {
-            const input = CharStreams.fromString(parseText);
-            const lexer = new LPCLexer(input);
-            const tokenStream = new CommonTokenStream(lexer);
-            const parser = new LPCParser(tokenStream);
+            return this.buildParsedDocument(document, input, (lexer) => lexer, { cacheResult: true });
+        } catch (error) {
+            return this.createFallbackParsedDocument(document, input, error);
+        }
+    }
 
-            if (typeof lexer.removeErrorListeners === 'function') {
-                lexer.removeErrorListeners();
-            }
-            if (typeof lexer.addErrorListener === 'function') {
-                lexer.addErrorListener(errorListener);
-            }
-            if (typeof parser.removeErrorListeners === 'function') {
-                parser.removeErrorListeners();
-            }
-            if (typeof parser.addErrorListener === 'function') {
-                parser.addErrorListener(errorListener);
-            }
+    private prepareParseInput(document: vscode.TextDocument): ParseInput {
+        const frontend = this.frontendService.get(document);
+        return {
+            startedAt: Date.now(),
+            startTime: performance.now(),
+            text: document.getText(),
+            parseText: frontend.preprocessor.activeView.text,
+            frontend,
+            errorListener: new CollectingErrorListener(document)
+        };
+    }
 
-            const tree = parser.sourceFile();
-
-            const parseTimeMs = performance.now() - startTime;
-            this.parseCount++;
-            this.totalParseTime += parseTimeMs;
-            this.recordParse(document.uri.toString(), parseTimeMs);
-
-            const allTokens = this.readTokens(tokenStream);
-            const visibleTokens = allTokens.filter((token) => token.channel === LPCLexer.DEFAULT_TOKEN_CHANNEL);
-            const hiddenTokens = allTokens.filter((token) => token.channel !== LPCLexer.DEFAULT_TOKEN_CHANNEL);
-            const parsed: ParsedDocument = {
-                uri: document.uri.toString(),
-                version: document.version,
-                text,
-                parseText,
-                frontend,
-                tokenStream,
-                tokens: tokenStream,
-                allTokens,
-                visibleTokens,
-                hiddenTokens,
-                tokenTriviaIndex: {} as TokenTriviaIndex,
-                tree,
-                diagnostics: [
-                    ...this.safeDiagnostics(errorListener),
-                    ...this.toVsCodePreprocessorDiagnostics(frontend.preprocessor.diagnostics)
-                ],
-                createdAt: startedAt,
-                lastAccessed: startedAt,
-                parseTimeMs,
-                parseTime: parseTimeMs,
-                size: text.length,
-                layoutTriviaSource: 'lexer-hidden-channel'
-            };
-            parsed.tokenTriviaIndex = new TokenTriviaIndex(parsed);
-
-            this.documentCache.set(document, parsed, text.length * 2);
-            return parsed;
-        } catch (error) {
-            return this.createFallbackParsedDocument(document, text, parseText, frontend, startedAt, startTime, error, errorListener);
+    /**
+     * 完整解析与声明层解析共用的构建流程：`createTokenSource` 决定交给 parser 的 token 来源，
+     * `cacheResult` 为 true 时写入文档缓存与内容寻址层。
+     */
+    private buildParsedDocument(
+        document: vscode.TextDocument,
+        input: ParseInput,
+        createTokenSource: (lexer: LPCLexer) => TokenSource,
+        options: { cacheResult: boolean; declarationOnly?: boolean }
+    ): ParsedDocument {
+        const { startedAt, startTime, text, parseText, frontend, errorListener } = input;
+        const lexer = new LPCLexer(CharStreams.fromString(parseText));
+        if (typeof lexer.removeErrorListeners === 'function') {
+            lexer.removeErrorListeners();
+        }
+        if (typeof lexer.addErrorListener === 'function') {
+            lexer.addErrorListener(errorListener);
         }
+
+        const tokenStream = new CommonTokenStream(createTokenSource(lexer));
+        const parser = new LPCParser(tokenStream);
+        if (typeof parser.removeErrorListeners === 'function') {
+            parser.removeErrorListeners();
+        }
+        if (typeof parser.addErrorListener === 'function') {
+            parser.addErrorListener(errorListener);
+        }
+
+        const tree = parser.sourceFile();
+
+        const parseTimeMs = performance.now() - startTime;
+        this.parseCount++;
+        this.totalParseTime += parseTimeMs;
+        this.recordParse(document.uri.toString(), parseTimeMs);
+
+        const allTokens = this.readTokens(tokenStream);
+        const parsed: ParsedDocument = withLazyTokenViews({
+            uri: document.uri.toString(),
+            version: document.version,
+            text,
+            parseText,
+            frontend,
+            tokenStream,
+            tokens: tokenStream,
+            allTokens,
+            tokenTable: TokenTable.fromTokens(allTokens, parseText),
+            tokenTriviaIndex: {} as TokenTriviaIndex,
+            tree,
+            diagnostics: [
+                ...this.safeDiagnostics(errorListener),
+                ...this.toVsCodePreprocessorDiagnostics(frontend.preprocessor.diagnostics)
+            ],
+            ...(options.declarationOnly ? { declarationOnly: true } : {}),
+            createdAt: startedAt,
+            lastAccessed: startedAt,
+            parseTimeMs,
+            parseTime: parseTimeMs,
+            size: text.length,
+            layoutTriviaSource: 'lexer-hidden-channel'
+        });
+        parsed.tokenTriviaIndex = new TokenTriviaIndex(parsed);
+
+        if (options.cacheResult) {
+            this.documentCache.set(document, parsed, estimateParsedDocumentBytes(parsed));
+            this.contentDocuments.set(parsed.uri, text, parsed);
+            this.memoryBudget?.notifyGrowth();
+        }
+        return parsed;
     }
 
     private createFallbackParsedDocument(
         document: vscode.TextDocument,
-        text: string,
-        parseText: string,
-        frontend: ReturnType<LpcFrontendService['get']>,
-        startedAt: number,
-        startTime: number,
-        error: unknown,
-        errorListener: CollectingErrorListener
+        input: ParseInput,
+        error: unknown
     ): ParsedDocument {
-        const input = CharStreams.fromString(parseText);
-        const lexer = new LPCLexer(input);
+        const { startedAt, startTime, text, parseText, frontend, errorListener } = input;
+        const charStream = CharStreams.fromString(parseText);
+        const lexer = new LPCLexer(charStream);
         const tokenStream = new CommonTokenStream(lexer);
         const tree = this.createEmptyParseTree();
 
@@ -191,9 +342,7 @@ export class ParsedDocumentService {
         }
 
         const allTokens = this.readTokensIfAvailable(tokenStream);
-        const visibleTokens = allTokens.filter((token) => token.channel === LPCLexer.DEFAULT_TOKEN_CHANNEL);
-        const hiddenTokens = allTokens.filter((token) => token.channel !== LPCLexer.DEFAULT_TOKEN_CHANNEL);
-        const parsed: ParsedDocument = {
+        const parsed: ParsedDocument = withLazyTokenViews({
             uri: document.uri.toString(),
             version: document.version,
             text,
@@ -202,8 +351,7 @@ export class ParsedDocumentService {
             tokenStream,
             tokens: tokenStream,
             allTokens,
-            visibleTokens,
-            hiddenTokens,
+            tokenTable: TokenTable.fromTokens(allTokens, parseText),
             tokenTriviaIndex: {} as TokenTriviaIndex,
             tree,
             diagnostics,
@@ -215,10 +363,11 @@ export class ParsedDocumentService {
             parseTime: parseTimeMs,
             size: text.length,
             layoutTriviaSource: 'lexer-hidden-channel'
-        };
+        });
         parsed.tokenTriviaIndex = new TokenTriviaIndex(parsed);
 
-        this.documentCache.set(document, parsed, text.length * 2);
+        this.documentCache.set(document, parsed, estimateParsedDocumentBytes(parsed));
+        this.memoryBudget?.notifyGrowth();
         return parsed;
     }
 
@@ -269,6 +418,7 @@ let globalParsedDocumentService: ParsedDocumentService | undefined;
 export function getGlobalParsedDocumentService(): ParsedDocumentService {
     if (!globalParsedDocumentService) {
         globalParsedDocumentService = new ParsedDocumentService({});
+        globalParsedDocumentService.attachMemoryBudget(getGlobalMemoryBudgetGovernor());
     }
 
     return globalParsedDocumentService;
@@ -286,3 +436,56 @@ export function disposeGlobalParsedDocumentService(): void {
     globalParsedDocumentService.dispose();
     globalParsedDocumentService = undefined;
 }
+
+/**
+ * 可见/隐藏 token 数组只在有调用方按对象访问时才从 token 表的下标视图生成，并缓存在文档上。
+ */
+function withLazyTokenViews(
+    fields: Omit<ParsedDocument, 'visibleTokens' | 'hiddenTokens'>
+): ParsedDocument {
+    const { allTokens, tokenTable } = fields;
+    let visibleTokens: Token[] | undefined;
+    let hiddenTokens: Token[] | undefined;
+
+    return Object.defineProperties(fields, {
+        visibleTokens: {
+            enumerable: true,
+            get: () => visibleTokens ??= selectTokens(allTokens, tokenTable!.visibleIndexes)
+        },
+        hiddenTokens: {
+            enumerable: true,
+            get: () => hiddenTokens ??= selectTokens(allTokens, tokenTable!.hiddenIndexes)
+        }
+    }) as ParsedDocument;
+}
+
+/**
+ * 复制解析结果（保留惰性 token 视图的 getter），换上新版本号与对应的预处理快照
+ */
+function rebindParsedDocument(
+    parsed: ParsedDocument,
+    version: number,
+    frontend: ParsedDocument['frontend']
+): ParsedDocument {
+    const now = Date.now();
+    const rebound = Object.defineProperties({}, Object.getOwnPropertyDescriptors(parsed)) as ParsedDocument;
+    rebound.version = version;
+    rebound.frontend = frontend;
+    rebound.lastAccessed = now;
+    return rebound;
+}
+
+function selectTokens(allTokens: readonly Token[], indexes: Int32Array): Token[] {
+    const tokens = new Array<Token>(indexes.length);
+    for (let index = 0; index < indexes.length; index++) {
+        tokens[index] = allTokens[indexes[index]];
+    }
+    return tokens;
+}
+
+function estimateParsedDocumentBytes(parsed: ParsedDocument): number {
+    // 原文与预处理后文本按 UTF-16 计，其余按 token 数折算。
+    return (parsed.text.length + parsed.parseText.length) * 2
+        + parsed.allTokens.length * PARSED_TOKEN_BYTES
+        + (parsed.tokenTable?.byteLength ?? 0);
+}
@@ -0,0 +1,150 @@
+import { Token } from 'antlr4ts';
+import { LPCLexer } from '../antlr/LPCLexer';
+import { LpcTokenLike } from './LpcTokenFacts';
+
+/**
+ * 按列存储的 token 表：类型、起止偏移、行列与通道各占一个定长类型数组，
+ * 文本按需从预处理后的源码切片。可见/隐藏 token 以下标数组表示，不再复制 token 对象。
+ *
+ * 表中的下标即 token 在流中的 `tokenIndex`（`BufferedTokenStream` 按读取顺序编号）。
+ */
+export class TokenTable {
+    public readonly length: number;
+    public readonly types: Int32Array;
+    public readonly startOffsets: Int32Array;
+    public readonly stopOffsets: Int32Array;
+    /** 从 1 开始的行号，与 antlr 一致 */
+    public readonly lines: Int32Array;
+    public readonly columns: Int32Array;
+    public readonly channels: Uint16Array;
+    public readonly visibleIndexes: Int32Array;
+    public readonly hiddenIndexes: Int32Array;
+
+    private constructor(
+        tokens: readonly LpcTokenLike[],
+        private readonly source: string | undefined,
+        private readonly texts: ReadonlyArray<string | undefined> | undefined
+    ) {
+        const length = tokens.length;
+        this.length = length;
+        this.types = new Int32Array(length);
+        this.startOffsets = new Int32Array(length);
+        this.stopOffsets = new Int32Array(length);
+        this.lines = new Int32Array(length);
+        this.columns = new Int32Array(length);
+        this.channels = new Uint16Array(length);
+
+        let visibleCount = 0;
+        for (let index = 0; index < length; index++) {
+            const token = tokens[index];
+            this.types[index] = token.type;
+            this.startOffsets[index] = token.startIndex;
+            this.stopOffsets[index] = token.stopIndex;
+            this.lines[index] = token.line;
+            this.columns[index] = token.charPositionInLine;
+            this.channels[index] = token.channel;
+            if (token.channel === LPCLexer.DEFAULT_TOKEN_CHANNEL) {
+                visibleCount++;
+            }
+        }
+
+        this.visibleIndexes = new Int32Array(visibleCount);
+        this.hiddenIndexes = new Int32Array(length - visibleCount);
+        let visibleCursor = 0;
+        let hiddenCursor = 0;
+        for (let index = 0; index < length; index++) {
+            if (this.channels[index] === LPCLexer.DEFAULT_TOKEN_CHANNEL) {
+                this.visibleIndexes[visibleCursor++] = index;
+            } else {
+                this.hiddenIndexes[hiddenCursor++] = index;
+            }
+        }
+    }
+
+    /**
+     * 由 token 流建表。给出 `source`（词法分析的输入文本）时 token 文本按偏移切片，
+     * 否则保留各 token 自带的文本。
+     */
+    public static fromTokens(tokens: readonly LpcTokenLike[], source?: string): TokenTable {
+        return new TokenTable(
+            tokens,
+            source,
+            source === undefined ? tokens.map((token) => token.text ?? undefined) : undefined
+        );
+    }
+
+    public text(index: number): string {
+        if (this.texts) {
+            return this.texts[index] ?? '';
+        }
+
+        const start = this.startOffsets[index];
+        const stop = this.stopOffsets[index];
+        if (this.types[index] === Token.EOF || stop < start) {
+            return '';
+        }
+
+        return this.source!.slice(start, stop + 1);
+    }
+
+    public isVisible(index: number): boolean {
+        return this.channels[index] === LPCLexer.DEFAULT_TOKEN_CHANNEL;
+    }
+
+    /**
+     * 轻量 token 视图：只在需要把单个 token 交给按对象访问的 API 时创建。
+     */
+    public view(index: number): LpcTokenLike & { text: string } {
+        return {
+            type: this.types[index],
+            text: this.text(index),
+            line: this.lines[index],
+            tokenIndex: index,
+            startIndex: this.startOffsets[index],
+            stopIndex: this.stopOffsets[index],
+            channel: this.channels[index],
+            charPositionInLine: this.columns[index]
+        };
+    }
+
+    /**
+     * 从 `index` 起沿 `direction` 方向找到的第一个可见 token 下标，找不到时返回 -1
+     */
+    public findAdjacentVisible(index: number, direction: -1 | 1): number {
+        for (let current = index + direction; current >= 0 && current < this.length; current += direction) {
+            if (this.channels[current] === LPCLexer.DEFAULT_TOKEN_CHANNEL) {
+                return current;
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * 起始偏移不大于 `offset` 的最后一个可见 token 下标（二分查找），不存在时返回 -1
+     */
+    public findVisibleAtOrBefore(offset: number): number {
+        let low = 0;
+        let high = this.visibleIndexes.length - 1;
+        let result = -1;
+        while (low <= high) {
+            const mid = (low + high) >>> 1;
+            const tokenIndex = this.visibleIndexes[mid];
+            if (this.startOffsets[tokenIndex] <= offset) {
+                result = tokenIndex;
+                low = mid + 1;
+            } else {
+                high = mid - 1;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * 估算占用字节数：六个定长列 + 两个下标视图
+     */
+    public get byteLength(): number {
+        return this.length * (4 * 5 + 2) + (this.visibleIndexes.length + this.hiddenIndexes.length) * 4;
+    }
+}
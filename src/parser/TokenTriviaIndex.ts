@@ -1,27 +1,32 @@
-import { Token } from 'antlr4ts';
 import * as vscode from 'vscode';
 import { LPCLexer } from '../antlr/LPCLexer';
+import { TokenTable } from './TokenTable';
 import { ParsedDocument, TokenTriviaAccessor, Trivia, TriviaKind } from './types';
 
+/**
+ * 隐藏通道 token 的 trivia 索引。首次查询时才构建；trivia 按 tokenIndex 有序存放，
+ * 区间查询用二分定位起点，复杂度 O(log n + k)。
+ */
 export class TokenTriviaIndex implements TokenTriviaAccessor {
-    private readonly allTrivia: Trivia[];
+    private built = false;
+    private allTrivia: Trivia[] = [];
+    /** 与 `allTrivia` 平行的 tokenIndex 列，供二分查找 */
+    private triviaTokenIndexes = new Int32Array(0);
     private readonly triviaByHiddenTokenIndex = new Map<number, Trivia[]>();
-    private readonly hiddenTokenIndexes = new Set<number>();
-    private readonly visibleTokenIndexes: number[];
-    private readonly lineStartOffsets: number[];
+    private visibleTokenIndexes = new Int32Array(0);
+    private lineStartOffsets: number[] = [];
+    private table!: TokenTable;
 
-    constructor(private readonly parsed: ParsedDocument) {
-        this.lineStartOffsets = buildLineStartOffsets(parsed.parseText);
-        this.visibleTokenIndexes = parsed.visibleTokens.map((token) => token.tokenIndex).filter(isDefined);
-        this.allTrivia = this.buildTriviaEntries(parsed.hiddenTokens);
-    }
+    constructor(private readonly parsed: ParsedDocument) {}
 
     public getLeadingTrivia(tokenIndex: number): Trivia[] {
+        this.ensureBuilt();
         const previousVisibleTokenIndex = this.findPreviousVisibleTokenIndex(tokenIndex);
         return this.getInterveningTrivia(previousVisibleTokenIndex, tokenIndex);
     }
 
     public getTrailingTrivia(tokenIndex: number): Trivia[] {
+        this.ensureBuilt();
         const nextVisibleTokenIndex = this.findNextVisibleTokenIndex(tokenIndex);
         return this.getInterveningTrivia(tokenIndex, nextVisibleTokenIndex);
     }
@@ -31,52 +36,67 @@ export class TokenTriviaIndex implements TokenTriviaAccessor {
             return [];
         }
 
+        this.ensureBuilt();
         const trivia: Trivia[] = [];
-        for (const entry of this.allTrivia) {
-            if (entry.tokenIndex > startTokenIndex && entry.tokenIndex < endTokenIndex) {
-                trivia.push(entry);
-            }
+        for (
+            let index = upperBound(this.triviaTokenIndexes, startTokenIndex);
+            index < this.allTrivia.length && this.triviaTokenIndexes[index] < endTokenIndex;
+            index++
+        ) {
+            trivia.push(this.allTrivia[index]);
         }
 
         return trivia;
     }
 
     public getTriviaForHiddenToken(tokenIndex: number): Trivia[] {
+        this.ensureBuilt();
         return [...(this.triviaByHiddenTokenIndex.get(tokenIndex) || [])];
     }
 
     public getAllTrivia(): Trivia[] {
+        this.ensureBuilt();
         return [...this.allTrivia];
     }
 
-    private buildTriviaEntries(hiddenTokens: Token[]): Trivia[] {
-        const entries: Trivia[] = [];
+    private ensureBuilt(): void {
+        if (this.built) {
+            return;
+        }
 
-        for (const token of hiddenTokens) {
-            if (!isDefined(token.tokenIndex)) {
-                continue;
-            }
+        this.built = true;
+        this.table = this.parsed.tokenTable ?? TokenTable.fromTokens(this.parsed.allTokens, this.parsed.parseText);
+        this.lineStartOffsets = buildLineStartOffsets(this.parsed.parseText);
+        this.visibleTokenIndexes = this.table.visibleIndexes;
+        this.allTrivia = this.buildTriviaEntries(this.table.hiddenIndexes);
+        this.triviaTokenIndexes = Int32Array.from(this.allTrivia, (entry) => entry.tokenIndex);
+    }
 
-            this.hiddenTokenIndexes.add(token.tokenIndex);
-            const tokenEntries = this.createTriviaEntriesForToken(token);
-            this.triviaByHiddenTokenIndex.set(token.tokenIndex, tokenEntries);
+    private buildTriviaEntries(hiddenIndexes: Int32Array): Trivia[] {
+        // 隐藏 token 下标递增，生成的 trivia 天然按 tokenIndex 有序。
+        const entries: Trivia[] = [];
+
+        for (const tokenIndex of hiddenIndexes) {
+            const tokenEntries = this.createTriviaEntriesForToken(tokenIndex);
+            this.triviaByHiddenTokenIndex.set(tokenIndex, tokenEntries);
             entries.push(...tokenEntries);
         }
 
         return entries;
     }
 
-    private createTriviaEntriesForToken(token: Token): Trivia[] {
-        const text = token.text ?? '';
+    private createTriviaEntriesForToken(tokenIndex: number): Trivia[] {
+        const text = this.table.text(tokenIndex);
         if (!text) {
             return [];
         }
 
-        if (token.type === LPCLexer.WS) {
-            return this.splitWhitespaceToken(token, text);
+        const tokenType = this.table.types[tokenIndex];
+        if (tokenType === LPCLexer.WS) {
+            return this.splitWhitespaceToken(tokenIndex, text);
         }
 
-        const kind = this.getTriviaKindForToken(token.type);
+        const kind = this.getTriviaKindForToken(tokenType);
         if (!kind) {
             return [];
         }
@@ -85,14 +105,14 @@ export class TokenTriviaIndex implements TokenTriviaAccessor {
             this.createTrivia(
                 kind,
                 text,
-                token.tokenIndex,
-                token.startIndex,
-                token.stopIndex + 1
+                tokenIndex,
+                this.table.startOffsets[tokenIndex],
+                this.table.stopOffsets[tokenIndex] + 1
             )
         ];
     }
 
-    private splitWhitespaceToken(token: Token, text: string): Trivia[] {
+    private splitWhitespaceToken(tokenIndex: number, text: string): Trivia[] {
         const entries: Trivia[] = [];
         let segmentStart = 0;
         let index = 0;
@@ -101,7 +121,7 @@ export class TokenTriviaIndex implements TokenTriviaAccessor {
             const char = text[index];
             if (char === '\r' || char === '\n') {
                 if (segmentStart < index) {
-                    entries.push(this.createTriviaFromSegment(token, text, 'whitespace', segmentStart, index));
+                    entries.push(this.createTriviaFromSegment(tokenIndex, text, 'whitespace', segmentStart, index));
                 }
 
                 const newlineStart = index;
@@ -110,7 +130,7 @@ export class TokenTriviaIndex implements TokenTriviaAccessor {
                     index++;
                 }
 
-                entries.push(this.createTriviaFromSegment(token, text, 'newline', newlineStart, index));
+                entries.push(this.createTriviaFromSegment(tokenIndex, text, 'newline', newlineStart, index));
                 segmentStart = index;
                 continue;
             }
@@ -119,25 +139,26 @@ export class TokenTriviaIndex implements TokenTriviaAccessor {
         }
 
         if (segmentStart < text.length) {
-            entries.push(this.createTriviaFromSegment(token, text, 'whitespace', segmentStart, text.length));
+            entries.push(this.createTriviaFromSegment(tokenIndex, text, 'whitespace', segmentStart, text.length));
         }
 
         return entries;
     }
 
     private createTriviaFromSegment(
-        token: Token,
+        tokenIndex: number,
         tokenText: string,
         kind: TriviaKind,
         segmentStart: number,
         segmentEnd: number
     ): Trivia {
+        const tokenStart = this.table.startOffsets[tokenIndex];
         return this.createTrivia(
             kind,
             tokenText.slice(segmentStart, segmentEnd),
-            token.tokenIndex,
-            token.startIndex + segmentStart,
-            token.startIndex + segmentEnd
+            tokenIndex,
+            tokenStart + segmentStart,
+            tokenStart + segmentEnd
         );
     }
 
@@ -175,26 +196,46 @@ export class TokenTriviaIndex implements TokenTriviaAccessor {
     }
 
     private findPreviousVisibleTokenIndex(tokenIndex: number): number {
-        let previous = -1;
-        for (const visibleIndex of this.visibleTokenIndexes) {
-            if (visibleIndex >= tokenIndex) {
-                break;
-            }
-            previous = visibleIndex;
-        }
-
-        return previous;
+        const position = lowerBound(this.visibleTokenIndexes, tokenIndex) - 1;
+        return position >= 0 ? this.visibleTokenIndexes[position] : -1;
     }
 
     private findNextVisibleTokenIndex(tokenIndex: number): number {
-        for (const visibleIndex of this.visibleTokenIndexes) {
-            if (visibleIndex > tokenIndex) {
-                return visibleIndex;
-            }
+        const position = upperBound(this.visibleTokenIndexes, tokenIndex);
+        return position < this.visibleTokenIndexes.length
+            ? this.visibleTokenIndexes[position]
+            : Number.MAX_SAFE_INTEGER;
+    }
+}
+
+/** 第一个不小于 `value` 的位置 */
+function lowerBound(values: Int32Array, value: number): number {
+    let low = 0;
+    let high = values.length;
+    while (low < high) {
+        const mid = (low + high) >>> 1;
+        if (values[mid] < value) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
+    }
+    return low;
+}
 
-        return Number.MAX_SAFE_INTEGER;
+/** 第一个大于 `value` 的位置 */
+function upperBound(values: Int32Array, value: number): number {
+    let low = 0;
+    let high = values.length;
+    while (low < high) {
+        const mid = (low + high) >>> 1;
+        if (values[mid] <= value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
     }
+    return low;
 }
 
 function buildLineStartOffsets(text: string): number[] {
@@ -226,7 +267,3 @@ function positionAt(lineStartOffsets: number[], offset: number): vscode.Position
     const line = Math.max(0, high);
     return new vscode.Position(line, normalizedOffset - lineStartOffsets[line]);
 }
-
-function isDefined(value: number | undefined): value is number {
-    return value !== undefined && value !== null;
-}
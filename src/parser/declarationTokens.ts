@@ -0,0 +1,62 @@
+import { Token } from 'antlr4ts';
+import { LPCLexer } from '../antlr/LPCLexer';
+
+/**
+ * 索引模式只关心声明层结构：保留函数体的 `{` / `}`，丢弃其中全部 token（包括隐藏通道），
+ * parser 会把每个函数体当作空 block。token 自身的行列与偏移不变，range 仍然对应原文。
+ */
+export function selectDeclarationTokens(tokens: readonly Token[]): Token[] {
+    const result: Token[] = [];
+    let parenDepth = 0;
+    let braceDepth = 0;
+    let skippedBodyDepth = 0;
+    let previousVisibleType: number | undefined;
+
+    for (const token of tokens) {
+        if (skippedBodyDepth > 0) {
+            if (token.type === LPCLexer.LBRACE) {
+                skippedBodyDepth += 1;
+            } else if (token.type === LPCLexer.RBRACE) {
+                skippedBodyDepth -= 1;
+                if (skippedBodyDepth === 0) {
+                    result.push(token);
+                    previousVisibleType = token.type;
+                }
+            } else if (token.type === Token.EOF) {
+                result.push(token);
+            }
+            continue;
+        }
+
+        result.push(token);
+        if (token.channel !== LPCLexer.DEFAULT_TOKEN_CHANNEL) {
+            continue;
+        }
+
+        switch (token.type) {
+            case LPCLexer.LPAREN:
+                parenDepth += 1;
+                break;
+            case LPCLexer.RPAREN:
+                parenDepth = Math.max(0, parenDepth - 1);
+                break;
+            case LPCLexer.LBRACE:
+                // `) {` at file level is a function body; `({`, class/struct bodies and the like stay intact.
+                if (parenDepth === 0 && braceDepth === 0 && previousVisibleType === LPCLexer.RPAREN) {
+                    skippedBodyDepth = 1;
+                } else {
+                    braceDepth += 1;
+                }
+                break;
+            case LPCLexer.RBRACE:
+                braceDepth = Math.max(0, braceDepth - 1);
+                break;
+            default:
+                break;
+        }
+
+        previousVisibleType = token.type;
+    }
+
+    return result;
+}
@@ -2,6 +2,7 @@ import { CommonTokenStream, Token } from 'antlr4ts';
 import * as vscode from 'vscode';
 import { LPCParser } from '../antlr/LPCParser';
 import { LpcFrontendSnapshot } from '../frontend/types';
+import type { TokenTable } from './TokenTable';
 
 export type LayoutTriviaSource = 'lexer-hidden-channel';
 export type TriviaKind = 'whitespace' | 'newline' | 'line-comment' | 'block-comment' | 'directive';
@@ -32,6 +33,8 @@ export interface ParsedDocument {
     tokenStream: CommonTokenStream;
     tokens: CommonTokenStream;
     allTokens: Token[];
+    /** 按列存储的 token 表；`visibleTokens` / `hiddenTokens` 由它的下标视图按需生成 */
+    tokenTable?: TokenTable;
     visibleTokens: Token[];
     hiddenTokens: Token[];
     tokenTriviaIndex: TokenTriviaAccessor;
@@ -39,6 +42,7 @@ export interface ParsedDocument {
     diagnostics: vscode.Diagnostic[];
     degraded?: boolean;
     failureReason?: string;
+    declarationOnly?: boolean;
     createdAt: number;
     lastAccessed: number;
     parseTimeMs: number;
@@ -31,6 +31,7 @@ export interface DocumentAnalysisService {
     getSnapshot(document: vscode.TextDocument, mode?: boolean | SnapshotAccessMode): DocumentSemanticSnapshot;
     getBestAvailableSnapshot(document: vscode.TextDocument): DocumentSemanticSnapshot;
     getBestAvailableSemanticSnapshot(document: vscode.TextDocument): SemanticSnapshot;
+    getDeclarationSnapshot?(document: vscode.TextDocument): SemanticSnapshot;
     scheduleRefresh(document: vscode.TextDocument, onReady?: (snapshot: DocumentSemanticSnapshot) => void): void;
     hasSnapshot(document: vscode.TextDocument): boolean;
     hasFreshSnapshot(document: vscode.TextDocument): boolean;
@@ -1,5 +1,7 @@
 import * as vscode from 'vscode';
 import { SymbolTable } from '../ast/symbolTable';
+import { ContentAddressedCache } from '../core/ContentAddressedCache';
+import { getGlobalMemoryBudgetGovernor, MemoryBudgetRegistration } from '../core/MemoryBudgetGovernor';
 import { getGlobalParsedDocumentService } from '../parser/ParsedDocumentService';
 import { ParsedDocument as ParsedDoc } from '../parser/types';
 import { SyntaxBuilder } from '../syntax/SyntaxBuilder';
@@ -14,9 +16,29 @@ import { DocumentSemanticSnapshot, SnapshotStats } from './documentSemanticTypes
 import { SemanticModelBuilder } from './SemanticModelBuilder';
 import { SemanticSnapshot, toDocumentSemanticSnapshot } from './semanticSnapshot';
 
+/** 语法树、语义模型与符号表按可见 token 数折算的估算字节数 */
+const SEMANTIC_TOKEN_BYTES = 96;
+const SEMANTIC_FALLBACK_BYTES = 4096;
+/** 语义分析建立在解析结果之上，是重建代价最高的一层 */
+const SEMANTIC_REBUILD_COST = 8;
+
+interface AnalysisAccounting {
+    readonly bytes: number;
+    lastAccessed: number;
+}
+
 export class DocumentSemanticSnapshotService implements DocumentAnalysisService {
     private static instance: DocumentSemanticSnapshotService;
     private readonly analyses = new Map<string, DocumentSemanticAnalysis>();
+    /** 与 `analyses` 同键；Map 顺序即最近使用顺序 */
+    private readonly accounting = new Map<string, AnalysisAccounting>();
+    private analysisBytes = 0;
+    /** 跨版本复用：文本与解析结果都未变化时沿用旧分析 */
+    private readonly contentAnalyses = new ContentAddressedCache<DocumentSemanticAnalysis>(
+        undefined,
+        (analysis) => estimateAnalysisBytes(analysis)
+    );
+    private memoryBudget?: MemoryBudgetRegistration;
     private readonly refreshTimers = new Map<string, NodeJS.Timeout>();
     private readonly pendingRefreshVersions = new Map<string, number>();
     private readonly refreshCallbacks = new Map<string, Array<(snapshot: DocumentSemanticSnapshot) => void>>();
@@ -37,6 +59,7 @@ export class DocumentSemanticSnapshotService implements DocumentAnalysisService
     public static getInstance(): DocumentSemanticSnapshotService {
         if (!DocumentSemanticSnapshotService.instance) {
             DocumentSemanticSnapshotService.instance = new DocumentSemanticSnapshotService();
+            DocumentSemanticSnapshotService.instance.attachMemoryBudget();
         }
 
         return DocumentSemanticSnapshotService.instance;
@@ -59,20 +82,31 @@ export class DocumentSemanticSnapshotService implements DocumentAnalysisService
             return cached;
         }
 
-        if (this.shouldInvalidateParsedDocument(mode) || this.hasSameVersionWithDifferentText(cached, document)) {
-            getGlobalParsedDocumentService().invalidate(document.uri);
+        const forceRefresh = this.shouldInvalidateParsedDocument(mode);
+        if (forceRefresh || this.hasSameVersionWithDifferentText(cached, document)) {
+            getGlobalParsedDocumentService().invalidate(document.uri, forceRefresh);
+        }
+
+        if (forceRefresh) {
+            this.contentAnalyses.deleteUri(document.uri.toString());
+            return this.buildAndStoreAnalysis(document);
         }
 
-        return this.buildAndStoreAnalysis(document);
+        return this.reuseUnchangedContent(document) ?? this.buildAndStoreAnalysis(document);
     }
 
     public getBestAvailableAnalysis(document: vscode.TextDocument): DocumentSemanticAnalysis {
         const cached = this.getCachedAnalysis(document);
         if (!cached) {
-            return this.buildAndStoreAnalysis(document);
+            return this.reuseUnchangedContent(document) ?? this.buildAndStoreAnalysis(document);
         }
 
         if (!this.isAnalysisFresh(cached, document)) {
+            const reused = this.reuseUnchangedContent(document);
+            if (reused) {
+                return reused;
+            }
+
             this.scheduleRefresh(document);
         }
 
@@ -133,6 +167,31 @@ export class DocumentSemanticSnapshotService implements DocumentAnalysisService
         return this.getSemanticSnapshot(document, false);
     }
 
+    /**
+     * 工作区索引使用的声明层快照：函数体被跳过，局部作用域为空。
+     * 已有新鲜的完整分析时直接复用；结果不写入分析缓存，避免交给需要函数体的特性。
+     */
+    public getDeclarationSnapshot(document: vscode.TextDocument): SemanticSnapshot {
+        const cached = this.getCachedAnalysis(document);
+        if (cached?.semantic && this.isAnalysisFresh(cached, document)) {
+            return cached.semantic;
+        }
+
+        const parsed = getGlobalParsedDocumentService().parseDeclarations(document);
+        if (!parsed.declarationOnly || parsed.degraded) {
+            return this.getSemanticSnapshot(document);
+        }
+
+        const startedAt = performance.now();
+        const syntax = new SyntaxBuilder(parsed).build();
+        const semantic = new SemanticModelBuilder().build(syntax);
+        const elapsedMs = performance.now() - startedAt;
+        this.buildCount += 1;
+        this.totalBuildTimeMs += elapsedMs;
+        this.recordBuild(document.uri.toString(), elapsedMs);
+        return semantic;
+    }
+
     public hasSnapshot(document: vscode.TextDocument): boolean {
         return this.analyses.has(this.getDocumentUri(document));
     }
@@ -179,7 +238,7 @@ export class DocumentSemanticSnapshotService implements DocumentAnalysisService
             }
 
             try {
-                const analysis = this.buildAndStoreAnalysis(document);
+                const analysis = this.reuseUnchangedContent(document) ?? this.buildAndStoreAnalysis(document);
                 this.flushRefreshCallbacks(uri, analysis.snapshot);
             } catch (error) {
                 console.error('Failed to refresh document semantic snapshot:', error);
@@ -195,7 +254,7 @@ export class DocumentSemanticSnapshotService implements DocumentAnalysisService
         this.clearScheduledRefresh(key);
         this.pendingRefreshVersions.delete(key);
         this.refreshCallbacks.delete(key);
-        this.analyses.delete(key);
+        this.deleteAnalysis(key);
         this.trackedUris.delete(key);
     }
 
@@ -208,6 +267,9 @@ export class DocumentSemanticSnapshotService implements DocumentAnalysisService
         this.pendingRefreshVersions.clear();
         this.refreshCallbacks.clear();
         this.analyses.clear();
+        this.accounting.clear();
+        this.contentAnalyses.clear();
+        this.analysisBytes = 0;
         this.trackedUris.clear();
         this.lastUpdatedAt = undefined;
         this.buildCount = 0;
@@ -243,7 +305,57 @@ export class DocumentSemanticSnapshotService implements DocumentAnalysisService
     }
 
     private getCachedAnalysis(document: vscode.TextDocument): DocumentSemanticAnalysis | undefined {
-        return this.analyses.get(this.getDocumentUri(document));
+        const uri = this.getDocumentUri(document);
+        const accounting = this.accounting.get(uri);
+        if (accounting) {
+            accounting.lastAccessed = Date.now();
+            this.accounting.delete(uri);
+            this.accounting.set(uri, accounting);
+        }
+
+        return this.analyses.get(uri);
+    }
+
+    /**
+     * 向统一内存预算登记语义分析缓存
+     */
+    private attachMemoryBudget(): void {
+        this.contentAnalyses.attachMemoryBudget(getGlobalMemoryBudgetGovernor(), 'semanticAnalysisContent', (uri, analysis) => {
+            const held = this.analyses.get(uri);
+            return held === analysis || (held?.syntax !== undefined && held.syntax.root === analysis.syntax?.root);
+        });
+        this.memoryBudget = getGlobalMemoryBudgetGovernor().register({
+            name: 'semanticAnalyses',
+            rebuildCost: SEMANTIC_REBUILD_COST,
+            getUsage: () => ({ entries: this.analyses.size, bytes: this.analysisBytes }),
+            peekColdest: () => {
+                const coldest = this.accounting.entries().next();
+                if (coldest.done) {
+                    return undefined;
+                }
+
+                const [uri, accounting] = coldest.value;
+                return { key: uri, bytes: accounting.bytes, lastAccessed: accounting.lastAccessed, documentUri: uri };
+            },
+            evict: (uri) => this.evictAnalysis(uri),
+            evictDocument: (uri) => this.evictAnalysis(uri)
+        });
+    }
+
+    private evictAnalysis(uri: string): number {
+        const bytes = this.accounting.get(uri)?.bytes ?? 0;
+        this.clearCache(uri);
+        this.contentAnalyses.deleteUri(uri);
+        return bytes;
+    }
+
+    private deleteAnalysis(uri: string): void {
+        const accounting = this.accounting.get(uri);
+        if (accounting) {
+            this.analysisBytes -= accounting.bytes;
+            this.accounting.delete(uri);
+        }
+        this.analyses.delete(uri);
     }
 
     private isAnalysisFresh(analysis: DocumentSemanticAnalysis, document: vscode.TextDocument): boolean {
@@ -285,9 +397,31 @@ export class DocumentSemanticSnapshotService implements DocumentAnalysisService
         this.buildCount += 1;
         this.totalBuildTimeMs += elapsedMs;
         this.recordBuild(document.uri.toString(), elapsedMs);
+        if (analysis.parsed && !analysis.snapshot.degraded) {
+            this.contentAnalyses.set(analysis.snapshot.uri, analysis.parsed.text, analysis);
+        }
         return analysis;
     }
 
+    /**
+     * 文本未变的新版本（撤销往返、无改动保存、重新打开）：解析层沿用了同一棵语法树时，
+     * 语义分析也直接沿用，只更新版本号。
+     */
+    private reuseUnchangedContent(document: vscode.TextDocument): DocumentSemanticAnalysis | undefined {
+        const uri = document.uri.toString();
+        const candidate = this.contentAnalyses.get(uri, document.getText());
+        if (!candidate?.parsed) {
+            return undefined;
+        }
+
+        const parsed = getGlobalParsedDocumentService().get(document);
+        if (parsed.tree !== candidate.parsed.tree) {
+            return undefined;
+        }
+
+        return this.storeAnalysis(document, rebindAnalysis(candidate, document.version, parsed));
+    }
+
     private recordBuild(uri: string, elapsedMs: number): void {
         const stats = this.buildStatsByUri.get(uri) ?? { count: 0, totalTimeMs: 0 };
         stats.count += 1;
@@ -300,24 +434,27 @@ export class DocumentSemanticSnapshotService implements DocumentAnalysisService
         analysis: DocumentSemanticAnalysis
     ): DocumentSemanticAnalysis {
         const uri = document.uri.toString();
+        this.deleteAnalysis(uri);
+        const bytes = estimateAnalysisBytes(analysis);
         this.analyses.set(uri, analysis);
+        this.accounting.set(uri, { bytes, lastAccessed: Date.now() });
+        this.analysisBytes += bytes;
         this.trackedUris.add(uri);
         this.lastUpdatedAt = analysis.snapshot.createdAt;
         this.pruneCache();
+        this.memoryBudget?.notifyGrowth();
         return analysis;
     }
 
     private pruneCache(): void {
-        if (this.analyses.size <= this.maxEntries) {
-            return;
-        }
-
-        const entries = Array.from(this.analyses.entries())
-            .sort((left, right) => left[1].snapshot.createdAt - right[1].snapshot.createdAt);
+        // accounting 的首个键即最久未访问的分析结果。
+        while (this.analyses.size > this.maxEntries) {
+            const coldest = this.accounting.keys().next();
+            if (coldest.done) {
+                return;
+            }
 
-        while (this.analyses.size > this.maxEntries && entries.length > 0) {
-            const [uri] = entries.shift()!;
-            this.clearCache(vscode.Uri.parse(uri));
+            this.clearCache(coldest.value);
         }
     }
 
@@ -440,3 +577,25 @@ export class DocumentSemanticSnapshotService implements DocumentAnalysisService
         };
     }
 }
+
+function rebindAnalysis(
+    analysis: DocumentSemanticAnalysis,
+    version: number,
+    parsed: ParsedDoc
+): DocumentSemanticAnalysis {
+    const syntax = analysis.syntax && { ...analysis.syntax, version, parsed };
+    const semantic = analysis.semantic && syntax && { ...analysis.semantic, version, syntax };
+
+    return {
+        ...analysis,
+        parsed,
+        syntax,
+        semantic,
+        snapshot: Object.freeze({ ...analysis.snapshot, version })
+    };
+}
+
+function estimateAnalysisBytes(analysis: DocumentSemanticAnalysis): number {
+    const tokenCount = analysis.parsed?.tokenTable?.visibleIndexes.length ?? analysis.parsed?.visibleTokens?.length;
+    return tokenCount !== undefined ? tokenCount * SEMANTIC_TOKEN_BYTES : SEMANTIC_FALLBACK_BYTES;
+}
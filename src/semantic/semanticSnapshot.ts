@@ -34,23 +34,48 @@ export interface SemanticSnapshot {
     createdAt: number;
 }
 
+const EMPTY_FILE_GLOBALS: readonly FileGlobalSummary[] = Object.freeze([]);
+
+/**
+ * 语义摘要构建完成后不再修改：递归冻结普通对象、数组与其中的 Range/Position，
+ * 之后快照与索引记录按引用交给调用方，查询路径上不再做与文件大小成正比的拷贝。
+ */
+export function freezeSemanticData<T>(value: T): T {
+    if (value === null || typeof value !== 'object' || Object.isFrozen(value)) {
+        return value;
+    }
+
+    Object.freeze(value);
+    for (const key of Object.keys(value as object)) {
+        freezeSemanticData((value as Record<string, unknown>)[key]);
+    }
+
+    return value;
+}
+
+/**
+ * 投影出对外的文档语义快照。摘要数组与 `SemanticSnapshot` 共享并被冻结；
+ * 诊断、符号表等非摘要字段仍按引用传递，不在冻结范围内。
+ */
 export function toDocumentSemanticSnapshot(snapshot: SemanticSnapshot): DocumentSemanticSnapshot {
-    return {
+    return Object.freeze({
         uri: snapshot.uri,
         version: snapshot.version,
         parseDiagnostics: snapshot.parseDiagnostics,
-        exportedFunctions: snapshot.exportedFunctions,
-        symbols: snapshot.symbols.map((symbol) => ({ ...symbol })),
-        localScopes: snapshot.localScopes,
-        typeDefinitions: snapshot.typeDefinitions,
-        fileGlobals: snapshot.fileGlobals ? snapshot.fileGlobals.map((summary) => ({ ...summary })) : [],
-        inheritStatements: snapshot.inheritStatements,
-        includeStatements: snapshot.includeStatements,
-        macroDefinitions: snapshot.macroDefinitions,
-        macroReferences: snapshot.macroReferences,
+        exportedFunctions: freezeSemanticData(snapshot.exportedFunctions),
+        symbols: freezeSemanticData(snapshot.symbols),
+        localScopes: freezeSemanticData(snapshot.localScopes),
+        typeDefinitions: freezeSemanticData(snapshot.typeDefinitions),
+        fileGlobals: snapshot.fileGlobals
+            ? freezeSemanticData(snapshot.fileGlobals)
+            : EMPTY_FILE_GLOBALS as FileGlobalSummary[],
+        inheritStatements: freezeSemanticData(snapshot.inheritStatements),
+        includeStatements: freezeSemanticData(snapshot.includeStatements),
+        macroDefinitions: freezeSemanticData(snapshot.macroDefinitions),
+        macroReferences: freezeSemanticData(snapshot.macroReferences),
         symbolTable: snapshot.symbolTable,
         degraded: snapshot.degraded,
         failureReason: snapshot.failureReason,
         createdAt: snapshot.createdAt
-    };
+    });
 }
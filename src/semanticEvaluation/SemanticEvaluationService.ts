@@ -9,6 +9,7 @@ import type { SemanticValue } from './types';
 import { unknownValue } from './valueFactories';
 import type { CalleeReturnEvaluator } from './calls/CalleeReturnEvaluator';
 import { CallTargetResolver } from './calls/CallTargetResolver';
+import type { FunctionReturnSummaryStore } from './calls/FunctionReturnSummaryStore';
 import type { EnvironmentSemanticRegistry } from './environment/EnvironmentSemanticRegistry';
 import { ConfiguredFunctionReturnProvider } from './environment/ConfiguredFunctionReturnProvider';
 import { RuntimeNonStaticProvider } from './environment/RuntimeNonStaticProvider';
@@ -48,6 +49,7 @@ export interface DefaultSemanticEvaluationServiceDependencies {
     pathSupport?: WorkspaceDocumentPathSupport;
     instanceResolutionFunctions?: InstanceResolutionFunctionMap;
     projectConfigProvider?: ConfiguredFunctionReturnProjectConfigProvider;
+    returnSummaryStore?: Pick<FunctionReturnSummaryStore, 'getFunction' | 'setFunction' | 'getSummary' | 'setSummary'>;
 }
 
 interface ContainingFunctionEvaluation {
@@ -400,7 +402,8 @@ export function createDefaultSemanticEvaluationService(
     const calleeReturnEvaluator = new DefaultCalleeReturnEvaluator({
         callTargetResolver,
         environmentRegistry,
-        pathSupport
+        pathSupport,
+        summaryStore: dependencies.returnSummaryStore
     });
 
     return new SemanticEvaluationService({
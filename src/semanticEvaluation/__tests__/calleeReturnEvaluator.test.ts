@@ -13,6 +13,7 @@ import { ExpressionEvaluator } from '../static/ExpressionEvaluator';
 import { StatementTransfer } from '../static/StatementTransfer';
 import { CallTargetResolver } from '../calls/CallTargetResolver';
 import { CalleeReturnEvaluator } from '../calls/CalleeReturnEvaluator';
+import { FunctionReturnSummaryStore } from '../calls/FunctionReturnSummaryStore';
 
 function normalizeWorkspaceFsPath(filePath: string): string {
     return path.normalize(filePath.replace(/^\/([A-Za-z]:)/, '$1'));
@@ -384,6 +385,183 @@ describe('CalleeReturnEvaluator', () => {
         expect(result).toEqual(unknownValue());
     });
 
+    test('follows call chains deeper than the inline call depth budget', async () => {
+        const result = await evaluateReturnCall({
+            'file:///D:/workspace/demo.c': [
+                'string level6() { return "/obj/deep"; }',
+                'string level5() { return level6(); }',
+                'string level4() { return level5(); }',
+                'string level3() { return level4(); }',
+                'string level2() { return level3(); }',
+                'string level1() { return level2(); }',
+                '',
+                'mixed demo() {',
+                '    return load_object(level1());',
+                '}'
+            ].join('\n')
+        }, 'file:///D:/workspace/demo.c', {}, (node) => getCallExpressionName(node) === 'level1');
+
+        expect(result).toEqual(literalValue('/obj/deep'));
+    });
+
+    test('solves recursive callees to a fixpoint', async () => {
+        const result = await evaluateReturnCall({
+            'file:///D:/workspace/demo.c': [
+                'string pick_path(int depth) {',
+                '    if (depth > 0) {',
+                '        return pick_path(depth - 1);',
+                '    }',
+                '    return "/obj/sword";',
+                '}',
+                '',
+                'mixed demo(int depth) {',
+                '    return pick_path(depth);',
+                '}'
+            ].join('\n')
+        }, 'file:///D:/workspace/demo.c');
+
+        expect(result).toEqual(literalValue('/obj/sword'));
+    });
+
+    test('reuses stored call graphs until a callee document is invalidated', async () => {
+        const sourceByUri = {
+            'file:///D:/workspace/base.c': [
+                'string base_path() {',
+                '    return "/obj/base";',
+                '}'
+            ].join('\n'),
+            'file:///D:/workspace/demo.c': [
+                'inherit "/base";',
+                '',
+                'string wrap_path() {',
+                '    return base_path();',
+                '}',
+                '',
+                'mixed demo() {',
+                '    return wrap_path();',
+                '}'
+            ].join('\n')
+        };
+        const documents = Object.entries(sourceByUri).map(([uri, source]) => createTextDocument(uri, source));
+        const callerDocument = documents.find((document) => document.fileName.endsWith('demo.c'));
+        if (!callerDocument) {
+            throw new Error('Missing caller document');
+        }
+        const pathSupport = new WorkspaceDocumentPathSupport({ host: createDocumentHost(documents) });
+        const callTargetResolver = new CallTargetResolver({
+            analysisService: DocumentSemanticSnapshotService.getInstance(),
+            pathSupport
+        });
+        const resolveCallTarget = jest.spyOn(callTargetResolver, 'resolveCallTarget');
+        const summaryStore = new FunctionReturnSummaryStore();
+        const evaluator = new CalleeReturnEvaluator({ callTargetResolver, summaryStore });
+        const { context, state, callExpression } = prepareCallEvaluation(documents, callerDocument);
+
+        await expect(evaluator.evaluateCallExpression(callerDocument, callExpression, context, state))
+            .resolves.toEqual(literalValue('/obj/base'));
+        expect(resolveCallTarget).toHaveBeenCalledTimes(2);
+
+        await expect(evaluator.evaluateCallExpression(callerDocument, callExpression, context, state))
+            .resolves.toEqual(literalValue('/obj/base'));
+        expect(resolveCallTarget).toHaveBeenCalledTimes(3);
+
+        summaryStore.invalidateDocument('file:///D:/workspace/base.c');
+        await expect(evaluator.evaluateCallExpression(callerDocument, callExpression, context, state))
+            .resolves.toEqual(literalValue('/obj/base'));
+        expect(resolveCallTarget).toHaveBeenCalledTimes(5);
+    });
+
+    test('drops summaries of dependent documents when an inherited definition is added', async () => {
+        const demoSource = [
+            'inherit "/base";',
+            '',
+            'string wrap_path() {',
+            '    return base_path();',
+            '}',
+            '',
+            'mixed demo() {',
+            '    return wrap_path();',
+            '}'
+        ].join('\n');
+        const summaryStore = new FunctionReturnSummaryStore({
+            getDependentUris: (uri) => uri === 'file:///D:/workspace/base.c' ? ['file:///D:/workspace/demo.c'] : []
+        });
+        const createEvaluator = (documents: vscode.TextDocument[]) => new CalleeReturnEvaluator({
+            callTargetResolver: new CallTargetResolver({
+                analysisService: DocumentSemanticSnapshotService.getInstance(),
+                pathSupport: new WorkspaceDocumentPathSupport({ host: createDocumentHost(documents) })
+            }),
+            summaryStore
+        });
+        const callerDocument = createTextDocument('file:///D:/workspace/demo.c', demoSource);
+        const initialDocuments = [
+            createTextDocument('file:///D:/workspace/base.c', 'string other_path() {\n    return "/obj/other";\n}'),
+            callerDocument
+        ];
+        const { context, state, callExpression } = prepareCallEvaluation(initialDocuments, callerDocument);
+
+        await expect(createEvaluator(initialDocuments).evaluateCallExpression(callerDocument, callExpression, context, state))
+            .resolves.not.toEqual(literalValue('/obj/base'));
+
+        const updatedDocuments = [
+            createTextDocument('file:///D:/workspace/base.c', 'string base_path() {\n    return "/obj/base";\n}', 2),
+            callerDocument
+        ];
+        const updatedEvaluator = createEvaluator(updatedDocuments);
+        // base.c holds no stored function, so only the dependent lookup reaches the cached wrap_path summary.
+        await expect(updatedEvaluator.evaluateCallExpression(callerDocument, callExpression, context, state))
+            .resolves.not.toEqual(literalValue('/obj/base'));
+
+        summaryStore.invalidateDocument('file:///D:/workspace/base.c');
+        await expect(updatedEvaluator.evaluateCallExpression(callerDocument, callExpression, context, state))
+            .resolves.toEqual(literalValue('/obj/base'));
+    });
+
+    test('recomputes caller summaries after an unsaved edit to a callee in another file', async () => {
+        const demoSource = [
+            'inherit "/base";',
+            '',
+            'string wrap_path() {',
+            '    return base_path();',
+            '}',
+            '',
+            'mixed demo() {',
+            '    return wrap_path();',
+            '}'
+        ].join('\n');
+        const summaryStore = new FunctionReturnSummaryStore();
+        const createEvaluator = (documents: vscode.TextDocument[]) => new CalleeReturnEvaluator({
+            callTargetResolver: new CallTargetResolver({
+                analysisService: DocumentSemanticSnapshotService.getInstance(),
+                pathSupport: new WorkspaceDocumentPathSupport({ host: createDocumentHost(documents) })
+            }),
+            summaryStore
+        });
+        const callerDocument = createTextDocument('file:///D:/workspace/demo.c', demoSource);
+        const savedDocuments = [
+            createTextDocument('file:///D:/workspace/base.c', 'string base_path() {\n    return "/obj/base";\n}'),
+            callerDocument
+        ];
+        const { context, state, callExpression } = prepareCallEvaluation(savedDocuments, callerDocument);
+
+        await expect(createEvaluator(savedDocuments).evaluateCallExpression(callerDocument, callExpression, context, state))
+            .resolves.toEqual(literalValue('/obj/base'));
+
+        // The editor now holds version 2 of base.c; nothing was written to disk.
+        const editedDocuments = [
+            createTextDocument('file:///D:/workspace/base.c', 'string base_path() {\n    return "/obj/edited";\n}', 2),
+            callerDocument
+        ];
+        const editedEvaluator = createEvaluator(editedDocuments);
+        await expect(editedEvaluator.evaluateCallExpression(callerDocument, callExpression, context, state))
+            .resolves.toEqual(literalValue('/obj/base'));
+
+        // didChange of base.c reaches the store through the server's onDocumentChanged hook.
+        summaryStore.invalidateDocument('file:///D:/workspace/base.c');
+        await expect(editedEvaluator.evaluateCallExpression(callerDocument, callExpression, context, state))
+            .resolves.toEqual(literalValue('/obj/edited'));
+    });
+
     test('resolves include-backed callees when a local prototype shadows the body', async () => {
         const sourceByUri = {
             'file:///D:/workspace/helper.c': [
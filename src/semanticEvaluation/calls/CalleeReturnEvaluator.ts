@@ -3,27 +3,30 @@ import type { WorkspaceDocumentPathSupport } from '../../language/shared/Workspa
 import { SyntaxKind, SyntaxNode } from '../../syntax/types';
 import type { SemanticValue } from '../types';
 import { unknownValue } from '../valueFactories';
-import { CoreStaticEvaluator } from '../static/CoreStaticEvaluator';
 import {
     createResolvedEnvironmentCallKey,
-    createStaticEvaluationContext,
     type StaticEvaluationContext
 } from '../static/StaticEvaluationContext';
-import {
-    bindEnvironmentValue,
-    createValueEnvironment,
-    type StaticEvaluationState
-} from '../static/StaticEvaluationState';
+import type { StaticEvaluationState } from '../static/StaticEvaluationState';
 import { ExpressionEvaluator } from '../static/ExpressionEvaluator';
 import type { EnvironmentSemanticRegistry } from '../environment/EnvironmentSemanticRegistry';
 import type { CallTargetResolver, ResolvedCallTarget } from './CallTargetResolver';
+import {
+    FunctionReturnSummaryStore,
+    getTargetSummaryKey,
+    type FunctionCallGraphEntry
+} from './FunctionReturnSummaryStore';
+import { ReturnSummaryEvaluator } from './ReturnSummaryEvaluator';
 
 export interface CalleeReturnEvaluatorOptions {
     callTargetResolver?: Pick<CallTargetResolver, 'resolveCallTarget'>;
     environmentRegistry?: Pick<EnvironmentSemanticRegistry, 'evaluate'>;
     pathSupport?: Pick<WorkspaceDocumentPathSupport, 'getWorkspaceFolderRoot' | 'resolveObjectFilePath'>;
+    summaryStore?: Pick<FunctionReturnSummaryStore, 'getFunction' | 'setFunction' | 'getSummary' | 'setSummary'>;
 }
 
+const MAX_COLLECTED_FUNCTIONS = 64;
+
 function collectDirectIdentifierCalls(root: SyntaxNode): SyntaxNode[] {
     const calls: SyntaxNode[] = [];
     const queue: SyntaxNode[] = [root];
@@ -52,6 +55,7 @@ export class CalleeReturnEvaluator {
     private readonly callTargetResolver: Pick<CallTargetResolver, 'resolveCallTarget'>;
     private readonly environmentRegistry?: Pick<EnvironmentSemanticRegistry, 'evaluate'>;
     private readonly pathSupport?: Pick<WorkspaceDocumentPathSupport, 'getWorkspaceFolderRoot' | 'resolveObjectFilePath'>;
+    private readonly summaryStore?: Pick<FunctionReturnSummaryStore, 'getFunction' | 'setFunction' | 'getSummary' | 'setSummary'>;
 
     public constructor(options: CalleeReturnEvaluatorOptions) {
         if (!options.callTargetResolver) {
@@ -61,6 +65,7 @@ export class CalleeReturnEvaluator {
         this.callTargetResolver = options.callTargetResolver;
         this.environmentRegistry = options.environmentRegistry;
         this.pathSupport = options.pathSupport;
+        this.summaryStore = options.summaryStore;
     }
 
     public async evaluateCallExpression(
@@ -84,62 +89,62 @@ export class CalleeReturnEvaluator {
             return unknownValue();
         }
 
-        const resolvedDirectCalls = new Map<string, ResolvedCallTarget>();
+        const summaryStore = this.summaryStore ?? new FunctionReturnSummaryStore();
         const resolvedEnvironmentCalls = new Map(callerContext.resolvedEnvironmentCalls ?? []);
-        await this.collectResolvedCallSemantics(
-            target,
-            resolvedDirectCalls,
-            resolvedEnvironmentCalls,
-            new Set<string>(),
-            callerContext.budget.maxCallDepth - nextCallDepth
-        );
+        const callGraph = await this.collectCallGraph(target, summaryStore, resolvedEnvironmentCalls);
 
         const callerExpressionEvaluator = new ExpressionEvaluator(callerContext);
         const argumentValues = getArgumentExpressions(callExpression).map((argument) =>
             callerExpressionEvaluator.evaluate(argument, callerState)
         );
 
-        let initialEnvironment = createValueEnvironment();
-        for (let index = 0; index < target.functionSummary.parameters.length; index += 1) {
-            const parameter = target.functionSummary.parameters[index];
-            initialEnvironment = bindEnvironmentValue(
-                initialEnvironment,
-                parameter.name,
-                argumentValues[index] ?? unknownValue()
-            );
-        }
-
-        const calleeContext = createStaticEvaluationContext({
-            syntax: target.syntax,
-            semantic: target.semantic,
-            functionSummary: target.functionSummary,
-            resolvedDirectCalls,
+        return new ReturnSummaryEvaluator(
+            callGraph,
+            summaryStore,
             resolvedEnvironmentCalls,
-            budget: callerContext.budget,
-            metadata: {
-                documentUri: target.document.uri.toString(),
-                functionName: target.functionSummary.name,
-                callDepth: nextCallDepth
-            },
-            initialEnvironment
-        });
-
-        return new CoreStaticEvaluator(calleeContext).evaluateFunction(target.functionNode);
+            callerContext.budget
+        ).evaluateTarget(target, argumentValues, nextCallDepth);
     }
 
-    private async collectResolvedCallSemantics(
-        target: ResolvedCallTarget,
-        resolvedDirectCalls: Map<string, ResolvedCallTarget>,
-        resolvedEnvironmentCalls: Map<string, SemanticValue>,
-        visitedFunctions: Set<string>,
-        remainingDepth: number
-    ): Promise<void> {
-        const targetKey = `${target.document.uri.toString()}|${target.functionSummary.name}`;
-        if (visitedFunctions.has(targetKey)) {
-            return;
+    private async collectCallGraph(
+        root: ResolvedCallTarget,
+        summaryStore: Pick<FunctionReturnSummaryStore, 'getFunction' | 'setFunction'>,
+        resolvedEnvironmentCalls: Map<string, SemanticValue>
+    ): Promise<Map<string, FunctionCallGraphEntry>> {
+        const callGraph = new Map<string, FunctionCallGraphEntry>();
+        const pending: ResolvedCallTarget[] = [root];
+
+        for (let index = 0; index < pending.length && callGraph.size < MAX_COLLECTED_FUNCTIONS; index += 1) {
+            const target = pending[index];
+            const targetKey = getTargetSummaryKey(target);
+            if (callGraph.has(targetKey)) {
+                continue;
+            }
+
+            let entry = summaryStore.getFunction(target);
+            if (!entry) {
+                const { callees, environmentCalls } = await this.resolveCallees(target);
+                entry = summaryStore.setFunction(target, callees, environmentCalls);
+            }
+
+            callGraph.set(targetKey, entry);
+            for (const [environmentCallKey, environmentValue] of entry.environmentCalls) {
+                if (!resolvedEnvironmentCalls.has(environmentCallKey)) {
+                    resolvedEnvironmentCalls.set(environmentCallKey, environmentValue);
+                }
+            }
+            pending.push(...entry.callees.values());
         }
 
-        visitedFunctions.add(targetKey);
+        return callGraph;
+    }
+
+    private async resolveCallees(target: ResolvedCallTarget): Promise<{
+        callees: Map<string, ResolvedCallTarget>;
+        environmentCalls: Map<string, SemanticValue>;
+    }> {
+        const callees = new Map<string, ResolvedCallTarget>();
+        const environmentCalls = new Map<string, SemanticValue>();
 
         for (const directCall of collectDirectIdentifierCalls(target.functionNode)) {
             const directCallee = directCall.children[0];
@@ -153,36 +158,28 @@ export class CalleeReturnEvaluator {
                 directCallee.name,
                 argumentCount
             );
-            if (!resolvedEnvironmentCalls.has(environmentCallKey)) {
+            if (!environmentCalls.has(environmentCallKey)) {
                 const environmentValue = await this.evaluateEnvironmentCall(
                     target.document,
                     directCallee.name,
                     argumentCount
                 );
                 if (environmentValue) {
-                    resolvedEnvironmentCalls.set(environmentCallKey, environmentValue);
+                    environmentCalls.set(environmentCallKey, environmentValue);
                 }
             }
 
-            const nestedTarget = await this.callTargetResolver.resolveCallTarget(target.document, directCall);
-            if (!nestedTarget) {
+            if (callees.has(directCallee.name)) {
                 continue;
             }
 
-            if (!resolvedDirectCalls.has(directCallee.name)) {
-                resolvedDirectCalls.set(directCallee.name, nestedTarget);
-            }
-
-            if (remainingDepth > 0) {
-                await this.collectResolvedCallSemantics(
-                    nestedTarget,
-                    resolvedDirectCalls,
-                    resolvedEnvironmentCalls,
-                    visitedFunctions,
-                    remainingDepth - 1
-                );
+            const nestedTarget = await this.callTargetResolver.resolveCallTarget(target.document, directCall);
+            if (nestedTarget) {
+                callees.set(directCallee.name, nestedTarget);
             }
         }
+
+        return { callees, environmentCalls };
     }
 
     private async evaluateEnvironmentCall(
@@ -0,0 +1,167 @@
+import { toDependencyKey } from '../../lsp/server/runtime/WorkspaceDependencyGraph';
+import type { SemanticValue } from '../types';
+import type { ResolvedCallTarget } from './CallTargetResolver';
+
+export interface FunctionReturnSummaryStoreOptions {
+    getDependentUris?: (uri: string) => readonly string[];
+}
+
+export interface FunctionCallGraphEntry {
+    target: ResolvedCallTarget;
+    callees: ReadonlyMap<string, ResolvedCallTarget>;
+    environmentCalls: ReadonlyMap<string, SemanticValue>;
+}
+
+interface StoredFunction extends FunctionCallGraphEntry {
+    calleeKeys: Set<string>;
+    summaries: Map<string, SemanticValue>;
+}
+
+const MAX_STORED_FUNCTIONS = 2048;
+const MAX_SUMMARIES_PER_FUNCTION = 32;
+
+export function createFunctionSummaryKey(documentUri: string, functionName: string): string {
+    return `${toDependencyKey(documentUri)}|${functionName}`;
+}
+
+export function getTargetSummaryKey(target: ResolvedCallTarget): string {
+    return createFunctionSummaryKey(target.document.uri.toString(), target.functionSummary.name);
+}
+
+export class FunctionReturnSummaryStore {
+    private readonly functions = new Map<string, StoredFunction>();
+    private readonly callersByCallee = new Map<string, Set<string>>();
+    private readonly functionKeysByDocument = new Map<string, Set<string>>();
+    private readonly getDependentUris?: (uri: string) => readonly string[];
+
+    public constructor(options: FunctionReturnSummaryStoreOptions = {}) {
+        this.getDependentUris = options.getDependentUris;
+    }
+
+    public getFunction(target: ResolvedCallTarget): FunctionCallGraphEntry | undefined {
+        const key = getTargetSummaryKey(target);
+        const entry = this.functions.get(key);
+        if (!entry) {
+            return undefined;
+        }
+
+        if (entry.target.syntax !== target.syntax || entry.target.functionNode !== target.functionNode) {
+            this.invalidateFunctions([key]);
+            return undefined;
+        }
+
+        return entry;
+    }
+
+    public setFunction(
+        target: ResolvedCallTarget,
+        callees: ReadonlyMap<string, ResolvedCallTarget>,
+        environmentCalls: ReadonlyMap<string, SemanticValue>
+    ): FunctionCallGraphEntry {
+        const key = getTargetSummaryKey(target);
+        if (this.functions.has(key)) {
+            this.invalidateFunctions([key]);
+        }
+        if (this.functions.size >= MAX_STORED_FUNCTIONS) {
+            this.clear();
+        }
+
+        const entry: StoredFunction = {
+            target,
+            callees,
+            environmentCalls,
+            calleeKeys: new Set(),
+            summaries: new Map()
+        };
+        this.functions.set(key, entry);
+        this.indexDocumentKey(target.document.uri.toString(), key);
+
+        for (const callee of callees.values()) {
+            const calleeKey = getTargetSummaryKey(callee);
+            entry.calleeKeys.add(calleeKey);
+            this.indexDocumentKey(callee.document.uri.toString(), calleeKey);
+
+            let callers = this.callersByCallee.get(calleeKey);
+            if (!callers) {
+                callers = new Set();
+                this.callersByCallee.set(calleeKey, callers);
+            }
+            callers.add(key);
+        }
+
+        return entry;
+    }
+
+    public getSummary(functionKey: string, signature: string): SemanticValue | undefined {
+        return this.functions.get(functionKey)?.summaries.get(signature);
+    }
+
+    public setSummary(functionKey: string, signature: string, value: SemanticValue): void {
+        const entry = this.functions.get(functionKey);
+        if (!entry) {
+            return;
+        }
+
+        if (entry.summaries.size >= MAX_SUMMARIES_PER_FUNCTION) {
+            entry.summaries.clear();
+        }
+        entry.summaries.set(signature, value);
+    }
+
+    public invalidateDocument(uri: string): void {
+        // Callees that did not resolve leave no reverse edge, so a definition added to an inherited or
+        // included file only reaches the callers through the documents that depend on it.
+        const keys: string[] = [];
+        for (const documentUri of [uri, ...(this.getDependentUris?.(uri) ?? [])]) {
+            const documentKey = toDependencyKey(documentUri);
+            keys.push(...(this.functionKeysByDocument.get(documentKey) ?? []));
+            this.functionKeysByDocument.delete(documentKey);
+        }
+
+        if (keys.length > 0) {
+            this.invalidateFunctions(keys);
+        }
+    }
+
+    public clear(): void {
+        this.functions.clear();
+        this.callersByCallee.clear();
+        this.functionKeysByDocument.clear();
+    }
+
+    private invalidateFunctions(keys: readonly string[]): void {
+        const pending = [...keys];
+        const visited = new Set(pending);
+
+        for (let index = 0; index < pending.length; index += 1) {
+            const key = pending[index];
+            for (const callerKey of this.callersByCallee.get(key) ?? []) {
+                if (!visited.has(callerKey)) {
+                    visited.add(callerKey);
+                    pending.push(callerKey);
+                }
+            }
+            this.callersByCallee.delete(key);
+
+            const entry = this.functions.get(key);
+            if (!entry) {
+                continue;
+            }
+
+            this.functions.delete(key);
+            for (const calleeKey of entry.calleeKeys) {
+                this.callersByCallee.get(calleeKey)?.delete(key);
+            }
+        }
+    }
+
+    private indexDocumentKey(uri: string, functionKey: string): void {
+        const documentKey = toDependencyKey(uri);
+        let keys = this.functionKeysByDocument.get(documentKey);
+        if (!keys) {
+            keys = new Set();
+            this.functionKeysByDocument.set(documentKey, keys);
+        }
+        keys.add(functionKey);
+    }
+}
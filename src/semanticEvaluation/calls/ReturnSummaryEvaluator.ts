@@ -0,0 +1,151 @@
+import type { SemanticValue } from '../types';
+import { unionValue, unknownValue } from '../valueFactories';
+import { serializeSemanticValue } from '../valueJoin';
+import { CoreStaticEvaluator } from '../static/CoreStaticEvaluator';
+import {
+    createStaticEvaluationContext,
+    type StaticCallSummaryProvider,
+    type StaticEvaluationBudget,
+    type StaticEvaluationContext
+} from '../static/StaticEvaluationContext';
+import { bindEnvironmentValue, createValueEnvironment } from '../static/StaticEvaluationState';
+import type { ResolvedCallTarget } from './CallTargetResolver';
+import {
+    createFunctionSummaryKey,
+    getTargetSummaryKey,
+    type FunctionCallGraphEntry,
+    type FunctionReturnSummaryStore
+} from './FunctionReturnSummaryStore';
+
+interface SummaryFrame {
+    functionKey: string;
+    signature: string;
+    approximation: SemanticValue;
+    recursive: boolean;
+    provisional: boolean;
+}
+
+const MAX_SUMMARY_DEPTH = 16;
+const MAX_FIXPOINT_ITERATIONS = 4;
+const MAX_SIGNATURE_LENGTH = 2048;
+
+export class ReturnSummaryEvaluator implements StaticCallSummaryProvider {
+    private readonly frames: SummaryFrame[] = [];
+
+    public constructor(
+        private readonly callGraph: ReadonlyMap<string, FunctionCallGraphEntry>,
+        private readonly store: Pick<FunctionReturnSummaryStore, 'getSummary' | 'setSummary'>,
+        private readonly environmentCalls: ReadonlyMap<string, SemanticValue>,
+        private readonly budget: StaticEvaluationBudget
+    ) {}
+
+    public evaluateCall(
+        callerContext: StaticEvaluationContext,
+        calleeName: string,
+        argumentValues: readonly SemanticValue[]
+    ): SemanticValue {
+        const callerKey = createFunctionSummaryKey(callerContext.metadata.documentUri, callerContext.metadata.functionName);
+        const target = this.callGraph.get(callerKey)?.callees.get(calleeName);
+        if (!target) {
+            return unknownValue();
+        }
+
+        return this.evaluateTarget(target, argumentValues, callerContext.metadata.callDepth + 1);
+    }
+
+    public evaluateTarget(
+        target: ResolvedCallTarget,
+        argumentValues: readonly SemanticValue[],
+        callDepth: number
+    ): SemanticValue {
+        const functionKey = getTargetSummaryKey(target);
+        const parameterValues = target.functionSummary.parameters.map((_, index) => argumentValues[index] ?? unknownValue());
+        const signature = parameterValues.map(serializeSemanticValue).join(',');
+        const cached = this.store.getSummary(functionKey, signature);
+        if (cached) {
+            return cached;
+        }
+
+        const activeIndex = this.frames.findIndex((frame) =>
+            frame.functionKey === functionKey && frame.signature === signature
+        );
+        if (activeIndex >= 0) {
+            this.frames[activeIndex].recursive = true;
+            this.markProvisional(activeIndex + 1);
+            return this.frames[activeIndex].approximation;
+        }
+
+        if (this.frames.length >= MAX_SUMMARY_DEPTH) {
+            this.markProvisional(0);
+            return unknownValue();
+        }
+
+        const frame: SummaryFrame = {
+            functionKey,
+            signature,
+            approximation: unionValue([]),
+            recursive: false,
+            provisional: false
+        };
+        this.frames.push(frame);
+
+        let result: SemanticValue;
+        try {
+            result = this.evaluateBody(target, parameterValues, callDepth);
+            for (let iteration = 1; frame.recursive; iteration += 1) {
+                if (serializeSemanticValue(result) === serializeSemanticValue(frame.approximation)) {
+                    break;
+                }
+                if (iteration >= MAX_FIXPOINT_ITERATIONS) {
+                    result = unknownValue();
+                    break;
+                }
+
+                frame.approximation = result;
+                result = this.evaluateBody(target, parameterValues, callDepth);
+            }
+        } finally {
+            this.frames.pop();
+        }
+
+        if (!frame.provisional && signature.length <= MAX_SIGNATURE_LENGTH) {
+            this.store.setSummary(functionKey, signature, result);
+        }
+
+        return result;
+    }
+
+    private evaluateBody(
+        target: ResolvedCallTarget,
+        parameterValues: readonly SemanticValue[],
+        callDepth: number
+    ): SemanticValue {
+        let initialEnvironment = createValueEnvironment();
+        target.functionSummary.parameters.forEach((parameter, index) => {
+            initialEnvironment = bindEnvironmentValue(initialEnvironment, parameter.name, parameterValues[index]);
+        });
+
+        const context = createStaticEvaluationContext({
+            syntax: target.syntax,
+            semantic: target.semantic,
+            functionSummary: target.functionSummary,
+            resolvedEnvironmentCalls: this.environmentCalls,
+            callSummaries: this,
+            budget: this.budget,
+            metadata: {
+                documentUri: target.document.uri.toString(),
+                functionName: target.functionSummary.name,
+                callDepth
+            },
+            initialEnvironment
+        });
+
+        return new CoreStaticEvaluator(context).evaluateFunction(target.functionNode);
+    }
+
+    private markProvisional(fromIndex: number): void {
+        for (let index = fromIndex; index < this.frames.length; index += 1) {
+            this.frames[index].provisional = true;
+        }
+    }
+}
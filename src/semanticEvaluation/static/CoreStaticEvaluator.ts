@@ -64,6 +64,14 @@ export class CoreStaticEvaluator {
         state: StaticEvaluationState
     ): SemanticValue {
         const callee = callExpression.children[0];
+        if (callee?.kind === SyntaxKind.Identifier && callee.name && this.context.callSummaries) {
+            return this.context.callSummaries.evaluateCall(
+                this.context,
+                callee.name,
+                this.evaluateArguments(callExpression, state)
+            );
+        }
+
         if (!this.context.syntax || !this.context.semantic || callee?.kind !== SyntaxKind.Identifier || !callee.name) {
             return unknownValue();
         }
@@ -90,10 +98,7 @@ export class CoreStaticEvaluator {
             return unknownValue();
         }
 
-        const argumentList = callExpression.children[1];
-        const argumentValues = argumentList?.children.map((argument) =>
-            this.expressionEvaluator.evaluate(argument, state)
-        ) ?? [];
+        const argumentValues = this.evaluateArguments(callExpression, state);
 
         let initialEnvironment = createValueEnvironment();
         for (let index = 0; index < targetSummary.parameters.length; index += 1) {
@@ -121,4 +126,11 @@ export class CoreStaticEvaluator {
             initialEnvironment
         }).evaluateFunction(functionNode);
     }
+
+    private evaluateArguments(callExpression: SyntaxNode, state: StaticEvaluationState): SemanticValue[] {
+        const argumentList = callExpression.children[1];
+        return argumentList?.children.map((argument) =>
+            this.expressionEvaluator.evaluate(argument, state)
+        ) ?? [];
+    }
 }
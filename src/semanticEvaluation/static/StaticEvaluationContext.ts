@@ -21,12 +21,21 @@ export interface StaticEvaluationMetadata {
     callDepth: number;
 }
 
+export interface StaticCallSummaryProvider {
+    evaluateCall(
+        callerContext: StaticEvaluationContext,
+        calleeName: string,
+        argumentValues: readonly SemanticValue[]
+    ): SemanticValue;
+}
+
 export interface StaticEvaluationContext {
     syntax?: SyntaxDocument;
     semantic?: SemanticSnapshot;
     functionSummary?: FunctionSummary;
     resolvedDirectCalls?: ReadonlyMap<string, ResolvedCallTarget>;
     resolvedEnvironmentCalls?: ReadonlyMap<string, SemanticValue>;
+    callSummaries?: StaticCallSummaryProvider;
     budget: StaticEvaluationBudget;
     metadata: StaticEvaluationMetadata;
     initialEnvironment: ValueEnvironment;
@@ -38,6 +47,7 @@ export interface CreateStaticEvaluationContextOptions {
     functionSummary?: FunctionSummary;
     resolvedDirectCalls?: ReadonlyMap<string, ResolvedCallTarget>;
     resolvedEnvironmentCalls?: ReadonlyMap<string, SemanticValue>;
+    callSummaries?: StaticCallSummaryProvider;
     budget?: Partial<StaticEvaluationBudget>;
     metadata: StaticEvaluationMetadata;
     initialEnvironment?: ValueEnvironment;
@@ -76,6 +86,7 @@ export function createStaticEvaluationContext(
         functionSummary: options.functionSummary,
         resolvedDirectCalls: options.resolvedDirectCalls,
         resolvedEnvironmentCalls: options.resolvedEnvironmentCalls,
+        callSummaries: options.callSummaries,
         budget: createStaticEvaluationBudget(options.budget),
         metadata: options.metadata,
         initialEnvironment: options.initialEnvironment ?? createValueEnvironment()
@@ -1,7 +1,7 @@
 import { SemanticValue } from './types';
 import { unionValue, unknownValue } from './valueFactories';
 
-function serializeSemanticValue(value: SemanticValue): string {
+export function serializeSemanticValue(value: SemanticValue): string {
     switch (value.kind) {
         case 'unknown':
             return '{"kind":"unknown"}';
@@ -562,8 +562,8 @@ export class SyntaxBuilder {
     }
 
     private createSourceFileTokenRange() {
-        const firstVisible = this.parsed.visibleTokens[0];
-        const lastVisible = this.parsed.visibleTokens[this.parsed.visibleTokens.length - 1];
+        const firstVisible = this.getVisibleTokenAt(0);
+        const lastVisible = this.getVisibleTokenAt(-1);
 
         if (!firstVisible || !lastVisible) {
             return createTokenRange(0, 0);
@@ -603,7 +603,7 @@ export class SyntaxBuilder {
             return startToken;
         }
 
-        return stopToken && stopToken.type !== Token.EOF ? stopToken : this.parsed.visibleTokens[0];
+        return stopToken && stopToken.type !== Token.EOF ? stopToken : this.getVisibleTokenAt(0);
     }
 
     public normalizeStopToken(stopToken: Token | undefined, startToken: Token | undefined): Token | undefined {
@@ -613,11 +613,30 @@ export class SyntaxBuilder {
 
         return startToken && startToken.type !== Token.EOF
             ? startToken
-            : this.parsed.visibleTokens[this.parsed.visibleTokens.length - 1];
+            : this.getVisibleTokenAt(-1);
     }
 
     public resolveTokenByIndex(tokenIndex: number): Token | undefined {
-        return this.parsed.allTokens.find((token) => token.tokenIndex === tokenIndex);
+        // token 在流中的下标就是 tokenIndex，常规情况下无需线性查找。
+        const token = this.parsed.allTokens[tokenIndex];
+        return token?.tokenIndex === tokenIndex
+            ? token
+            : this.parsed.allTokens.find((candidate) => candidate.tokenIndex === tokenIndex);
+    }
+
+    /**
+     * 第 `position` 个可见 token（负数从末尾数起）；有 token 表时不生成可见 token 数组
+     */
+    private getVisibleTokenAt(position: number): Token | undefined {
+        const tokenTable = this.parsed.tokenTable;
+        if (!tokenTable) {
+            const visibleTokens = this.parsed.visibleTokens;
+            return visibleTokens[position < 0 ? visibleTokens.length + position : position];
+        }
+
+        const visibleIndexes = tokenTable.visibleIndexes;
+        const tokenIndex = visibleIndexes[position < 0 ? visibleIndexes.length + position : position];
+        return tokenIndex === undefined ? undefined : this.parsed.allTokens[tokenIndex];
     }
 
     public createRange(startToken: Token | undefined, stopToken: Token | undefined): vscode.Range {
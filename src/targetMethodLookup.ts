@@ -1,6 +1,6 @@
 import * as path from 'path';
-import * as fs from 'fs';
 import * as vscode from 'vscode';
+import { getGlobalVirtualFileSystem } from './core/VirtualFileSystem';
 import { SymbolType } from './ast/symbolTable';
 import {
     WorkspaceDocumentPathSupport,
@@ -48,6 +48,7 @@ export class TargetMethodLookup {
     private readonly pathSupport: WorkspaceDocumentPathSupport;
     private readonly cache = new Map<string, CachedTargetMethodLookup>();
     private readonly maxCacheEntries = 500;
+    private readonly fileSystem = getGlobalVirtualFileSystem();
 
     constructor(
         analysisService: TargetMethodAnalysisService,
@@ -360,13 +361,10 @@ export class TargetMethodLookup {
 
     private createDocumentVersionToken(document: vscode.TextDocument): string {
         const fsPath = document.uri.fsPath;
-        if (fsPath) {
-            try {
-                const stat = fs.statSync(fsPath);
-                return `${document.version}:${stat.mtimeMs}:${stat.size}`;
-            } catch {
-                // In-memory test documents and virtual documents may not exist on disk.
-            }
+        // In-memory test documents and virtual documents may not exist on disk.
+        const stat = fsPath ? this.fileSystem.stat(fsPath) : undefined;
+        if (stat) {
+            return `${document.version}:${stat.mtimeMs}:${stat.size}`;
         }
 
         return `${document.version}:${document.getText().length}`;
@@ -375,13 +373,10 @@ export class TargetMethodLookup {
     private createDependencyFingerprint(dependencies: readonly string[]): string {
         return dependencies
             .map((dependencyUri) => {
-                try {
-                    const fsPath = this.dependencyUriToFsPath(dependencyUri);
-                    const stat = fs.statSync(fsPath);
-                    return `${dependencyUri}:${stat.mtimeMs}:${stat.size}`;
-                } catch {
-                    return `${dependencyUri}:missing`;
-                }
+                const stat = this.fileSystem.stat(this.dependencyUriToFsPath(dependencyUri));
+                return stat
+                    ? `${dependencyUri}:${stat.mtimeMs}:${stat.size}`
+                    : `${dependencyUri}:missing`;
             })
             .join(';');
     }